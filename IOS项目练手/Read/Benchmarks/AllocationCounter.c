@@ -0,0 +1,143 @@
+//
+//  AllocationCounter.c
+//  Read Benchmarks
+//
+//  堆分配计数实现
+//
+
+#include "AllocationCounter.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <sys/resource.h>
+
+static atomic_bool sCounting;
+static atomic_uint_fast64_t sCount;
+static atomic_uint_fast64_t sBytes;
+
+static inline void AllocationCounterRecord(size_t size) {
+    if (atomic_load_explicit(&sCounting, memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&sCount, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&sBytes, size, memory_order_relaxed);
+    }
+}
+
+#if defined(__APPLE__)
+
+#include <malloc/malloc.h>
+
+// libsystem_malloc 在每次分配/释放时调用（MallocStackLogging 使用的同一个钩子）
+typedef void (MallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3,
+                            uintptr_t result, uint32_t numHotFramesToSkip);
+extern MallocLogger *malloc_logger;
+
+static const uint32_t kMallocLogTypeAllocate = 2;
+static const uint32_t kMallocLogTypeDeallocate = 4;
+
+static void AllocationCounterLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3,
+                                    uintptr_t result, uint32_t numHotFramesToSkip) {
+    (void)arg1; (void)arg3; (void)numHotFramesToSkip;
+    // realloc 同时带有分配和释放标记，按一次分配计
+    if ((type & kMallocLogTypeAllocate) && result) {
+        // 带 zone 参数时 arg2 是大小；calloc 为 arg2 * arg3
+        size_t size = (type & kMallocLogTypeDeallocate) ? arg3 : arg2;
+        AllocationCounterRecord(size);
+    }
+}
+
+bool AllocationCounterIsSupported(void) {
+    return true;
+}
+
+void AllocationCounterStart(void) {
+    malloc_logger = AllocationCounterLogger;
+    atomic_store(&sCounting, true);
+}
+
+void AllocationCounterStop(void) {
+    atomic_store(&sCounting, false);
+    malloc_logger = NULL;
+}
+
+uint64_t AllocationCounterPeakRSS(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)usage.ru_maxrss;            // macOS 单位为字节
+}
+
+#elif defined(__GLIBC__)
+
+// 可执行文件中的定义优先于 libc，动态库（libobjc、gnustep-base）的分配也经过这里
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+    AllocationCounterRecord(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    AllocationCounterRecord(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    AllocationCounterRecord(size);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+
+bool AllocationCounterIsSupported(void) {
+    return true;
+}
+
+void AllocationCounterStart(void) {
+    atomic_store(&sCounting, true);
+}
+
+void AllocationCounterStop(void) {
+    atomic_store(&sCounting, false);
+}
+
+uint64_t AllocationCounterPeakRSS(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)usage.ru_maxrss * 1024;     // Linux 单位为 KB
+}
+
+#else
+
+bool AllocationCounterIsSupported(void) {
+    return false;
+}
+
+void AllocationCounterStart(void) {
+}
+
+void AllocationCounterStop(void) {
+}
+
+uint64_t AllocationCounterPeakRSS(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)usage.ru_maxrss * 1024;
+}
+
+#endif
+
+void AllocationCounterReset(void) {
+    atomic_store(&sCount, 0);
+    atomic_store(&sBytes, 0);
+}
+
+AllocationCounts AllocationCounterRead(void) {
+    AllocationCounts counts = {
+        .count = atomic_load(&sCount),
+        .bytes = atomic_load(&sBytes),
+    };
+    return counts;
+}
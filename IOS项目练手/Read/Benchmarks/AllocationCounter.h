@@ -0,0 +1,46 @@
+//
+//  AllocationCounter.h
+//  Read Benchmarks
+//
+//  堆分配计数 - 统计一段代码中 malloc / calloc / realloc 的次数和字节数
+//
+
+#ifndef AllocationCounter_h
+#define AllocationCounter_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * 计数快照（从 AllocationCounterReset 开始累计，不扣除释放）
+ */
+typedef struct {
+    uint64_t count;   // 分配次数
+    uint64_t bytes;   // 申请的字节数
+} AllocationCounts;
+
+/**
+ * 当前平台是否支持分配计数
+ *   Linux (glibc)：可执行文件中定义 malloc 族函数，覆盖所有动态库的调用
+ *   macOS：通过 malloc_logger 回调
+ */
+bool AllocationCounterIsSupported(void);
+
+/**
+ * 开始 / 停止计数（停止后分配不再累计）
+ */
+void AllocationCounterStart(void);
+void AllocationCounterStop(void);
+
+/**
+ * 清零并读取
+ */
+void AllocationCounterReset(void);
+AllocationCounts AllocationCounterRead(void);
+
+/**
+ * 进程的峰值常驻内存（字节）
+ */
+uint64_t AllocationCounterPeakRSS(void);
+
+#endif /* AllocationCounter_h */
@@ -0,0 +1,449 @@
+//
+//  AppBenchmarks.m
+//  Read Benchmarks
+//
+//  App 微基准 - 规则解析、分页计算、存储读写，在 MicroBenchmark 框架下运行
+//
+//  用法：
+//    ./micro-benchmark [--filter TEXT] [--warmup SEC] [--min-time SEC] [--output FILE] [--list]
+//
+//  解析用例以 Corpus 中的每个书源为一个变体；分页依赖 CoreText，只在 macOS 上编译
+//
+
+#import <Foundation/Foundation.h>
+#include <math.h>
+#import "BookSource.h"
+#import "RuleParser.h"
+#import "HTMLParser.h"
+#import "ContentCleaner.h"
+#import "SourceResponseParser.h"
+#import "BookSourceSnapshot.h"
+#import "ChapterSearchIndex.h"
+#import "MicroBenchmark.h"
+
+#if defined(__APPLE__)
+#import <AppKit/AppKit.h>
+#import "PaginationEngine.h"
+#import "ChapterOffsetIndex.h"
+#endif
+
+static const NSUInteger kIndexedChapterCount = 50;      // 搜索索引中的章节数
+static const NSUInteger kOffsetIndexChapterCount = 200; // 垂直模式窗口内的章节数（远大于实际，放大查找开销）
+
+#pragma mark - 语料
+
+/**
+ * 语料中的一个书源：variant 为语料目录名（如 biquge），pages 按 search / toc / content 存放响应和 URL
+ */
+@interface AppBenchmarkCorpusEntry : NSObject
+@property (copy, nonatomic) NSString *variant;
+@property (strong, nonatomic) BookSource *source;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSString *> *pages;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSString *> *urls;
+@end
+
+@implementation AppBenchmarkCorpusEntry
+@end
+
+static NSString *AppBenchmarkDirectory(void) {
+    return [[NSProcessInfo processInfo].arguments.firstObject stringByDeletingLastPathComponent];
+}
+
+static NSArray<BookSource *> *AppBenchmarkBookSources(void) {
+    static NSArray<BookSource *> *sources = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSString *path = [AppBenchmarkDirectory() stringByAppendingPathComponent:@"../Read/Resources/book_sources.json"];
+        NSData *data = [NSData dataWithContentsOfFile:path];
+        NSArray *json = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+
+        NSMutableArray<BookSource *> *result = [NSMutableArray array];
+        for (NSDictionary *item in [json isKindOfClass:[NSArray class]] ? json : @[]) {
+            BookSource *source = [BookSource bookSourceFromJSON:item];
+            if (source.bookSourceUrl) {
+                [result addObject:source];
+            }
+        }
+        if (result.count == 0) {
+            fprintf(stderr, "⚠️ 无法读取书源：%s\n", path.UTF8String);
+        }
+        sources = result;
+    });
+    return sources;
+}
+
+static NSArray<AppBenchmarkCorpusEntry *> *AppBenchmarkCorpus(void) {
+    static NSArray<AppBenchmarkCorpusEntry *> *corpus = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableDictionary<NSString *, BookSource *> *sources = [NSMutableDictionary dictionary];
+        for (BookSource *source in AppBenchmarkBookSources()) {
+            sources[source.bookSourceUrl] = source;
+        }
+
+        NSString *corpusPath = [AppBenchmarkDirectory() stringByAppendingPathComponent:@"Corpus"];
+        NSData *data = [NSData dataWithContentsOfFile:[corpusPath stringByAppendingPathComponent:@"manifest.json"]];
+        NSDictionary *manifest = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+
+        NSMutableArray<AppBenchmarkCorpusEntry *> *result = [NSMutableArray array];
+        for (NSDictionary *item in [manifest isKindOfClass:[NSDictionary class]] ? manifest[@"sources"] : @[]) {
+            BookSource *source = sources[item[@"bookSourceUrl"]];
+            if (!source) {
+                continue;
+            }
+
+            AppBenchmarkCorpusEntry *entry = [[AppBenchmarkCorpusEntry alloc] init];
+            entry.source = source;
+            entry.pages = [NSMutableDictionary dictionary];
+            entry.urls = [NSMutableDictionary dictionary];
+            for (NSDictionary *response in item[@"responses"]) {
+                NSString *file = response[@"file"];
+                NSString *content = [NSString stringWithContentsOfFile:[corpusPath stringByAppendingPathComponent:file]
+                                                              encoding:NSUTF8StringEncoding
+                                                                 error:nil];
+                if (content) {
+                    entry.variant = [file stringByDeletingLastPathComponent];
+                    entry.pages[response[@"kind"]] = content;
+                    entry.urls[response[@"kind"]] = response[@"url"];
+                }
+            }
+            if (entry.variant) {
+                [result addObject:entry];
+            }
+        }
+        if (result.count == 0) {
+            fprintf(stderr, "⚠️ 无法读取语料：%s\n", corpusPath.UTF8String);
+        }
+        corpus = result;
+    });
+    return corpus;
+}
+
+/**
+ * 语料中清洗后的正文（分页、索引用例的输入）
+ */
+static NSArray<NSString *> *AppBenchmarkChapterTexts(void) {
+    NSMutableArray<NSString *> *texts = [NSMutableArray array];
+    for (AppBenchmarkCorpusEntry *entry in AppBenchmarkCorpus()) {
+        NSString *content = entry.pages[@"content"];
+        NSString *text = content ? [SourceResponseParser chapterTextFromContent:content bookSource:entry.source] : nil;
+        if (text.length > 0) {
+            [texts addObject:text];
+        }
+    }
+    return texts;
+}
+
+static NSString *AppBenchmarkTemporaryPath(NSString *name) {
+    NSString *fileName = [NSString stringWithFormat:@"read-bench-%d-%@", [NSProcessInfo processInfo].processIdentifier, name];
+    return [NSTemporaryDirectory() stringByAppendingPathComponent:fileName];
+}
+
+#pragma mark - 解析
+
+MICRO_BENCHMARK(parser, search) {
+    for (AppBenchmarkCorpusEntry *entry in AppBenchmarkCorpus()) {
+        NSString *page = entry.pages[@"search"];
+        if (!page) {
+            continue;
+        }
+        context.bytesPerIteration = [page lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        [context measureVariant:entry.variant block:^{
+            MICRO_DO_NOT_OPTIMIZE([SourceResponseParser booksFromSearchContent:page bookSource:entry.source]);
+        }];
+    }
+}
+
+MICRO_BENCHMARK(parser, toc) {
+    for (AppBenchmarkCorpusEntry *entry in AppBenchmarkCorpus()) {
+        NSString *page = entry.pages[@"toc"];
+        if (!page) {
+            continue;
+        }
+        NSString *baseURL = entry.urls[@"toc"];
+        context.bytesPerIteration = [page lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        [context measureVariant:entry.variant block:^{
+            MICRO_DO_NOT_OPTIMIZE([SourceResponseParser chaptersFromTocContent:page bookSource:entry.source baseURL:baseURL]);
+        }];
+    }
+}
+
+MICRO_BENCHMARK(parser, content) {
+    for (AppBenchmarkCorpusEntry *entry in AppBenchmarkCorpus()) {
+        NSString *page = entry.pages[@"content"];
+        if (!page) {
+            continue;
+        }
+        context.bytesPerIteration = [page lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        [context measureVariant:entry.variant block:^{
+            MICRO_DO_NOT_OPTIMIZE([SourceResponseParser chapterTextFromContent:page bookSource:entry.source]);
+        }];
+    }
+}
+
+/**
+ * 只计清洗：输入是正文规则提取出的 HTML 片段
+ */
+MICRO_BENCHMARK(parser, clean) {
+    for (AppBenchmarkCorpusEntry *entry in AppBenchmarkCorpus()) {
+        NSString *page = entry.pages[@"content"];
+        if (!page) {
+            continue;
+        }
+        ContentCleaner *cleaner = [ContentCleaner cleanerForContentRule:entry.source.ruleContent.content];
+        NSString *extracted = [SourceResponseParser stringFromResult:[RuleParser extractFromContent:page
+                                                                                            withRule:cleaner.extractionRule]];
+        if (extracted.length == 0) {
+            continue;
+        }
+        context.bytesPerIteration = [extracted lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        [context measureVariant:entry.variant block:^{
+            MICRO_DO_NOT_OPTIMIZE([cleaner cleanContent:extracted]);
+        }];
+    }
+}
+
+/**
+ * 选择器转正则并命中正则缓存（每条 HTML 规则的每一步都会走一次）
+ */
+MICRO_BENCHMARK(parser, selectorStep) {
+    [context measure:^{
+        NSString *pattern = [HTMLParser patternForSelectorStep:@"class.book-item"];
+        MICRO_DO_NOT_OPTIMIZE([HTMLParser regexWithPattern:pattern options:NSRegularExpressionDotMatchesLineSeparators]);
+    }];
+}
+
+MICRO_BENCHMARK(parser, fullURL) {
+    [context measureVariant:@"relative" block:^{
+        MICRO_DO_NOT_OPTIMIZE([SourceResponseParser fullURL:@"500012.html" baseURL:@"https://www.biquge.com/book/1013/"]);
+    }];
+    [context measureVariant:@"rootRelative" block:^{
+        MICRO_DO_NOT_OPTIMIZE([SourceResponseParser fullURL:@"/book/1013/500012.html" baseURL:@"https://www.biquge.com/book/1013/"]);
+    }];
+}
+
+#pragma mark - 分页
+
+#if defined(__APPLE__)
+
+static PaginationLayout *AppBenchmarkLayout(void) {
+    PaginationLayout *layout = [PaginationLayout layoutWithFontSize:17 pageSize:CGSizeMake(335, 600)];
+    layout.lineSpacing = 6;
+    layout.paragraphSpacing = 10;
+    return layout;
+}
+
+/**
+ * 对照：原来的分页方法（ReadingPaginationService 的 binarySearchPageLengthFrom:）
+ * 每页二分查找能放下的最大字符数，每一步用 boundingRectWithSize: 排版整个前缀；
+ * 字体、行距、段距、页面尺寸与 layout 一致
+ */
+static NSArray<NSNumber *> *AppBenchmarkReferencePageBreaks(NSString *text, PaginationLayout *layout) {
+    NSFont *font = layout.fontName.length > 0 ? [NSFont fontWithName:layout.fontName size:layout.fontSize] : nil;
+    NSMutableParagraphStyle *style = [[NSMutableParagraphStyle alloc] init];
+    style.lineSpacing = layout.lineSpacing;
+    style.paragraphSpacing = layout.paragraphSpacing;
+    NSDictionary *attributes = @{NSFontAttributeName: font ?: [NSFont systemFontOfSize:layout.fontSize],
+                                 NSParagraphStyleAttributeName: style};
+    CGSize size = layout.pageSize;
+
+    NSMutableArray<NSNumber *> *breaks = [NSMutableArray array];
+    NSInteger totalLength = text.length;
+    NSInteger currentIndex = 0;
+    while (currentIndex < totalLength) {
+        [breaks addObject:@(currentIndex)];
+
+        NSInteger left = 1;
+        NSInteger right = totalLength - currentIndex;
+        NSInteger pageLength = 1;
+        while (left <= right) {
+            NSInteger mid = (left + right) / 2;
+            NSString *substring = [text substringWithRange:NSMakeRange(currentIndex, mid)];
+            CGRect boundingRect = [substring boundingRectWithSize:size
+                                                          options:NSStringDrawingUsesLineFragmentOrigin
+                                                       attributes:attributes
+                                                          context:nil];
+            if (ceil(boundingRect.size.height) <= size.height) {
+                pageLength = mid;
+                left = mid + 1;
+            } else {
+                right = mid - 1;
+            }
+        }
+        currentIndex += pageLength;
+    }
+    return breaks;
+}
+
+/**
+ * 两种分页结果的差异：页数、起始位置不同的页数、起始位置的最大偏差（字符数）
+ */
+static NSDictionary *AppBenchmarkPageBreakDifference(NSArray<NSNumber *> *breaks, NSArray<NSNumber *> *reference) {
+    NSUInteger common = MIN(breaks.count, reference.count);
+    NSUInteger mismatched = MAX(breaks.count, reference.count) - common;
+    NSInteger maxDelta = 0;
+    for (NSUInteger i = 0; i < common; i++) {
+        NSInteger delta = labs(breaks[i].integerValue - reference[i].integerValue);
+        mismatched += delta != 0;
+        maxDelta = MAX(maxDelta, delta);
+    }
+    return @{
+        @"pages": @(breaks.count),
+        @"referencePages": @(reference.count),
+        @"mismatchedBreaks": @(mismatched),
+        @"maxBreakDelta": @(maxDelta),
+    };
+}
+
+MICRO_BENCHMARK(pagination, pageBreaks) {
+    PaginationLayout *layout = AppBenchmarkLayout();
+    NSArray<NSString *> *texts = AppBenchmarkChapterTexts();
+    if (texts.count == 0) {
+        return;
+    }
+
+    // 单章约 5000 字；长章节（约 3 万字）放大每页成本之外的固定开销差异
+    NSString *chapter = texts.firstObject;
+    NSString *longChapter = [[texts componentsJoinedByString:@"\n"] stringByPaddingToLength:30000
+                                                                                  withString:chapter
+                                                                             startingAtIndex:0];
+
+    context.bytesPerIteration = [chapter lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    [context measureVariant:@"chapter" block:^{
+        MICRO_DO_NOT_OPTIMIZE([[PaginationEngine sharedEngine] pageBreaksForText:chapter layout:layout]);
+    }];
+
+    // 对照只跑单章：长章节每页要排版数万字的前缀十几次，一次迭代就要数秒
+    [context measureVariant:@"chapter-boundingRect" block:^{
+        MICRO_DO_NOT_OPTIMIZE(AppBenchmarkReferencePageBreaks(chapter, layout));
+    }];
+    NSDictionary *difference = AppBenchmarkPageBreakDifference([[PaginationEngine sharedEngine] pageBreaksForText:chapter layout:layout],
+                                                               AppBenchmarkReferencePageBreaks(chapter, layout));
+    [context addResultFields:difference];
+    fprintf(stderr, "%-44s pages %lu vs %lu, %lu breaks differ (max %ld chars)\n", "  engine vs boundingRect",
+            [difference[@"pages"] unsignedLongValue], [difference[@"referencePages"] unsignedLongValue],
+            [difference[@"mismatchedBreaks"] unsignedLongValue], [difference[@"maxBreakDelta"] longValue]);
+
+    context.bytesPerIteration = [longChapter lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    [context measureVariant:@"long" block:^{
+        MICRO_DO_NOT_OPTIMIZE([[PaginationEngine sharedEngine] pageBreaksForText:longChapter layout:layout]);
+    }];
+}
+
+/**
+ * 从阅读锚点开始只排 3 页（打开章节时的首屏路径）
+ */
+MICRO_BENCHMARK(pagination, anchorPages) {
+    PaginationLayout *layout = AppBenchmarkLayout();
+    NSString *chapter = AppBenchmarkChapterTexts().firstObject;
+    if (!chapter) {
+        return;
+    }
+
+    NSRange range = NSMakeRange(chapter.length / 2, chapter.length - chapter.length / 2);
+    [context measure:^{
+        MICRO_DO_NOT_OPTIMIZE([[PaginationEngine sharedEngine] pageBreaksForText:chapter layout:layout range:range maxPages:3]);
+    }];
+}
+
+MICRO_BENCHMARK(pagination, offsetIndex) {
+    ChapterOffsetIndex *index = [[ChapterOffsetIndex alloc] init];
+    index.topInset = 10;
+    for (NSUInteger i = 0; i < kOffsetIndexChapterCount; i++) {
+        [index appendChapter:(NSInteger)i height:2400 + (i % 7) * 300];
+    }
+
+    __block CGFloat offset = 0;
+    CGFloat total = index.totalHeight;
+    [context measureVariant:@"chapterAtOffset" block:^{
+        offset = fmod(offset + 997, total);
+        MICRO_DO_NOT_OPTIMIZE([index chapterAtOffset:offset]);
+    }];
+
+    __block NSInteger chapter = 0;
+    [context measureVariant:@"setHeight" block:^{
+        chapter = (chapter + 13) % (NSInteger)kOffsetIndexChapterCount;
+        [index setHeight:2400 + (chapter % 5) * 250 forChapter:chapter];
+        MICRO_DO_NOT_OPTIMIZE([index offsetForChapter:(NSInteger)kOffsetIndexChapterCount - 1]);
+    }];
+
+    // 滑动窗口：向前插入一章、淘汰最后一章
+    ChapterOffsetIndex *window = [[ChapterOffsetIndex alloc] init];
+    for (NSUInteger i = 0; i < 8; i++) {
+        [window appendChapter:(NSInteger)(1000000 + i) height:3000];
+    }
+    [context measureVariant:@"slideBackward" block:^{
+        [window prependChapter:window.firstChapterIndex - 1 height:3000];
+        [window removeLastChapter];
+    }];
+}
+
+#endif
+
+#pragma mark - 存储
+
+MICRO_BENCHMARK(storage, snapshot) {
+    NSArray<BookSource *> *sources = AppBenchmarkBookSources();
+    NSString *path = AppBenchmarkTemporaryPath(@"sources.bss");
+    if (sources.count == 0 || ![BookSourceSnapshot writeBookSources:sources toPath:path]) {
+        return;
+    }
+
+    [context measureVariant:@"write" block:^{
+        MICRO_DO_NOT_OPTIMIZE([BookSourceSnapshot writeBookSources:sources toPath:path]);
+    }];
+    [context measureVariant:@"read" block:^{
+        MICRO_DO_NOT_OPTIMIZE([BookSourceSnapshot readBookSourcesFromPath:path]);
+    }];
+    // 读取后访问规则，触发延迟解码
+    [context measureVariant:@"readDecodeRules" block:^{
+        for (BookSource *source in [BookSourceSnapshot readBookSourcesFromPath:path]) {
+            MICRO_DO_NOT_OPTIMIZE(source.ruleSearch);
+            MICRO_DO_NOT_OPTIMIZE(source.ruleToc);
+            MICRO_DO_NOT_OPTIMIZE(source.ruleContent);
+        }
+    }];
+
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+MICRO_BENCHMARK(storage, searchIndex) {
+    NSArray<NSString *> *texts = AppBenchmarkChapterTexts();
+    if (texts.count == 0) {
+        return;
+    }
+
+    ChapterSearchIndex *index = [[ChapterSearchIndex alloc] initWithFilePath:AppBenchmarkTemporaryPath(@"search.idx")];
+    for (NSUInteger i = 0; i < kIndexedChapterCount; i++) {
+        [index addChapter:(NSInteger)i content:texts[i % texts.count]];
+    }
+    // 加入索引是异步的，同步查询一次等待完成
+    [index containsChapter:0];
+
+    [context measureVariant:@"phrase" block:^{
+        MICRO_DO_NOT_OPTIMIZE([index search:@"少年一道" limit:50]);
+    }];
+    [context measureVariant:@"bigram" block:^{
+        MICRO_DO_NOT_OPTIMIZE([index search:@"灵气" limit:0]);
+    }];
+    [context measureVariant:@"singleCharacter" block:^{
+        MICRO_DO_NOT_OPTIMIZE([index search:@"灵" limit:50]);
+    }];
+
+    // 每次迭代新建索引文件：加入一章（分词、压缩、追加段）再删除
+    NSString *text = texts.firstObject;
+    NSString *buildPath = AppBenchmarkTemporaryPath(@"search-build.idx");
+    context.bytesPerIteration = [text lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    [context measureVariant:@"addChapter" block:^{
+        ChapterSearchIndex *building = [[ChapterSearchIndex alloc] initWithFilePath:buildPath];
+        [building addChapter:0 content:text];
+        MICRO_DO_NOT_OPTIMIZE([building containsChapter:0]);
+        [building removeAllEntries];
+    }];
+
+    [index removeAllEntries];
+}
+
+int main(int argc, const char *argv[]) {
+    return MicroBenchmarkMain(argc, argv);
+}
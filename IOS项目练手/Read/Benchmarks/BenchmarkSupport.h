@@ -0,0 +1,48 @@
+//
+//  BenchmarkSupport.h
+//  Read Benchmarks
+//
+//  基准测试公共工具 - 单调时钟、耗时样本（分位数 / 直方图）、线程数
+//
+
+#import <Foundation/Foundation.h>
+#include <stdint.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 单调时钟（纳秒）
+ */
+uint64_t BenchmarkNowNanos(void);
+
+/**
+ * 当前进程的线程数（不支持的平台返回 0）
+ */
+NSUInteger BenchmarkThreadCount(void);
+
+/**
+ * 耗时样本（纳秒），输出时按指定单位给出分位数和直方图
+ * 非线程安全，只在一个线程（或加锁）添加样本
+ */
+@interface BenchmarkSamples : NSObject
+
+@property (assign, nonatomic, readonly) NSUInteger count;
+
+- (void)addNanos:(uint64_t)nanos;
+- (double)totalNanos;
+
+/**
+ * p50 / p90 / p99 / min / max / mean
+ * @param divisor 1e6 → 毫秒，1e3 → 微秒
+ */
+- (NSDictionary *)summaryWithDivisor:(double)divisor;
+
+/**
+ * 按 2 的幂分桶的直方图：[{"le": 1, "count": n}, {"le": 2, ...}, {"le": 4, ...}, ...]
+ * 每个桶只计 (le/2, le] 区间内的样本（非累计，第一个桶含 0）；桶一直排到覆盖最大样本，至少到 maxBound
+ */
+- (NSArray<NSDictionary *> *)histogramWithDivisor:(double)divisor maxBound:(double)maxBound;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,137 @@
+//
+//  BenchmarkSupport.m
+//  Read Benchmarks
+//
+//  基准测试公共工具实现
+//
+
+#import "BenchmarkSupport.h"
+#include <time.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+uint64_t BenchmarkNowNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+NSUInteger BenchmarkThreadCount(void) {
+#if defined(__APPLE__)
+    thread_act_array_t threads = NULL;
+    mach_msg_type_number_t count = 0;
+    if (task_threads(mach_task_self(), &threads, &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    for (mach_msg_type_number_t i = 0; i < count; i++) {
+        mach_port_deallocate(mach_task_self(), threads[i]);
+    }
+    vm_deallocate(mach_task_self(), (vm_address_t)threads, count * sizeof(thread_act_t));
+    return count;
+#elif defined(__linux__)
+    FILE *status = fopen("/proc/self/status", "r");
+    if (!status) {
+        return 0;
+    }
+    char line[256];
+    unsigned long count = 0;
+    while (fgets(line, sizeof(line), status)) {
+        if (strncmp(line, "Threads:", 8) == 0) {
+            count = strtoul(line + 8, NULL, 10);
+            break;
+        }
+    }
+    fclose(status);
+    return count;
+#else
+    return 0;
+#endif
+}
+
+@implementation BenchmarkSamples {
+    uint64_t *_values;
+    NSUInteger _capacity;
+}
+
+- (void)dealloc {
+    free(_values);
+}
+
+- (void)addNanos:(uint64_t)nanos {
+    if (_count == _capacity) {
+        _capacity = _capacity ? _capacity * 2 : 64;
+        _values = realloc(_values, _capacity * sizeof(uint64_t));
+    }
+    _values[_count++] = nanos;
+}
+
+- (double)totalNanos {
+    double total = 0;
+    for (NSUInteger i = 0; i < _count; i++) {
+        total += _values[i];
+    }
+    return total;
+}
+
+static int BenchmarkCompareNanos(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+- (double)percentile:(double)p sorted:(const uint64_t *)sorted {
+    // 最近秩法
+    NSUInteger rank = (NSUInteger)ceil(p / 100.0 * _count);
+    return sorted[MAX(rank, 1) - 1];
+}
+
+- (NSDictionary *)summaryWithDivisor:(double)divisor {
+    if (_count == 0) {
+        return @{};
+    }
+
+    uint64_t *sorted = malloc(_count * sizeof(uint64_t));
+    memcpy(sorted, _values, _count * sizeof(uint64_t));
+    qsort(sorted, _count, sizeof(uint64_t), BenchmarkCompareNanos);
+
+    NSDictionary *summary = @{
+        @"p50": @([self percentile:50 sorted:sorted] / divisor),
+        @"p90": @([self percentile:90 sorted:sorted] / divisor),
+        @"p99": @([self percentile:99 sorted:sorted] / divisor),
+        @"min": @(sorted[0] / divisor),
+        @"max": @(sorted[_count - 1] / divisor),
+        @"mean": @([self totalNanos] / _count / divisor),
+    };
+    free(sorted);
+    return summary;
+}
+
+- (NSArray<NSDictionary *> *)histogramWithDivisor:(double)divisor maxBound:(double)maxBound {
+    double largest = 0;
+    for (NSUInteger i = 0; i < _count; i++) {
+        largest = MAX(largest, _values[i] / divisor);
+    }
+
+    NSMutableArray<NSDictionary *> *buckets = [NSMutableArray array];
+    for (double bound = 1; ; bound *= 2) {
+        NSUInteger count = 0;
+        for (NSUInteger i = 0; i < _count; i++) {
+            double value = _values[i] / divisor;
+            if (value <= bound && (value > bound / 2 || bound == 1)) {
+                count++;
+            }
+        }
+        [buckets addObject:@{@"le": @(bound), @"count": @(count)}];
+
+        if (bound >= largest && bound >= maxBound) {
+            break;
+        }
+    }
+    return buckets;
+}
+
+@end
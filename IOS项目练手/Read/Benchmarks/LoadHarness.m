@@ -0,0 +1,406 @@
+//
+//  LoadHarness.m
+//  Read Benchmarks
+//
+//  端到端压测 - 通过回放服务器驱动 BookSearchService / BookContentService，
+//  模拟多个用户同时多书源搜索并打开章节，输出延迟直方图、首个结果时间、吞吐量和线程数（JSON）
+//
+//  用法（先启动 replay-server）：
+//    ./load-harness [--replay URL] [--corpus DIR] [--sources FILE] [--keyword 剑来]
+//                   [--users N] [--rounds N] [--output FILE] [--trace FILE]
+//
+//  --trace 同时记录应用内的追踪区间（TraceRecorder），导出 Chrome trace JSON，可用 Perfetto 打开
+//
+//  每个用户的一次会话：
+//    多书源搜索 → 取一本搜索结果 → 获取目录（详情页 + 目录页）→ 打开一个章节（含分页）
+//  每轮同时开始 N 个会话，全部结束后开始下一轮
+//
+
+#import <Foundation/Foundation.h>
+#import "BookSource.h"
+#import "NetworkManager.h"
+#import "BookSearchService.h"
+#import "TraceRecorder.h"
+#import "MetricsRegistry.h"
+#import "BookContentService.h"
+#import "ChapterListStore.h"
+#import "ParseExecutor.h"
+#import "BenchmarkSupport.h"
+
+static NSString * const kDefaultReplayURL = @"http://127.0.0.1:8090";
+static const NSInteger kDefaultUsers = 8;
+static const NSInteger kDefaultRounds = 5;
+static const double kThreadSampleInterval = 0.02;   // 线程数采样间隔（秒）
+static const double kHistogramMaxMs = 4096;
+
+#pragma mark - LoadHarness
+
+@interface LoadHarness : NSObject
+@property (copy, nonatomic) NSURL *replayURL;
+@property (copy, nonatomic) NSString *corpusPath;
+@property (copy, nonatomic) NSString *sourcesPath;
+@property (copy, nonatomic) NSString *keyword;
+@property (assign, nonatomic) NSInteger users;
+@property (assign, nonatomic) NSInteger rounds;
+
+@property (strong, nonatomic) NSArray<BookSource *> *sources;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, BenchmarkSamples *> *samples;   // 阶段 → 耗时
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSNumber *> *failures;          // 阶段 → 失败次数
+@property (strong, nonatomic) NSMutableSet<NSString *> *openedBookUrls;
+@property (strong, nonatomic) BenchmarkSamples *threadSamples;
+@property (strong, nonatomic) BenchmarkSamples *backlogSamples;                               // 解析积压（与线程数同时采样）
+@property (strong, nonatomic) dispatch_source_t threadSampler;
+@property (assign, nonatomic) NSInteger runningSessions;
+@property (assign, nonatomic) NSInteger completedSessions;
+@property (assign, nonatomic) BOOL finished;
+@end
+
+@implementation LoadHarness
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _replayURL = [NSURL URLWithString:kDefaultReplayURL];
+        _keyword = @"剑来";
+        _users = kDefaultUsers;
+        _rounds = kDefaultRounds;
+        _samples = [NSMutableDictionary dictionary];
+        _failures = [NSMutableDictionary dictionary];
+        _openedBookUrls = [NSMutableSet set];
+        _threadSamples = [[BenchmarkSamples alloc] init];
+        _backlogSamples = [[BenchmarkSamples alloc] init];
+    }
+    return self;
+}
+
+#pragma mark - 准备
+
+- (nullable id)JSONObjectAtPath:(NSString *)path {
+    NSData *data = [NSData dataWithContentsOfFile:path];
+    return data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+}
+
+/**
+ * 只压测语料中录制过的书源（其他书源的请求回放服务器会返回 404）
+ */
+- (BOOL)loadSources {
+    NSDictionary *manifest = [self JSONObjectAtPath:[self.corpusPath stringByAppendingPathComponent:@"manifest.json"]];
+    NSArray *json = [self JSONObjectAtPath:self.sourcesPath];
+    if (![manifest isKindOfClass:[NSDictionary class]] || ![json isKindOfClass:[NSArray class]]) {
+        return NO;
+    }
+
+    NSSet<NSString *> *recorded = [NSSet setWithArray:[manifest[@"sources"] valueForKey:@"bookSourceUrl"]];
+    NSMutableArray<BookSource *> *sources = [NSMutableArray array];
+    for (NSDictionary *item in json) {
+        BookSource *source = [BookSource bookSourceFromJSON:item];
+        if ([recorded containsObject:source.bookSourceUrl]) {
+            source.enabled = YES;
+            [sources addObject:source];
+        }
+    }
+    self.sources = sources;
+    return sources.count > 0;
+}
+
+- (BOOL)waitForReplayServer {
+    NSURL *healthURL = [self.replayURL URLByAppendingPathComponent:@"__replay/health"];
+    for (int attempt = 0; attempt < 50; attempt++) {
+        if ([NSData dataWithContentsOfURL:healthURL]) {
+            return YES;
+        }
+        [NSThread sleepForTimeInterval:0.1];
+    }
+    return NO;
+}
+
+- (nullable NSDictionary *)replayStats {
+    NSData *data = [NSData dataWithContentsOfURL:[self.replayURL URLByAppendingPathComponent:@"__replay/stats"]];
+    return data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+}
+
+#pragma mark - 记录（主线程）
+
+- (void)record:(NSString *)stage since:(uint64_t)start {
+    BenchmarkSamples *samples = self.samples[stage];
+    if (!samples) {
+        samples = [[BenchmarkSamples alloc] init];
+        self.samples[stage] = samples;
+    }
+    [samples addNanos:BenchmarkNowNanos() - start];
+}
+
+- (void)fail:(NSString *)stage {
+    self.failures[stage] = @(self.failures[stage].integerValue + 1);
+}
+
+- (void)startThreadSampler {
+    self.threadSampler = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0,
+                                                dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+    dispatch_source_set_timer(self.threadSampler, DISPATCH_TIME_NOW,
+                              (uint64_t)(kThreadSampleInterval * NSEC_PER_SEC), NSEC_PER_MSEC);
+    BenchmarkSamples *threadSamples = self.threadSamples;
+    BenchmarkSamples *backlogSamples = self.backlogSamples;
+    dispatch_source_set_event_handler(self.threadSampler, ^{
+        NSUInteger count = BenchmarkThreadCount();
+        NSUInteger backlog = [ParseExecutor sharedExecutor].backlog;
+        @synchronized (threadSamples) {
+            [threadSamples addNanos:count];
+            [backlogSamples addNanos:backlog];
+        }
+    });
+    dispatch_resume(self.threadSampler);
+}
+
+#pragma mark - 会话
+
+- (void)startRound:(NSInteger)round {
+    if (round >= self.rounds) {
+        self.finished = YES;
+        return;
+    }
+
+    // 每轮清空搜索缓存，保证每次搜索都经过网络
+    [[BookSearchService sharedService] clearCache];
+
+    self.runningSessions = self.users;
+    for (NSInteger user = 0; user < self.users; user++) {
+        [self runSessionForUser:user round:round completion:^{
+            self.completedSessions++;
+            if (--self.runningSessions == 0) {
+                [self startRound:round + 1];
+            }
+        }];
+    }
+}
+
+- (void)runSessionForUser:(NSInteger)user round:(NSInteger)round completion:(void (^)(void))completion {
+    uint64_t sessionStart = BenchmarkNowNanos();
+    __block BOOL firstResult = NO;
+
+    [[BookSearchService sharedService] searchBooks:self.keyword
+                                     inBookSources:self.sources
+                                          progress:^(BookSource *source, NSArray<SearchResultBook *> *books) {
+        [self record:[NSString stringWithFormat:@"search.%@", source.bookSourceName] since:sessionStart];
+        if (books.count == 0) {
+            [self fail:[NSString stringWithFormat:@"search.%@", source.bookSourceName]];
+        } else if (!firstResult) {
+            firstResult = YES;
+            [self record:@"timeToFirstResult" since:sessionStart];
+        }
+    } completion:^(NSArray<SearchResultBook *> *allBooks) {
+        [self record:@"search" since:sessionStart];
+        if (allBooks.count == 0) {
+            [self fail:@"search"];
+            completion();
+            return;
+        }
+
+        // 不同用户打开不同书源的书
+        SearchResultBook *book = allBooks[(user + round) % allBooks.count];
+        [self.openedBookUrls addObject:book.bookUrl];
+        [self openBook:book user:user sessionStart:sessionStart completion:completion];
+    }];
+}
+
+- (void)openBook:(SearchResultBook *)book
+            user:(NSInteger)user
+    sessionStart:(uint64_t)sessionStart
+      completion:(void (^)(void))completion {
+    uint64_t tocStart = BenchmarkNowNanos();
+
+    [[BookContentService sharedService] fetchChapterList:book.bookUrl
+                                              bookSource:book.bookSource
+                                                 success:^(NSString *tocUrl, NSArray<ChapterModel *> *chapters) {
+        [self record:@"toc" since:tocStart];
+        if (chapters.count == 0) {
+            [self fail:@"toc"];
+            completion();
+            return;
+        }
+
+        NSUInteger index = (user * 7) % chapters.count;
+        ChapterModel *chapter = chapters[index];
+        ChapterModel *nextChapter = index + 1 < chapters.count ? chapters[index + 1] : nil;
+        uint64_t chapterStart = BenchmarkNowNanos();
+
+        [[BookContentService sharedService] fetchChapterContent:chapter.chapterUrl
+                                                 nextChapterUrl:nextChapter.chapterUrl
+                                                     bookSource:book.bookSource
+                                                        success:^(ChapterContent *content) {
+            [self record:@"chapter" since:chapterStart];
+            [self record:@"session" since:sessionStart];
+            completion();
+        } failure:^(NSError *error) {
+            [self fail:@"chapter"];
+            completion();
+        }];
+    } failure:^(NSError *error) {
+        [self fail:@"toc"];
+        completion();
+    }];
+}
+
+#pragma mark - 运行
+
+- (NSDictionary *)run {
+    [[NetworkManager sharedManager] setReplayBaseURL:self.replayURL hostCount:self.sources.count];
+
+    NSDictionary *statsBefore = [self replayStats];
+    NSUInteger idleThreads = BenchmarkThreadCount();
+    [self startThreadSampler];
+    uint64_t start = BenchmarkNowNanos();
+
+    [self startRound:0];
+    while (!self.finished) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.05]];
+    }
+
+    double seconds = (BenchmarkNowNanos() - start) / 1e9;
+    dispatch_source_cancel(self.threadSampler);
+    NSDictionary *statsAfter = [self replayStats];
+
+    // 压测写入的持久化目录不保留
+    for (NSString *bookUrl in self.openedBookUrls) {
+        [[ChapterListStore sharedStore] removeChapterListForBookUrl:bookUrl];
+    }
+
+    NSMutableDictionary *stages = [NSMutableDictionary dictionary];
+    for (NSString *stage in self.samples) {
+        BenchmarkSamples *samples = self.samples[stage];
+        stages[stage] = @{
+            @"count": @(samples.count),
+            @"failures": self.failures[stage] ?: @0,
+            @"latencyMs": [samples summaryWithDivisor:1e6],
+            @"histogramMs": [samples histogramWithDivisor:1e6 maxBound:kHistogramMaxMs],
+        };
+    }
+    for (NSString *stage in self.failures) {
+        if (!stages[stage]) {
+            stages[stage] = @{@"count": @0, @"failures": self.failures[stage]};
+        }
+    }
+
+    NSInteger requests = [statsAfter[@"served"] integerValue] - [statsBefore[@"served"] integerValue];
+    NSDictionary *threadSummary;
+    NSDictionary *backlogSummary;
+    @synchronized (self.threadSamples) {
+        threadSummary = [self.threadSamples summaryWithDivisor:1];
+        backlogSummary = [self.backlogSamples summaryWithDivisor:1];
+    }
+
+    return @{
+        @"replay": self.replayURL.absoluteString,
+        @"sources": [self.sources valueForKey:@"bookSourceUrl"],
+        @"users": @(self.users),
+        @"rounds": @(self.rounds),
+        @"durationSeconds": @(seconds),
+        @"throughput": @{
+            @"sessionsPerSecond": @(self.completedSessions / seconds),
+            @"requestsPerSecond": @(requests / seconds),
+        },
+        @"stages": stages,
+        @"threads": @{
+            @"idle": @(idleThreads),
+            @"peak": threadSummary[@"max"] ?: @0,
+            @"mean": threadSummary[@"mean"] ?: @0,
+            @"p90": threadSummary[@"p90"] ?: @0,
+        },
+        @"parseBacklog": @{
+            @"capacity": @([ParseExecutor sharedExecutor].capacity),
+            @"workers": @([ParseExecutor sharedExecutor].workerCount),
+            @"peak": backlogSummary[@"max"] ?: @0,
+            @"mean": backlogSummary[@"mean"] ?: @0,
+        },
+        @"server": statsAfter ?: [NSNull null],
+        @"metrics": [MetricsRegistry snapshot],
+    };
+}
+
+@end
+
+#pragma mark - main
+
+static void LoadHarnessPrintUsage(void) {
+    fprintf(stderr,
+            "usage: load-harness [--replay URL] [--corpus DIR] [--sources FILE] [--keyword WORD]\n"
+            "                    [--users N] [--rounds N] [--output FILE] [--trace FILE]\n");
+}
+
+int main(int argc, const char *argv[]) {
+    @autoreleasepool {
+        NSString *executableDirectory = [[NSString stringWithUTF8String:argv[0]] stringByDeletingLastPathComponent];
+        LoadHarness *harness = [[LoadHarness alloc] init];
+        harness.corpusPath = [executableDirectory stringByAppendingPathComponent:@"Corpus"];
+        harness.sourcesPath = [executableDirectory stringByAppendingPathComponent:@"../Read/Resources/book_sources.json"];
+        NSString *outputPath = nil;
+        NSString *tracePath = nil;
+
+        for (int i = 1; i < argc; i++) {
+            NSString *option = [NSString stringWithUTF8String:argv[i]];
+            NSString *value = i + 1 < argc ? [NSString stringWithUTF8String:argv[++i]] : nil;
+            if (!value) {
+                LoadHarnessPrintUsage();
+                return 2;
+            }
+
+            if ([option isEqualToString:@"--replay"]) {
+                harness.replayURL = [NSURL URLWithString:value];
+            } else if ([option isEqualToString:@"--corpus"]) {
+                harness.corpusPath = value;
+            } else if ([option isEqualToString:@"--sources"]) {
+                harness.sourcesPath = value;
+            } else if ([option isEqualToString:@"--keyword"]) {
+                harness.keyword = value;
+            } else if ([option isEqualToString:@"--users"]) {
+                harness.users = MAX(value.integerValue, 1);
+            } else if ([option isEqualToString:@"--rounds"]) {
+                harness.rounds = MAX(value.integerValue, 1);
+            } else if ([option isEqualToString:@"--output"]) {
+                outputPath = value;
+            } else if ([option isEqualToString:@"--trace"]) {
+                tracePath = value;
+            } else {
+                LoadHarnessPrintUsage();
+                return 2;
+            }
+        }
+
+        if (![harness loadSources]) {
+            fprintf(stderr, "❌ 没有可压测的书源（检查 --corpus 和 --sources）\n");
+            return 2;
+        }
+        if (![harness waitForReplayServer]) {
+            fprintf(stderr, "❌ 回放服务器未就绪：%s\n", harness.replayURL.absoluteString.UTF8String);
+            return 2;
+        }
+
+        if (tracePath) {
+            [TraceRecorder startRecording];
+        }
+        NSDictionary *report = [harness run];
+        if (tracePath) {
+            [TraceRecorder stopRecording];
+            if (![[TraceRecorder chromeTraceData] writeToFile:tracePath atomically:YES]) {
+                fprintf(stderr, "⚠️ 写入追踪文件失败：%s\n", tracePath.UTF8String);
+            } else {
+                fprintf(stderr, "追踪：%lu 个事件 → %s\n", (unsigned long)[TraceRecorder eventCount], tracePath.UTF8String);
+            }
+        }
+        NSDictionary *session = report[@"stages"][@"session"][@"latencyMs"];
+        fprintf(stderr, "%ld 用户 × %ld 轮：会话 p50 %.1f ms / p99 %.1f ms，%.2f 会话/秒，峰值线程 %s\n",
+                (long)harness.users, (long)harness.rounds,
+                [session[@"p50"] doubleValue], [session[@"p99"] doubleValue],
+                [report[@"throughput"][@"sessionsPerSecond"] doubleValue],
+                [[report[@"threads"][@"peak"] description] UTF8String]);
+
+        NSData *json = [NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted error:nil];
+        if (outputPath) {
+            [json writeToFile:outputPath atomically:YES];
+        } else {
+            fwrite(json.bytes, 1, json.length, stdout);
+            fputc('\n', stdout);
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,104 @@
+//
+//  MicroBenchmark.h
+//  Read Benchmarks
+//
+//  微基准框架 - 注册宏、预热、自动校准迭代次数、中位数 / MAD / 批 p99 统计、JSON 输出
+//
+
+#import <Foundation/Foundation.h>
+#include <stdint.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class MicroBenchmarkContext;
+
+typedef void (*MicroBenchmarkFunction)(MicroBenchmarkContext *context);
+
+/**
+ * 登记一个基准（由 MICRO_BENCHMARK 在 main 之前调用，只保存指针，不分配内存）
+ */
+void MicroBenchmarkRegister(const char *group, const char *name, MicroBenchmarkFunction function);
+
+/**
+ * 注册一个基准，函数体内先准备数据，再调用 measure: 计时：
+ *
+ *   MICRO_BENCHMARK(parser, toc) {
+ *       NSString *html = ...;                       // 准备数据，不计时
+ *       [context measure:^{
+ *           MICRO_DO_NOT_OPTIMIZE([SourceResponseParser chaptersFromTocContent:html ...]);
+ *       }];
+ *   }
+ */
+#define MICRO_BENCHMARK(group, name) \
+    static void MicroBenchmark_##group##_##name(MicroBenchmarkContext *context); \
+    __attribute__((constructor)) static void MicroBenchmarkRegister_##group##_##name(void) { \
+        MicroBenchmarkRegister(#group, #name, MicroBenchmark_##group##_##name); \
+    } \
+    static void MicroBenchmark_##group##_##name(__attribute__((unused)) MicroBenchmarkContext *context)
+
+/**
+ * 让编译器认为结果被使用，计算不会被当作死代码删除，也不会被提到循环外
+ */
+static inline void MicroBenchmarkEscape(void *pointer) {
+    __asm__ __volatile__("" : : "r"(pointer) : "memory");
+}
+
+#define MICRO_DO_NOT_OPTIMIZE(value) do { \
+        __typeof__(value) _microBenchmarkValue = (value); \
+        MicroBenchmarkEscape((void *)&_microBenchmarkValue); \
+    } while (0)
+
+/**
+ * 运行参数
+ */
+typedef struct {
+    double warmupSeconds;       // 每个用例计时前的预热时长
+    double minTimeSeconds;      // 每个用例至少采样的总时长
+    double sampleSeconds;       // 校准目标：每个样本（一批迭代）的耗时
+    NSUInteger minSamples;
+    NSUInteger maxSamples;
+} MicroBenchmarkOptions;
+
+MicroBenchmarkOptions MicroBenchmarkDefaultOptions(void);
+
+/**
+ * 基准上下文（每个注册的基准一个）
+ *
+ * 说明：
+ *   一个基准可以调用多次 measureVariant:block:，每次是一个用例（如不同数据规模、不同书源）。
+ *   每次迭代都在独立的 @autoreleasepool 中执行，临时对象不会跨迭代堆积；
+ *   池的创建和释放计入耗时，其开销单独以 harnessOverheadNs 报告，不从结果中扣除。
+ */
+@interface MicroBenchmarkContext : NSObject
+
+/**
+ * 每次迭代处理的字节数（设置后报告吞吐量），对之后的 measure 生效
+ */
+@property (assign, nonatomic) NSUInteger bytesPerIteration;
+
+- (void)measure:(void (^)(void))block;
+
+- (void)measureVariant:(NSString *)variant block:(void (^)(void))block;
+
+/**
+ * 给最近一次 measure 的结果附加字段（如与对照实现的结果差异），写入 JSON；该用例被 --filter 跳过时忽略
+ */
+- (void)addResultFields:(NSDictionary<NSString *, id> *)fields;
+
+@end
+
+/**
+ * 运行所有登记的基准，输出 JSON
+ *
+ * 用法：
+ *   <程序> [--filter TEXT] [--warmup SEC] [--min-time SEC] [--output FILE] [--list]
+ *
+ *   --filter 只运行名称（group/name/variant）包含 TEXT 的用例
+ *   控制台逐行打印中位数、MAD、批 p99（每批迭代平均耗时的 p99，不是单次迭代的尾延迟）；
+ *   JSON 写入 --output 指定的文件，没有时写到标准输出
+ *
+ * @return 进程退出码
+ */
+int MicroBenchmarkMain(int argc, const char *_Nonnull argv[_Nonnull]);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,322 @@
+//
+//  MicroBenchmark.m
+//  Read Benchmarks
+//
+//  微基准框架实现
+//
+
+#import "MicroBenchmark.h"
+#import "BenchmarkSupport.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+enum {
+    kMicroBenchmarkMaxCount = 256,
+};
+static const uint64_t kMaxIterationsPerSample = 1ull << 30;
+
+#pragma mark - 登记
+
+typedef struct {
+    const char *group;
+    const char *name;
+    MicroBenchmarkFunction function;
+} MicroBenchmarkEntry;
+
+// 在 main 之前由构造函数写入，此时 Objective-C 运行时不一定可用，只用 C 数组
+static MicroBenchmarkEntry gBenchmarks[kMicroBenchmarkMaxCount];
+static NSUInteger gBenchmarkCount = 0;
+
+void MicroBenchmarkRegister(const char *group, const char *name, MicroBenchmarkFunction function) {
+    if (gBenchmarkCount == kMicroBenchmarkMaxCount) {
+        fprintf(stderr, "⚠️ 基准数量超过 %d，忽略 %s/%s\n", kMicroBenchmarkMaxCount, group, name);
+        return;
+    }
+    gBenchmarks[gBenchmarkCount++] = (MicroBenchmarkEntry){group, name, function};
+}
+
+MicroBenchmarkOptions MicroBenchmarkDefaultOptions(void) {
+    return (MicroBenchmarkOptions){
+        .warmupSeconds = 0.1,
+        .minTimeSeconds = 0.5,
+        .sampleSeconds = 0.001,
+        .minSamples = 20,
+        .maxSamples = 2000,
+    };
+}
+
+#pragma mark - 计时
+
+/**
+ * 连续运行一批迭代，每次迭代一个自动释放池
+ */
+static uint64_t MicroBenchmarkRunBatch(void (^block)(void), uint64_t iterations) {
+    uint64_t start = BenchmarkNowNanos();
+    for (uint64_t i = 0; i < iterations; i++) {
+        @autoreleasepool {
+            block();
+        }
+    }
+    return BenchmarkNowNanos() - start;
+}
+
+static int MicroBenchmarkCompareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static double MicroBenchmarkMedian(const double *sorted, NSUInteger count) {
+    return count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+}
+
+/**
+ * 按数量级选择单位（ns / µs / ms / s）
+ */
+static void MicroBenchmarkFormatNanos(double nanos, char *buffer, size_t size) {
+    if (nanos < 1e3) {
+        snprintf(buffer, size, "%.1f ns", nanos);
+    } else if (nanos < 1e6) {
+        snprintf(buffer, size, "%.2f µs", nanos / 1e3);
+    } else if (nanos < 1e9) {
+        snprintf(buffer, size, "%.2f ms", nanos / 1e6);
+    } else {
+        snprintf(buffer, size, "%.2f s", nanos / 1e9);
+    }
+}
+
+typedef struct {
+    uint64_t warmupIterations;
+    uint64_t iterationsPerSample;
+    NSUInteger samples;
+    double median;
+    double mad;
+    double batchP99;         // 批均值的 p99，不是单次迭代的 p99
+    double min;
+    double mean;
+} MicroBenchmarkStats;
+
+/**
+ * 预热 → 校准 → 采样
+ * 每个样本是一批迭代的平均耗时；批量大小使一批耗时约为 sampleSeconds，计时精度和循环开销可以忽略
+ * 分位数也是对批均值统计的：偶发的单次慢迭代被同一批的其他迭代摊薄，批 p99 反映的是批与批之间的波动，
+ * 不是单次调用的尾延迟（每批只有 1 次迭代时两者相同）
+ */
+static MicroBenchmarkStats MicroBenchmarkRun(void (^block)(void), MicroBenchmarkOptions options) {
+    MicroBenchmarkStats stats = {0};
+
+    // 预热：至少一次，直到预热时长用完（填充缓存、完成延迟初始化）
+    uint64_t warmupNanos = (uint64_t)(options.warmupSeconds * 1e9);
+    uint64_t warmupStart = BenchmarkNowNanos();
+    do {
+        MicroBenchmarkRunBatch(block, 1);
+        stats.warmupIterations++;
+    } while (BenchmarkNowNanos() - warmupStart < warmupNanos);
+
+    // 校准：按上一批的实测耗时估算批量大小，每轮最多放大 10 倍
+    uint64_t targetNanos = MAX((uint64_t)(options.sampleSeconds * 1e9), 1);
+    uint64_t iterations = 1;
+    for (;;) {
+        uint64_t elapsed = MicroBenchmarkRunBatch(block, iterations);
+        if (elapsed >= targetNanos || iterations >= kMaxIterationsPerSample) {
+            break;
+        }
+        double estimate = elapsed > 0 ? ceil(iterations * 1.2 * targetNanos / elapsed) : iterations * 10.0;
+        iterations = (uint64_t)MIN(MAX(estimate, iterations + 1.0), MIN(iterations * 10.0, (double)kMaxIterationsPerSample));
+    }
+    stats.iterationsPerSample = iterations;
+
+    NSUInteger maxSamples = MAX(options.maxSamples, MAX(options.minSamples, 1));
+    double *values = malloc(maxSamples * sizeof(double));
+    uint64_t minNanos = (uint64_t)(options.minTimeSeconds * 1e9);
+    uint64_t total = 0;
+    NSUInteger count = 0;
+    while (count < maxSamples && (count < options.minSamples || total < minNanos || count == 0)) {
+        uint64_t elapsed = MicroBenchmarkRunBatch(block, iterations);
+        total += elapsed;
+        values[count++] = (double)elapsed / iterations;
+    }
+
+    qsort(values, count, sizeof(double), MicroBenchmarkCompareDoubles);
+    stats.samples = count;
+    stats.median = MicroBenchmarkMedian(values, count);
+    stats.min = values[0];
+    stats.mean = (double)total / iterations / count;
+    // 最近秩法
+    NSUInteger rank = (NSUInteger)ceil(0.99 * count);
+    stats.batchP99 = values[MAX(rank, 1) - 1];
+
+    // MAD：各样本与中位数之差的绝对值的中位数（未乘 1.4826 换算为标准差）
+    for (NSUInteger i = 0; i < count; i++) {
+        values[i] = fabs(values[i] - stats.median);
+    }
+    qsort(values, count, sizeof(double), MicroBenchmarkCompareDoubles);
+    stats.mad = MicroBenchmarkMedian(values, count);
+
+    free(values);
+    return stats;
+}
+
+#pragma mark - MicroBenchmarkContext
+
+@interface MicroBenchmarkContext ()
+@property (copy, nonatomic) NSString *group;
+@property (copy, nonatomic) NSString *name;
+@property (copy, nonatomic, nullable) NSString *filter;
+@property (assign, nonatomic) MicroBenchmarkOptions options;
+@property (strong, nonatomic) NSMutableArray<NSDictionary *> *results;
+@property (strong, nonatomic, nullable) NSMutableDictionary *lastResult;
+@end
+
+@implementation MicroBenchmarkContext
+
+- (void)measure:(void (^)(void))block {
+    [self measureVariant:@"" block:block];
+}
+
+- (void)measureVariant:(NSString *)variant block:(void (^)(void))block {
+    NSString *fullName = [NSString stringWithFormat:@"%@/%@", self.group, self.name];
+    if (variant.length > 0) {
+        fullName = [fullName stringByAppendingFormat:@"/%@", variant];
+    }
+    self.lastResult = nil;
+    if (self.filter.length > 0 && ![fullName containsString:self.filter]) {
+        return;
+    }
+
+    MicroBenchmarkStats stats = MicroBenchmarkRun(block, self.options);
+
+    NSMutableDictionary *result = [@{
+        @"name": fullName,
+        @"group": self.group,
+        @"benchmark": self.name,
+        @"variant": variant,
+        @"warmupIterations": @(stats.warmupIterations),
+        @"iterationsPerSample": @(stats.iterationsPerSample),
+        @"samples": @(stats.samples),
+        @"medianNs": @(stats.median),
+        @"madNs": @(stats.mad),
+        @"batchP99Ns": @(stats.batchP99),
+        @"minNs": @(stats.min),
+        @"meanNs": @(stats.mean),
+    } mutableCopy];
+    if (self.bytesPerIteration > 0 && stats.median > 0) {
+        result[@"bytesPerIteration"] = @(self.bytesPerIteration);
+        result[@"throughputMBps"] = @(self.bytesPerIteration / (stats.median / 1e9) / (1024.0 * 1024.0));
+    }
+    [self.results addObject:result];
+    self.lastResult = result;
+
+    char median[32], batchP99[32];
+    MicroBenchmarkFormatNanos(stats.median, median, sizeof(median));
+    MicroBenchmarkFormatNanos(stats.batchP99, batchP99, sizeof(batchP99));
+    fprintf(stderr, "%-44s median %10s  MAD ±%5.1f%%  batch p99 %10s  %5lu × %llu\n",
+            fullName.UTF8String, median, stats.median > 0 ? stats.mad / stats.median * 100 : 0, batchP99,
+            (unsigned long)stats.samples, (unsigned long long)stats.iterationsPerSample);
+}
+
+- (void)addResultFields:(NSDictionary<NSString *, id> *)fields {
+    [self.lastResult addEntriesFromDictionary:fields];
+}
+
+@end
+
+#pragma mark - main
+
+static void MicroBenchmarkPrintUsage(const char *program) {
+    fprintf(stderr, "usage: %s [--filter TEXT] [--warmup SEC] [--min-time SEC] [--output FILE] [--list]\n", program);
+}
+
+int MicroBenchmarkMain(int argc, const char *argv[]) {
+    @autoreleasepool {
+        MicroBenchmarkOptions options = MicroBenchmarkDefaultOptions();
+        NSString *filter = nil;
+        NSString *outputPath = nil;
+
+        for (int i = 1; i < argc; i++) {
+            NSString *option = [NSString stringWithUTF8String:argv[i]];
+            if ([option isEqualToString:@"--list"]) {
+                for (NSUInteger j = 0; j < gBenchmarkCount; j++) {
+                    printf("%s/%s\n", gBenchmarks[j].group, gBenchmarks[j].name);
+                }
+                return 0;
+            }
+
+            NSString *value = i + 1 < argc ? [NSString stringWithUTF8String:argv[i + 1]] : nil;
+            if (!value) {
+                MicroBenchmarkPrintUsage(argv[0]);
+                return 2;
+            }
+            i++;
+
+            if ([option isEqualToString:@"--filter"]) {
+                filter = value;
+            } else if ([option isEqualToString:@"--warmup"]) {
+                options.warmupSeconds = MAX(value.doubleValue, 0);
+            } else if ([option isEqualToString:@"--min-time"]) {
+                options.minTimeSeconds = MAX(value.doubleValue, 0);
+            } else if ([option isEqualToString:@"--output"]) {
+                outputPath = value;
+            } else {
+                MicroBenchmarkPrintUsage(argv[0]);
+                return 2;
+            }
+        }
+
+        // 空迭代（只有自动释放池和 block 调用）的耗时，用于判断很快的用例有多少是框架本身的开销
+        double overhead = MicroBenchmarkRun(^{}, options).median;
+
+        NSMutableArray<NSDictionary *> *results = [NSMutableArray array];
+        for (NSUInteger i = 0; i < gBenchmarkCount; i++) {
+            @autoreleasepool {
+                MicroBenchmarkContext *context = [[MicroBenchmarkContext alloc] init];
+                context.group = @(gBenchmarks[i].group);
+                context.name = @(gBenchmarks[i].name);
+                context.filter = filter;
+                context.options = options;
+                context.results = results;
+                gBenchmarks[i].function(context);
+            }
+        }
+
+        if (results.count == 0) {
+            fprintf(stderr, "⚠️ 没有匹配的基准%s%s\n", filter ? "：" : "", filter ? filter.UTF8String : "");
+            return 1;
+        }
+
+        NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+        formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        formatter.timeZone = [NSTimeZone timeZoneWithName:@"UTC"];
+        formatter.dateFormat = @"yyyy-MM-dd'T'HH:mm:ss'Z'";
+
+#if defined(__APPLE__)
+        NSString *platform = @"darwin";
+#else
+        NSString *platform = @"gnustep";
+#endif
+
+        NSDictionary *report = @{
+            @"schema": @1,
+            @"timestamp": [formatter stringFromDate:[NSDate date]],
+            @"platform": platform,
+            @"warmupSeconds": @(options.warmupSeconds),
+            @"minTimeSeconds": @(options.minTimeSeconds),
+            @"sampleSeconds": @(options.sampleSeconds),
+            @"harnessOverheadNs": @(overhead),
+            @"benchmarks": results,
+        };
+
+        NSError *error = nil;
+        NSData *json = [NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted error:&error];
+        if (outputPath) {
+            if (![json writeToFile:outputPath options:NSDataWritingAtomic error:&error]) {
+                fprintf(stderr, "❌ 无法写入 %s：%s\n", outputPath.UTF8String, error.localizedDescription.UTF8String);
+                return 2;
+            }
+        } else {
+            fwrite(json.bytes, 1, json.length, stdout);
+            fputc('\n', stdout);
+        }
+        return 0;
+    }
+}
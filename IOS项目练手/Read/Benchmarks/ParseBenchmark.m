@@ -0,0 +1,503 @@
+//
+//  ParseBenchmark.m
+//  Read Benchmarks
+//
+//  解析基准测试 - 对录制的书源响应运行规则层，输出吞吐量、规则耗时分位数、分配次数和峰值内存（JSON）
+//
+//  用法：
+//    ./parse-benchmark [--corpus DIR] [--sources FILE] [--iterations N] [--warmup N]
+//                      [--output FILE] [--compare BASELINE] [--threshold PERCENT]
+//
+//  --compare 与保存的基线对比，任一指标退化超过阈值（默认 10%）时在报告中列出并以状态码 1 退出
+//
+
+#import <Foundation/Foundation.h>
+#include <math.h>
+#import "BookSource.h"
+#import "RuleParser.h"
+#import "HTMLParser.h"
+#import "ContentCleaner.h"
+#import "JSScriptEngine.h"
+#import "SourceResponseParser.h"
+#import "RuleCostAnalyzer.h"
+#include "AllocationCounter.h"
+#import "BenchmarkSupport.h"
+
+static const NSInteger kDefaultIterations = 50;
+static const NSInteger kDefaultWarmup = 5;
+static const double kDefaultThresholdPercent = 10;
+static const NSUInteger kMaxElementsPerRule = 200;      // 每次迭代中逐元素计时的最大元素数
+static const double kRuleNoiseFloorMicros = 2;          // 规则耗时变化小于 2µs 不算退化（计时噪声）
+
+#pragma mark - ParseBenchmark
+
+@interface ParseBenchmark : NSObject
+@property (copy, nonatomic) NSString *corpusPath;
+@property (copy, nonatomic) NSString *sourcesPath;
+@property (assign, nonatomic) NSInteger iterations;
+@property (assign, nonatomic) NSInteger warmup;
+@property (strong, nonatomic) NSMutableArray<NSDictionary *> *loopResults;
+@property (strong, nonatomic) NSMutableArray<NSDictionary *> *ruleResults;
+@property (strong, nonatomic) NSMutableArray<NSDictionary *> *analysisResults;
+- (BOOL)run:(NSError **)error;
+- (NSDictionary *)report;
+@end
+
+@implementation ParseBenchmark
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _iterations = kDefaultIterations;
+        _warmup = kDefaultWarmup;
+        _loopResults = [NSMutableArray array];
+        _ruleResults = [NSMutableArray array];
+        _analysisResults = [NSMutableArray array];
+    }
+    return self;
+}
+
+#pragma mark - 加载
+
+- (nullable id)JSONObjectAtPath:(NSString *)path error:(NSError **)error {
+    NSData *data = [NSData dataWithContentsOfFile:path options:0 error:error];
+    return data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:error] : nil;
+}
+
+- (NSDictionary<NSString *, BookSource *> *)loadBookSources:(NSError **)error {
+    NSArray *json = [self JSONObjectAtPath:self.sourcesPath error:error];
+    if (![json isKindOfClass:[NSArray class]]) {
+        return nil;
+    }
+
+    NSMutableDictionary<NSString *, BookSource *> *sources = [NSMutableDictionary dictionary];
+    for (NSDictionary *item in json) {
+        BookSource *source = [BookSource bookSourceFromJSON:item];
+        if (source.bookSourceUrl) {
+            sources[source.bookSourceUrl] = source;
+        }
+    }
+    return sources;
+}
+
+#pragma mark - 运行
+
+- (BOOL)run:(NSError **)error {
+    NSDictionary<NSString *, BookSource *> *sources = [self loadBookSources:error];
+    NSDictionary *manifest = [self JSONObjectAtPath:[self.corpusPath stringByAppendingPathComponent:@"manifest.json"] error:error];
+    if (!sources || ![manifest isKindOfClass:[NSDictionary class]]) {
+        return NO;
+    }
+
+    for (NSDictionary *entry in manifest[@"sources"]) {
+        BookSource *source = sources[entry[@"bookSourceUrl"]];
+        if (!source) {
+            fprintf(stderr, "⚠️ 书源不在 %s 中，跳过：%s\n",
+                    self.sourcesPath.UTF8String, [entry[@"bookSourceUrl"] UTF8String]);
+            continue;
+        }
+
+        NSMutableDictionary<NSString *, NSString *> *samples = [NSMutableDictionary dictionary];
+        for (NSDictionary *response in entry[@"responses"]) {
+            // 详情页只供回放服务器使用，解析流程不单独计时
+            if (![@[@"search", @"toc", @"content"] containsObject:response[@"kind"]]) {
+                continue;
+            }
+
+            NSString *file = response[@"file"];
+            NSString *content = [NSString stringWithContentsOfFile:[self.corpusPath stringByAppendingPathComponent:file]
+                                                          encoding:NSUTF8StringEncoding
+                                                             error:error];
+            if (!content) {
+                return NO;
+            }
+
+            NSString *name = [[file stringByDeletingPathExtension] copy];   // 例如 biquge/toc
+            [self measureLoop:response[@"kind"] name:name content:content url:response[@"url"] source:source];
+            [self measureRules:response[@"kind"] name:name content:content source:source];
+            samples[response[@"kind"]] = samples[response[@"kind"]] ?: content;
+        }
+        [self analyzeSource:source samples:samples];
+    }
+    return YES;
+}
+
+/**
+ * 运行一种响应的完整解析流程（与 App 中的调用相同）
+ * @return 解析出的条目数（书籍数、章节数或正文字数）
+ */
+- (NSUInteger)parse:(NSString *)kind content:(NSString *)content url:(NSString *)url source:(BookSource *)source {
+    if ([kind isEqualToString:@"search"]) {
+        return [SourceResponseParser booksFromSearchContent:content bookSource:source].count;
+    }
+    if ([kind isEqualToString:@"toc"]) {
+        return [SourceResponseParser chaptersFromTocContent:content bookSource:source baseURL:url].count;
+    }
+    if ([kind isEqualToString:@"content"]) {
+        [SourceResponseParser nextPageURLFromContent:content bookSource:source baseURL:url];
+        return [SourceResponseParser chapterTextFromContent:content bookSource:source].length;
+    }
+    return 0;
+}
+
+- (void)measureLoop:(NSString *)kind name:(NSString *)name content:(NSString *)content
+                url:(NSString *)url source:(BookSource *)source {
+    NSUInteger items = 0;
+    for (NSInteger i = 0; i < self.warmup; i++) {
+        @autoreleasepool {
+            items = [self parse:kind content:content url:url source:source];
+        }
+    }
+
+    BenchmarkSamples *samples = [[BenchmarkSamples alloc] init];
+    AllocationCounterReset();
+    AllocationCounterStart();
+    for (NSInteger i = 0; i < self.iterations; i++) {
+        @autoreleasepool {
+            uint64_t start = BenchmarkNowNanos();
+            [self parse:kind content:content url:url source:source];
+            [samples addNanos:BenchmarkNowNanos() - start];
+        }
+    }
+    AllocationCounterStop();
+    AllocationCounts allocations = AllocationCounterRead();
+
+    NSUInteger inputBytes = [content lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    double seconds = samples.totalNanos / 1e9;
+
+    NSMutableDictionary *result = [@{
+        @"name": name,
+        @"kind": kind,
+        @"source": source.bookSourceUrl,
+        @"inputBytes": @(inputBytes),
+        @"items": @(items),
+        @"throughputMBps": @(seconds > 0 ? inputBytes * (double)self.iterations / seconds / (1024.0 * 1024.0) : 0),
+        @"latencyMs": [samples summaryWithDivisor:1e6],
+    } mutableCopy];
+    if (AllocationCounterIsSupported()) {
+        result[@"allocationsPerIteration"] = @(allocations.count / (double)self.iterations);
+        result[@"allocatedBytesPerIteration"] = @(allocations.bytes / (double)self.iterations);
+    }
+    [self.loopResults addObject:result];
+
+    fprintf(stderr, "%-20s %8.2f MB/s  p50 %8.3f ms  %6lu items\n", name.UTF8String,
+            [result[@"throughputMBps"] doubleValue], [result[@"latencyMs"][@"p50"] doubleValue], (unsigned long)items);
+}
+
+#pragma mark - 单条规则
+
+/**
+ * 对一种响应涉及的每条规则单独计时：列表规则作用于整页，字段规则作用于列表中的每个元素
+ */
+- (void)measureRules:(NSString *)kind name:(NSString *)name content:(NSString *)content source:(BookSource *)source {
+    NSString *listRule = nil;
+    NSDictionary<NSString *, NSString *> *fieldRules = nil;
+    BOOL fieldsUseHTMLParser = NO;
+
+    if ([kind isEqualToString:@"search"]) {
+        RuleSearch *rule = source.ruleSearch;
+        listRule = rule.bookList;
+        fieldRules = [self rulesFromPairs:@[@"name", rule.name ?: @"", @"author", rule.author ?: @"",
+                                            @"bookUrl", rule.bookUrl ?: @"", @"intro", rule.intro ?: @"",
+                                            @"lastChapter", rule.lastChapter ?: @""]];
+        fieldsUseHTMLParser = YES;
+    } else if ([kind isEqualToString:@"toc"]) {
+        RuleToc *rule = source.ruleToc;
+        listRule = rule.chapterList;
+        // @js 部分在命令行中不执行，只计普通规则部分
+        NSString *urlRule = rule.chapterUrl ? [JSScriptEngine extractNormalRuleFromRule:rule.chapterUrl] : nil;
+        fieldRules = [self rulesFromPairs:@[@"chapterName", rule.chapterName ?: @"", @"chapterUrl", urlRule ?: @""]];
+    } else if ([kind isEqualToString:@"content"]) {
+        ContentCleaner *cleaner = [ContentCleaner cleanerForContentRule:source.ruleContent.content];
+        [self measureRule:[name stringByAppendingString:@"/content"] rule:cleaner.extractionRule block:^{
+            [RuleParser extractFromContent:content withRule:cleaner.extractionRule];
+        }];
+
+        NSString *extracted = [SourceResponseParser stringFromResult:[RuleParser extractFromContent:content
+                                                                                          withRule:cleaner.extractionRule]] ?: @"";
+        [self measureRule:[name stringByAppendingString:@"/clean"] rule:source.ruleContent.content ?: @"" block:^{
+            [cleaner cleanContent:extracted];
+        }];
+
+        NSString *nextRule = source.ruleContent.nextContentUrl;
+        if (nextRule.length > 0) {
+            [self measureRule:[name stringByAppendingString:@"/nextContentUrl"] rule:nextRule block:^{
+                [RuleParser extractFromContent:content withRule:nextRule];
+            }];
+        }
+        return;
+    }
+
+    if (listRule.length == 0) {
+        return;
+    }
+
+    [self measureRule:[name stringByAppendingFormat:@"/%@", [kind isEqualToString:@"toc"] ? @"chapterList" : @"bookList"]
+                 rule:listRule
+                block:^{
+        [RuleParser extractFromContent:content withRule:listRule];
+    }];
+
+    id listResult = [RuleParser extractFromContent:content withRule:listRule];
+    NSArray *elements = [listResult isKindOfClass:[NSArray class]] ? listResult : (listResult ? @[listResult] : @[]);
+    if (elements.count > kMaxElementsPerRule) {
+        elements = [elements subarrayWithRange:NSMakeRange(0, kMaxElementsPerRule)];
+    }
+
+    for (NSString *field in fieldRules) {
+        NSString *rule = fieldRules[field];
+        BenchmarkSamples *samples = [[BenchmarkSamples alloc] init];
+        for (NSInteger i = 0; i < self.iterations; i++) {
+            @autoreleasepool {
+                for (id element in elements) {
+                    uint64_t start = BenchmarkNowNanos();
+                    if ([element isKindOfClass:[NSDictionary class]]) {
+                        [RuleParser extractFromJSON:element withRule:rule];
+                    } else if (fieldsUseHTMLParser) {
+                        [HTMLParser extractFromHTML:element withRule:rule];
+                    } else {
+                        [RuleParser extractFromContent:element withRule:rule];
+                    }
+                    [samples addNanos:BenchmarkNowNanos() - start];
+                }
+            }
+        }
+        [self addRuleResult:[name stringByAppendingFormat:@"/%@", field] rule:rule samples:samples];
+    }
+}
+
+- (NSDictionary<NSString *, NSString *> *)rulesFromPairs:(NSArray<NSString *> *)pairs {
+    NSMutableDictionary *rules = [NSMutableDictionary dictionary];
+    for (NSUInteger i = 0; i + 1 < pairs.count; i += 2) {
+        if (pairs[i + 1].length > 0) {
+            rules[pairs[i]] = pairs[i + 1];
+        }
+    }
+    return rules;
+}
+
+- (void)measureRule:(NSString *)name rule:(NSString *)rule block:(void (^)(void))block {
+    BenchmarkSamples *samples = [[BenchmarkSamples alloc] init];
+    for (NSInteger i = 0; i < self.iterations; i++) {
+        @autoreleasepool {
+            uint64_t start = BenchmarkNowNanos();
+            block();
+            [samples addNanos:BenchmarkNowNanos() - start];
+        }
+    }
+    [self addRuleResult:name rule:rule samples:samples];
+}
+
+- (void)addRuleResult:(NSString *)name rule:(NSString *)rule samples:(BenchmarkSamples *)samples {
+    [self.ruleResults addObject:@{
+        @"name": name,
+        @"rule": rule,
+        @"samples": @(samples.count),
+        @"latencyUs": [samples summaryWithDivisor:1e3],
+    }];
+}
+
+#pragma mark - 规则开销分析
+
+/**
+ * 导入时的静态分析结果和样本页实测，用于校准开销分
+ */
+- (void)analyzeSource:(BookSource *)source samples:(NSDictionary<NSString *, NSString *> *)samples {
+    RuleCostReport *report = [RuleCostAnalyzer analyzeBookSource:source samples:samples];
+
+    NSMutableArray<NSDictionary *> *entries = [NSMutableArray array];
+    for (RuleCostEntry *entry in report.entries) {
+        [entries addObject:@{@"field": entry.field, @"complexity": @(entry.complexity), @"score": @(entry.score)}];
+    }
+
+    [self.analysisResults addObject:@{
+        @"source": source.bookSourceUrl,
+        @"costScore": @(report.costScore),
+        @"slow": @([RuleCostAnalyzer isSlowBookSource:source]),
+        @"warnings": report.warnings,
+        @"sampleMs": report.sampleMilliseconds,
+        @"entries": entries,
+    }];
+}
+
+#pragma mark - 报告
+
+- (NSDictionary *)report {
+    NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+    formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    formatter.timeZone = [NSTimeZone timeZoneWithName:@"UTC"];
+    formatter.dateFormat = @"yyyy-MM-dd'T'HH:mm:ss'Z'";
+
+#if defined(__APPLE__)
+    NSString *platform = @"darwin";
+#else
+    NSString *platform = @"gnustep";
+#endif
+
+    return @{
+        @"schema": @1,
+        @"timestamp": [formatter stringFromDate:[NSDate date]],
+        @"platform": platform,
+        @"iterations": @(self.iterations),
+        @"allocationCounting": @(AllocationCounterIsSupported()),
+        @"peakRSSBytes": @(AllocationCounterPeakRSS()),
+        @"loops": self.loopResults,
+        @"rules": self.ruleResults,
+        @"analysis": self.analysisResults,
+    };
+}
+
+@end
+
+#pragma mark - 基线对比
+
+/**
+ * 比较当前结果和基线，返回退化列表
+ * 吞吐量下降、p50 耗时上升、每次迭代分配次数上升超过阈值即为退化
+ */
+static NSArray<NSDictionary *> *BenchmarkCompare(NSDictionary *baseline, NSDictionary *current, double thresholdPercent) {
+    NSMutableArray<NSDictionary *> *regressions = [NSMutableArray array];
+
+    void (^check)(NSString *, NSString *, double, double, BOOL, double) =
+        ^(NSString *name, NSString *metric, double before, double after, BOOL higherIsBetter, double noiseFloor) {
+        if (before <= 0 || fabs(after - before) < noiseFloor) {
+            return;
+        }
+        double change = (after - before) / before * 100.0;
+        BOOL regressed = higherIsBetter ? change < -thresholdPercent : change > thresholdPercent;
+        if (regressed) {
+            [regressions addObject:@{@"name": name, @"metric": metric,
+                                     @"baseline": @(before), @"current": @(after), @"changePercent": @(change)}];
+        }
+    };
+
+    NSMutableDictionary<NSString *, NSDictionary *> *baseLoops = [NSMutableDictionary dictionary];
+    for (NSDictionary *loop in baseline[@"loops"]) {
+        baseLoops[loop[@"name"]] = loop;
+    }
+    for (NSDictionary *loop in current[@"loops"]) {
+        NSDictionary *base = baseLoops[loop[@"name"]];
+        if (!base) {
+            continue;
+        }
+        check(loop[@"name"], @"throughputMBps",
+              [base[@"throughputMBps"] doubleValue], [loop[@"throughputMBps"] doubleValue], YES, 0);
+        check(loop[@"name"], @"latencyMs.p50",
+              [base[@"latencyMs"][@"p50"] doubleValue], [loop[@"latencyMs"][@"p50"] doubleValue], NO, 0);
+        if (base[@"allocationsPerIteration"] && loop[@"allocationsPerIteration"]) {
+            check(loop[@"name"], @"allocationsPerIteration",
+                  [base[@"allocationsPerIteration"] doubleValue], [loop[@"allocationsPerIteration"] doubleValue], NO, 0);
+        }
+    }
+
+    NSMutableDictionary<NSString *, NSDictionary *> *baseRules = [NSMutableDictionary dictionary];
+    for (NSDictionary *rule in baseline[@"rules"]) {
+        baseRules[rule[@"name"]] = rule;
+    }
+    for (NSDictionary *rule in current[@"rules"]) {
+        NSDictionary *base = baseRules[rule[@"name"]];
+        if (!base) {
+            continue;
+        }
+        check(rule[@"name"], @"latencyUs.p50",
+              [base[@"latencyUs"][@"p50"] doubleValue], [rule[@"latencyUs"][@"p50"] doubleValue], NO, kRuleNoiseFloorMicros);
+        check(rule[@"name"], @"latencyUs.p99",
+              [base[@"latencyUs"][@"p99"] doubleValue], [rule[@"latencyUs"][@"p99"] doubleValue], NO, kRuleNoiseFloorMicros);
+    }
+
+    return regressions;
+}
+
+#pragma mark - main
+
+static void BenchmarkPrintUsage(void) {
+    fprintf(stderr,
+            "usage: parse-benchmark [--corpus DIR] [--sources FILE] [--iterations N] [--warmup N]\n"
+            "                       [--output FILE] [--compare BASELINE] [--threshold PERCENT]\n");
+}
+
+int main(int argc, const char *argv[]) {
+    @autoreleasepool {
+        NSString *executableDirectory = [[NSString stringWithUTF8String:argv[0]] stringByDeletingLastPathComponent];
+        ParseBenchmark *benchmark = [[ParseBenchmark alloc] init];
+        benchmark.corpusPath = [executableDirectory stringByAppendingPathComponent:@"Corpus"];
+        benchmark.sourcesPath = [executableDirectory stringByAppendingPathComponent:@"../Read/Resources/book_sources.json"];
+
+        NSString *outputPath = nil;
+        NSString *baselinePath = nil;
+        double threshold = kDefaultThresholdPercent;
+
+        for (int i = 1; i < argc; i++) {
+            NSString *option = [NSString stringWithUTF8String:argv[i]];
+            NSString *value = i + 1 < argc ? [NSString stringWithUTF8String:argv[i + 1]] : nil;
+            if (!value) {
+                BenchmarkPrintUsage();
+                return 2;
+            }
+            i++;
+
+            if ([option isEqualToString:@"--corpus"]) {
+                benchmark.corpusPath = value;
+            } else if ([option isEqualToString:@"--sources"]) {
+                benchmark.sourcesPath = value;
+            } else if ([option isEqualToString:@"--iterations"]) {
+                benchmark.iterations = MAX(value.integerValue, 1);
+            } else if ([option isEqualToString:@"--warmup"]) {
+                benchmark.warmup = MAX(value.integerValue, 0);
+            } else if ([option isEqualToString:@"--output"]) {
+                outputPath = value;
+            } else if ([option isEqualToString:@"--compare"]) {
+                baselinePath = value;
+            } else if ([option isEqualToString:@"--threshold"]) {
+                threshold = value.doubleValue;
+            } else {
+                BenchmarkPrintUsage();
+                return 2;
+            }
+        }
+
+        NSError *error = nil;
+        if (![benchmark run:&error]) {
+            fprintf(stderr, "❌ 基准测试失败：%s\n", error.localizedDescription.UTF8String ?: "语料或书源文件无效");
+            return 2;
+        }
+
+        NSMutableDictionary *report = [[benchmark report] mutableCopy];
+        NSArray<NSDictionary *> *regressions = nil;
+
+        if (baselinePath) {
+            NSData *baselineData = [NSData dataWithContentsOfFile:baselinePath];
+            NSDictionary *baseline = baselineData ? [NSJSONSerialization JSONObjectWithData:baselineData options:0 error:&error] : nil;
+            if (![baseline isKindOfClass:[NSDictionary class]]) {
+                fprintf(stderr, "❌ 无法读取基线：%s\n", baselinePath.UTF8String);
+                return 2;
+            }
+
+            regressions = BenchmarkCompare(baseline, report, threshold);
+            report[@"comparison"] = @{
+                @"baseline": baselinePath,
+                @"baselineTimestamp": baseline[@"timestamp"] ?: [NSNull null],
+                @"thresholdPercent": @(threshold),
+                @"regressions": regressions,
+            };
+
+            for (NSDictionary *regression in regressions) {
+                fprintf(stderr, "⚠️ 退化 %-36s %-24s %12.3f → %12.3f (%+.1f%%)\n",
+                        [regression[@"name"] UTF8String], [regression[@"metric"] UTF8String],
+                        [regression[@"baseline"] doubleValue], [regression[@"current"] doubleValue],
+                        [regression[@"changePercent"] doubleValue]);
+            }
+            fprintf(stderr, "%lu 项退化（阈值 %.1f%%）\n", (unsigned long)regressions.count, threshold);
+        }
+
+        NSData *json = [NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted error:&error];
+        if (outputPath) {
+            [json writeToFile:outputPath atomically:YES];
+        } else {
+            fwrite(json.bytes, 1, json.length, stdout);
+            fputc('\n', stdout);
+        }
+
+        return regressions.count > 0 ? 1 : 0;
+    }
+}
@@ -0,0 +1,574 @@
+//
+//  ReplayServer.m
+//  Read Benchmarks
+//
+//  回放服务器 - 本地 HTTP 服务，按书源返回录制的响应，模拟延迟、抖动、错误率和带宽
+//
+//  用法：
+//    ./replay-server [--corpus DIR] [--port N] [--profile NAME] [--latency MS] [--jitter MS]
+//                    [--error-rate RATE] [--bandwidth KBPS] [--host-profile HOST=NAME]... [--seed N] [--verbose]
+//
+//  请求路径为 /<scheme>/<host>/<path>?<query>（NetworkManager 回放模式改写后的格式），
+//  服务器还原出原始 URL，在 Corpus/manifest.json 中查找对应的录制响应：
+//    1. URL 完全相同
+//    2. 同一站点、路径相同（忽略查询参数，例如不同关键词的搜索）
+//    3. 同一站点、公共路径前缀最长，层级数相同者优先（例如其他章节的正文页）
+//
+//  控制接口：
+//    GET /__replay/health   就绪检查
+//    GET /__replay/stats    请求统计（JSON）
+//
+
+#import <Foundation/Foundation.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <iconv.h>
+
+static const int kDefaultPort = 8090;
+static const NSUInteger kMaxHeaderBytes = 64 * 1024;
+static const NSUInteger kSendChunkBytes = 4096;
+
+#pragma mark - ReplayProfile
+
+/**
+ * 网络条件
+ */
+@interface ReplayProfile : NSObject <NSCopying>
+@property (copy, nonatomic) NSString *name;
+@property (assign, nonatomic) double latencyMs;       // 首字节前的延迟（中位）
+@property (assign, nonatomic) double jitterMs;        // 延迟在 ±jitter 内均匀分布
+@property (assign, nonatomic) double errorRate;       // 注入错误的概率（一半 503，一半直接断开连接）
+@property (assign, nonatomic) double bandwidthKBps;   // 响应体发送速率，0 表示不限
++ (nullable instancetype)profileNamed:(NSString *)name;
+@end
+
+@implementation ReplayProfile
+
++ (nullable instancetype)profileNamed:(NSString *)name {
+    // 名称: 延迟, 抖动, 错误率, 带宽
+    NSDictionary<NSString *, NSArray<NSNumber *> *> *presets = @{
+        @"local": @[@0,   @0,   @0,     @0],
+        @"wifi":  @[@40,  @15,  @0.005, @2000],
+        @"4g":    @[@120, @60,  @0.01,  @800],
+        @"3g":    @[@400, @200, @0.03,  @120],
+        @"flaky": @[@250, @400, @0.15,  @200],
+    };
+    NSArray<NSNumber *> *values = presets[name];
+    if (!values) {
+        return nil;
+    }
+
+    ReplayProfile *profile = [[ReplayProfile alloc] init];
+    profile.name = name;
+    profile.latencyMs = values[0].doubleValue;
+    profile.jitterMs = values[1].doubleValue;
+    profile.errorRate = values[2].doubleValue;
+    profile.bandwidthKBps = values[3].doubleValue;
+    return profile;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    ReplayProfile *copy = [[ReplayProfile alloc] init];
+    copy.name = self.name;
+    copy.latencyMs = self.latencyMs;
+    copy.jitterMs = self.jitterMs;
+    copy.errorRate = self.errorRate;
+    copy.bandwidthKBps = self.bandwidthKBps;
+    return copy;
+}
+
+- (NSDictionary *)dictionaryValue {
+    return @{@"name": self.name ?: @"custom", @"latencyMs": @(self.latencyMs), @"jitterMs": @(self.jitterMs),
+             @"errorRate": @(self.errorRate), @"bandwidthKBps": @(self.bandwidthKBps)};
+}
+
+@end
+
+#pragma mark - ReplayResponse
+
+/**
+ * 一条录制的响应（响应体已按站点编码转换好）
+ */
+@interface ReplayResponse : NSObject
+@property (copy, nonatomic) NSString *url;
+@property (copy, nonatomic) NSString *path;
+@property (copy, nonatomic) NSArray<NSString *> *segments;
+@property (copy, nonatomic) NSString *contentType;
+@property (strong, nonatomic) NSData *body;
+@end
+
+@implementation ReplayResponse
+@end
+
+static NSArray<NSString *> *ReplayPathSegments(NSString *path) {
+    NSMutableArray<NSString *> *segments = [NSMutableArray array];
+    for (NSString *segment in [path componentsSeparatedByString:@"/"]) {
+        if (segment.length > 0) {
+            [segments addObject:segment];
+        }
+    }
+    return segments;
+}
+
+/**
+ * UTF-8 转为站点编码（录制语料统一存为 UTF-8，按 manifest 的 charset 还原线上的字节）
+ */
+static NSData *ReplayTranscode(NSData *utf8, NSString *charset) {
+    NSString *target = [charset.lowercaseString hasPrefix:@"gb"] ? @"GB18030" : charset.uppercaseString;
+    iconv_t converter = iconv_open(target.UTF8String, "UTF-8");
+    if (converter == (iconv_t)-1) {
+        fprintf(stderr, "⚠️ 不支持的编码 %s，按 UTF-8 发送\n", charset.UTF8String);
+        return utf8;
+    }
+
+    NSMutableData *output = [NSMutableData dataWithLength:utf8.length * 2 + 16];
+    char *in = (char *)utf8.bytes;
+    size_t inLeft = utf8.length;
+    char *out = output.mutableBytes;
+    size_t outLeft = output.length;
+    size_t result = iconv(converter, &in, &inLeft, &out, &outLeft);
+    iconv_close(converter);
+
+    if (result == (size_t)-1) {
+        fprintf(stderr, "⚠️ 转换到 %s 失败，按 UTF-8 发送\n", charset.UTF8String);
+        return utf8;
+    }
+    output.length = output.length - outLeft;
+    return output;
+}
+
+#pragma mark - ReplayServer
+
+@interface ReplayServer : NSObject
+@property (copy, nonatomic) NSString *corpusPath;
+@property (assign, nonatomic) int port;
+@property (assign, nonatomic) unsigned int seed;
+@property (assign, nonatomic) BOOL verbose;
+@property (copy, nonatomic) ReplayProfile *defaultProfile;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, ReplayProfile *> *hostProfiles;
+@property (strong, nonatomic) NSDictionary<NSString *, NSArray<ReplayResponse *> *> *responsesByHost;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSNumber *> *stats;
+@property (assign, nonatomic) NSInteger activeConnections;
+- (BOOL)loadCorpus:(NSError **)error;
+- (int)serve;
+- (void)handleConnection:(NSNumber *)socketNumber;
+@end
+
+@implementation ReplayServer
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _port = kDefaultPort;
+        _seed = (unsigned int)time(NULL);
+        _defaultProfile = [ReplayProfile profileNamed:@"local"];
+        _hostProfiles = [NSMutableDictionary dictionary];
+        _stats = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+#pragma mark - 语料
+
+- (BOOL)loadCorpus:(NSError **)error {
+    NSData *data = [NSData dataWithContentsOfFile:[self.corpusPath stringByAppendingPathComponent:@"manifest.json"]
+                                          options:0
+                                            error:error];
+    NSDictionary *manifest = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:error] : nil;
+    if (![manifest isKindOfClass:[NSDictionary class]]) {
+        return NO;
+    }
+
+    NSMutableDictionary<NSString *, NSMutableArray<ReplayResponse *> *> *byHost = [NSMutableDictionary dictionary];
+    for (NSDictionary *source in manifest[@"sources"]) {
+        for (NSDictionary *entry in source[@"responses"]) {
+            NSString *file = entry[@"file"];
+            NSData *body = [NSData dataWithContentsOfFile:[self.corpusPath stringByAppendingPathComponent:file]
+                                                  options:0
+                                                    error:error];
+            NSURL *url = [NSURL URLWithString:entry[@"url"]];
+            if (!body || !url.host) {
+                return NO;
+            }
+
+            NSString *charset = entry[@"charset"] ?: @"utf-8";
+            BOOL isJSON = [file.pathExtension isEqualToString:@"json"];
+
+            ReplayResponse *response = [[ReplayResponse alloc] init];
+            response.url = url.absoluteString;
+            response.path = url.path.length > 0 ? url.path : @"/";
+            response.segments = ReplayPathSegments(response.path);
+            response.body = [charset.lowercaseString isEqualToString:@"utf-8"] ? body : ReplayTranscode(body, charset);
+            response.contentType = [NSString stringWithFormat:@"%@; charset=%@", isJSON ? @"application/json" : @"text/html", charset];
+
+            NSString *host = [self hostKeyForURL:url];
+            if (!byHost[host]) {
+                byHost[host] = [NSMutableArray array];
+            }
+            [byHost[host] addObject:response];
+        }
+    }
+
+    self.responsesByHost = byHost;
+    return YES;
+}
+
+- (NSString *)hostKeyForURL:(NSURL *)url {
+    return url.port ? [NSString stringWithFormat:@"%@:%@", url.host, url.port] : url.host;
+}
+
+/**
+ * 按原始 URL 查找录制的响应（规则见文件头）
+ */
+- (nullable ReplayResponse *)responseForURL:(NSURL *)url {
+    NSArray<ReplayResponse *> *candidates = self.responsesByHost[[self hostKeyForURL:url]];
+    NSString *path = url.path.length > 0 ? url.path : @"/";
+    NSArray<NSString *> *segments = ReplayPathSegments(path);
+
+    ReplayResponse *best = nil;
+    NSInteger bestScore = -1;
+    for (ReplayResponse *response in candidates) {
+        if ([response.url isEqualToString:url.absoluteString]) {
+            return response;
+        }
+
+        NSInteger score = 0;
+        if ([response.path isEqualToString:path]) {
+            score = 1000;
+        } else {
+            NSUInteger common = 0;
+            while (common < segments.count && common < response.segments.count &&
+                   [segments[common] isEqualToString:response.segments[common]]) {
+                common++;
+            }
+            score = common * 4 + (segments.count == response.segments.count ? 2 : 0);
+        }
+
+        if (score > bestScore) {
+            best = response;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+- (ReplayProfile *)profileForHost:(NSString *)host {
+    return self.hostProfiles[host] ?: self.defaultProfile;
+}
+
+#pragma mark - 统计
+
+- (void)count:(NSString *)key {
+    @synchronized (self) {
+        self.stats[key] = @(self.stats[key].integerValue + 1);
+    }
+}
+
+- (void)connectionDidOpen:(BOOL)open {
+    @synchronized (self) {
+        self.activeConnections += open ? 1 : -1;
+        if (self.activeConnections > self.stats[@"peakConnections"].integerValue) {
+            self.stats[@"peakConnections"] = @(self.activeConnections);
+        }
+    }
+}
+
+- (NSDictionary *)statsSnapshot {
+    @synchronized (self) {
+        NSMutableDictionary *snapshot = [self.stats mutableCopy];
+        snapshot[@"activeConnections"] = @(self.activeConnections);
+        snapshot[@"profile"] = [self.defaultProfile dictionaryValue];
+        return snapshot;
+    }
+}
+
+#pragma mark - 服务
+
+- (int)serve {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("socket");
+        return 1;
+    }
+
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(self.port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(listener, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(listener, 256) < 0) {
+        perror("bind/listen");
+        close(listener);
+        return 1;
+    }
+
+    fprintf(stderr, "回放服务器已启动：http://127.0.0.1:%d（%lu 个站点，网络条件 %s）\n",
+            self.port, (unsigned long)self.responsesByHost.count, self.defaultProfile.name.UTF8String ?: "custom");
+
+    while (YES) {
+        int client = accept(listener, NULL, NULL);
+        if (client < 0) {
+            continue;
+        }
+        // ⭐ 每个连接一个线程：延迟和限速用 sleep 实现，不能占用共享的工作线程
+        [NSThread detachNewThreadSelector:@selector(handleConnection:) toTarget:self withObject:@(client)];
+    }
+}
+
+- (void)handleConnection:(NSNumber *)socketNumber {
+    @autoreleasepool {
+        int client = socketNumber.intValue;
+        [self connectionDidOpen:YES];
+        [self handleRequestOnSocket:client];
+        close(client);
+        [self connectionDidOpen:NO];
+    }
+}
+
+- (void)handleRequestOnSocket:(int)client {
+    int noDelay = 1;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    // 读取请求头（POST 的请求体不关心，读掉即可）
+    NSMutableData *buffer = [NSMutableData data];
+    NSRange headerEnd = NSMakeRange(NSNotFound, 0);
+    NSData *separator = [@"\r\n\r\n" dataUsingEncoding:NSASCIIStringEncoding];
+    char chunk[4096];
+    while (headerEnd.location == NSNotFound && buffer.length < kMaxHeaderBytes) {
+        ssize_t received = recv(client, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return;
+        }
+        [buffer appendBytes:chunk length:received];
+        headerEnd = [buffer rangeOfData:separator options:0 range:NSMakeRange(0, buffer.length)];
+    }
+    if (headerEnd.location == NSNotFound) {
+        [self sendStatus:400 reason:@"Bad Request" body:nil contentType:nil onSocket:client profile:nil];
+        return;
+    }
+
+    NSString *header = [[NSString alloc] initWithData:[buffer subdataWithRange:NSMakeRange(0, headerEnd.location)]
+                                             encoding:NSISOLatin1StringEncoding];
+    NSArray<NSString *> *lines = [header componentsSeparatedByString:@"\r\n"];
+    NSArray<NSString *> *requestLine = [lines.firstObject componentsSeparatedByString:@" "];
+    if (requestLine.count < 2) {
+        [self sendStatus:400 reason:@"Bad Request" body:nil contentType:nil onSocket:client profile:nil];
+        return;
+    }
+
+    NSInteger contentLength = 0;
+    for (NSString *line in lines) {
+        if ([line.lowercaseString hasPrefix:@"content-length:"]) {
+            contentLength = [[line substringFromIndex:15] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]].integerValue;
+        }
+    }
+    NSInteger bodyReceived = buffer.length - NSMaxRange(headerEnd);
+    while (bodyReceived < contentLength) {
+        ssize_t received = recv(client, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return;
+        }
+        bodyReceived += received;
+    }
+
+    NSString *method = requestLine[0];
+    NSString *target = requestLine[1];
+    [self count:@"requests"];
+
+    // 控制接口
+    if ([target isEqualToString:@"/__replay/health"]) {
+        [self sendStatus:200 reason:@"OK" body:[@"ok" dataUsingEncoding:NSUTF8StringEncoding]
+             contentType:@"text/plain" onSocket:client profile:nil];
+        return;
+    }
+    if ([target isEqualToString:@"/__replay/stats"]) {
+        NSData *json = [NSJSONSerialization dataWithJSONObject:[self statsSnapshot] options:0 error:nil];
+        [self sendStatus:200 reason:@"OK" body:json contentType:@"application/json" onSocket:client profile:nil];
+        return;
+    }
+
+    // /<scheme>/<host>/<path> → scheme://host/path
+    NSArray<NSString *> *parts = [[target substringFromIndex:MIN(1, target.length)] componentsSeparatedByString:@"/"];
+    NSURL *originalURL = nil;
+    if (parts.count >= 2) {
+        NSString *rest = [[parts subarrayWithRange:NSMakeRange(2, parts.count - 2)] componentsJoinedByString:@"/"];
+        originalURL = [NSURL URLWithString:[NSString stringWithFormat:@"%@://%@/%@", parts[0], parts[1], rest]];
+    }
+
+    ReplayResponse *response = originalURL ? [self responseForURL:originalURL] : nil;
+    if (!response) {
+        [self count:@"notFound"];
+        if (self.verbose) {
+            fprintf(stderr, "404 %s %s\n", method.UTF8String, target.UTF8String);
+        }
+        [self sendStatus:404 reason:@"Not Found" body:nil contentType:nil onSocket:client profile:nil];
+        return;
+    }
+
+    ReplayProfile *profile = [self profileForHost:[self hostKeyForURL:originalURL]];
+    unsigned int seed;
+    @synchronized (self) {
+        seed = self.seed = self.seed * 1103515245u + 12345u;
+    }
+
+    // 延迟（首字节前）
+    double delayMs = profile.latencyMs + ((double)rand_r(&seed) / RAND_MAX * 2 - 1) * profile.jitterMs;
+    if (delayMs > 0) {
+        usleep((useconds_t)(delayMs * 1000));
+    }
+
+    // 错误注入
+    if (profile.errorRate > 0 && (double)rand_r(&seed) / RAND_MAX < profile.errorRate) {
+        if (rand_r(&seed) % 2 == 0) {
+            [self count:@"injected503"];
+            [self sendStatus:503 reason:@"Service Unavailable" body:nil contentType:nil onSocket:client profile:nil];
+        } else {
+            // 直接重置连接
+            [self count:@"injectedReset"];
+            struct linger reset = {1, 0};
+            setsockopt(client, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+        }
+        return;
+    }
+
+    if (self.verbose) {
+        fprintf(stderr, "200 %s %s → %s (%.0fms)\n", method.UTF8String, originalURL.absoluteString.UTF8String,
+                response.url.UTF8String, delayMs);
+    }
+    [self count:@"served"];
+    [self sendStatus:200 reason:@"OK" body:response.body contentType:response.contentType onSocket:client profile:profile];
+}
+
+- (void)sendStatus:(NSInteger)status
+            reason:(NSString *)reason
+              body:(nullable NSData *)body
+       contentType:(nullable NSString *)contentType
+          onSocket:(int)client
+           profile:(nullable ReplayProfile *)profile {
+    NSString *header = [NSString stringWithFormat:@"HTTP/1.1 %ld %@\r\nContent-Type: %@\r\nContent-Length: %lu\r\nCache-Control: no-store\r\nConnection: close\r\n\r\n",
+                        (long)status, reason, contentType ?: @"text/plain", (unsigned long)body.length];
+    NSData *headerData = [header dataUsingEncoding:NSASCIIStringEncoding];
+    if (![self sendBytes:headerData.bytes length:headerData.length onSocket:client]) {
+        return;
+    }
+
+    // ⭐ 限速：按块发送，每块之后等待 块大小 / 带宽
+    const char *bytes = body.bytes;
+    NSUInteger offset = 0;
+    while (offset < body.length) {
+        NSUInteger length = MIN(kSendChunkBytes, body.length - offset);
+        if (![self sendBytes:bytes + offset length:length onSocket:client]) {
+            return;
+        }
+        offset += length;
+
+        if (profile.bandwidthKBps > 0) {
+            usleep((useconds_t)(length / (profile.bandwidthKBps * 1024.0) * 1e6));
+        }
+    }
+}
+
+- (BOOL)sendBytes:(const char *)bytes length:(NSUInteger)length onSocket:(int)client {
+    while (length > 0) {
+        ssize_t sent = send(client, bytes, length, 0);
+        if (sent <= 0) {
+            return NO;
+        }
+        bytes += sent;
+        length -= sent;
+    }
+    return YES;
+}
+
+@end
+
+#pragma mark - main
+
+static void ReplayPrintUsage(void) {
+    fprintf(stderr,
+            "usage: replay-server [--corpus DIR] [--port N] [--profile local|wifi|4g|3g|flaky]\n"
+            "                     [--latency MS] [--jitter MS] [--error-rate RATE] [--bandwidth KBPS]\n"
+            "                     [--host-profile HOST=PROFILE]... [--seed N] [--verbose]\n");
+}
+
+int main(int argc, const char *argv[]) {
+    @autoreleasepool {
+        signal(SIGPIPE, SIG_IGN);
+
+        ReplayServer *server = [[ReplayServer alloc] init];
+        server.corpusPath = [[[NSString stringWithUTF8String:argv[0]] stringByDeletingLastPathComponent]
+                             stringByAppendingPathComponent:@"Corpus"];
+        ReplayProfile *profile = [server.defaultProfile copy];
+
+        for (int i = 1; i < argc; i++) {
+            NSString *option = [NSString stringWithUTF8String:argv[i]];
+            if ([option isEqualToString:@"--verbose"]) {
+                server.verbose = YES;
+                continue;
+            }
+
+            NSString *value = i + 1 < argc ? [NSString stringWithUTF8String:argv[++i]] : nil;
+            if (!value) {
+                ReplayPrintUsage();
+                return 2;
+            }
+
+            if ([option isEqualToString:@"--corpus"]) {
+                server.corpusPath = value;
+            } else if ([option isEqualToString:@"--port"]) {
+                server.port = value.intValue;
+            } else if ([option isEqualToString:@"--seed"]) {
+                server.seed = (unsigned int)value.integerValue;
+            } else if ([option isEqualToString:@"--profile"]) {
+                profile = [ReplayProfile profileNamed:value];
+                if (!profile) {
+                    fprintf(stderr, "❌ 未知的网络条件：%s\n", value.UTF8String);
+                    return 2;
+                }
+            } else if ([option isEqualToString:@"--latency"]) {
+                profile.latencyMs = value.doubleValue;
+                profile.name = nil;
+            } else if ([option isEqualToString:@"--jitter"]) {
+                profile.jitterMs = value.doubleValue;
+                profile.name = nil;
+            } else if ([option isEqualToString:@"--error-rate"]) {
+                profile.errorRate = value.doubleValue;
+                profile.name = nil;
+            } else if ([option isEqualToString:@"--bandwidth"]) {
+                profile.bandwidthKBps = value.doubleValue;
+                profile.name = nil;
+            } else if ([option isEqualToString:@"--host-profile"]) {
+                NSArray<NSString *> *pair = [value componentsSeparatedByString:@"="];
+                ReplayProfile *hostProfile = pair.count == 2 ? [ReplayProfile profileNamed:pair[1]] : nil;
+                if (!hostProfile) {
+                    fprintf(stderr, "❌ --host-profile 格式为 HOST=PROFILE：%s\n", value.UTF8String);
+                    return 2;
+                }
+                server.hostProfiles[pair[0]] = hostProfile;
+            } else {
+                ReplayPrintUsage();
+                return 2;
+            }
+        }
+        server.defaultProfile = profile;
+
+        NSError *error = nil;
+        if (![server loadCorpus:&error]) {
+            fprintf(stderr, "❌ 无法加载语料：%s\n", error.localizedDescription.UTF8String ?: server.corpusPath.UTF8String);
+            return 2;
+        }
+
+        return [server serve];
+    }
+}
@@ -8,6 +8,7 @@
 #import "BookSourceViewController.h"
 #import "BookSourceManager.h"
 #import "BookSource.h"
+#import "RuleCostAnalyzer.h"
 
 @interface BookSourceViewController () <UITableViewDelegate, UITableViewDataSource>
 @property (strong, nonatomic) UITableView *tableView;
@@ -151,33 +152,20 @@
     }
 
     NSData *data = [jsonString dataUsingEncoding:NSUTF8StringEncoding];
-    NSError *error = nil;
-    id jsonObject = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
 
-    if (error) {
-        [self showMessage:[NSString stringWithFormat:@"JSON 解析失败: %@", error.localizedDescription]];
-        return;
-    }
-
-    BOOL success = NO;
-    if ([jsonObject isKindOfClass:[NSDictionary class]]) {
-        // 单个书源
-        BookSource *source = [BookSource bookSourceFromJSON:jsonObject];
-        success = [[BookSourceManager sharedManager] addBookSource:source];
-    } else if ([jsonObject isKindOfClass:[NSArray class]]) {
-        // 多个书源
-        success = [[BookSourceManager sharedManager] importBookSourcesFromJSONArray:jsonObject];
-    } else {
-        [self showMessage:@"无效的 JSON 格式"];
-        return;
-    }
-
-    if (success) {
-        [self loadBookSources];
-        [self showMessage:@"导入成功"];
-    } else {
-        [self showMessage:@"导入失败"];
-    }
+    // ⭐ 流式导入：后台逐个解析书源，标题栏显示进度
+    NSString *originalTitle = self.title;
+    [[BookSourceManager sharedManager] importBookSourcesFromData:data progress:^(NSUInteger importedCount, double fraction) {
+        self.title = [NSString stringWithFormat:@"导入中 %lu（%.0f%%）", (unsigned long)importedCount, fraction * 100];
+    } completion:^(NSUInteger importedCount, BOOL success) {
+        self.title = originalTitle;
+        if (success) {
+            [self loadBookSources];
+            [self showMessage:[NSString stringWithFormat:@"导入成功（%lu 个书源）", (unsigned long)importedCount]];
+        } else {
+            [self showMessage:@"导入失败：无效的 JSON 格式"];
+        }
+    }];
 }
 
 - (void)showMessage:(NSString *)message {
@@ -194,15 +182,9 @@
 #pragma mark - UITableViewDataSource
 
 - (NSInteger)numberOfSectionsInTableView:(UITableView *)tableView {
-    // 按分组显示，过滤掉 NSNull 对象
-    NSMutableSet *groups = [NSMutableSet set];
-    for (BookSource *source in self.bookSources) {
-        NSString *group = source.bookSourceGroup;
-        if (group && ![group isKindOfClass:[NSNull class]] && group.length > 0) {
-            [groups addObject:group];
-        }
-    }
-    return groups.count > 0 ? groups.count : 1;
+    // 按分组显示（分组索引由 BookSourceManager 维护）
+    NSInteger groupCount = [self getValidGroups].count;
+    return groupCount > 0 ? groupCount : 1;
 }
 
 - (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
@@ -231,7 +213,8 @@
         // 配置 cell
         cell.textLabel.text = source.bookSourceName ?: @"未知书源";
         NSString *url = source.bookSourceUrl ?: @"无URL";
-        cell.detailTextLabel.text = [NSString stringWithFormat:@"%@ | %@",
+        cell.detailTextLabel.text = [NSString stringWithFormat:@"%@%@ | %@",
+                                     [RuleCostAnalyzer isSlowBookSource:source] ? @"⚠️ " : @"",
                                      url,
                                      source.enabled ? @"已启用" : @"已禁用"];
         cell.accessoryType = UITableViewCellAccessoryDisclosureIndicator;
@@ -251,16 +234,9 @@
     return @"书源列表";
 }
 
-// 辅助方法：获取有效的分组列表（过滤 NSNull）
+// 辅助方法：获取有效的分组列表（已过滤 NSNull，顺序稳定）
 - (NSArray<NSString *> *)getValidGroups {
-    NSMutableSet *groups = [NSMutableSet set];
-    for (BookSource *source in self.bookSources) {
-        NSString *group = source.bookSourceGroup;
-        if (group && ![group isKindOfClass:[NSNull class]] && group.length > 0) {
-            [groups addObject:group];
-        }
-    }
-    return [groups allObjects];
+    return [[BookSourceManager sharedManager] allGroups];
 }
 
 #pragma mark - UITableViewDelegate
@@ -283,12 +259,21 @@
 }
 
 - (void)showBookSourceDetail:(BookSource *)source {
-    NSString *message = [NSString stringWithFormat:@"名称: %@\nURL: %@\n分组: %@\n备注: %@\n状态: %@",
-                        source.bookSourceName ?: @"未知",
-                        source.bookSourceUrl ?: @"无",
-                        source.bookSourceGroup ?: @"未分组",
-                        source.bookSourceComment ?: @"无",
-                        source.enabled ? @"已启用" : @"已禁用"];
+    NSMutableString *message = [NSMutableString stringWithFormat:@"名称: %@\nURL: %@\n分组: %@\n备注: %@\n状态: %@",
+                               source.bookSourceName ?: @"未知",
+                               source.bookSourceUrl ?: @"无",
+                               source.bookSourceGroup ?: @"未分组",
+                               source.bookSourceComment ?: @"无",
+                               source.enabled ? @"已启用" : @"已禁用"];
+
+    // 导入时的规则开销分析
+    if (source.costScore > 0) {
+        [message appendFormat:@"\n规则开销: %ld%@", (long)source.costScore,
+         [RuleCostAnalyzer isSlowBookSource:source] ? @"（较慢）" : @""];
+    }
+    for (NSString *warning in source.costWarnings) {
+        [message appendFormat:@"\n⚠️ %@", warning];
+    }
 
     UIAlertController *alert = [UIAlertController alertControllerWithTitle:@"书源详情"
                                                                    message:message
@@ -14,6 +14,7 @@
 #import "ReaderViewController.h"
 #import "BookContentService.h"
 #import "BookSourceManager.h"
+#import "ChapterCache.h"
 #import "ScreenAdapter.h"  // ⭐ 屏幕适配工具
 
 @interface BookshelfViewController () <UITableViewDataSource, UITableViewDelegate>
@@ -407,6 +408,14 @@
     NSArray<ChapterModel *> *cachedChapters = [[BookContentService sharedService] getCachedChapterListForBook:book];
     if (cachedChapters && cachedChapters.count > 0) {
         [self handleChaptersLoaded:cachedChapters forBook:book bookSource:bookSource];
+
+        // 后台刷新目录，只同步新增的尾部章节
+        [[BookContentService sharedService] refreshChapterListForBook:book bookSource:bookSource completion:^(NSArray<ChapterModel *> *newChapters) {
+            if (newChapters.count > 0) {
+                book.latestChapterName = newChapters.lastObject.chapterName;
+                [[BookshelfManager sharedManager] updateBook:book];
+            }
+        }];
         return;
     }
 
@@ -430,12 +439,52 @@
 
     [self presentViewController:self.currentLoadingAlert animated:YES completion:nil];
 
-    // 从网络加载章节列表
+    // 从网络加载章节列表（分批交付）
+    // ⭐ 上次阅读的章节一解析出来就开始加载正文，与剩余目录的解析并行；两者都完成后再打开阅读器，首屏直接命中缓存
     __weak typeof(self) weakSelf = self;
+    dispatch_group_t openGroup = dispatch_group_create();
+    __block ChapterModel *resumeChapter = nil;
+    __block NSString *resumeContent = nil;
+    NSInteger resumeIndex = MAX(book.currentChapter, 0);
+
+    dispatch_group_enter(openGroup);
     [[BookContentService sharedService] fetchChapterList:book.bookUrl
                                               bookSource:bookSource
-                                                 success:^(NSString *tocUrl, NSArray<ChapterModel *> *chapters) {
-        dispatch_async(dispatch_get_main_queue(), ^{
+                                           aroundChapter:resumeIndex
+                                                   batch:^(NSArray<ChapterModel *> *chapters, NSUInteger elementCount) {
+        if (resumeChapter) return;
+
+        NSString *nextChapterUrl = nil;
+        for (ChapterModel *chapter in chapters) {
+            if (resumeChapter) {
+                nextChapterUrl = chapter.chapterUrl;
+                break;
+            }
+            if (chapter.chapterIndex == resumeIndex) {
+                resumeChapter = chapter;
+            }
+        }
+        if (!resumeChapter) return;
+
+        dispatch_group_enter(openGroup);
+        [[BookContentService sharedService] fetchChapterContent:resumeChapter.chapterUrl
+                                                 nextChapterUrl:nextChapterUrl
+                                                     bookSource:bookSource
+                                                        success:^(ChapterContent *content) {
+            resumeContent = content.content;
+            dispatch_group_leave(openGroup);
+        } failure:^(NSError *error) {
+            // 正文失败不影响打开，阅读器会重新请求
+            dispatch_group_leave(openGroup);
+        }];
+    } completion:^(NSString *tocUrl, NSArray<ChapterModel *> *chapters) {
+        dispatch_group_notify(openGroup, dispatch_get_main_queue(), ^{
+            // 目录中有条目被跳过时章节位置会前移，确认位置对应的仍是同一章再放入缓存
+            if (resumeContent && resumeIndex < (NSInteger)chapters.count &&
+                [chapters[resumeIndex].chapterUrl isEqualToString:resumeChapter.chapterUrl]) {
+                [[ChapterCache sharedCache] setContent:resumeContent forBook:book.bookUrl chapter:resumeIndex];
+            }
+
             __strong typeof(weakSelf) self = weakSelf;
             if (!self) return;
 
@@ -448,7 +497,9 @@
             }];
             self.currentLoadingAlert = nil;
         });
+        dispatch_group_leave(openGroup);
     } failure:^(NSError *error) {
+        dispatch_group_leave(openGroup);
         dispatch_async(dispatch_get_main_queue(), ^{
             __strong typeof(weakSelf) self = weakSelf;
             if (!self) return;
@@ -10,6 +10,8 @@
 #import "BookSourceManager.h"
 #import "ReadingStatsManager.h"
 #import "ScreenAdapter.h"  // ⭐ 屏幕适配工具
+#import "TraceRecorder.h"
+#import "MetricsRegistry.h"
 
 @interface ProfileViewController () <UITableViewDelegate, UITableViewDataSource>
 @property (strong, nonatomic) UITableView *tableView;
@@ -60,6 +62,10 @@
             @{@"title": @"书源管理", @"icon": @"📚", @"action": @"showBookSourceSettings"},
             @{@"title": @"清理缓存", @"icon": @"🗑", @"action": @"clearCache", @"detail": @"cacheSizeText"},
             @{@"title": @"关于我们", @"icon": @"ℹ️", @"action": @"showAbout"}
+        ],
+        @[
+            @{@"title": @"书源性能", @"icon": @"📈", @"action": @"showSourceMetrics"},
+            @{@"title": @"性能追踪", @"icon": @"🔬", @"action": @"toggleTracing", @"detail": @"traceStatusText"}
         ]
     ];
 }
@@ -128,6 +134,8 @@
     // 如果是清理缓存，显示缓存大小
     if ([item[@"detail"] isEqualToString:@"cacheSizeText"]) {
         cell.detailTextLabel.text = self.cacheSizeText;
+    } else if ([item[@"detail"] isEqualToString:@"traceStatusText"]) {
+        cell.detailTextLabel.text = [TraceRecorder isRecording] ? @"记录中" : nil;
     } else {
         cell.detailTextLabel.text = nil;
     }
@@ -460,6 +468,115 @@
     [self presentViewController:alert animated:YES completion:nil];
 }
 
+/**
+ * 书源性能：按本地耗时从高到低列出前几个书源，可导出完整 JSON
+ */
+- (void)showSourceMetrics {
+    NSDictionary *snapshot = [MetricsRegistry snapshot];
+    NSArray<NSDictionary *> *sources = snapshot[@"sources"];
+    if (sources.count == 0) {
+        [self showAlert:@"书源性能" message:@"暂无数据\n\n搜索或阅读后再来查看"];
+        return;
+    }
+
+    NSMutableString *message = [NSMutableString string];
+    NSInteger count = MIN(5, sources.count);
+    for (NSInteger i = 0; i < count; i++) {
+        NSDictionary *source = sources[i];
+        NSDictionary *timers = source[@"timers"];
+        [message appendFormat:@"\n%@\n", source[@"name"]];
+        [message appendFormat:@"请求 %@ 次 · %@ · 失败 %@\n",
+         source[@"requests"],
+         [BookContentManager formatCacheSize:[source[@"bytes"] unsignedLongLongValue]],
+         source[@"errors"]];
+        if (timers[@"request"]) {
+            [message appendFormat:@"请求 p50 %.0f ms / p99 %.0f ms\n",
+             [timers[@"request"][@"p50Ms"] doubleValue], [timers[@"request"][@"p99Ms"] doubleValue]];
+        }
+        [message appendFormat:@"本地耗时 %.0f ms（JS %.0f ms）\n",
+         [source[@"costMs"] doubleValue], [timers[@"script"][@"totalMs"] doubleValue]];
+
+        NSDictionary *cache = source[@"cache"];
+        NSDictionary *cacheTitles = @{@"search": @"搜索", @"toc": @"目录", @"chapter": @"章节", @"pagination": @"分页"};
+        NSMutableArray<NSString *> *ratios = [NSMutableArray array];
+        for (NSString *name in @[@"search", @"toc", @"chapter", @"pagination"]) {
+            if (cache[name]) {
+                [ratios addObject:[NSString stringWithFormat:@"%@ %.0f%%", cacheTitles[name], [cache[name][@"hitRatio"] doubleValue] * 100]];
+            }
+        }
+        if (ratios.count > 0) {
+            [message appendFormat:@"缓存命中 %@\n", [ratios componentsJoinedByString:@" · "]];
+        }
+    }
+
+    UIAlertController *alert = [UIAlertController alertControllerWithTitle:@"书源性能"
+                                                                   message:message
+                                                            preferredStyle:UIAlertControllerStyleAlert];
+    UIAlertAction *exportAction = [UIAlertAction actionWithTitle:@"导出 JSON"
+                                                           style:UIAlertActionStyleDefault
+                                                         handler:^(UIAlertAction * _Nonnull action) {
+        NSString *documents = NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES).firstObject;
+        NSError *error = nil;
+        NSString *path = [MetricsRegistry writeSnapshotToDirectory:[documents stringByAppendingPathComponent:@"Metrics"]
+                                                             error:&error];
+        if (!path) {
+            NSLog(@"❌ 导出性能指标失败: %@", error.localizedDescription);
+            [self showAlert:@"书源性能" message:@"导出失败"];
+            return;
+        }
+        [self presentShareSheetForFile:path];
+    }];
+    UIAlertAction *closeAction = [UIAlertAction actionWithTitle:@"关闭" style:UIAlertActionStyleCancel handler:nil];
+    [alert addAction:closeAction];
+    [alert addAction:exportAction];
+    [self presentViewController:alert animated:YES completion:nil];
+}
+
+/**
+ * 性能追踪开关
+ * 开始后去打开一章再回来停止，导出的 trace JSON 可以拖进 Perfetto（ui.perfetto.dev）查看
+ */
+- (void)toggleTracing {
+    if (![TraceRecorder isRecording]) {
+        [TraceRecorder startRecording];
+        [self.tableView reloadData];
+        [self showAlert:@"性能追踪" message:@"已开始记录\n\n去打开一章或搜索一本书，然后回到这里停止并导出"];
+        return;
+    }
+
+    [TraceRecorder stopRecording];
+    [self.tableView reloadData];
+
+    NSUInteger eventCount = [TraceRecorder eventCount];
+    if (eventCount == 0) {
+        [self showAlert:@"性能追踪" message:@"没有记录到事件"];
+        return;
+    }
+
+    NSString *documents = NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES).firstObject;
+    NSError *error = nil;
+    NSString *path = [TraceRecorder writeChromeTraceToDirectory:[documents stringByAppendingPathComponent:@"Traces"]
+                                                         error:&error];
+    if (!path) {
+        NSLog(@"❌ 导出追踪失败: %@", error.localizedDescription);
+        [self showAlert:@"性能追踪" message:@"导出失败"];
+        return;
+    }
+
+    NSLog(@"🔬 已导出 %lu 个事件: %@", (unsigned long)eventCount, path);
+
+    // 通过分享面板导出（AirDrop 到电脑后用 Perfetto 打开）
+    [self presentShareSheetForFile:path];
+}
+
+- (void)presentShareSheetForFile:(NSString *)path {
+    UIActivityViewController *activity = [[UIActivityViewController alloc] initWithActivityItems:@[[NSURL fileURLWithPath:path]]
+                                                                          applicationActivities:nil];
+    activity.popoverPresentationController.sourceView = self.view;
+    activity.popoverPresentationController.sourceRect = CGRectMake(CGRectGetMidX(self.view.bounds), CGRectGetMidY(self.view.bounds), 0, 0);
+    [self presentViewController:activity animated:YES completion:nil];
+}
+
 - (void)showAbout {
     NSString *version = [[[NSBundle mainBundle] infoDictionary] objectForKey:@"CFBundleShortVersionString"] ?: @"1.0.0";
     NSString *message = [NSString stringWithFormat:@"Read - 小说阅读器\n\n版本：v%@\n\n功能特性：\n✓ 支持多书源\n✓ 在线阅读\n✓ 本地缓存\n✓ 阅读记录\n\n© 2025 Read Team", version];
@@ -6,11 +6,16 @@
 //
 
 #import "ChapterListViewController.h"
+#import "BookContentManager.h"
 #import "BookContentService.h"
 #import "BookSourceManager.h"
 #import "BookshelfManager.h"
 #import "ChapterModel.h"
 #import "ReaderViewController.h"
+#import "UIViewController+Alert.h"
+
+static const NSUInteger kFullTextSearchLimit = 200;        // 全文搜索最多取多少个命中
+static const NSUInteger kFullTextSearchMaxChapters = 20;   // 结果列表最多列出多少章
 
 @interface ChapterListViewController () <UITableViewDataSource, UITableViewDelegate>
 @property (strong, nonatomic) BookModel *book;
@@ -19,6 +24,7 @@
 @property (strong, nonatomic) UILabel *errorLabel;
 // chapters 属性已在 .h 文件中公开声明，这里不需要重复
 @property (copy, nonatomic) NSString *tocUrl;  // 目录URL
+@property (strong, nonatomic, nullable) NSMutableArray *pendingSlots;  // 分批加载中的目录（按目录位置，未到达为 NSNull），完成后为 nil
 @end
 
 @implementation ChapterListViewController
@@ -44,6 +50,12 @@
     [self setupLoadingIndicator];
     [self setupErrorLabel];
 
+    // 在已缓存的章节正文中搜索
+    self.navigationItem.rightBarButtonItem = [[UIBarButtonItem alloc] initWithImage:[UIImage systemImageNamed:@"magnifyingglass"]
+                                                                              style:UIBarButtonItemStylePlain
+                                                                             target:self
+                                                                             action:@selector(searchButtonTapped)];
+
     // 如果已经有章节列表（从阅读器传入），直接显示
     if (self.chapters && self.chapters.count > 0) {
         self.tableView.hidden = NO;
@@ -119,21 +131,59 @@
     [self.loadingIndicator startAnimating];
     self.errorLabel.hidden = YES;
 
+    // ⭐ 分批加载：当前章附近的章节先显示，其余章节解析完一块填入一块
     [[BookContentService sharedService] fetchChapterList:self.book.bookUrl
                                               bookSource:bookSource
-                                                 success:^(NSString *tocUrl, NSArray<ChapterModel *> *chapters) {
+                                           aroundChapter:self.book.currentChapter
+                                                   batch:^(NSArray<ChapterModel *> *chapters, NSUInteger elementCount) {
+        [self handleChapterBatch:chapters elementCount:elementCount];
+    } completion:^(NSString *tocUrl, NSArray<ChapterModel *> *chapters) {
         [self handleChapterListSuccess:tocUrl chapters:chapters];
     } failure:^(NSError *error) {
         [self handleChapterListFailure:error];
     }];
 }
 
-- (void)handleChapterListSuccess:(NSString *)tocUrl chapters:(NSArray<ChapterModel *> *)chapters {
-    [self.loadingIndicator stopAnimating];
+- (void)handleChapterBatch:(NSArray<ChapterModel *> *)chapters elementCount:(NSUInteger)elementCount {
+    BOOL firstBatch = (self.pendingSlots == nil);
+    if (firstBatch) {
+        // 第一批到达时按目录条目总数建好占位行，直接定位到当前章
+        self.pendingSlots = [NSMutableArray arrayWithCapacity:elementCount];
+        for (NSUInteger i = 0; i < elementCount; i++) {
+            [self.pendingSlots addObject:[NSNull null]];
+        }
+    }
 
-    if (chapters.count > 0) {
+    for (ChapterModel *chapter in chapters) {
+        if (chapter.chapterIndex >= 0 && chapter.chapterIndex < (NSInteger)self.pendingSlots.count) {
+            self.pendingSlots[chapter.chapterIndex] = chapter;
+        }
+    }
+
+    if (firstBatch) {
+        [self.loadingIndicator stopAnimating];
+        self.tableView.hidden = NO;
+        [self.tableView reloadData];
+
+        NSInteger currentRow = self.book.currentChapter;
+        if (currentRow >= 0 && currentRow < (NSInteger)self.pendingSlots.count) {
+            [self.tableView scrollToRowAtIndexPath:[NSIndexPath indexPathForRow:currentRow inSection:0]
+                                  atScrollPosition:UITableViewScrollPositionMiddle
+                                          animated:NO];
+        }
+    } else {
+        // 行数不变，只刷新屏幕上的占位行
+        NSArray<NSIndexPath *> *visibleRows = self.tableView.indexPathsForVisibleRows;
+        if (visibleRows.count > 0) {
+            [self.tableView reloadRowsAtIndexPaths:visibleRows withRowAnimation:UITableViewRowAnimationNone];
+        }
     }
+}
+
+- (void)handleChapterListSuccess:(NSString *)tocUrl chapters:(NSArray<ChapterModel *> *)chapters {
+    [self.loadingIndicator stopAnimating];
 
+    self.pendingSlots = nil;
     self.tocUrl = tocUrl;
     self.chapters = chapters;
 
@@ -151,6 +201,7 @@
 
 - (void)handleChapterListFailure:(NSError *)error {
     [self.loadingIndicator stopAnimating];
+    self.pendingSlots = nil;
     NSString *message = [NSString stringWithFormat:@"❌\n加载失败\n%@", error.localizedDescription];
     [self showError:message];
 }
@@ -164,13 +215,23 @@
 #pragma mark - UITableViewDataSource
 
 - (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
-    return self.chapters.count;
+    return self.pendingSlots ? self.pendingSlots.count : self.chapters.count;
 }
 
 - (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
     UITableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:@"ChapterCell" forIndexPath:indexPath];
 
-    ChapterModel *chapter = self.chapters[indexPath.row];
+    // 分批加载中还没到达的章节
+    id slot = self.pendingSlots ? self.pendingSlots[indexPath.row] : self.chapters[indexPath.row];
+    if (slot == [NSNull null]) {
+        cell.textLabel.text = [NSString stringWithFormat:@"%ld. 加载中…", (long)(indexPath.row + 1)];
+        cell.textLabel.font = [UIFont systemFontOfSize:15];
+        cell.textLabel.textColor = [UIColor tertiaryLabelColor];
+        cell.accessoryType = UITableViewCellAccessoryNone;
+        cell.selectionStyle = UITableViewCellSelectionStyleNone;
+        return cell;
+    }
+    ChapterModel *chapter = slot;
 
     // 显示章节序号和名称
     cell.textLabel.text = [NSString stringWithFormat:@"%ld. %@", (long)(indexPath.row + 1), chapter.chapterName];
@@ -190,10 +251,84 @@
     return cell;
 }
 
+#pragma mark - 全文搜索
+
+- (void)searchButtonTapped {
+    [self showInputAlertWithTitle:@"搜索正文"
+                          message:@"只搜索已缓存的章节"
+                      placeholder:@"输入关键词"
+                   confirmHandler:^(NSString *inputText) {
+        [self searchCachedChaptersForText:inputText];
+    }];
+}
+
+- (void)searchCachedChaptersForText:(NSString *)text {
+    NSString *keyword = [text stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+    if (keyword.length == 0 || self.book.bookUrl.length == 0) {
+        return;
+    }
+
+    [self.loadingIndicator startAnimating];
+    NSString *bookId = self.book.bookUrl;
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        NSArray<ChapterSearchHit *> *hits = [[BookContentManager sharedManager] searchText:keyword
+                                                                                  inBookId:bookId
+                                                                                     limit:kFullTextSearchLimit];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self.loadingIndicator stopAnimating];
+            [self showSearchHits:hits keyword:keyword];
+        });
+    });
+}
+
+// 命中按章节归并（已按章节排序），每章一项，点击进入该章
+- (void)showSearchHits:(NSArray<ChapterSearchHit *> *)hits keyword:(NSString *)keyword {
+    NSMutableArray<NSNumber *> *chapterIndexes = [NSMutableArray array];
+    NSMutableArray<NSNumber *> *hitCounts = [NSMutableArray array];
+    for (ChapterSearchHit *hit in hits) {
+        if (hit.chapterIndex < 0 || hit.chapterIndex >= (NSInteger)self.chapters.count) {
+            continue;
+        }
+        if (chapterIndexes.count > 0 && chapterIndexes.lastObject.integerValue == hit.chapterIndex) {
+            hitCounts[hitCounts.count - 1] = @(hitCounts.lastObject.integerValue + 1);
+            continue;
+        }
+        if (chapterIndexes.count == kFullTextSearchMaxChapters) {
+            break;
+        }
+        [chapterIndexes addObject:@(hit.chapterIndex)];
+        [hitCounts addObject:@1];
+    }
+
+    if (chapterIndexes.count == 0) {
+        [self showAlertWithTitle:@"搜索正文" message:[NSString stringWithFormat:@"已缓存的章节中没有找到“%@”", keyword]];
+        return;
+    }
+
+    NSMutableArray<UIAlertAction *> *actions = [NSMutableArray array];
+    for (NSInteger i = 0; i < chapterIndexes.count; i++) {
+        ChapterModel *chapter = self.chapters[chapterIndexes[i].integerValue];
+        NSString *title = [NSString stringWithFormat:@"%@（%@ 处）", chapter.chapterName, hitCounts[i]];
+        [actions addObject:[UIAlertAction actionWithTitle:title
+                                                    style:UIAlertActionStyleDefault
+                                                  handler:^(UIAlertAction * _Nonnull action) {
+            [self openChapter:chapter];
+        }]];
+    }
+    [self showActionSheetWithTitle:[NSString stringWithFormat:@"“%@”", keyword] message:nil actions:actions];
+}
+
 #pragma mark - UITableViewDelegate
 
 - (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath {
-    ChapterModel *chapter = self.chapters[indexPath.row];
+    [self openChapter:self.chapters[indexPath.row]];
+}
+
+- (void)openChapter:(ChapterModel *)chapter {
+    // 阅读器需要完整目录，分批加载完成前不响应
+    if (self.pendingSlots) {
+        return;
+    }
 
     // 进入阅读页面
     BookSource *bookSource = [[BookSourceManager sharedManager] getBookSourceByName:self.book.bookSourceName];
@@ -12,6 +12,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 // 前向声明
 @class PageModel;
+@class VirtualChapterDocument;
+@class VirtualDocumentUpdate;
 
 /**
  * 内容页面视图控制器
@@ -21,6 +23,7 @@ NS_ASSUME_NONNULL_BEGIN
  *   2. 支持垂直滚动模式（scrollEnabled = YES）
  *   3. 支持横向翻页模式（scrollEnabled = NO）
  *   4. 自适应内容高度
+ *   5. 垂直模式下按虚拟文档的窗口，每章一个文本视图分段显示
  *
  * 使用示例：
  *   // 垂直模式
@@ -86,11 +89,21 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (assign, nonatomic) BOOL scrollEnabled;
 
+/**
+ * 文字颜色（由阅读器按日间 / 夜间模式设置，nil 时使用系统标签色）
+ */
+@property (strong, nonatomic, nullable) UIColor *textColor;
+
 /**
  * 当前内容高度（缓存，避免重复计算）
  */
 @property (assign, nonatomic) CGFloat currentContentHeight;
 
+/**
+ * 章节视图的宽度（垂直分段显示时使用，水平居中；0 表示使用默认边距）
+ */
+@property (assign, nonatomic) CGFloat segmentWidth;
+
 #pragma mark - 方法
 
 /**
@@ -99,6 +112,33 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)displayContent:(NSString *)content;
 
+/**
+ * 显示分页后的单页（横向模式）
+ * @param pageModel 页面模型
+ */
+- (void)displayPageModel:(PageModel *)pageModel;
+
+/**
+ * 应用虚拟文档的窗口变化（垂直模式）：增删章节文本视图、按文档位置排布、补偿滚动位置
+ * @param update 窗口变化
+ * @param document 变化后的文档
+ * @param attributes 新增章节视图的文字属性
+ */
+- (void)applyDocumentUpdate:(VirtualDocumentUpdate *)update
+                   document:(VirtualChapterDocument *)document
+                 attributes:(NSDictionary<NSAttributedStringKey, id> *)attributes;
+
+/**
+ * 以新的文字属性重设所有章节视图（字号、颜色变化后，需随后按新高度重新应用文档）
+ */
+- (void)applySegmentTextAttributes:(NSDictionary<NSAttributedStringKey, id> *)attributes
+                          document:(VirtualChapterDocument *)document;
+
+/**
+ * 移除所有章节视图
+ */
+- (void)removeAllSegmentViews;
+
 /**
  * 显示加载中状态
  */
@@ -8,6 +8,11 @@
 #import "ContentPageViewController.h"
 #import "ReadingPaginationService.h"  // 引入PageModel
 #import "AppConfig.h"
+#import "VirtualChapterDocument.h"
+
+@interface ContentPageViewController ()
+@property (strong, nonatomic) NSMutableDictionary<NSNumber *, UITextView *> *segmentViews;  // {chapterIndex: 章节视图}
+@end
 
 @implementation ContentPageViewController
 
@@ -28,7 +33,7 @@
                                                                            self.view.bounds.size.width - 2 * AppConfig.readingPadding,
                                                                            30)];
         self.chapterTitleLabel.font = [UIFont boldSystemFontOfSize:18];
-        self.chapterTitleLabel.textColor = [UIColor labelColor];
+        self.chapterTitleLabel.textColor = self.textColor ?: [UIColor labelColor];
         self.chapterTitleLabel.textAlignment = NSTextAlignmentCenter;
 
         if (self.pageModel) {
@@ -56,7 +61,7 @@
                                                                         self.view.bounds.size.width - 2 * AppConfig.readingPadding,
                                                                         100)];
     self.contentTextView.font = [UIFont systemFontOfSize:AppConfig.defaultFontSize];
-    self.contentTextView.textColor = [UIColor labelColor];
+    self.contentTextView.textColor = self.textColor ?: [UIColor labelColor];
     self.contentTextView.backgroundColor = [UIColor clearColor];
     self.contentTextView.editable = NO;  // 不可编辑
     self.contentTextView.selectable = YES;  // 可选择文本
@@ -93,7 +98,7 @@
 
     // 如果有内容就显示
     if (self.pageModel) {
-        [self displayContent:self.pageModel.pageContent];
+        [self displayPageModel:self.pageModel];
     } else if (self.content) {
         [self displayContent:self.content];
     }
@@ -101,6 +106,7 @@
 
 - (void)displayContent:(NSString *)content {
     self.content = content;
+    [self removeAllSegmentViews];
 
     if (!self.contentTextView) {
         return;
@@ -135,6 +141,106 @@
     [self.scrollView setContentOffset:CGPointZero animated:NO];
 }
 
+- (void)displayPageModel:(PageModel *)pageModel {
+    // ⭐ 只为当前显示的页面生成文字，排版属性与分页时一致
+    self.content = nil;
+    self.contentTextView.attributedText = [pageModel attributedContentWithTextColor:self.textColor ?: [UIColor labelColor]];
+    self.pageInfoLabel.text = [NSString stringWithFormat:@"%ld / %ld",
+                               (long)(pageModel.pageIndex + 1),
+                               (long)pageModel.totalPages];
+
+    CGFloat maxHeight = self.scrollView.bounds.size.height - 2 * AppConfig.readingTopMargin;
+    self.contentTextView.frame = CGRectMake(AppConfig.readingPadding,
+                                            AppConfig.readingTopMargin,
+                                            self.view.bounds.size.width - 2 * AppConfig.readingPadding,
+                                            maxHeight);
+    self.scrollView.contentSize = self.scrollView.bounds.size;
+    [self.scrollView setContentOffset:CGPointZero animated:NO];
+}
+
+#pragma mark - 垂直模式分段显示
+
+- (void)applyDocumentUpdate:(VirtualDocumentUpdate *)update
+                   document:(VirtualChapterDocument *)document
+                 attributes:(NSDictionary<NSAttributedStringKey, id> *)attributes {
+    if (!self.segmentViews) {
+        self.segmentViews = [NSMutableDictionary dictionary];
+    }
+
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+
+    for (VirtualChapterSegment *segment in update.removedSegments) {
+        [self.segmentViews[@(segment.chapterIndex)] removeFromSuperview];
+        [self.segmentViews removeObjectForKey:@(segment.chapterIndex)];
+    }
+
+    for (VirtualChapterSegment *segment in update.insertedSegments) {
+        UITextView *textView = [self makeSegmentTextView];
+        // ⭐ 每章独立的文字存储，追加章节不再复制已有的全部文字
+        textView.attributedText = [[NSAttributedString alloc] initWithString:segment.text attributes:attributes];
+        [self.segmentViews[@(segment.chapterIndex)] removeFromSuperview];
+        self.segmentViews[@(segment.chapterIndex)] = textView;
+        [self.scrollView addSubview:textView];
+    }
+
+    if (self.segmentViews.count > 0) {
+        self.content = nil;
+        self.contentTextView.text = nil;
+    }
+
+    [self layoutSegmentViewsWithDocument:document];
+
+    // ⭐ 直接移动 bounds 而不是 setContentOffset:，不打断正在进行的减速滚动
+    if (update.contentOffsetDelta != 0) {
+        CGRect bounds = self.scrollView.bounds;
+        bounds.origin.y += update.contentOffsetDelta;
+        self.scrollView.bounds = bounds;
+    }
+
+    [CATransaction commit];
+}
+
+- (void)applySegmentTextAttributes:(NSDictionary<NSAttributedStringKey, id> *)attributes
+                          document:(VirtualChapterDocument *)document {
+    for (VirtualChapterSegment *segment in document.segments) {
+        UITextView *textView = self.segmentViews[@(segment.chapterIndex)];
+        textView.attributedText = [[NSAttributedString alloc] initWithString:segment.text attributes:attributes];
+    }
+}
+
+- (void)removeAllSegmentViews {
+    for (UITextView *textView in self.segmentViews.allValues) {
+        [textView removeFromSuperview];
+    }
+    [self.segmentViews removeAllObjects];
+}
+
+- (void)layoutSegmentViewsWithDocument:(VirtualChapterDocument *)document {
+    CGFloat scrollWidth = self.scrollView.bounds.size.width;
+    CGFloat width = self.segmentWidth > 0 ? self.segmentWidth : scrollWidth - 2 * AppConfig.readingPadding;
+    CGFloat x = floor((scrollWidth - width) / 2);
+
+    for (VirtualChapterSegment *segment in document.segments) {
+        UITextView *textView = self.segmentViews[@(segment.chapterIndex)];
+        textView.frame = CGRectMake(x, [document offsetForChapter:segment.chapterIndex], width, segment.height);
+    }
+
+    self.scrollView.contentSize = CGSizeMake(scrollWidth, document.contentHeight);
+    self.currentContentHeight = document.contentHeight - document.bottomInset;
+}
+
+- (UITextView *)makeSegmentTextView {
+    UITextView *textView = [[UITextView alloc] initWithFrame:CGRectZero];
+    textView.backgroundColor = [UIColor clearColor];
+    textView.editable = NO;
+    textView.selectable = YES;
+    textView.scrollEnabled = NO;
+    textView.textContainerInset = UIEdgeInsetsZero;
+    textView.textContainer.lineFragmentPadding = 0;
+    return textView;
+}
+
 - (void)showLoading {
     [self.loadingIndicator startAnimating];
     self.contentTextView.hidden = YES;
@@ -17,8 +17,13 @@
 // ⭐ 引入新的管理器
 #import "ReadingContentManager.h"
 #import "ReadingProgressManager.h"
+#import "TraceRecorder.h"
 #import "ReadingSettingsManager.h"
 #import "ReadingPaginationService.h"
+#import "PaginationCache.h"
+#import "PaginationScheduler.h"
+#import "VirtualChapterDocument.h"
+#import "ChapterPrefetchPlanner.h"
 #import "ErrorHandler.h"
 #import "UIViewController+Alert.h"
 #import "AppConfig.h"
@@ -26,7 +31,6 @@
 #import <QuartzCore/QuartzCore.h>
 
 // ⭐ 常量定义
-static const NSInteger MAX_CACHE_COUNT = 10;
 static const CGFloat FLOATING_TITLE_UPDATE_INTERVAL = 0.1;
 
 // ⭐ 阅读设置常量（映射到 ReadingSettingsManager）
@@ -47,10 +51,12 @@ static const CGFloat kMaxFontSize = 30.0;
 @property (strong, nonatomic) ChapterModel *currentChapter;
 
 // ⭐ 新的管理器（替代原有分散的逻辑）
-@property (strong, nonatomic) ReadingContentManager *contentManager;      // 内容加载和缓存
+@property (strong, nonatomic) ReadingContentManager *contentManager;      // 内容加载和缓存（章节正文缓存）
 @property (strong, nonatomic) ReadingProgressManager *progressManager;    // 进度保存和恢复
 @property (strong, nonatomic) ReadingSettingsManager *settingsManager;    // 阅读设置
 @property (strong, nonatomic) ReadingPaginationService *paginationService; // 分页服务
+@property (strong, nonatomic) PaginationScheduler *paginationScheduler;    // 后台预分页
+@property (strong, nonatomic) ChapterPrefetchPlanner *prefetchPlanner;     // 按阅读速度预取章节
 
 // ⭐ UI组件
 @property (strong, nonatomic) UIPageViewController *pageViewController;  // 左右翻页
@@ -70,21 +76,23 @@ static const CGFloat kMaxFontSize = 30.0;
 @property (assign, nonatomic) PageTurnMode pageTurnMode;                 // 翻页模式
 @property (assign, nonatomic) BOOL isToolbarVisible;                     // 工具栏是否可见
 @property (assign, nonatomic) BOOL isLoadingNextChapter;                 // 是否正在加载下一章
+@property (assign, nonatomic) BOOL isLoadingPreviousChapter;             // 是否正在加载上一章（窗口向上扩展）
 @property (assign, nonatomic) NSTimeInterval lastTitleUpdateTime;        // 上次更新标题的时间
 @property (assign, nonatomic) CGFloat lastSavedScrollOffset;             // 上次保存的滚动位置
+@property (assign, nonatomic) CGFloat pendingFontSize;                   // 拖动字号滑块时最新的字号
+@property (assign, nonatomic) BOOL isFontRelayoutScheduled;              // 是否已安排字号变化后的重排
+@property (assign, nonatomic) TraceSpan openChapterSpan;                 // 打开章节到首屏显示（性能追踪）
 
 // ⭐ 垂直模式相关
-@property (strong, nonatomic) NSMutableArray<ChapterModel *> *loadedChapters;  // 已加载的章节
+@property (strong, nonatomic) NSMutableArray<ChapterModel *> *loadedChapters;  // 已加载（含正在追加）的章节
+@property (strong, nonatomic) VirtualChapterDocument *verticalDocument;  // 当前章节附近的章节窗口
 
 // ⭐ 横向模式相关
 @property (strong, nonatomic) NSMutableArray<PageModel *> *allPages;     // 所有页面（可变）
 @property (assign, nonatomic) NSInteger currentPageIndex;                // 当前页面索引
 
 // ⭐ 临时兼容性属性（用于快速修复编译错误，后续逐步迁移到新管理器）
-@property (strong, nonatomic) NSMutableDictionary<NSNumber *, NSString *> *contentCache;
-@property (strong, nonatomic) NSMutableDictionary<NSNumber *, NSDate *> *cacheAccessTime;
 @property (strong, nonatomic) NSMutableSet<NSNumber *> *pendingRequests;
-@property (strong, nonatomic) NSMutableDictionary<NSNumber *, NSNumber *> *chapterOffsets;
 @property (strong, nonatomic) NSMutableDictionary<NSNumber *, NSArray<PageModel *> *> *pagesCache;
 
 @end
@@ -114,19 +122,21 @@ static const CGFloat kMaxFontSize = 30.0;
         _progressManager = [[ReadingProgressManager alloc] initWithBook:book];
         _settingsManager = [ReadingSettingsManager sharedManager];
         _paginationService = [[ReadingPaginationService alloc] init];
+        _paginationScheduler = [[PaginationScheduler alloc] init];
+        _prefetchPlanner = [[ChapterPrefetchPlanner alloc] initWithChapterCount:chapters.count
+                                                                      sourceKey:bookSource.bookSourceUrl];
 
         // 垂直模式相关
         _loadedChapters = [NSMutableArray array];
+        _verticalDocument = [[VirtualChapterDocument alloc] initWithOffsetIndex:_progressManager.offsetIndex];
+        _verticalDocument.bottomInset = 10;
 
         // 横向模式相关
         _allPages = @[];
         _currentPageIndex = 0;
 
         // ⭐ 临时兼容性属性初始化（用于快速修复编译错误）
-        _contentCache = [NSMutableDictionary dictionary];
-        _cacheAccessTime = [NSMutableDictionary dictionary];
         _pendingRequests = [NSMutableSet set];
-        _chapterOffsets = [NSMutableDictionary dictionary];
         _pagesCache = [NSMutableDictionary dictionary];
 
         // 隐藏底部 TabBar
@@ -143,8 +153,8 @@ static const CGFloat kMaxFontSize = 30.0;
     [self setupNavigationBar];
 
     [self setupUI];
+    [self setupPrefetchPlanner];
     [self loadCurrentChapterContent];
-    [self preloadNext3Chapters];  // 预加载接下来的3章
 
     // ⭐ 应用保存的阅读设置
     dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.5 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
@@ -252,6 +262,7 @@ static const CGFloat kMaxFontSize = 30.0;
     self.currentPageVC = [[ContentPageViewController alloc] init];
     self.currentPageVC.chapter = self.currentChapter;
     self.currentPageVC.scrollEnabled = YES;  // 竖向模式允许滚动
+    self.currentPageVC.textColor = [self getTextColorForNightMode:[self isNightModeEnabled]];
     self.currentPageVC.view.frame = self.view.bounds;
 
     [self addChildViewController:self.currentPageVC];
@@ -275,14 +286,14 @@ static const CGFloat kMaxFontSize = 30.0;
     self.pageViewController.delegate = self;
 
     // 构建分页数据
-    NSString *content = self.contentCache[@(self.currentChapter.chapterIndex)];
-    if (content) {
+    if ([self.contentManager isChapterCached:self.currentChapter.chapterIndex]) {
         [self buildAllPagesFromChapter:self.currentChapter];
     }
 
     // 创建第一个页面
     ContentPageViewController *startVC = [[ContentPageViewController alloc] init];
     startVC.scrollEnabled = NO;  // 横向模式禁止滚动
+    startVC.textColor = [self getTextColorForNightMode:[self isNightModeEnabled]];
 
     if (self.allPages.count > 0) {
         PageModel *firstPage = self.allPages[self.currentPageIndex];
@@ -515,7 +526,7 @@ static const CGFloat kMaxFontSize = 30.0;
 
     // 确定按钮
     UIAlertAction *confirmAction = [UIAlertAction actionWithTitle:@"确定" style:UIAlertActionStyleDefault handler:^(UIAlertAction * _Nonnull action) {
-        [self saveFontSize:fontSlider.value];
+        [self saveFontSize:roundf(fontSlider.value)];
         [self applyReadingSettings];
     }];
     [fontAlert addAction:confirmAction];
@@ -529,6 +540,25 @@ static const CGFloat kMaxFontSize = 30.0;
     if (sizeLabel) {
         sizeLabel.text = [NSString stringWithFormat:@"%.0f", slider.value];
     }
+
+    // ⭐ 实时预览：只在取整后的字号变化时重排，拖动中的多次变化合并为一次，同一时间最多一次排版
+    CGFloat fontSize = roundf(slider.value);
+    if (fontSize == [self getCurrentFontSize] && !self.isFontRelayoutScheduled) {
+        return;
+    }
+    self.pendingFontSize = fontSize;
+    if (self.isFontRelayoutScheduled) {
+        return;
+    }
+
+    self.isFontRelayoutScheduled = YES;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        self.isFontRelayoutScheduled = NO;
+        if (self.pendingFontSize != [self getCurrentFontSize]) {
+            [self saveFontSize:self.pendingFontSize];
+            [self applyReadingSettings];
+        }
+    });
 }
 
 - (void)showBackgroundColorSettings {
@@ -629,6 +659,7 @@ static const CGFloat kMaxFontSize = 30.0;
         self.currentPageVC.view.backgroundColor = bgColor;
         self.currentPageVC.scrollView.backgroundColor = bgColor;
         self.currentPageVC.contentTextView.backgroundColor = bgColor;
+        self.currentPageVC.textColor = textColor;
         self.currentPageVC.contentTextView.textColor = textColor;
 
         // 更新字体大小
@@ -650,6 +681,17 @@ static const CGFloat kMaxFontSize = 30.0;
         self.floatingTitleLabel.textColor = textColor;
         self.floatingTitleLabel.backgroundColor = [bgColor colorWithAlphaComponent:0.9];
     }
+
+    // ⭐ 垂直模式：窗口内每章一个视图，重新设置文字并测量高度
+    if (self.pageTurnMode == PageTurnModeVertical) {
+        [self relayoutVerticalDocument];
+    }
+
+    // ⭐ 横向模式下字号变化会改变分页，重新分页（同时取消旧排版的预分页任务）
+    if (self.pageTurnMode == PageTurnModeHorizontal && self.paginationScheduler.layout &&
+        ![[self currentPaginationLayout] isEqual:self.paginationScheduler.layout]) {
+        [self updateHorizontalModeLayout];
+    }
 }
 
 - (void)togglePageMode {
@@ -709,45 +751,45 @@ static const CGFloat kMaxFontSize = 30.0;
 }
 
 - (void)updateFloatingTitleWithOffset:(CGFloat)offset {
-    // 根据滚动位置找到当前显示的章节
-    for (ChapterModel *chapter in self.loadedChapters) {
-        NSNumber *chapterOffset = self.chapterOffsets[@(chapter.chapterIndex)];
-        if (chapterOffset && offset >= chapterOffset.floatValue) {
-            // 检查是否到下一章
-            NSInteger nextIndex = chapter.chapterIndex + 1;
-            NSNumber *nextOffset = self.chapterOffsets[@(nextIndex)];
-
-            if (!nextOffset || offset < nextOffset.floatValue) {
-                // 当前在这一章
-                if (![self.floatingTitleLabel.text isEqualToString:chapter.chapterName]) {
-                    self.floatingTitleLabel.text = chapter.chapterName;
-
-                    // 更新当前章节
-                    if (self.currentChapter.chapterIndex != chapter.chapterIndex) {
-                        NSInteger oldChapterIndex = self.currentChapter.chapterIndex;
-                        self.currentChapter = chapter;
-                        self.book.currentChapter = chapter.chapterIndex;
-                        [[BookshelfManager sharedManager] updateBook:self.book];
-
-                        // ⭐ 记录阅读记录
-                        [[ReadingStatsManager sharedManager] addReadingRecord:self.book.bookUrl
-                                                                     bookTitle:self.book.title
-                                                                   chapterName:chapter.chapterName
-                                                                  chapterIndex:chapter.chapterIndex];
-
-                        // ⭐ 记录阅读字数（估算：章节内容长度）
-                        NSString *content = self.contentCache[@(chapter.chapterIndex)];
-                        if (content) {
-                            [[ReadingStatsManager sharedManager] addReadingWords:content.length];
-                        }
-
-                        // ⭐ 章节变化时，触发后台加载更多章节
-                        [self onChapterChangedFrom:oldChapterIndex to:chapter.chapterIndex];
-                    }
-                }
-                break;
-            }
+    // ⭐ 根据滚动位置在章节偏移索引中找到当前显示的章节（O(log n)）
+    NSInteger chapterIndex = [self.progressManager findChapterAtOffset:offset];
+    if (chapterIndex < 0 || chapterIndex >= (NSInteger)self.chapters.count) {
+        return;
+    }
+
+    ChapterModel *chapter = self.chapters[chapterIndex];
+    if ([self.floatingTitleLabel.text isEqualToString:chapter.chapterName]) {
+        return;
+    }
+    self.floatingTitleLabel.text = chapter.chapterName;
+
+    // 更新当前章节
+    if (self.currentChapter.chapterIndex != chapter.chapterIndex) {
+        NSInteger oldChapterIndex = self.currentChapter.chapterIndex;
+        self.currentChapter = chapter;
+        self.book.currentChapter = chapter.chapterIndex;
+        [[BookshelfManager sharedManager] updateBook:self.book];
+
+        // ⭐ 记录阅读记录
+        [[ReadingStatsManager sharedManager] addReadingRecord:self.book.bookUrl
+                                                     bookTitle:self.book.title
+                                                   chapterName:chapter.chapterName
+                                                  chapterIndex:chapter.chapterIndex];
+
+        // ⭐ 记录阅读字数（估算：章节内容长度）
+        NSString *content = [self.contentManager peekCachedContent:chapter.chapterIndex];
+        if (content) {
+            [[ReadingStatsManager sharedManager] addReadingWords:content.length];
         }
+
+        // ⭐ 更新阅读速度并按新的当前章节重新规划预取
+        [self.prefetchPlanner readerDidEnterChapter:chapter.chapterIndex wordCount:content.length];
+
+        // ⭐ 章节变化时，触发后台加载更多章节
+        [self onChapterChangedFrom:oldChapterIndex to:chapter.chapterIndex];
+
+        // ⭐ 窗口随当前章节移动，淘汰远离的章节
+        [self slideVerticalWindowToChapter:chapter.chapterIndex];
     }
 }
 
@@ -774,13 +816,20 @@ static const CGFloat kMaxFontSize = 30.0;
         return;
     }
 
-    NSString *progressKey = [NSString stringWithFormat:@"ReadProgress_%@", self.book.bookUrl];
-    NSDictionary *progress = @{
-        @"chapterIndex": @(self.currentChapter.chapterIndex),
-        @"scrollOffset": @(self.currentPageVC.scrollView.contentOffset.y)
-    };
+    CGFloat scrollOffset = self.currentPageVC.scrollView.contentOffset.y;
+    NSInteger chapterIndex = self.currentChapter.chapterIndex;
 
-    [[NSUserDefaults standardUserDefaults] setObject:progress forKey:progressKey];
+    // ⭐ 垂直模式按滚动位置定位章节（浮动标题有节流，currentChapter 可能稍有滞后）
+    //    窗口会淘汰和插入章节，绝对位置不稳定，保存的是章节内的位置
+    if (self.pageTurnMode == PageTurnModeVertical) {
+        NSInteger visibleIndex = [self.progressManager findChapterAtOffset:scrollOffset];
+        if (visibleIndex >= 0) {
+            chapterIndex = visibleIndex;
+            scrollOffset = MAX(0, scrollOffset - [self.progressManager getChapterOffset:visibleIndex]);
+        }
+    }
+
+    [self.progressManager scheduleDebouncedSave:scrollOffset chapterIndex:chapterIndex];
 }
 
 /**
@@ -791,16 +840,21 @@ static const CGFloat kMaxFontSize = 30.0;
         return;
     }
 
-    NSString *progressKey = [NSString stringWithFormat:@"ReadProgress_%@", self.book.bookUrl];
-    NSDictionary *progress = [[NSUserDefaults standardUserDefaults] objectForKey:progressKey];
+    ReadingProgress *progress = [self.progressManager restoreProgress];
 
-    if (progress && [progress isKindOfClass:[NSDictionary class]]) {
-        CGFloat scrollOffset = [progress[@"scrollOffset"] floatValue];
+    if (progress) {
+        NSInteger chapterIndex = progress.chapterIndex;
+        CGFloat scrollOffset = progress.scrollOffset;
 
         // 延迟恢复滚动位置（等待内容加载完成）
         dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.3 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
             if (self.pageTurnMode == PageTurnModeVertical && self.currentPageVC) {
-                [self.currentPageVC.scrollView setContentOffset:CGPointMake(0, scrollOffset) animated:NO];
+                // 保存的是章节内的位置，换算回窗口中的位置（旧版本的绝对位置在读取时已置 0，回到章节开头）
+                CGFloat targetOffset = scrollOffset;
+                if ([self.verticalDocument segmentForChapter:chapterIndex]) {
+                    targetOffset += [self.verticalDocument offsetForChapter:chapterIndex];
+                }
+                [self.currentPageVC.scrollView setContentOffset:CGPointMake(0, targetOffset) animated:NO];
             }
         });
     }
@@ -809,6 +863,8 @@ static const CGFloat kMaxFontSize = 30.0;
 #pragma mark - Content Loading (竖向模式：一次性加载3章)
 
 - (void)loadCurrentChapterContent {
+    self.openChapterSpan = TraceSpanBegin("reader", "openChapter");
+
     if (self.pageTurnMode == PageTurnModeHorizontal) {
         // 横向模式：单章加载+分页
         [self loadSingleChapterForHorizontalMode];
@@ -821,55 +877,73 @@ static const CGFloat kMaxFontSize = 30.0;
 // 横向模式：单章加载
 - (void)loadSingleChapterForHorizontalMode {
     NSInteger chapterIndex = self.currentChapter.chapterIndex;
-    NSString *cachedContent = self.contentCache[@(chapterIndex)];
+    NSString *cachedContent = [self.contentManager getCachedContent:chapterIndex];
 
     if (cachedContent) {
         [self buildAllPagesFromChapter:self.currentChapter];
         if (self.allPages.count > 0 && self.currentPageVC) {
             self.currentPageVC.pageModel = self.allPages[self.currentPageIndex];
-            [self.currentPageVC.view setNeedsLayout];
+            [self.currentPageVC displayPageModel:self.currentPageVC.pageModel];
         }
+        [self finishOpenChapterTrace];
+        [self.prefetchPlanner readerDidEnterChapter:chapterIndex wordCount:cachedContent.length];
         return;
     }
 
     [self.currentPageVC.loadingIndicator startAnimating];
+    [self.prefetchPlanner beginForegroundFetch];
     [[BookContentService sharedService] fetchChapterContent:self.currentChapter.chapterUrl
+                                             nextChapterUrl:[self chapterUrlAfterChapter:self.currentChapter]
                                                  bookSource:self.bookSource
                                                     success:^(ChapterContent *content) {
-        self.contentCache[@(chapterIndex)] = content.content;
+        [self.contentManager cacheContent:content.content forChapter:chapterIndex];
         [self.currentPageVC.loadingIndicator stopAnimating];
         [self buildAllPagesFromChapter:self.currentChapter];
         if (self.allPages.count > 0 && self.currentPageVC) {
             self.currentPageVC.pageModel = self.allPages[self.currentPageIndex];
-            [self.currentPageVC.view setNeedsLayout];
+            [self.currentPageVC displayPageModel:self.currentPageVC.pageModel];
         }
-        [self preloadNext3Chapters];
+        [self finishOpenChapterTrace];
+        [self.prefetchPlanner readerDidEnterChapter:chapterIndex wordCount:content.content.length];
+        [self.prefetchPlanner endForegroundFetch];
     } failure:^(NSError *error) {
+        [self finishOpenChapterTrace];
+        [self.prefetchPlanner endForegroundFetch];
         [self.currentPageVC.loadingIndicator stopAnimating];
         NSString *errorMsg = [NSString stringWithFormat:@"加载失败\n\n%@", error.localizedDescription];
         [self displayContent:errorMsg];
     }];
 }
 
-// 竖向模式：流式加载（先显示当前章，预加载后3章）
+// 竖向模式：流式加载（先显示当前章，再按阅读速度预取后续章节）
 - (void)loadMultipleChaptersForVerticalMode {
     NSInteger startIndex = self.currentChapter.chapterIndex;
 
     [self.currentPageVC.loadingIndicator startAnimating];
     [self.loadedChapters removeAllObjects];
-    [self.chapterOffsets removeAllObjects];
+    [self.verticalDocument removeAllSegments];
+    [self.currentPageVC removeAllSegmentViews];
 
     // 1. 先加载并显示当前章（快速显示）
     [self loadAndDisplayChapter:startIndex isFirst:YES completion:^(BOOL success) {
         [self.currentPageVC.loadingIndicator stopAnimating];
+        [self finishOpenChapterTrace];
 
-        // ⭐ 2. 初始加载完成后，预加载接下来的3章
+        // ⭐ 2. 初始加载完成后，从当前章开始计时并预取后续章节
         if (success) {
-            [self preloadNext3Chapters];
+            [self.prefetchPlanner readerDidEnterChapter:startIndex
+                                              wordCount:[self.contentManager peekCachedContent:startIndex].length];
         }
     }];
 }
 
+// 性能追踪：打开章节的区间在首屏显示（或加载失败）时结束
+- (void)finishOpenChapterTrace {
+    TraceSpan span = self.openChapterSpan;
+    TRACE_END_ASYNC(span, self.currentChapter.chapterName.UTF8String, (int64_t)self.currentChapter.chapterIndex);
+    self.openChapterSpan = (TraceSpan){0};
+}
+
 // 加载并显示单章
 - (void)loadAndDisplayChapter:(NSInteger)chapterIndex
                       isFirst:(BOOL)isFirst
@@ -884,10 +958,8 @@ static const CGFloat kMaxFontSize = 30.0;
     NSNumber *indexKey = @(chapterIndex);
 
     // ⭐ 1. 先检查内存缓存
-    NSString *cachedContent = self.contentCache[indexKey];
+    NSString *cachedContent = [self.contentManager getCachedContent:chapterIndex];
     if (cachedContent) {
-        [self updateCacheAccessTime:chapterIndex];  // ⭐ 更新访问时间
-
         if (isFirst) {
             [self displayFirstChapter:chapter content:cachedContent];
         } else {
@@ -902,9 +974,7 @@ static const CGFloat kMaxFontSize = 30.0;
     NSString *localContent = [self loadLocalCacheForChapter:chapterIndex];
     if (localContent) {
         // 加载到内存缓存
-        self.contentCache[indexKey] = localContent;
-        [self updateCacheAccessTime:chapterIndex];
-        [self trimCacheIfNeeded];  // ⭐ LRU 清理
+        [self.contentManager cacheContent:localContent forChapter:chapterIndex];
 
         if (isFirst) {
             [self displayFirstChapter:chapter content:localContent];
@@ -923,15 +993,15 @@ static const CGFloat kMaxFontSize = 30.0;
     }
     [self.pendingRequests addObject:indexKey];
 
-    // ⭐ 4. 从网络加载
+    // ⭐ 4. 从网络加载（预取让路）
+    [self.prefetchPlanner beginForegroundFetch];
     [[BookContentService sharedService] fetchChapterContent:chapter.chapterUrl
+                                             nextChapterUrl:[self chapterUrlAfterChapter:chapter]
                                                  bookSource:self.bookSource
                                                     success:^(ChapterContent *content) {
 
         // 缓存到内存
-        self.contentCache[indexKey] = content.content;
-        [self updateCacheAccessTime:chapterIndex];
-        [self trimCacheIfNeeded];  // ⭐ LRU 清理
+        [self.contentManager cacheContent:content.content forChapter:chapterIndex];
 
         // ⭐ 保存到离线缓存
         [self saveLocalCacheForChapter:chapterIndex content:content.content];
@@ -946,12 +1016,16 @@ static const CGFloat kMaxFontSize = 30.0;
                 [self appendChapterToScrollView:chapter content:content.content];
             }
 
+            [self.prefetchPlanner endForegroundFetch];
             if (completion) completion(YES);
         });
 
     } failure:^(NSError *error) {
         [self.pendingRequests removeObject:indexKey];  // 移除请求标记
-        if (completion) completion(NO);
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self.prefetchPlanner endForegroundFetch];
+            if (completion) completion(NO);
+        });
     }];
 }
 
@@ -971,6 +1045,7 @@ static const CGFloat kMaxFontSize = 30.0;
     }
 
     self.isLoadingNextChapter = YES;
+    [self.prefetchPlanner beginForegroundFetch];  // ⭐ 读者马上要看的章节，预取让路
     NSNumber *indexKey = @(nextIndex);
 
     // ⭐ 在后台线程加载
@@ -978,13 +1053,12 @@ static const CGFloat kMaxFontSize = 30.0;
         ChapterModel *nextChapter = self.chapters[nextIndex];
 
         // ⭐ 1. 先检查内存缓存
-        NSString *cachedContent = self.contentCache[indexKey];
+        NSString *cachedContent = [self.contentManager getCachedContent:nextIndex];
         if (cachedContent) {
-            [self updateCacheAccessTime:nextIndex];
             dispatch_async(dispatch_get_main_queue(), ^{
                 [self appendChapterToScrollView:nextChapter content:cachedContent];
-                self.isLoadingNextChapter = NO;
-                [self preloadNext3Chapters];
+                [self finishBackgroundLoadingNextChapter];
+                [self schedulePrefetch];
             });
             return;
         }
@@ -992,34 +1066,33 @@ static const CGFloat kMaxFontSize = 30.0;
         // ⭐ 2. 检查离线缓存
         NSString *localContent = [self loadLocalCacheForChapter:nextIndex];
         if (localContent) {
-            self.contentCache[indexKey] = localContent;
-            [self updateCacheAccessTime:nextIndex];
-            [self trimCacheIfNeeded];
+            [self.contentManager cacheContent:localContent forChapter:nextIndex];
 
             dispatch_async(dispatch_get_main_queue(), ^{
                 [self appendChapterToScrollView:nextChapter content:localContent];
-                self.isLoadingNextChapter = NO;
-                [self preloadNext3Chapters];
+                [self finishBackgroundLoadingNextChapter];
+                [self schedulePrefetch];
             });
             return;
         }
 
         // ⭐ 3. 请求去重检查
         if ([self.pendingRequests containsObject:indexKey]) {
-            self.isLoadingNextChapter = NO;
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [self finishBackgroundLoadingNextChapter];
+            });
             return;
         }
         [self.pendingRequests addObject:indexKey];
 
         // ⭐ 4. 从网络加载
         [[BookContentService sharedService] fetchChapterContent:nextChapter.chapterUrl
+                                                 nextChapterUrl:[self chapterUrlAfterChapter:nextChapter]
                                                      bookSource:self.bookSource
                                                         success:^(ChapterContent *content) {
 
             // 缓存内容
-            self.contentCache[indexKey] = content.content;
-            [self updateCacheAccessTime:nextIndex];
-            [self trimCacheIfNeeded];
+            [self.contentManager cacheContent:content.content forChapter:nextIndex];
 
             // ⭐ 保存到离线缓存
             [self saveLocalCacheForChapter:nextIndex content:content.content];
@@ -1029,17 +1102,24 @@ static const CGFloat kMaxFontSize = 30.0;
             // 在主线程追加到UI
             dispatch_async(dispatch_get_main_queue(), ^{
                 [self appendChapterToScrollView:nextChapter content:content.content];
-                self.isLoadingNextChapter = NO;
-                [self preloadNext3Chapters];
+                [self finishBackgroundLoadingNextChapter];
+                [self schedulePrefetch];
             });
 
         } failure:^(NSError *error) {
             [self.pendingRequests removeObject:indexKey];
-            self.isLoadingNextChapter = NO;
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [self finishBackgroundLoadingNextChapter];
+            });
         }];
     });
 }
 
+- (void)finishBackgroundLoadingNextChapter {
+    self.isLoadingNextChapter = NO;
+    [self.prefetchPlanner endForegroundFetch];
+}
+
 - (void)displayContent:(NSString *)content {
     [self.currentPageVC displayContent:content];
 }
@@ -1047,18 +1127,21 @@ static const CGFloat kMaxFontSize = 30.0;
 // 显示第一章（初始化）
 - (void)displayFirstChapter:(ChapterModel *)chapter content:(NSString *)content {
 
+    [self.loadedChapters removeAllObjects];
     [self.loadedChapters addObject:chapter];
 
     // 构建内容
-    NSString *chapterTitle = [NSString stringWithFormat:@"【 %@ 】\n\n", chapter.chapterName];
-    NSString *fullContent = [NSString stringWithFormat:@"%@%@\n\n━━━━━━━━━━━━━━━━━━━━\n\n", chapterTitle, content];
-
-
-    // 记录章节起始位置
-    self.chapterOffsets[@(chapter.chapterIndex)] = @(10);  // 初始偏移10
-
-    // ⭐ 直接在主线程显示（第一章不需要后台处理）
-    [self.currentPageVC displayContent:fullContent];
+    NSString *fullContent = [self verticalSegmentTextForChapter:chapter content:content];
+    NSDictionary<NSAttributedStringKey, id> *attributes = [self verticalTextAttributes];
+    CGFloat width = [ScreenAdapter readingContentWidth];
+
+    // ⭐ 直接在主线程显示（第一章不需要后台处理），章节从初始偏移10开始
+    CGFloat height = [self heightForVerticalSegmentText:fullContent attributes:attributes width:width];
+    self.verticalDocument.offsetIndex.topInset = 10;
+    VirtualDocumentUpdate *update = [self.verticalDocument resetWithChapter:chapter.chapterIndex text:fullContent height:height];
+    self.currentPageVC.segmentWidth = width;
+    [self.currentPageVC applyDocumentUpdate:update document:self.verticalDocument attributes:attributes];
+    [self.currentPageVC.scrollView setContentOffset:CGPointZero animated:NO];
 
     // 更新阅读进度
     self.book.currentChapter = chapter.chapterIndex;
@@ -1074,106 +1157,229 @@ static const CGFloat kMaxFontSize = 30.0;
     [self.loadedChapters addObject:chapter];
 
     // ⭐ 在主线程获取 UI 相关的值（避免线程安全问题）
-    CGFloat width = self.view.bounds.size.width - 30;
-    CGFloat currentContentHeight = self.currentPageVC.currentContentHeight;
+    CGFloat width = [ScreenAdapter readingContentWidth];
+    NSDictionary<NSAttributedStringKey, id> *attributes = [self verticalTextAttributes];
 
-    // ⭐ 在后台线程计算新章节高度（增量计算，不需要重新计算整个文本）
+    // ⭐ 在后台线程计算新章节高度（只测量新章节）
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-        // 构建新章节内容
-        NSString *chapterTitle = [NSString stringWithFormat:@"【 %@ 】\n\n", chapter.chapterName];
-        NSString *newContent = [NSString stringWithFormat:@"%@%@\n\n━━━━━━━━━━━━━━━━━━━━\n\n", chapterTitle, content];
-
-
-        // ⭐ 只计算新章节的高度（增量计算）
-        UIFont *contentFont = [UIFont systemFontOfSize:17];
-
-        CGSize newChapterSize = [newContent boundingRectWithSize:CGSizeMake(width, CGFLOAT_MAX)
-                                                          options:NSStringDrawingUsesLineFragmentOrigin
-                                                       attributes:@{NSFontAttributeName: contentFont}
-                                                          context:nil].size;
+        NSString *newContent = [self verticalSegmentTextForChapter:chapter content:content];
+        CGFloat height = [self heightForVerticalSegmentText:newContent attributes:attributes width:width];
 
         // 回到主线程更新UI
         dispatch_async(dispatch_get_main_queue(), ^{
+            // ⭐ 新章节是独立的文本视图，已显示的章节不需要重新生成文字
+            VirtualDocumentUpdate *update = [self.verticalDocument appendChapter:chapter.chapterIndex
+                                                                            text:newContent
+                                                                          height:height];
+            if (update) {
+                [self.currentPageVC applyDocumentUpdate:update document:self.verticalDocument attributes:attributes];
+            } else {
+                // 窗口已移动（不相邻或超出窗口），放弃本次追加，滚动到底部时会重新加载
+                [self.loadedChapters removeObject:chapter];
+            }
 
-            // 记录新章节的起始偏移（使用缓存的当前高度）
-            self.chapterOffsets[@(chapter.chapterIndex)] = @(currentContentHeight);
+            // ⭐ 修复：不再自动连续加载！由滚动事件触发
+            // 移除自动触发逻辑，改为由 scrollViewDidScroll 根据滚动位置判断是否需要加载
+            self.isLoadingNextChapter = NO;  // 标记加载完成
+        });
+    });
+}
 
-            [CATransaction begin];
-            [CATransaction setDisableActions:YES];
+// ⭐ 向上滚动到窗口顶部时，在开头插入上一章（被淘汰的章节通常还在缓存中）
+- (void)startBackgroundLoadingPreviousChapter {
+    VirtualChapterSegment *firstSegment = self.verticalDocument.segments.firstObject;
+    if (!firstSegment || firstSegment.chapterIndex <= 0 || self.isLoadingPreviousChapter) {
+        return;
+    }
+    // ⭐ 上一章已在窗口外时会被 prependChapter 拒绝，不要每次滚动都重新加载、测量
+    if (![self.verticalDocument canPrependChapter:firstSegment.chapterIndex - 1]) {
+        return;
+    }
 
-            // ⭐ 使用 NSMutableAttributedString 增量追加（避免重新渲染整个文本）
-            UIFont *font = [UIFont systemFontOfSize:17];
-            NSDictionary *attributes = @{NSFontAttributeName: font};
+    self.isLoadingPreviousChapter = YES;
+    [self.prefetchPlanner beginForegroundFetch];
+    NSInteger previousIndex = firstSegment.chapterIndex - 1;
+    ChapterModel *chapter = self.chapters[previousIndex];
+    CGFloat width = [ScreenAdapter readingContentWidth];
+    NSDictionary<NSAttributedStringKey, id> *attributes = [self verticalTextAttributes];
 
-            NSMutableAttributedString *attributedString;
-            if (self.currentPageVC.contentTextView.attributedText.length > 0) {
-                attributedString = [[NSMutableAttributedString alloc] initWithAttributedString:self.currentPageVC.contentTextView.attributedText];
-            } else {
-                attributedString = [[NSMutableAttributedString alloc] init];
+    void (^insertContent)(NSString *) = ^(NSString *content) {
+        NSString *text = [self verticalSegmentTextForChapter:chapter content:content];
+        CGFloat height = [self heightForVerticalSegmentText:text attributes:attributes width:width];
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            VirtualDocumentUpdate *update = [self.verticalDocument prependChapter:previousIndex text:text height:height];
+            if (update) {
+                // 插入后滚动位置同步下移，屏幕上的内容不动
+                [self.currentPageVC applyDocumentUpdate:update document:self.verticalDocument attributes:attributes];
+                [self.loadedChapters insertObject:chapter atIndex:0];
+                self.lastSavedScrollOffset += update.contentOffsetDelta;
             }
+            self.isLoadingPreviousChapter = NO;
+            [self.prefetchPlanner endForegroundFetch];
+        });
+    };
 
-            NSAttributedString *newAttributedContent = [[NSAttributedString alloc] initWithString:newContent attributes:attributes];
-            [attributedString appendAttributedString:newAttributedContent];
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSString *content = [self.contentManager getCachedContent:previousIndex] ?: [self loadLocalCacheForChapter:previousIndex];
+        if (content) {
+            insertContent(content);
+            return;
+        }
 
-            self.currentPageVC.contentTextView.attributedText = attributedString;
+        [[BookContentService sharedService] fetchChapterContent:chapter.chapterUrl
+                                                 nextChapterUrl:[self chapterUrlAfterChapter:chapter]
+                                                     bookSource:self.bookSource
+                                                        success:^(ChapterContent *chapterContent) {
+            [self saveLocalCacheForChapter:previousIndex content:chapterContent.content];
+            insertContent(chapterContent.content);
+        } failure:^(NSError *error) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                self.isLoadingPreviousChapter = NO;
+                [self.prefetchPlanner endForegroundFetch];
+            });
+        }];
+    });
+}
 
-            // ⭐ 使用增量计算更新高度
-            CGFloat newTotalHeight = currentContentHeight + newChapterSize.height;
-            self.currentPageVC.contentTextView.frame = CGRectMake(15, 10, width, newTotalHeight);
-            self.currentPageVC.scrollView.contentSize = CGSizeMake(self.view.bounds.size.width, newTotalHeight + 20);
-            self.currentPageVC.currentContentHeight = newTotalHeight;  // 更新缓存的高度
+// ⭐ 当前章节变化后移动窗口：淘汰远离的章节，并补偿顶部移除造成的位移
+- (void)slideVerticalWindowToChapter:(NSInteger)chapterIndex {
+    VirtualDocumentUpdate *update = [self.verticalDocument updateCurrentChapter:chapterIndex];
+    if (update.isEmpty) {
+        return;
+    }
 
-            [CATransaction commit];
+    [self.currentPageVC applyDocumentUpdate:update document:self.verticalDocument attributes:[self verticalTextAttributes]];
+    self.lastSavedScrollOffset += update.contentOffsetDelta;
 
-            // ⭐ 修复：不再自动连续加载！由滚动事件触发
-            // 移除自动触发逻辑，改为由 scrollViewDidScroll 根据滚动位置判断是否需要加载
-            self.isLoadingNextChapter = NO;  // 标记加载完成
+    for (VirtualChapterSegment *segment in update.removedSegments) {
+        NSUInteger index = [self.loadedChapters indexOfObjectPassingTest:^BOOL(ChapterModel *obj, NSUInteger idx, BOOL *stop) {
+            return obj.chapterIndex == segment.chapterIndex;
+        }];
+        if (index != NSNotFound) {
+            [self.loadedChapters removeObjectAtIndex:index];
+        }
+    }
+}
+
+// ⭐ 字号或宽度变化后重新测量窗口内的章节，保持当前章节内的阅读位置
+- (void)relayoutVerticalDocument {
+    VirtualChapterDocument *document = self.verticalDocument;
+    if (document.segments.count == 0 || !self.currentPageVC) {
+        return;
+    }
 
+    UIScrollView *scrollView = self.currentPageVC.scrollView;
+    NSInteger anchorChapter = [document chapterAtOffset:scrollView.contentOffset.y];
+    CGFloat anchorHeight = [document segmentForChapter:anchorChapter].height;
+    CGFloat anchorFraction = anchorHeight > 0
+        ? (scrollView.contentOffset.y - [document offsetForChapter:anchorChapter]) / anchorHeight
+        : 0;
+
+    CGFloat width = [ScreenAdapter readingContentWidth];
+    NSDictionary<NSAttributedStringKey, id> *attributes = [self verticalTextAttributes];
+    for (VirtualChapterSegment *segment in document.segments) {
+        [document setHeight:[self heightForVerticalSegmentText:segment.text attributes:attributes width:width]
+                 forChapter:segment.chapterIndex];
+    }
 
-        });
-    });
+    self.currentPageVC.segmentWidth = width;
+    [self.currentPageVC applySegmentTextAttributes:attributes document:document];
+    [self.currentPageVC applyDocumentUpdate:[[VirtualDocumentUpdate alloc] init] document:document attributes:attributes];
+
+    CGFloat newOffset = [document offsetForChapter:anchorChapter] + anchorFraction * [document segmentForChapter:anchorChapter].height;
+    [scrollView setContentOffset:CGPointMake(0, MAX(0, newOffset)) animated:NO];
 }
 
-#pragma mark - Preloading
+// 目录中的下一章地址（分页正文的下一页链接指向它时，本章到此结束）
+- (nullable NSString *)chapterUrlAfterChapter:(ChapterModel *)chapter {
+    NSInteger nextIndex = chapter.chapterIndex + 1;
+    return nextIndex < (NSInteger)self.chapters.count ? self.chapters[nextIndex].chapterUrl : nil;
+}
 
-// ⭐ 预加载接下来的3章（基于最后已加载的章节）
-- (void)preloadNext3Chapters {
-    if (self.loadedChapters.count == 0) return;
+// 章节在垂直模式下的显示文本
+- (NSString *)verticalSegmentTextForChapter:(ChapterModel *)chapter content:(NSString *)content {
+    NSString *chapterTitle = [NSString stringWithFormat:@"【 %@ 】\n\n", chapter.chapterName];
+    return [NSString stringWithFormat:@"%@%@\n\n━━━━━━━━━━━━━━━━━━━━\n\n", chapterTitle, content];
+}
 
-    ChapterModel *lastLoadedChapter = self.loadedChapters.lastObject;
-    NSInteger lastLoadedIndex = lastLoadedChapter.chapterIndex;
+// 垂直模式的文字属性（字号、段间距与横向模式一致，夜间模式颜色）
+- (NSDictionary<NSAttributedStringKey, id> *)verticalTextAttributes {
+    NSMutableDictionary<NSAttributedStringKey, id> *attributes =
+        [[ReadingPaginationService textAttributesForLayout:[self currentPaginationLayout]] mutableCopy];
+    attributes[NSForegroundColorAttributeName] = [self getTextColorForNightMode:[self isNightModeEnabled]];
+    return attributes;
+}
 
+// 测量章节高度（可在后台线程调用）
+- (CGFloat)heightForVerticalSegmentText:(NSString *)text
+                             attributes:(NSDictionary<NSAttributedStringKey, id> *)attributes
+                                  width:(CGFloat)width {
+    CGRect rect = [text boundingRectWithSize:CGSizeMake(width, CGFLOAT_MAX)
+                                     options:NSStringDrawingUsesLineFragmentOrigin
+                                  attributes:attributes
+                                     context:nil];
+    return ceil(rect.size.height);
+}
 
-    // 预加载接下来的3章
-    for (NSInteger i = 1; i <= 3; i++) {
-        NSInteger targetIndex = lastLoadedIndex + i;
-        if (targetIndex < self.chapters.count) {
-            // 检查缓存中是否已有
-            if (!self.contentCache[@(targetIndex)]) {
-                [self preloadChapterAtIndex:targetIndex];
-            } else {
-            }
+#pragma mark - Preloading
+
+/**
+ * 配置预取规划器：已在内存、离线缓存或正在请求的章节不预取
+ */
+- (void)setupPrefetchPlanner {
+    __weak typeof(self) weakSelf = self;
+    self.prefetchPlanner.availabilityBlock = ^BOOL(NSInteger chapterIndex) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf) {
+            return YES;
         }
-    }
+        return [strongSelf.contentManager isChapterCached:chapterIndex] ||
+               [strongSelf.pendingRequests containsObject:@(chapterIndex)] ||
+               [[BookContentManager sharedManager] isChapterDownloadedWithBookId:strongSelf.book.bookUrl
+                                                                       chapterId:[@(chapterIndex) stringValue]];
+    };
+    self.prefetchPlanner.fetchBlock = ^(NSInteger chapterIndex, void (^completion)(BOOL success)) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf) {
+            completion(NO);
+            return;
+        }
+        [strongSelf preloadChapterAtIndex:chapterIndex completion:completion];
+    };
 }
 
-- (void)preloadChapterAtIndex:(NSInteger)index {
+// ⭐ 以当前章节为中心补齐预取（预取的章数由规划器按阅读速度和书源延迟决定）
+- (void)schedulePrefetch {
+    [self.prefetchPlanner planAroundChapter:self.currentChapter.chapterIndex];
+}
+
+- (void)preloadChapterAtIndex:(NSInteger)index completion:(nullable void (^)(BOOL success))completion {
     if (index < 0 || index >= self.chapters.count) {
+        if (completion) completion(NO);
         return;
     }
 
     ChapterModel *chapter = self.chapters[index];
+    NSNumber *indexKey = @(index);
+    [self.pendingRequests addObject:indexKey];
 
     [[BookContentService sharedService] fetchChapterContent:chapter.chapterUrl
+                                             nextChapterUrl:[self chapterUrlAfterChapter:chapter]
                                                  bookSource:self.bookSource
                                                     success:^(ChapterContent *content) {
-        self.contentCache[@(index)] = content.content;
+        [self.contentManager cacheContent:content.content forChapter:index];
+        [self saveLocalCacheForChapter:index content:content.content];
+        [self.pendingRequests removeObject:indexKey];
 
-        // 如果是横向模式，同时缓存分页结果
+        // ⭐ 横向模式：交给后台预分页，完成后拼接到页面数组，翻到下一章时无需等待排版
         if (self.pageTurnMode == PageTurnModeHorizontal) {
-            [self paginateChapter:chapter content:content.content];
+            [self schedulePaginationForChapter:chapter content:content.content];
         }
+        if (completion) completion(YES);
     } failure:^(NSError *error) {
+        [self.pendingRequests removeObject:indexKey];
+        if (completion) completion(NO);
     }];
 }
 
@@ -1188,91 +1394,135 @@ static const CGFloat kMaxFontSize = 30.0;
         return cachedPages;
     }
 
+    PaginationLayout *layout = [self currentPaginationLayout];
+    self.paginationScheduler.layout = layout;
+
+    // 优先使用后台预分页的结果，其次读取持久化的分页缓存，都未命中时分页引擎单遍扫描
+    NSString *chapterText = [content copy];
+    NSArray<NSNumber *> *breaks = [self.paginationScheduler pageBreaksForChapter:chapter.chapterIndex] ?:
+                                  [[PaginationCache sharedCache] pageBreaksForText:chapterText layout:layout];
+    NSArray<PageModel *> *pages = [self pagesForChapter:chapter text:chapterText pageBreaks:breaks layout:layout];
+
+    // 缓存分页结果
+    self.pagesCache[chapterKey] = pages;
+
+
+    return pages;
+}
+
+// 当前排版参数（字号与 ContentPageViewController 渲染一致）
+- (PaginationLayout *)currentPaginationLayout {
     // ⭐ 使用 ScreenAdapter 获取正确的内容宽度
     CGFloat pageWidth = [ScreenAdapter readingContentWidth];
     CGFloat pageHeight = self.view.bounds.size.height - 50 - 30 - 30 - 60;  // 标题50 + 上边距30 + 页码30 + 工具栏60
 
-    UIFont *font = [UIFont systemFontOfSize:17];
-    NSDictionary *attributes = @{NSFontAttributeName: font};
+    // ⭐ 段落间距由段落样式提供（约一行高），不再复制整章把 \n 替换为 \n\n
+    CGFloat fontSize = [self getCurrentFontSize];
+    PaginationLayout *layout = [PaginationLayout layoutWithFontSize:fontSize
+                                                           pageSize:CGSizeMake(pageWidth, pageHeight)];
+    layout.paragraphSpacing = ceil([UIFont systemFontOfSize:fontSize].lineHeight);
+    return layout;
+}
 
-    // 格式化内容（加行间距）
-    NSString *formattedContent = [content stringByReplacingOccurrencesOfString:@"\n" withString:@"\n\n"];
+// 根据分页位置生成页面（所有页面共享同一份章节文本，只记录范围）
+- (NSArray<PageModel *> *)pagesForChapter:(ChapterModel *)chapter
+                                     text:(NSString *)chapterText
+                               pageBreaks:(NSArray<NSNumber *> *)breaks
+                                   layout:(PaginationLayout *)layout {
+    NSMutableArray<PageModel *> *pages = [NSMutableArray arrayWithCapacity:breaks.count];
+    NSInteger contentLength = chapterText.length;
 
-    // 分页算法：逐字符累加，直到超出一页高度
-    NSMutableArray<PageModel *> *pages = [NSMutableArray array];
-    NSInteger contentLength = formattedContent.length;
-    NSInteger startIndex = 0;
-    NSInteger pageIndex = 0;
-
-    while (startIndex < contentLength) {
-        // 二分查找：找到能放入一页的最大字符数
-        NSInteger left = 1;
-        NSInteger right = contentLength - startIndex;
-        NSInteger bestEnd = left;
-
-        while (left <= right) {
-            NSInteger mid = (left + right) / 2;
-            NSInteger endIndex = MIN(startIndex + mid, contentLength);
-            NSString *testContent = [formattedContent substringWithRange:NSMakeRange(startIndex, endIndex - startIndex)];
-
-            CGSize size = [testContent boundingRectWithSize:CGSizeMake(pageWidth, CGFLOAT_MAX)
-                                                    options:NSStringDrawingUsesLineFragmentOrigin
-                                                 attributes:attributes
-                                                    context:nil].size;
-
-            if (size.height <= pageHeight) {
-                bestEnd = mid;
-                left = mid + 1;
-            } else {
-                right = mid - 1;
-            }
-        }
-
-        // 创建页面
-        NSInteger endIndex = MIN(startIndex + bestEnd, contentLength);
-        NSString *pageContent = [formattedContent substringWithRange:NSMakeRange(startIndex, endIndex - startIndex)];
+    for (NSInteger pageIndex = 0; pageIndex < breaks.count; pageIndex++) {
+        NSInteger startIndex = breaks[pageIndex].integerValue;
+        NSInteger endIndex = pageIndex + 1 < breaks.count ? breaks[pageIndex + 1].integerValue : contentLength;
 
         PageModel *page = [[PageModel alloc] init];
         page.chapter = chapter;
         page.pageIndex = pageIndex;
-        page.pageContent = pageContent;
+        page.chapterText = chapterText;
+        page.pageRange = NSMakeRange(startIndex, endIndex - startIndex);
+        page.layout = layout;
+        page.totalPages = breaks.count;
         [pages addObject:page];
-
-        startIndex = endIndex;
-        pageIndex++;
     }
+    return pages;
+}
 
-    // 设置总页数
-    NSInteger totalPages = pages.count;
-    for (PageModel *page in pages) {
-        page.totalPages = totalPages;
+// 安排后台分页，完成后缓存并拼接到页面数组
+- (void)schedulePaginationForChapter:(ChapterModel *)chapter content:(NSString *)content {
+    if (self.pagesCache[@(chapter.chapterIndex)]) {
+        return;
     }
 
-    // 缓存分页结果
-    self.pagesCache[chapterKey] = pages;
+    PaginationLayout *layout = [self currentPaginationLayout];
+    self.paginationScheduler.layout = layout;
 
-
-    return pages;
+    NSString *chapterText = [content copy];
+    __weak typeof(self) weakSelf = self;
+    [self.paginationScheduler schedulePaginationForChapter:chapter.chapterIndex
+                                                      text:chapterText
+                                                completion:^(NSInteger chapterIndex, NSArray<NSNumber *> *pageBreaks) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf || strongSelf.pagesCache[@(chapterIndex)]) {
+            return;
+        }
+        strongSelf.pagesCache[@(chapterIndex)] = [strongSelf pagesForChapter:chapter
+                                                                         text:chapterText
+                                                                   pageBreaks:pageBreaks
+                                                                       layout:strongSelf.paginationScheduler.layout];
+        [strongSelf mergePaginatedNeighbours];
+    }];
 }
 
-// 构建当前章节及前后章节的所有页面数组
-- (void)buildAllPagesFromChapter:(ChapterModel *)chapter {
-    NSMutableArray<PageModel *> *allPages = [NSMutableArray array];
+// 把已分页的相邻章节拼接到页面数组两端（保持章节连续，当前页不变）
+- (void)mergePaginatedNeighbours {
+    if (self.allPages.count == 0) {
+        return;
+    }
+
+    NSArray<PageModel *> *pages;
+    while ((pages = self.pagesCache[@(self.allPages.lastObject.chapter.chapterIndex + 1)])) {
+        [self.allPages addObjectsFromArray:pages];
+    }
+    while ((pages = self.pagesCache[@(self.allPages.firstObject.chapter.chapterIndex - 1)])) {
+        [self.allPages insertObjects:pages atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, pages.count)]];
+        self.currentPageIndex += pages.count;
+    }
+}
 
+// 从当前章节向外安排相邻章节的后台分页（前 1 章、后 3 章）
+- (void)scheduleNeighbourPaginationAroundChapter:(ChapterModel *)chapter {
     NSInteger startChapter = MAX(0, chapter.chapterIndex - 1);
-    NSInteger endChapter = MIN(self.chapters.count - 1, chapter.chapterIndex + 3);
+    NSInteger endChapter = MIN((NSInteger)self.chapters.count - 1, chapter.chapterIndex + 3);
+    for (NSInteger distance = 1; distance <= endChapter - chapter.chapterIndex || chapter.chapterIndex - distance >= startChapter; distance++) {
+        for (NSNumber *candidate in @[@(chapter.chapterIndex + distance), @(chapter.chapterIndex - distance)]) {
+            NSInteger i = candidate.integerValue;
+            if (i < startChapter || i > endChapter) {
+                continue;
+            }
+            NSString *content = [self.contentManager peekCachedContent:i];
+            if (content) {
+                [self schedulePaginationForChapter:self.chapters[i] content:content];
+            }
+        }
+    }
+}
 
-    for (NSInteger i = startChapter; i <= endChapter; i++) {
-        ChapterModel *ch = self.chapters[i];
-        NSString *content = self.contentCache[@(i)];
+// 构建当前章节及前后章节的所有页面数组
+- (void)buildAllPagesFromChapter:(ChapterModel *)chapter {
+    self.paginationScheduler.currentChapterIndex = chapter.chapterIndex;
 
-        if (content) {
-            NSArray<PageModel *> *pages = [self paginateChapter:ch content:content];
-            [allPages addObjectsFromArray:pages];
-        }
+    // ⭐ 只同步分页当前章节，相邻章节已有结果则直接拼接，否则交给后台按距离优先分页
+    NSMutableArray<PageModel *> *allPages = [NSMutableArray array];
+    NSString *currentContent = [self.contentManager peekCachedContent:chapter.chapterIndex];
+    if (currentContent) {
+        [allPages addObjectsFromArray:[self paginateChapter:chapter content:currentContent]];
     }
 
+    [self scheduleNeighbourPaginationAroundChapter:chapter];
+
     self.allPages = allPages;
+    [self mergePaginatedNeighbours];
 
     // 找到当前页面索引
     self.currentPageIndex = 0;
@@ -1309,15 +1559,20 @@ static const CGFloat kMaxFontSize = 30.0;
         [self saveReadingProgress];
     }
 
+    // ⭐ 接近窗口顶部时，在开头插入上一章
+    if (offsetY < scrollViewHeight) {
+        [self startBackgroundLoadingPreviousChapter];
+    }
+
     // 3. ⭐ 智能加载：当用户阅读到最后已显示章节的80%位置时，显示下一章
     if (self.loadedChapters.count > 0 && !self.isLoadingNextChapter) {
         ChapterModel *lastLoadedChapter = self.loadedChapters.lastObject;
         NSInteger lastLoadedIndex = lastLoadedChapter.chapterIndex;
 
         // 获取最后一章的起始偏移
-        NSNumber *lastChapterOffsetNum = self.chapterOffsets[@(lastLoadedIndex)];
-        if (lastChapterOffsetNum) {
-            CGFloat lastChapterOffset = [lastChapterOffsetNum floatValue];
+        ChapterOffsetIndex *offsetIndex = self.progressManager.offsetIndex;
+        if ([offsetIndex containsChapter:lastLoadedIndex]) {
+            CGFloat lastChapterOffset = [offsetIndex offsetForChapter:lastLoadedIndex];
             CGFloat lastChapterHeight = contentHeight - lastChapterOffset;
 
             // 当用户阅读到最后一章的80%位置时，显示下一章并预加载后3章
@@ -1366,6 +1621,7 @@ static const CGFloat kMaxFontSize = 30.0;
     PageModel *prevPage = self.allPages[currentIndex - 1];
     ContentPageViewController *prevVC = [[ContentPageViewController alloc] init];
     prevVC.scrollEnabled = NO;
+    prevVC.textColor = [self getTextColorForNightMode:[self isNightModeEnabled]];
     prevVC.pageModel = prevPage;
 
     return prevVC;
@@ -1394,8 +1650,12 @@ static const CGFloat kMaxFontSize = 30.0;
     if (currentIndex < 0 || currentIndex >= self.allPages.count - 1) {
         // 如果是最后一页，尝试加载下一章
         ChapterModel *currentChapter = currentVC.pageModel.chapter;
-        if (currentChapter.chapterIndex + 1 < self.chapters.count) {
-            [self preloadChapterAtIndex:currentChapter.chapterIndex + 1];
+        NSInteger nextIndex = currentChapter.chapterIndex + 1;
+        if (nextIndex < self.chapters.count && ![self.pendingRequests containsObject:@(nextIndex)]) {
+            [self.prefetchPlanner beginForegroundFetch];
+            [self preloadChapterAtIndex:nextIndex completion:^(BOOL success) {
+                [self.prefetchPlanner endForegroundFetch];
+            }];
         }
         return nil;
     }
@@ -1404,6 +1664,7 @@ static const CGFloat kMaxFontSize = 30.0;
     PageModel *nextPage = self.allPages[currentIndex + 1];
     ContentPageViewController *nextVC = [[ContentPageViewController alloc] init];
     nextVC.scrollEnabled = NO;
+    nextVC.textColor = [self getTextColorForNightMode:[self isNightModeEnabled]];
     nextVC.pageModel = nextPage;
 
     return nextVC;
@@ -1434,15 +1695,20 @@ static const CGFloat kMaxFontSize = 30.0;
                 }
             }
 
+            // 预分页以新的当前章节为中心调整优先级
+            self.paginationScheduler.currentChapterIndex = self.currentChapter.chapterIndex;
+
             // 更新阅读进度
             self.book.currentChapter = self.currentChapter.chapterIndex;
             [[BookshelfManager sharedManager] updateBook:self.book];
 
-            // 如果翻到新章节，预加载后续章节
+            // 如果翻到新章节，更新阅读速度并预取后续章节
             static NSInteger lastChapterIndex = -1;
             if (lastChapterIndex != self.currentChapter.chapterIndex) {
-                [self preloadNext3Chapters];
-                lastChapterIndex = self.currentChapter.chapterIndex;
+                NSInteger chapterIndex = self.currentChapter.chapterIndex;
+                [self.prefetchPlanner readerDidEnterChapter:chapterIndex
+                                                  wordCount:[self.contentManager peekCachedContent:chapterIndex].length];
+                lastChapterIndex = chapterIndex;
             }
         } else {
             // 竖向滚动模式（不应该走到这里）
@@ -1451,41 +1717,7 @@ static const CGFloat kMaxFontSize = 30.0;
     }
 }
 
-#pragma mark - ⭐ 内存管理优化
-
-
-- (void)trimCacheIfNeeded {
-    if (self.contentCache.count <= MAX_CACHE_COUNT) {
-        return;
-    }
-
-    // 按访问时间排序，移除最旧的章节
-    NSArray *sortedKeys = [self.contentCache.allKeys sortedArrayUsingComparator:^NSComparisonResult(NSNumber *key1, NSNumber *key2) {
-        NSDate *time1 = self.cacheAccessTime[key1] ?: [NSDate distantPast];
-        NSDate *time2 = self.cacheAccessTime[key2] ?: [NSDate distantPast];
-        return [time1 compare:time2];
-    }];
-
-    // 移除最旧的章节（保留最新的 MAX_CACHE_COUNT 章）
-    NSInteger removeCount = sortedKeys.count - MAX_CACHE_COUNT;
-    for (NSInteger i = 0; i < removeCount; i++) {
-        NSNumber *key = sortedKeys[i];
-        [self.contentCache removeObjectForKey:key];
-        [self.cacheAccessTime removeObjectForKey:key];
-    }
-}
-
-
-
-
-
-
-/**
- * 更新缓存访问时间（用于 LRU）
- */
-- (void)updateCacheAccessTime:(NSInteger)chapterIndex {
-    self.cacheAccessTime[@(chapterIndex)] = [NSDate date];
-}
+#pragma mark - ⭐ 离线缓存
 
 /**
  * 保存章节到离线缓存
@@ -1606,6 +1838,12 @@ static const CGFloat kMaxFontSize = 30.0;
     CGFloat toolbarHeight = self.isToolbarVisible ? 60 : 0;
     scrollView.frame = CGRectMake(0, scrollY, screenWidth, screenHeight - scrollY - toolbarHeight);
 
+    // ⭐ 分段显示时按新宽度重新测量窗口内的章节
+    if (self.verticalDocument.segments.count > 0) {
+        [self relayoutVerticalDocument];
+        return;
+    }
+
     // ⭐ 更新 textView 布局和内容
     UITextView *textView = self.currentPageVC.contentTextView;
     if (textView && textView.text.length > 0) {
@@ -1630,62 +1868,148 @@ static const CGFloat kMaxFontSize = 30.0;
 
 /**
  * 更新横向模式布局（需要重新分页）
+ *
+ * ⭐ 以当前页首字为阅读锚点增量重排：同步只排锚点前一页、锚点所在页和下一页，
+ *    章节其余部分和相邻章节交给后台分页，完成后替换，用户位置不变
  */
 - (void)updateHorizontalModeLayout {
     // ⭐ 检查是否在横向模式
-    if (!self.pageViewController) {
+    if (!self.pageViewController || !self.currentChapter) {
         return;  // 不在横向模式，无需处理
     }
 
-    // ⭐ 保存当前页面索引和旧的总页数
-    NSInteger oldPageIndex = self.currentPageIndex;
-    NSInteger oldPagesCount = self.allPages.count;
+    ChapterModel *chapter = self.currentChapter;
+    PageModel *visiblePage = self.currentPageVC.pageModel;
+    BOOL sameChapter = visiblePage && visiblePage.chapter.chapterIndex == chapter.chapterIndex;
+    NSString *chapterText = sameChapter ? visiblePage.chapterText : [[self.contentManager peekCachedContent:chapter.chapterIndex] copy];
+    if (chapterText.length == 0) {
+        return;  // 没有内容，无法分页
+    }
+    NSUInteger anchor = sameChapter ? MIN(visiblePage.pageRange.location, chapterText.length - 1) : 0;
 
-    // 清除旧的分页缓存
+    // 排版参数变化时取消进行中的预分页，清除旧的分页结果
+    PaginationLayout *layout = [self currentPaginationLayout];
+    self.paginationScheduler.layout = layout;
+    self.paginationScheduler.currentChapterIndex = chapter.chapterIndex;
     [self.pagesCache removeAllObjects];
-    [self.allPages removeAllObjects];
 
-    // ⭐ 重新分页（使用新的屏幕尺寸）
-    if (!self.currentChapter) {
-        return;  // 没有当前章节，无法分页
+    // ⭐ 同步部分：从锚点开始只排两页（多取一个位置作为第二页的结束）
+    NSArray<NSNumber *> *headBreaks = [[PaginationEngine sharedEngine] pageBreaksForText:chapterText
+                                                                                  layout:layout
+                                                                                   range:NSMakeRange(anchor, chapterText.length - anchor)
+                                                                                maxPages:2];
+    if (headBreaks.count == 0) {
+        return;  // 分页失败，无法设置页面
     }
 
-    [self buildAllPagesFromChapter:self.currentChapter];
-
-    // ⭐ 尝试恢复到相近的页面
-    if (self.allPages.count == 0) {
-        return;  // 分页失败，无法设置页面
+    // 临时页码按首页字数估算，后台分页完成后替换为准确值
+    NSUInteger firstPageEnd = headBreaks.count > 1 ? headBreaks[1].unsignedIntegerValue : chapterText.length;
+    NSUInteger charsPerPage = MAX((NSUInteger)1, firstPageEnd - anchor);
+
+    // ⭐ 锚点不在章首时同步补排锚点前一页，后台结果到达前也能往回翻
+    //    从锚点前约两页处开始排，取结束于锚点的最后一页（与后台结果一样，锚点前一页可能不满）
+    NSMutableArray<NSNumber *> *pageStarts = [NSMutableArray array];
+    if (anchor > 0) {
+        NSUInteger windowStart = anchor > charsPerPage * 2 ? anchor - charsPerPage * 2 : 0;
+        NSArray<NSNumber *> *tailBreaks = [[PaginationEngine sharedEngine] pageBreaksForText:chapterText
+                                                                                      layout:layout
+                                                                                       range:NSMakeRange(windowStart, anchor - windowStart)
+                                                                                    maxPages:0];
+        if (tailBreaks.count > 0) {
+            [pageStarts addObject:tailBreaks.lastObject];
+        }
     }
+    NSInteger anchorPosition = pageStarts.count;
+    for (NSInteger i = 0; i < MIN((NSInteger)headBreaks.count, 2); i++) {
+        [pageStarts addObject:headBreaks[i]];
+    }
+    NSUInteger headEnd = headBreaks.count > 2 ? headBreaks[2].unsignedIntegerValue : chapterText.length;
+
+    NSInteger estimatedIndex = MAX((NSInteger)(anchor / charsPerPage), anchorPosition);
+    NSInteger estimatedTotal = MAX((NSInteger)((chapterText.length + charsPerPage - 1) / charsPerPage),
+                                   estimatedIndex + (NSInteger)pageStarts.count - anchorPosition);
 
-    // 计算新的页面索引（按比例）
-    NSInteger newPageIndex = 0;
-    if (oldPageIndex > 0 && oldPagesCount > 0) {
-        // 按照之前的进度比例来定位
-        CGFloat progress = (CGFloat)oldPageIndex / (CGFloat)oldPagesCount;
-        newPageIndex = (NSInteger)(progress * self.allPages.count);
-        newPageIndex = MAX(0, MIN(newPageIndex, self.allPages.count - 1));  // 确保在有效范围内
+    NSMutableArray<PageModel *> *headPages = [NSMutableArray array];
+    for (NSInteger i = 0; i < pageStarts.count; i++) {
+        NSUInteger pageStart = pageStarts[i].unsignedIntegerValue;
+        NSUInteger pageEnd = i + 1 < pageStarts.count ? pageStarts[i + 1].unsignedIntegerValue : headEnd;
+
+        PageModel *page = [[PageModel alloc] init];
+        page.chapter = chapter;
+        page.pageIndex = estimatedIndex + i - anchorPosition;
+        page.chapterText = chapterText;
+        page.pageRange = NSMakeRange(pageStart, pageEnd - pageStart);
+        page.layout = layout;
+        page.totalPages = estimatedTotal;
+        [headPages addObject:page];
     }
 
-    self.currentPageIndex = newPageIndex;
+    self.allPages = headPages;
+    self.currentPageIndex = anchorPosition;
+    [self showPageAtIndex:anchorPosition];
+
+    // ⭐ 后台部分：整章以锚点为界分页，完成后替换临时页面，再拼接相邻章节
+    __weak typeof(self) weakSelf = self;
+    [self.paginationScheduler schedulePaginationForChapter:chapter.chapterIndex
+                                                      text:chapterText
+                                              anchorOffset:anchor
+                                                completion:^(NSInteger chapterIndex, NSArray<NSNumber *> *pageBreaks) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf || chapterIndex != strongSelf.currentChapter.chapterIndex) {
+            return;
+        }
+        [strongSelf replacePagesForChapter:chapter
+                                      text:chapterText
+                                pageBreaks:pageBreaks
+                                    layout:strongSelf.paginationScheduler.layout];
+        [strongSelf scheduleNeighbourPaginationAroundChapter:chapter];
+    }];
+}
+
+// 用完整的分页结果替换当前章节的临时页面，保持正在显示的那一页
+- (void)replacePagesForChapter:(ChapterModel *)chapter
+                          text:(NSString *)chapterText
+                    pageBreaks:(NSArray<NSNumber *> *)pageBreaks
+                        layout:(PaginationLayout *)layout {
+    NSArray<PageModel *> *pages = [self pagesForChapter:chapter text:chapterText pageBreaks:pageBreaks layout:layout];
+    if (pages.count == 0) {
+        return;
+    }
+    self.pagesCache[@(chapter.chapterIndex)] = pages;
 
-    // 创建新页面
-    ContentPageViewController *newPageVC = [[ContentPageViewController alloc] init];
-    if (!newPageVC) {
-        return;  // 创建失败
+    // 找到包含当前页首字的页面（锚点分页时恰好从该字开始）
+    PageModel *visiblePage = self.currentPageVC.pageModel;
+    NSUInteger location = visiblePage.chapter.chapterIndex == chapter.chapterIndex ? visiblePage.pageRange.location : 0;
+    NSInteger pageIndex = 0;
+    for (NSInteger i = 0; i < pages.count; i++) {
+        if (NSLocationInRange(location, pages[i].pageRange)) {
+            pageIndex = i;
+            break;
+        }
     }
 
-    newPageVC.scrollEnabled = NO;
-    newPageVC.pageModel = self.allPages[newPageIndex];
+    self.allPages = [pages mutableCopy];
+    self.currentPageIndex = pageIndex;
+    [self mergePaginatedNeighbours];
 
-    // ⭐ 检查 pageModel 是否有效
-    if (!newPageVC.pageModel) {
-        return;  // pageModel 无效，不能设置
+    // 内容不变，只需刷新页码并替换模型，翻页时才能在 allPages 中找到当前页
+    self.currentPageVC.pageModel = self.allPages[self.currentPageIndex];
+    [self.currentPageVC displayPageModel:self.currentPageVC.pageModel];
+}
+
+// 显示 allPages 中的指定页（不带动画）
+- (void)showPageAtIndex:(NSInteger)index {
+    if (index < 0 || index >= self.allPages.count) {
+        return;
     }
 
-    self.currentPageVC = newPageVC;
+    ContentPageViewController *pageVC = [[ContentPageViewController alloc] init];
+    pageVC.scrollEnabled = NO;
+    pageVC.textColor = [self getTextColorForNightMode:[self isNightModeEnabled]];
+    pageVC.pageModel = self.allPages[index];
+    self.currentPageVC = pageVC;
 
-    // ⭐ 确保 newPageVC 不为 nil 才设置
-    [self.pageViewController setViewControllers:@[newPageVC]
+    [self.pageViewController setViewControllers:@[pageVC]
                                       direction:UIPageViewControllerNavigationDirectionForward
                                        animated:NO
                                      completion:nil];
@@ -1750,10 +2074,8 @@ static const CGFloat kMaxFontSize = 30.0;
 
     // 保存当前滚动位置
     if (self.pageTurnMode == PageTurnModeVertical && self.currentPageVC) {
-        CGFloat currentOffset = self.currentPageVC.scrollView.contentOffset.y;
-        [[NSUserDefaults standardUserDefaults] setFloat:currentOffset
-                                                 forKey:[NSString stringWithFormat:@"ReadProgress_%@_%ld", self.book.bookUrl, (long)self.currentChapter.chapterIndex]];
-        [[NSUserDefaults standardUserDefaults] synchronize];
+        [self saveReadingProgress];
+        [self.progressManager saveImmediately];
     }
 
     // 返回时通知书架刷新
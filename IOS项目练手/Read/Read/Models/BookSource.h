@@ -70,12 +70,29 @@ NS_ASSUME_NONNULL_BEGIN
 @property (strong, nonatomic) RuleSearch *ruleSearch;
 @property (strong, nonatomic) RuleToc *ruleToc;
 
+// 规则开销（导入时由 RuleCostAnalyzer 分析，不参与 JSON 导出）
+@property (assign, nonatomic) NSInteger costScore;                          // 0 表示未分析
+@property (copy, nonatomic, nullable) NSArray<NSString *> *costWarnings;
+
 // 从 JSON 创建书源
 + (instancetype)bookSourceFromJSON:(NSDictionary *)json;
 
 // 转换为 JSON
 - (NSDictionary *)toJSON;
 
+#pragma mark - 规则延迟解码（二进制快照）
+
+/**
+ * 四组规则的紧凑 JSON 数据
+ * 规则尚未解码时直接返回快照中的原始字节，不触发解码
+ */
+- (nullable NSData *)compactRuleData;
+
+/**
+ * 设置规则原始数据（从快照恢复时使用），规则在首次访问时才解码
+ */
+- (void)setLazyRuleData:(NSData *)ruleData;
+
 @end
 
 NS_ASSUME_NONNULL_END
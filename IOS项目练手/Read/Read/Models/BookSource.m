@@ -19,8 +19,17 @@
 @implementation RuleToc
 @end
 
+@interface BookSource ()
+@property (strong, nonatomic, nullable) NSData *lazyRuleData;  // 尚未解码的规则数据
+@end
+
 @implementation BookSource
 
+@synthesize ruleBookInfo = _ruleBookInfo;
+@synthesize ruleContent = _ruleContent;
+@synthesize ruleSearch = _ruleSearch;
+@synthesize ruleToc = _ruleToc;
+
 + (instancetype)bookSourceFromJSON:(NSDictionary *)json {
     BookSource *source = [[BookSource alloc] init];
 
@@ -50,48 +59,7 @@
     source.weight = [json[@"weight"] integerValue];
 
     // 解析规则
-    NSDictionary *bookInfoDict = json[@"ruleBookInfo"];
-    if (bookInfoDict) {
-        RuleBookInfo *bookInfo = [[RuleBookInfo alloc] init];
-        bookInfo.baseRule = bookInfoDict[@"init"];
-        bookInfo.intro = bookInfoDict[@"intro"];
-        bookInfo.kind = bookInfoDict[@"kind"];
-        bookInfo.tocUrl = bookInfoDict[@"tocUrl"];
-        source.ruleBookInfo = bookInfo;
-    }
-
-    NSDictionary *contentDict = json[@"ruleContent"];
-    if (contentDict) {
-        RuleContent *content = [[RuleContent alloc] init];
-        content.content = contentDict[@"content"];
-        content.nextContentUrl = contentDict[@"nextContentUrl"];
-        source.ruleContent = content;
-    }
-
-    NSDictionary *searchDict = json[@"ruleSearch"];
-    if (searchDict) {
-        RuleSearch *search = [[RuleSearch alloc] init];
-        search.author = searchDict[@"author"];
-        search.bookList = searchDict[@"bookList"];
-        search.bookUrl = searchDict[@"bookUrl"];
-        search.checkKeyWord = searchDict[@"checkKeyWord"];
-        search.intro = searchDict[@"intro"];
-        search.lastChapter = searchDict[@"lastChapter"];
-        search.name = searchDict[@"name"];
-        search.coverUrl = searchDict[@"coverUrl"];
-        search.kind = searchDict[@"kind"];
-        search.wordCount = searchDict[@"wordCount"];
-        source.ruleSearch = search;
-    }
-
-    NSDictionary *tocDict = json[@"ruleToc"];
-    if (tocDict) {
-        RuleToc *toc = [[RuleToc alloc] init];
-        toc.chapterList = tocDict[@"chapterList"];
-        toc.chapterName = tocDict[@"chapterName"];
-        toc.chapterUrl = tocDict[@"chapterUrl"];
-        source.ruleToc = toc;
-    }
+    [source applyRulesFromJSON:json];
 
     return source;
 }
@@ -117,6 +85,14 @@
     json[@"weight"] = @(self.weight);
 
     // 规则
+    [json addEntriesFromDictionary:[self rulesJSON]];
+
+    return json;
+}
+
+- (NSDictionary *)rulesJSON {
+    NSMutableDictionary *json = [NSMutableDictionary dictionary];
+
     if (self.ruleBookInfo) {
         json[@"ruleBookInfo"] = @{
             @"init": self.ruleBookInfo.baseRule ?: @"",
@@ -134,7 +110,7 @@
     }
 
     if (self.ruleSearch) {
-        json[@"ruleSearch"] = @{
+        NSMutableDictionary *search = [@{
             @"author": self.ruleSearch.author ?: @"",
             @"bookList": self.ruleSearch.bookList ?: @"",
             @"bookUrl": self.ruleSearch.bookUrl ?: @"",
@@ -142,7 +118,12 @@
             @"intro": self.ruleSearch.intro ?: @"",
             @"lastChapter": self.ruleSearch.lastChapter ?: @"",
             @"name": self.ruleSearch.name ?: @""
-        };
+        } mutableCopy];
+        // 可选字段，保证快照往返不丢失
+        if (self.ruleSearch.coverUrl) search[@"coverUrl"] = self.ruleSearch.coverUrl;
+        if (self.ruleSearch.kind) search[@"kind"] = self.ruleSearch.kind;
+        if (self.ruleSearch.wordCount) search[@"wordCount"] = self.ruleSearch.wordCount;
+        json[@"ruleSearch"] = search;
     }
 
     if (self.ruleToc) {
@@ -156,5 +137,126 @@
     return json;
 }
 
+#pragma mark - 规则延迟解码
+
+- (void)applyRulesFromJSON:(NSDictionary *)json {
+    NSDictionary *bookInfoDict = json[@"ruleBookInfo"];
+    if (bookInfoDict) {
+        RuleBookInfo *bookInfo = [[RuleBookInfo alloc] init];
+        bookInfo.baseRule = bookInfoDict[@"init"];
+        bookInfo.intro = bookInfoDict[@"intro"];
+        bookInfo.kind = bookInfoDict[@"kind"];
+        bookInfo.tocUrl = bookInfoDict[@"tocUrl"];
+        _ruleBookInfo = bookInfo;
+    }
+
+    NSDictionary *contentDict = json[@"ruleContent"];
+    if (contentDict) {
+        RuleContent *content = [[RuleContent alloc] init];
+        content.content = contentDict[@"content"];
+        content.nextContentUrl = contentDict[@"nextContentUrl"];
+        _ruleContent = content;
+    }
+
+    NSDictionary *searchDict = json[@"ruleSearch"];
+    if (searchDict) {
+        RuleSearch *search = [[RuleSearch alloc] init];
+        search.author = searchDict[@"author"];
+        search.bookList = searchDict[@"bookList"];
+        search.bookUrl = searchDict[@"bookUrl"];
+        search.checkKeyWord = searchDict[@"checkKeyWord"];
+        search.intro = searchDict[@"intro"];
+        search.lastChapter = searchDict[@"lastChapter"];
+        search.name = searchDict[@"name"];
+        search.coverUrl = searchDict[@"coverUrl"];
+        search.kind = searchDict[@"kind"];
+        search.wordCount = searchDict[@"wordCount"];
+        _ruleSearch = search;
+    }
+
+    NSDictionary *tocDict = json[@"ruleToc"];
+    if (tocDict) {
+        RuleToc *toc = [[RuleToc alloc] init];
+        toc.chapterList = tocDict[@"chapterList"];
+        toc.chapterName = tocDict[@"chapterName"];
+        toc.chapterUrl = tocDict[@"chapterUrl"];
+        _ruleToc = toc;
+    }
+}
+
+- (nullable NSData *)compactRuleData {
+    @synchronized (self) {
+        if (self.lazyRuleData) {
+            return self.lazyRuleData;
+        }
+    }
+    return [NSJSONSerialization dataWithJSONObject:[self rulesJSON] options:0 error:nil];
+}
+
+- (void)setLazyRuleData:(NSData *)ruleData {
+    @synchronized (self) {
+        _lazyRuleData = ruleData;
+        _ruleBookInfo = nil;
+        _ruleContent = nil;
+        _ruleSearch = nil;
+        _ruleToc = nil;
+    }
+}
+
+- (void)decodeLazyRulesIfNeeded {
+    @synchronized (self) {
+        if (!_lazyRuleData) {
+            return;
+        }
+        NSData *data = _lazyRuleData;
+        _lazyRuleData = nil;
+
+        NSDictionary *json = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+        if ([json isKindOfClass:[NSDictionary class]]) {
+            [self applyRulesFromJSON:json];
+        }
+    }
+}
+
+- (RuleBookInfo *)ruleBookInfo {
+    [self decodeLazyRulesIfNeeded];
+    return _ruleBookInfo;
+}
+
+- (void)setRuleBookInfo:(RuleBookInfo *)ruleBookInfo {
+    [self decodeLazyRulesIfNeeded];
+    _ruleBookInfo = ruleBookInfo;
+}
+
+- (RuleContent *)ruleContent {
+    [self decodeLazyRulesIfNeeded];
+    return _ruleContent;
+}
+
+- (void)setRuleContent:(RuleContent *)ruleContent {
+    [self decodeLazyRulesIfNeeded];
+    _ruleContent = ruleContent;
+}
+
+- (RuleSearch *)ruleSearch {
+    [self decodeLazyRulesIfNeeded];
+    return _ruleSearch;
+}
+
+- (void)setRuleSearch:(RuleSearch *)ruleSearch {
+    [self decodeLazyRulesIfNeeded];
+    _ruleSearch = ruleSearch;
+}
+
+- (RuleToc *)ruleToc {
+    [self decodeLazyRulesIfNeeded];
+    return _ruleToc;
+}
+
+- (void)setRuleToc:(RuleToc *)ruleToc {
+    [self decodeLazyRulesIfNeeded];
+    _ruleToc = ruleToc;
+}
+
 @end
 
@@ -0,0 +1,24 @@
+//
+//  SearchResultBook.h
+//  Read
+//
+//  搜索结果书籍模型
+//
+
+#import <Foundation/Foundation.h>
+#import "BookSource.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// 搜索结果书籍模型
+@interface SearchResultBook : NSObject
+@property (copy, nonatomic) NSString *name;           // 书名
+@property (copy, nonatomic) NSString *author;         // 作者
+@property (copy, nonatomic) NSString *bookUrl;        // 书籍详情URL
+@property (copy, nonatomic) NSString *intro;          // 简介
+@property (copy, nonatomic) NSString *lastChapter;    // 最新章节
+@property (copy, nonatomic) NSString *coverUrl;       // 封面URL
+@property (strong, nonatomic) BookSource *bookSource; // 来源书源
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,11 @@
+//
+//  SearchResultBook.m
+//  Read
+//
+//  搜索结果书籍模型实现
+//
+
+#import "SearchResultBook.h"
+
+@implementation SearchResultBook
+@end
@@ -16,7 +16,7 @@ NS_ASSUME_NONNULL_BEGIN
 @interface ChapterContent : NSObject
 @property (copy, nonatomic) NSString *chapterName;    // 章节名称
 @property (copy, nonatomic) NSString *content;        // 正文内容
-@property (copy, nonatomic) NSString *nextChapterUrl; // 下一章URL（如果有）
+@property (copy, nonatomic, nullable) NSString *nextChapterUrl; // 下一章URL（下一页链接跨入下一章时）
 @end
 
 @interface BookContentService : NSObject
@@ -36,6 +36,22 @@ NS_ASSUME_NONNULL_BEGIN
                  success:(void(^)(NSString *tocUrl, NSArray<ChapterModel *> *chapters))success
                  failure:(void(^)(NSError *error))failure;
 
+/**
+ * 获取书籍目录（分批交付）
+ * 目录页下载后，阅读位置附近的章节最先解析并交出，其余章节每解析完一块交出一块，
+ * 调用方可以先显示部分目录、同时加载当前章正文，不必等整本目录解析完
+ * @param chapterIndex 阅读位置（章节索引）
+ * @param batch 分批回调（主线程），chapterIndex 为目录中的位置，elementCount 为目录条目总数；为空时等同 fetchChapterList
+ * @param completion 完成回调（所有批次之后），返回完整章节列表，与 fetchChapterList 的成功回调相同
+ * @param failure 失败回调（此前可能已经交出部分批次）
+ */
+- (void)fetchChapterList:(NSString *)bookUrl
+              bookSource:(BookSource *)bookSource
+           aroundChapter:(NSInteger)chapterIndex
+                   batch:(nullable void(^)(NSArray<ChapterModel *> *chapters, NSUInteger elementCount))batch
+              completion:(void(^)(NSString *tocUrl, NSArray<ChapterModel *> *chapters))completion
+                 failure:(void(^)(NSError *error))failure;
+
 /**
  * 获取章节内容
  * @param chapterUrl 章节URL
@@ -48,13 +64,38 @@ NS_ASSUME_NONNULL_BEGIN
                     success:(void(^)(ChapterContent *content))success
                     failure:(void(^)(NSError *error))failure;
 
+/**
+ * 获取章节内容（正文分多页时沿书源的下一页规则抓取并按页序拼接）
+ * @param chapterUrl 章节URL
+ * @param nextChapterUrl 目录中下一章的URL（下一页链接指向它时视为章节结束，可为空）
+ * @param bookSource 书源
+ * @param success 成功回调（主线程）
+ * @param failure 失败回调
+ */
+- (void)fetchChapterContent:(NSString *)chapterUrl
+             nextChapterUrl:(nullable NSString *)nextChapterUrl
+                 bookSource:(BookSource *)bookSource
+                    success:(void(^)(ChapterContent *content))success
+                    failure:(void(^)(NSError *error))failure;
+
 /**
  * 获取缓存的章节列表（用于快速打开）
+ * 内存中没有时读取持久化目录，重启后依然有效
  * @param book 书籍模型
  * @return 缓存的章节列表，如果没有缓存则返回 nil
  */
 - (nullable NSArray<ChapterModel *> *)getCachedChapterListForBook:(BookModel *)book;
 
+/**
+ * 后台刷新目录（只对比尾部，新增章节写入持久化目录）
+ * @param book 书籍模型
+ * @param bookSource 书源
+ * @param completion 完成回调（主线程），返回新增章节
+ */
+- (void)refreshChapterListForBook:(BookModel *)book
+                       bookSource:(BookSource *)bookSource
+                       completion:(nullable void(^)(NSArray<ChapterModel *> *newChapters))completion;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -8,11 +8,236 @@
 #import "BookContentService.h"
 #import "NetworkManager.h"
 #import "RuleParser.h"
-#import "JSScriptEngine.h"
+#import "SourceResponseParser.h"
+#import "ChapterListStore.h"
+#import "TraceRecorder.h"
+#import "MetricsRegistry.h"
+#import "ParseExecutor.h"
 
 @implementation ChapterContent
 @end
 
+#pragma mark - 分页章节组装
+
+static const NSUInteger kChapterPageLimit = 20;   // 单章最多跟随的页数（防止规则误配时无限翻页）
+
+/**
+ * 一章多页的组装状态（各页并发解析，按页序拼接）
+ */
+@interface ChapterPageAssembly : NSObject
+@property (copy, nonatomic) void (^success)(ChapterContent *content);
+@property (copy, nonatomic) void (^failure)(NSError *error);
+- (instancetype)initWithChapterUrl:(NSString *)chapterUrl nextChapterUrl:(nullable NSString *)nextChapterUrl;
+- (BOOL)shouldFollowPageURL:(nullable NSString *)url afterPage:(NSUInteger)pageIndex;
+- (void)setText:(NSString *)text forPage:(NSUInteger)pageIndex;
+- (void)failPage:(NSUInteger)pageIndex error:(NSError *)error;
+@end
+
+@interface ChapterPageAssembly ()
+@property (copy, nonatomic) NSString *chapterUrl;
+@property (copy, nonatomic, nullable) NSString *nextChapterUrl;      // 目录中的下一章（链接指向它时停止）
+@property (copy, nonatomic, nullable) NSString *crossedChapterUrl;   // 跨入下一章的链接
+@property (strong, nonatomic) NSMutableArray *pageTexts;             // 按页序，未完成为 NSNull
+@property (strong, nonatomic) NSMutableSet<NSString *> *visitedUrls;
+@property (assign, nonatomic) NSInteger lastPageIndex;               // 最后一页（未确定为 -1）
+@property (assign, nonatomic) BOOL finished;
+@end
+
+@implementation ChapterPageAssembly
+
+- (instancetype)initWithChapterUrl:(NSString *)chapterUrl nextChapterUrl:(nullable NSString *)nextChapterUrl {
+    self = [super init];
+    if (self) {
+        _chapterUrl = [chapterUrl copy];
+        _nextChapterUrl = [nextChapterUrl copy];
+        _pageTexts = [NSMutableArray arrayWithObject:[NSNull null]];
+        _visitedUrls = [NSMutableSet setWithObject:[ChapterPageAssembly normalizedURL:chapterUrl]];
+        _lastPageIndex = -1;
+    }
+    return self;
+}
+
+- (BOOL)shouldFollowPageURL:(nullable NSString *)url afterPage:(NSUInteger)pageIndex {
+    @synchronized (self) {
+        BOOL follow = url.length > 0 && !self.finished && pageIndex + 1 < kChapterPageLimit;
+        NSString *normalized = follow ? [ChapterPageAssembly normalizedURL:url] : nil;
+
+        if (follow && [self.visitedUrls containsObject:normalized]) {
+            follow = NO;   // 回到已抓取的页（如最后一页链接指回目录或第一页）
+        } else if (follow && ![self isSameChapterURL:url]) {
+            follow = NO;
+            self.crossedChapterUrl = url;
+        }
+
+        if (!follow) {
+            self.lastPageIndex = pageIndex;
+            [self completeIfPossible];
+            return NO;
+        }
+
+        [self.visitedUrls addObject:normalized];
+        [self.pageTexts addObject:[NSNull null]];
+        return YES;
+    }
+}
+
+- (void)setText:(NSString *)text forPage:(NSUInteger)pageIndex {
+    @synchronized (self) {
+        if (pageIndex < self.pageTexts.count) {
+            self.pageTexts[pageIndex] = text ?: @"";
+        }
+        [self completeIfPossible];
+    }
+}
+
+- (void)failPage:(NSUInteger)pageIndex error:(NSError *)error {
+    @synchronized (self) {
+        if (self.finished) {
+            return;
+        }
+        if (pageIndex == 0) {
+            self.finished = YES;
+            void (^failure)(NSError *) = self.failure;
+            if (failure) failure(error);
+            return;
+        }
+
+        // 后续页失败：保留已取到的部分，章节在失败页之前结束
+        NSLog(@"⚠️ 章节第 %lu 页加载失败，只显示前 %lu 页: %@",
+              (unsigned long)(pageIndex + 1), (unsigned long)pageIndex, error.localizedDescription);
+        [self.pageTexts removeObjectsInRange:NSMakeRange(pageIndex, self.pageTexts.count - pageIndex)];
+        self.lastPageIndex = (NSInteger)pageIndex - 1;
+        [self completeIfPossible];
+    }
+}
+
+// 调用方已持有锁
+- (void)completeIfPossible {
+    if (self.finished || self.lastPageIndex < 0) {
+        return;
+    }
+    for (NSInteger i = 0; i <= self.lastPageIndex; i++) {
+        if (self.pageTexts[i] == [NSNull null]) {
+            return;
+        }
+    }
+    self.finished = YES;
+
+    NSMutableArray<NSString *> *parts = [NSMutableArray arrayWithCapacity:self.lastPageIndex + 1];
+    for (NSInteger i = 0; i <= self.lastPageIndex; i++) {
+        NSString *text = self.pageTexts[i];
+        if (text.length > 0) {
+            [parts addObject:text];
+        }
+    }
+
+    // 各页已整理为段落，直接以换行相接
+    ChapterContent *content = [[ChapterContent alloc] init];
+    content.content = [parts componentsJoinedByString:@"\n"];
+    content.nextChapterUrl = self.crossedChapterUrl;
+
+    void (^success)(ChapterContent *) = self.success;
+    void (^failure)(NSError *) = self.failure;
+
+    // 回到主线程
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (content.content.length > 0) {
+            if (success) success(content);
+        } else {
+            NSError *error = [NSError errorWithDomain:@"BookContentService"
+                                               code:-1007
+                                           userInfo:@{NSLocalizedDescriptionKey: @"正文内容为空"}];
+            if (failure) failure(error);
+        }
+    });
+}
+
+// 同一章的分页链接：不是目录中的下一章，带有可识别的页码（123_2.html、123-2.html、?page=2），
+// 且去掉页码后路径和其余查询参数都与章节地址相同（read.php?id=456 与 read.php?id=457 是两章）；
+// 章节地址本身的 _12 / -12、?p=12 不当作页码，chapter-12.html 到 chapter-13.html 是换章
+- (BOOL)isSameChapterURL:(NSString *)url {
+    if (self.nextChapterUrl && [[ChapterPageAssembly normalizedURL:url] isEqualToString:[ChapterPageAssembly normalizedURL:self.nextChapterUrl]]) {
+        return NO;
+    }
+
+    BOOL hasPageMarker = NO;
+    NSString *stem = [ChapterPageAssembly pageStemForURL:url stripPageMarkers:YES hasPageMarker:&hasPageMarker];
+    if (!hasPageMarker) {
+        return NO;
+    }
+    return [stem isEqualToString:[ChapterPageAssembly pageStemForURL:self.chapterUrl stripPageMarkers:NO hasPageMarker:NULL]];
+}
+
++ (NSString *)normalizedURL:(NSString *)url {
+    NSString *normalized = [url stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    NSRange fragment = [normalized rangeOfString:@"#"];
+    if (fragment.location != NSNotFound) {
+        normalized = [normalized substringToIndex:fragment.location];
+    }
+    return normalized;
+}
+
+// 查询参数中表示页码的键
++ (BOOL)isPageQueryName:(NSString *)name {
+    static NSSet<NSString *> *pageNames = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pageNames = [NSSet setWithObjects:@"page", @"p", @"pn", @"pageno", @"page_no", @"pageindex", nil];
+    });
+    return [pageNames containsObject:name.lowercaseString];
+}
+
+// 去掉扩展名，查询参数排序后保留；stripPageMarkers 时再去掉末尾的 _2 / -2 和查询参数中的页码（并记录是否带页码）
++ (NSString *)pageStemForURL:(NSString *)url stripPageMarkers:(BOOL)stripPageMarkers hasPageMarker:(nullable BOOL *)hasPageMarker {
+    static NSRegularExpression *pageSuffix = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pageSuffix = [NSRegularExpression regularExpressionWithPattern:@"[_-]\\d{1,3}$" options:0 error:nil];
+    });
+
+    BOOL marked = NO;
+    NSString *stem = [self normalizedURL:url];
+    NSString *query = nil;
+    NSRange queryRange = [stem rangeOfString:@"?"];
+    if (queryRange.location != NSNotFound) {
+        query = [stem substringFromIndex:NSMaxRange(queryRange)];
+        stem = [stem substringToIndex:queryRange.location];
+    }
+    if ([stem.lastPathComponent containsString:@"."]) {
+        stem = stem.stringByDeletingPathExtension;
+    }
+    NSRange suffix = stripPageMarkers ? [pageSuffix rangeOfFirstMatchInString:stem options:0 range:NSMakeRange(0, stem.length)]
+                                     : NSMakeRange(NSNotFound, 0);
+    if (suffix.location != NSNotFound) {
+        stem = [stem substringToIndex:suffix.location];
+        marked = YES;
+    }
+
+    NSMutableArray<NSString *> *params = [NSMutableArray array];
+    for (NSString *pair in [query componentsSeparatedByString:@"&"]) {
+        if (pair.length == 0) {
+            continue;
+        }
+        NSString *name = [pair componentsSeparatedByString:@"="].firstObject;
+        if (stripPageMarkers && [self isPageQueryName:name]) {
+            marked = YES;
+        } else {
+            [params addObject:pair];
+        }
+    }
+    if (params.count > 0) {
+        [params sortUsingSelector:@selector(compare:)];
+        stem = [NSString stringWithFormat:@"%@?%@", stem, [params componentsJoinedByString:@"&"]];
+    }
+
+    if (hasPageMarker) {
+        *hasPageMarker = marked;
+    }
+    return stem;
+}
+
+@end
+
 @interface BookContentService ()
 @property (strong, nonatomic) NSMutableDictionary<NSString *, NSArray<ChapterModel *> *> *chapterListCache;  // 章节列表缓存 {bookId: chapters}
 @end
@@ -42,6 +267,20 @@
               bookSource:(BookSource *)bookSource
                  success:(void(^)(NSString *tocUrl, NSArray<ChapterModel *> *chapters))success
                  failure:(void(^)(NSError *error))failure {
+    [self fetchChapterList:bookUrl
+                bookSource:bookSource
+             aroundChapter:0
+                     batch:nil
+                completion:success
+                   failure:failure];
+}
+
+- (void)fetchChapterList:(NSString *)bookUrl
+              bookSource:(BookSource *)bookSource
+           aroundChapter:(NSInteger)chapterIndex
+                   batch:(nullable void(^)(NSArray<ChapterModel *> *chapters, NSUInteger elementCount))batch
+              completion:(void(^)(NSString *tocUrl, NSArray<ChapterModel *> *chapters))success
+                 failure:(void(^)(NSError *error))failure {
 
     if (!bookUrl || !bookSource) {
         NSError *error = [NSError errorWithDomain:@"BookContentService"
@@ -52,7 +291,7 @@
     }
 
     // 1. 先请求书籍详情页（bookUrl）
-    NSString *fullBookUrl = [self buildFullURL:bookUrl baseURL:bookSource.bookSourceUrl];
+    NSString *fullBookUrl = [SourceResponseParser fullURL:bookUrl baseURL:bookSource.bookSourceUrl];
 
     // 解析自定义 header
     NSDictionary *headers = [self parseHeaders:bookSource.header];
@@ -60,15 +299,21 @@
     [[NetworkManager sharedManager] GET:fullBookUrl
                                 headers:headers
                                encoding:nil
+                               priority:ParseExecutorPriorityHigh
                                 success:^(NSData *data, NSString *html) {
         // 2. 从详情页解析出目录URL
         [self parseTocUrl:html
                bookUrl:fullBookUrl
             bookSource:bookSource
+         aroundChapter:chapterIndex
+                 batch:batch
                success:^(NSString *tocUrl, NSArray<ChapterModel *> *chapters) {
-            // ⭐ 缓存章节列表（使用bookUrl作为key）
+            // ⭐ 缓存章节列表（使用bookUrl作为key），并在后台持久化
             if (chapters && chapters.count > 0) {
                 self.chapterListCache[bookUrl] = chapters;
+                dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), ^{
+                    [[ChapterListStore sharedStore] reconcileChapterList:chapters forBookUrl:bookUrl];
+                });
             }
 
             // 调用原始success回调
@@ -85,6 +330,8 @@
 - (void)parseTocUrl:(NSString *)html
             bookUrl:(NSString *)bookUrl
          bookSource:(BookSource *)bookSource
+      aroundChapter:(NSInteger)chapterIndex
+              batch:(nullable void(^)(NSArray<ChapterModel *> *chapters, NSUInteger elementCount))batch
             success:(void(^)(NSString *tocUrl, NSArray<ChapterModel *> *chapters))success
             failure:(void(^)(NSError *error))failure {
 
@@ -137,18 +384,21 @@
     }
 
     // 构建完整的目录URL
-    NSString *fullTocUrl = [self buildFullURL:tocUrl baseURL:bookSource.bookSourceUrl];
+    NSString *fullTocUrl = [SourceResponseParser fullURL:tocUrl baseURL:bookSource.bookSourceUrl];
 
     // 3. 请求目录页
     NSDictionary *headers = [self parseHeaders:bookSource.header];
     [[NetworkManager sharedManager] GET:fullTocUrl
                                 headers:headers
                                encoding:nil
+                               priority:ParseExecutorPriorityHigh
                                 success:^(NSData *data, NSString *tocHtml) {
         // 4. 解析章节列表
         [self parseChapterList:tocHtml
                     bookSource:bookSource
                        baseURL:fullTocUrl
+                 aroundChapter:chapterIndex
+                         batch:batch
                        success:^(NSArray<ChapterModel *> *chapters) {
             if (success) {
                 success(fullTocUrl, chapters);
@@ -163,6 +413,8 @@
 - (void)parseChapterList:(NSString *)html
               bookSource:(BookSource *)bookSource
                  baseURL:(NSString *)baseURL
+           aroundChapter:(NSInteger)chapterIndex
+                   batch:(nullable void(^)(NSArray<ChapterModel *> *chapters, NSUInteger elementCount))batch
                  success:(void(^)(NSArray<ChapterModel *> *chapters))success
                  failure:(void(^)(NSError *error))failure {
 
@@ -175,95 +427,25 @@
         return;
     }
 
-    // 在后台线程解析
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-
-        // 解析章节元素列表
-        id chapterListResult = [RuleParser extractFromContent:html withRule:tocRule.chapterList];
-
-        NSArray *chapterElements = nil;
-        if ([chapterListResult isKindOfClass:[NSArray class]]) {
-            chapterElements = chapterListResult;
+    // 在解析线程池中解析（用户正在等待，优先于排队的搜索结果）
+    [[ParseExecutor sharedExecutor] submitWithPriority:ParseExecutorPriorityHigh block:^{
+
+        NSArray<ChapterModel *> *chapters = nil;
+        if (batch) {
+            // ⭐ 分批交付：阅读位置附近的一块最先到达主线程，其余每解析完一块交出一块
+            chapters = [SourceResponseParser chaptersFromTocContent:html
+                                                         bookSource:bookSource
+                                                            baseURL:baseURL
+                                                        aroundIndex:(NSUInteger)MAX(chapterIndex, 0)
+                                                       batchHandler:^(NSArray<ChapterModel *> *chunk, NSUInteger elementCount) {
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    batch(chunk, elementCount);
+                });
+            }];
         } else {
-            chapterElements = @[];
-        }
-
-        NSMutableArray<ChapterModel *> *chapters = [NSMutableArray array];
-
-        for (NSInteger i = 0; i < chapterElements.count; i++) {
-            id element = chapterElements[i];
-
-            // 解析章节名称
-            NSString *chapterName = nil;
-            if (tocRule.chapterName) {
-                // 判断元素类型
-                if ([element isKindOfClass:[NSDictionary class]]) {
-                    // JSON 对象，直接提取字段
-                    id nameResult = [RuleParser extractFromJSON:element withRule:tocRule.chapterName];
-                    chapterName = [self stringFromResult:nameResult];
-                } else if ([element isKindOfClass:[NSString class]]) {
-                    // HTML 字符串，使用 HTML 解析
-                    id nameResult = [RuleParser extractFromContent:element withRule:tocRule.chapterName];
-                    chapterName = [self stringFromResult:nameResult];
-                } else {
-                    // 其他类型，尝试转字符串
-                    chapterName = [element description];
-                }
-            }
-
-            // 解析章节URL
-            NSString *chapterUrl = nil;
-            if (tocRule.chapterUrl) {
-                // 检查是否包含 JavaScript 代码
-                if ([JSScriptEngine containsJavaScript:tocRule.chapterUrl]) {
-                    // 先提取普通规则部分
-                    NSString *normalRule = [JSScriptEngine extractNormalRuleFromRule:tocRule.chapterUrl];
-                    NSString *jsScript = [JSScriptEngine extractJavaScriptFromRule:tocRule.chapterUrl];
-
-                    // 先用普通规则提取数据
-                    id urlResult = nil;
-                    if (normalRule) {
-                        if ([element isKindOfClass:[NSDictionary class]]) {
-                            urlResult = [RuleParser extractFromJSON:element withRule:normalRule];
-                        } else if ([element isKindOfClass:[NSString class]]) {
-                            urlResult = [RuleParser extractFromContent:element withRule:normalRule];
-                        }
-                    }
-
-                    NSString *extractedValue = [self stringFromResult:urlResult];
-
-                    // 执行 JavaScript 脚本
-                    if (jsScript && extractedValue) {
-                        NSDictionary *context = @{@"result": extractedValue};
-                        id jsResult = [JSScriptEngine executeScript:jsScript withContext:context];
-                        chapterUrl = [self stringFromResult:jsResult];
-                    }
-                } else {
-                    // 普通规则，直接提取
-                    if ([element isKindOfClass:[NSDictionary class]]) {
-                        // JSON 对象，直接提取字段
-                        id urlResult = [RuleParser extractFromJSON:element withRule:tocRule.chapterUrl];
-                        chapterUrl = [self stringFromResult:urlResult];
-                    } else if ([element isKindOfClass:[NSString class]]) {
-                        // HTML 字符串，使用 HTML 解析
-                        id urlResult = [RuleParser extractFromContent:element withRule:tocRule.chapterUrl];
-                        chapterUrl = [self stringFromResult:urlResult];
-                    } else {
-                        // 其他类型，尝试转字符串
-                        chapterUrl = [element description];
-                    }
-                }
-            }
-
-            if (chapterName && chapterUrl) {
-                // 构建完整URL
-                NSString *fullChapterUrl = [self buildFullURL:chapterUrl baseURL:baseURL];
-
-                ChapterModel *chapter = [ChapterModel chapterWithName:chapterName
-                                                                  url:fullChapterUrl
-                                                                index:i];
-                [chapters addObject:chapter];
-            }
+            chapters = [SourceResponseParser chaptersFromTocContent:html
+                                                         bookSource:bookSource
+                                                            baseURL:baseURL];
         }
 
         // 回到主线程
@@ -277,7 +459,7 @@
                 if (failure) failure(error);
             }
         });
-    });
+    }];
 }
 
 #pragma mark - 获取章节内容
@@ -286,6 +468,18 @@
                  bookSource:(BookSource *)bookSource
                     success:(void(^)(ChapterContent *content))success
                     failure:(void(^)(NSError *error))failure {
+    [self fetchChapterContent:chapterUrl
+               nextChapterUrl:nil
+                   bookSource:bookSource
+                      success:success
+                      failure:failure];
+}
+
+- (void)fetchChapterContent:(NSString *)chapterUrl
+             nextChapterUrl:(nullable NSString *)nextChapterUrl
+                 bookSource:(BookSource *)bookSource
+                    success:(void(^)(ChapterContent *content))success
+                    failure:(void(^)(NSError *error))failure {
 
     if (!chapterUrl || !bookSource) {
         NSError *error = [NSError errorWithDomain:@"BookContentService"
@@ -295,122 +489,59 @@
         return;
     }
 
-    NSDictionary *headers = [self parseHeaders:bookSource.header];
-
-    [[NetworkManager sharedManager] GET:chapterUrl
-                                headers:headers
-                               encoding:nil
-                                success:^(NSData *data, NSString *html) {
-        // 在后台线程解析内容
-        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-            [self parseChapterContent:html
-                           bookSource:bookSource
-                              baseURL:chapterUrl
-                              success:success
-                              failure:failure];
-        });
-    } failure:failure];
-}
-
-- (void)parseChapterContent:(NSString *)html
-                 bookSource:(BookSource *)bookSource
-                    baseURL:(NSString *)baseURL
-                    success:(void(^)(ChapterContent *content))success
-                    failure:(void(^)(NSError *error))failure {
-
     RuleContent *contentRule = bookSource.ruleContent;
     if (!contentRule || !contentRule.content) {
         NSError *error = [NSError errorWithDomain:@"BookContentService"
                                            code:-1006
                                        userInfo:@{NSLocalizedDescriptionKey: @"书源缺少正文规则"}];
-        dispatch_async(dispatch_get_main_queue(), ^{
-            if (failure) failure(error);
-        });
+        if (failure) failure(error);
         return;
     }
 
-    // 解析正文内容
-    id contentResult = [RuleParser extractFromContent:html withRule:contentRule.content];
-    NSString *contentText = [self stringFromResult:contentResult];
-
-    // 解析下一章URL（如果有）
-    NSString *nextChapterUrl = nil;
-    if (contentRule.nextContentUrl) {
-        id nextUrlResult = [RuleParser extractFromContent:html withRule:contentRule.nextContentUrl];
-        nextChapterUrl = [self stringFromResult:nextUrlResult];
-        if (nextChapterUrl) {
-            nextChapterUrl = [self buildFullURL:nextChapterUrl baseURL:baseURL];
-        }
-    }
-
-    // 创建内容对象
-    ChapterContent *content = [[ChapterContent alloc] init];
-    content.content = contentText ?: @"";
-    content.nextChapterUrl = nextChapterUrl;
-
-    // 回到主线程
-    dispatch_async(dispatch_get_main_queue(), ^{
-        if (content.content.length > 0) {
-            if (success) success(content);
-        } else {
-            NSError *error = [NSError errorWithDomain:@"BookContentService"
-                                               code:-1007
-                                           userInfo:@{NSLocalizedDescriptionKey: @"正文内容为空"}];
-            if (failure) failure(error);
-        }
-    });
+    ChapterPageAssembly *assembly = [[ChapterPageAssembly alloc] initWithChapterUrl:chapterUrl
+                                                                     nextChapterUrl:nextChapterUrl];
+    TraceSpan fetchSpan = TraceSpanBegin("content", "fetchChapter");
+    assembly.success = ^(ChapterContent *content) {
+        TRACE_END_ASYNC(fetchSpan, chapterUrl.UTF8String, (int64_t)content.content.length);
+        if (success) success(content);
+    };
+    assembly.failure = ^(NSError *error) {
+        TRACE_END_ASYNC(fetchSpan, chapterUrl.UTF8String, -1);
+        if (failure) failure(error);
+    };
+    [self fetchChapterPage:0 url:chapterUrl bookSource:bookSource assembly:assembly];
 }
 
-#pragma mark - 辅助方法
-
-- (NSString *)stringFromResult:(id)result {
-    if (!result || [result isKindOfClass:[NSNull class]]) {
-        return nil;
-    }
+// ⭐ 分页章节流水线：每页先解析下一页链接并立即发出请求，再清洗本页正文，网络与解析重叠
+- (void)fetchChapterPage:(NSUInteger)pageIndex
+                     url:(NSString *)pageUrl
+              bookSource:(BookSource *)bookSource
+                assembly:(ChapterPageAssembly *)assembly {
 
-    if ([result isKindOfClass:[NSString class]]) {
-        return result;
-    }
+    NSDictionary *headers = [self parseHeaders:bookSource.header];
 
-    if ([result isKindOfClass:[NSArray class]]) {
-        NSArray *array = result;
-        if (array.count > 0) {
-            return [self stringFromResult:array[0]];
-        }
-        return nil;
-    }
+    [[NetworkManager sharedManager] GET:pageUrl
+                                headers:headers
+                               encoding:nil
+                               priority:ParseExecutorPriorityHigh
+                                success:^(NSData *data, NSString *html) {
+        // 在解析线程池中解析内容
+        [[ParseExecutor sharedExecutor] submitWithPriority:ParseExecutorPriorityHigh block:^{
+            // 1. 下一页链接（只扫描链接，不清洗正文）
+            NSString *nextPageUrl = [SourceResponseParser nextPageURLFromContent:html bookSource:bookSource baseURL:pageUrl];
+            if ([assembly shouldFollowPageURL:nextPageUrl afterPage:pageIndex]) {
+                [self fetchChapterPage:pageIndex + 1 url:nextPageUrl bookSource:bookSource assembly:assembly];
+            }
 
-    return [NSString stringWithFormat:@"%@", result];
+            // 2. 本页正文
+            [assembly setText:[SourceResponseParser chapterTextFromContent:html bookSource:bookSource] forPage:pageIndex];
+        }];
+    } failure:^(NSError *error) {
+        [assembly failPage:pageIndex error:error];
+    }];
 }
 
-- (NSString *)buildFullURL:(NSString *)url baseURL:(NSString *)baseURL {
-    if (!url || url.length == 0) {
-        return baseURL;
-    }
-
-    // 如果已经是完整URL
-    if ([url hasPrefix:@"http://"] || [url hasPrefix:@"https://"]) {
-        return url;
-    }
-
-    // 如果是相对路径
-    if ([url hasPrefix:@"/"]) {
-        // 提取baseURL的scheme和host
-        NSURL *base = [NSURL URLWithString:baseURL];
-        if (base) {
-            return [NSString stringWithFormat:@"%@://%@%@", base.scheme, base.host, url];
-        }
-    }
-
-    // 相对于当前页面的路径
-    NSURL *base = [NSURL URLWithString:baseURL];
-    if (base) {
-        NSURL *full = [NSURL URLWithString:url relativeToURL:base];
-        return full.absoluteString;
-    }
-
-    return url;
-}
+#pragma mark - 辅助方法
 
 - (NSDictionary *)parseHeaders:(NSString *)headerString {
     if (!headerString || headerString.length == 0) {
@@ -439,7 +570,60 @@
         return nil;
     }
 
-    return self.chapterListCache[book.bookUrl];
+    MetricsSource source = [MetricsRegistry sourceWithName:book.bookSourceName host:nil];
+    NSArray<ChapterModel *> *chapters = self.chapterListCache[book.bookUrl];
+    if (chapters) {
+        MetricsCount(source, MetricCounterTocCacheHit, 1);
+        return chapters;
+    }
+
+    // ⭐ 内存中没有时读取持久化目录（内存映射，章节按需解码）
+    chapters = [[ChapterListStore sharedStore] chapterListForBookUrl:book.bookUrl];
+    if (chapters) {
+        self.chapterListCache[book.bookUrl] = chapters;
+    }
+    MetricsCount(source, chapters ? MetricCounterTocCacheHit : MetricCounterTocCacheMiss, 1);
+    return chapters;
+}
+
+- (void)refreshChapterListForBook:(BookModel *)book
+                       bookSource:(BookSource *)bookSource
+                       completion:(void(^)(NSArray<ChapterModel *> *newChapters))completion {
+    if (!book.bookUrl || !bookSource) {
+        return;
+    }
+
+    NSString *bookUrl = book.bookUrl;
+    [[NetworkManager sharedManager] GET:[SourceResponseParser fullURL:bookUrl baseURL:bookSource.bookSourceUrl]
+                                headers:[self parseHeaders:bookSource.header]
+                               encoding:nil
+                                success:^(NSData *data, NSString *html) {
+        [self parseTocUrl:html
+               bookUrl:[SourceResponseParser fullURL:bookUrl baseURL:bookSource.bookSourceUrl]
+            bookSource:bookSource
+         aroundChapter:0
+                 batch:nil
+               success:^(NSString *tocUrl, NSArray<ChapterModel *> *chapters) {
+            if (chapters.count == 0) {
+                return;
+            }
+            // 只对比尾部，返回新增章节
+            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), ^{
+                NSArray<ChapterModel *> *newChapters = [[ChapterListStore sharedStore] reconcileChapterList:chapters forBookUrl:bookUrl];
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    self.chapterListCache[bookUrl] = chapters;
+                    if (completion) {
+                        completion(newChapters);
+                    }
+                });
+            });
+        }
+               failure:^(NSError *error) {
+            NSLog(@"⚠️ 后台刷新目录失败: %@", error.localizedDescription);
+        }];
+    } failure:^(NSError *error) {
+        NSLog(@"⚠️ 后台刷新目录失败: %@", error.localizedDescription);
+    }];
 }
 
 @end
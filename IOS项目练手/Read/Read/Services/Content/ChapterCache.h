@@ -0,0 +1,81 @@
+//
+//  ChapterCache.h
+//  Read
+//
+//  章节内容缓存 - 全局共享，按字节预算淘汰，热层保存字符串、温层保存压缩数据
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 章节内容缓存
+ *
+ * 职责：
+ *   1. 按（书籍, 章节索引）缓存正文，阅读页和内容管理器共用同一份文本
+ *   2. 两级存储：
+ *      热层 - 解码后的 NSString，直接返回；
+ *      温层 - UTF-8 + LZFSE 压缩数据（中文正文约为热层的 1/3），命中时解压并提升回热层
+ *   3. 按字节预算淘汰：热层超出预算时最久未访问的章节压缩降级到温层，温层超出预算时丢弃
+ *   4. 系统内存紧张时自动收缩（警告：热层只留最近的章节；严重：全部清空）
+ *
+ * 说明：
+ *   哈希表 + 双向链表（节点即缓存条目）实现 LRU，查找、访问、插入、淘汰均为 O(1)。
+ *   线程安全，可以在后台线程读写。
+ *   离线缓存（BookContentManager）是持久化的全文，这里只是内存中的加速层。
+ *
+ * 使用示例：
+ *   ChapterCache *cache = [ChapterCache sharedCache];
+ *   [cache setContent:text forBook:book.bookUrl chapter:12];
+ *   NSString *content = [cache contentForBook:book.bookUrl chapter:12];   // 热层或温层命中，否则 nil
+ */
+@interface ChapterCache : NSObject
+
++ (instancetype)sharedCache;
+
+/**
+ * 字节预算（热层按 UTF-16 计算，温层按压缩后大小计算）
+ * 默认热层 8MB、温层 4MB；调小后立即淘汰
+ */
+@property (assign, nonatomic) NSUInteger hotByteLimit;
+@property (assign, nonatomic) NSUInteger warmByteLimit;
+
+/**
+ * 当前占用
+ */
+@property (assign, nonatomic, readonly) NSUInteger hotBytes;
+@property (assign, nonatomic, readonly) NSUInteger warmBytes;
+@property (assign, nonatomic, readonly) NSUInteger count;
+
+/**
+ * 获取章节内容（命中时标记为最近访问，温层命中会解压并提升到热层）
+ */
+- (nullable NSString *)contentForBook:(NSString *)bookId chapter:(NSInteger)chapterIndex;
+
+/**
+ * 读取但不算一次访问（不影响淘汰顺序，温层条目只解压出副本、不提升到热层）
+ * 用于统计字数、预分页等探测，避免把远处的章节一直留在缓存中
+ */
+- (nullable NSString *)peekContentForBook:(NSString *)bookId chapter:(NSInteger)chapterIndex;
+
+/**
+ * 是否已缓存（不影响淘汰顺序）
+ */
+- (BOOL)containsBook:(NSString *)bookId chapter:(NSInteger)chapterIndex;
+
+/**
+ * 缓存章节内容（空内容忽略），放入热层
+ */
+- (void)setContent:(NSString *)content forBook:(NSString *)bookId chapter:(NSInteger)chapterIndex;
+
+/**
+ * 移除
+ */
+- (void)removeContentForBook:(NSString *)bookId chapter:(NSInteger)chapterIndex;
+- (void)removeAllContentForBook:(NSString *)bookId;
+- (void)removeAllContent;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,365 @@
+//
+//  ChapterCache.m
+//  Read
+//
+//  章节内容缓存实现
+//
+
+#import "ChapterCache.h"
+#import <UIKit/UIKit.h>
+#include <compression.h>
+
+static const NSUInteger kDefaultHotByteLimit = 8 * 1024 * 1024;
+static const NSUInteger kDefaultWarmByteLimit = 4 * 1024 * 1024;
+
+#pragma mark - ChapterCacheEntry
+
+/**
+ * 缓存条目（同时是 LRU 链表节点）
+ * 链表指针不持有条目，条目由哈希表持有；从哈希表移除前必须先从链表摘下
+ */
+@interface ChapterCacheEntry : NSObject {
+@public
+    __unsafe_unretained ChapterCacheEntry *_prev;
+    __unsafe_unretained ChapterCacheEntry *_next;
+}
+@property (copy, nonatomic) NSString *key;
+@property (copy, nonatomic) NSString *bookId;
+@property (strong, nonatomic, nullable) NSString *text;        // 热层：解码后的文本
+@property (strong, nonatomic, nullable) NSData *compressed;    // 温层：LZFSE 压缩的 UTF-8
+@property (assign, nonatomic) NSUInteger utf8Length;           // 温层：解压后的长度
+@property (assign, nonatomic) NSUInteger cost;                 // 当前所在层的字节数
+@end
+
+@implementation ChapterCacheEntry
+@end
+
+/**
+ * 一层的 LRU 链表（头部最近访问）
+ */
+typedef struct {
+    __unsafe_unretained ChapterCacheEntry *head;
+    __unsafe_unretained ChapterCacheEntry *tail;
+    NSUInteger bytes;
+} ChapterCacheList;
+
+static void ChapterCacheListPushFront(ChapterCacheList *list, ChapterCacheEntry *entry) {
+    entry->_prev = nil;
+    entry->_next = list->head;
+    if (list->head) {
+        list->head->_prev = entry;
+    }
+    list->head = entry;
+    if (!list->tail) {
+        list->tail = entry;
+    }
+    list->bytes += entry.cost;
+}
+
+static void ChapterCacheListRemove(ChapterCacheList *list, ChapterCacheEntry *entry) {
+    if (entry->_prev) {
+        entry->_prev->_next = entry->_next;
+    } else {
+        list->head = entry->_next;
+    }
+    if (entry->_next) {
+        entry->_next->_prev = entry->_prev;
+    } else {
+        list->tail = entry->_prev;
+    }
+    entry->_prev = nil;
+    entry->_next = nil;
+    list->bytes -= entry.cost;
+}
+
+#pragma mark - ChapterCache
+
+@interface ChapterCache () {
+    ChapterCacheList _hot;
+    ChapterCacheList _warm;
+}
+@property (strong, nonatomic) NSMutableDictionary<NSString *, ChapterCacheEntry *> *entries;
+@property (strong, nonatomic) dispatch_source_t memoryPressureSource;
+@end
+
+@implementation ChapterCache
+
++ (instancetype)sharedCache {
+    static ChapterCache *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[self alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _entries = [NSMutableDictionary dictionary];
+        _hotByteLimit = kDefaultHotByteLimit;
+        _warmByteLimit = kDefaultWarmByteLimit;
+
+        // ⭐ 系统内存紧张时收缩
+        _memoryPressureSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0,
+                                                       DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL,
+                                                       dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+        __weak typeof(self) weakSelf = self;
+        dispatch_source_set_event_handler(_memoryPressureSource, ^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            unsigned long level = dispatch_source_get_data(strongSelf.memoryPressureSource);
+            [strongSelf handleMemoryPressure:(level & DISPATCH_MEMORYPRESSURE_CRITICAL) != 0];
+        });
+        dispatch_resume(_memoryPressureSource);
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(didReceiveMemoryWarning)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    dispatch_source_cancel(_memoryPressureSource);
+}
+
+#pragma mark - 属性
+
+- (NSUInteger)hotBytes {
+    @synchronized (self) {
+        return _hot.bytes;
+    }
+}
+
+- (NSUInteger)warmBytes {
+    @synchronized (self) {
+        return _warm.bytes;
+    }
+}
+
+- (NSUInteger)count {
+    @synchronized (self) {
+        return self.entries.count;
+    }
+}
+
+- (void)setHotByteLimit:(NSUInteger)hotByteLimit {
+    @synchronized (self) {
+        _hotByteLimit = hotByteLimit;
+        [self trimToHotBytes:_hotByteLimit warmBytes:_warmByteLimit];
+    }
+}
+
+- (void)setWarmByteLimit:(NSUInteger)warmByteLimit {
+    @synchronized (self) {
+        _warmByteLimit = warmByteLimit;
+        [self trimToHotBytes:_hotByteLimit warmBytes:_warmByteLimit];
+    }
+}
+
+#pragma mark - 读写
+
+- (nullable NSString *)contentForBook:(NSString *)bookId chapter:(NSInteger)chapterIndex {
+    if (bookId.length == 0) {
+        return nil;
+    }
+
+    @synchronized (self) {
+        ChapterCacheEntry *entry = self.entries[[self keyForBook:bookId chapter:chapterIndex]];
+        if (!entry) {
+            return nil;
+        }
+
+        // 热层命中：移到头部
+        if (entry.text) {
+            ChapterCacheListRemove(&_hot, entry);
+            ChapterCacheListPushFront(&_hot, entry);
+            return entry.text;
+        }
+
+        // ⭐ 温层命中：解压后提升到热层（解压失败说明数据损坏，直接丢弃）
+        ChapterCacheListRemove(&_warm, entry);
+        NSString *text = [self decompressEntry:entry];
+        if (!text) {
+            [self.entries removeObjectForKey:entry.key];
+            return nil;
+        }
+
+        entry.text = text;
+        entry.compressed = nil;
+        entry.cost = text.length * sizeof(unichar);
+        ChapterCacheListPushFront(&_hot, entry);
+        [self trimToHotBytes:self.hotByteLimit warmBytes:self.warmByteLimit];
+        return text;
+    }
+}
+
+- (nullable NSString *)peekContentForBook:(NSString *)bookId chapter:(NSInteger)chapterIndex {
+    if (bookId.length == 0) {
+        return nil;
+    }
+
+    @synchronized (self) {
+        ChapterCacheEntry *entry = self.entries[[self keyForBook:bookId chapter:chapterIndex]];
+        if (!entry) {
+            return nil;
+        }
+        return entry.text ?: [self decompressEntry:entry];
+    }
+}
+
+- (BOOL)containsBook:(NSString *)bookId chapter:(NSInteger)chapterIndex {
+    if (bookId.length == 0) {
+        return NO;
+    }
+
+    @synchronized (self) {
+        return self.entries[[self keyForBook:bookId chapter:chapterIndex]] != nil;
+    }
+}
+
+- (void)setContent:(NSString *)content forBook:(NSString *)bookId chapter:(NSInteger)chapterIndex {
+    if (content.length == 0 || bookId.length == 0) {
+        return;
+    }
+
+    @synchronized (self) {
+        NSString *key = [self keyForBook:bookId chapter:chapterIndex];
+        [self removeEntry:self.entries[key]];
+
+        ChapterCacheEntry *entry = [[ChapterCacheEntry alloc] init];
+        entry.key = key;
+        entry.bookId = bookId;
+        entry.text = [content copy];
+        entry.cost = content.length * sizeof(unichar);
+        self.entries[key] = entry;
+        ChapterCacheListPushFront(&_hot, entry);
+
+        [self trimToHotBytes:self.hotByteLimit warmBytes:self.warmByteLimit];
+    }
+}
+
+- (void)removeContentForBook:(NSString *)bookId chapter:(NSInteger)chapterIndex {
+    if (bookId.length == 0) {
+        return;
+    }
+
+    @synchronized (self) {
+        [self removeEntry:self.entries[[self keyForBook:bookId chapter:chapterIndex]]];
+    }
+}
+
+- (void)removeAllContentForBook:(NSString *)bookId {
+    @synchronized (self) {
+        for (ChapterCacheEntry *entry in self.entries.allValues) {
+            if ([entry.bookId isEqualToString:bookId]) {
+                [self removeEntry:entry];
+            }
+        }
+    }
+}
+
+- (void)removeAllContent {
+    @synchronized (self) {
+        _hot = (ChapterCacheList){0};
+        _warm = (ChapterCacheList){0};
+        [self.entries removeAllObjects];
+    }
+}
+
+#pragma mark - 内存紧张
+
+- (void)didReceiveMemoryWarning {
+    [self handleMemoryPressure:NO];
+}
+
+- (void)handleMemoryPressure:(BOOL)critical {
+    if (critical) {
+        [self removeAllContent];
+        NSLog(@"⚠️ ChapterCache: 内存严重不足，已清空章节缓存");
+        return;
+    }
+
+    // 热层只留最近的章节（其余压缩），温层减半
+    @synchronized (self) {
+        [self trimToHotBytes:self.hotByteLimit / 4 warmBytes:self.warmByteLimit / 2];
+    }
+}
+
+#pragma mark - 私有方法（调用方持有锁）
+
+- (NSString *)keyForBook:(NSString *)bookId chapter:(NSInteger)chapterIndex {
+    return [NSString stringWithFormat:@"%ld|%@", (long)chapterIndex, bookId];
+}
+
+- (void)removeEntry:(nullable ChapterCacheEntry *)entry {
+    if (!entry) {
+        return;
+    }
+    ChapterCacheListRemove(entry.text ? &_hot : &_warm, entry);
+    [self.entries removeObjectForKey:entry.key];
+}
+
+/**
+ * 淘汰：热层尾部压缩降级到温层头部，温层尾部丢弃
+ */
+- (void)trimToHotBytes:(NSUInteger)hotBytes warmBytes:(NSUInteger)warmBytes {
+    while (_hot.bytes > hotBytes && _hot.tail) {
+        ChapterCacheEntry *entry = _hot.tail;
+        ChapterCacheListRemove(&_hot, entry);
+
+        if (![self compressEntry:entry]) {
+            [self.entries removeObjectForKey:entry.key];
+            continue;
+        }
+        ChapterCacheListPushFront(&_warm, entry);
+    }
+
+    while (_warm.bytes > warmBytes && _warm.tail) {
+        ChapterCacheEntry *entry = _warm.tail;
+        ChapterCacheListRemove(&_warm, entry);
+        [self.entries removeObjectForKey:entry.key];
+    }
+}
+
+/**
+ * 压缩条目文本（成功后条目处于温层状态，cost 为压缩后大小）
+ */
+- (BOOL)compressEntry:(ChapterCacheEntry *)entry {
+    NSData *utf8 = [entry.text dataUsingEncoding:NSUTF8StringEncoding];
+    if (utf8.length == 0) {
+        return NO;
+    }
+
+    // 压缩后比原文还大时没有保留的意义，按失败处理
+    NSMutableData *buffer = [NSMutableData dataWithLength:utf8.length];
+    size_t size = compression_encode_buffer(buffer.mutableBytes, buffer.length,
+                                            utf8.bytes, utf8.length,
+                                            NULL, COMPRESSION_LZFSE);
+    if (size == 0) {
+        return NO;
+    }
+    buffer.length = size;
+
+    entry.compressed = buffer;
+    entry.utf8Length = utf8.length;
+    entry.text = nil;
+    entry.cost = size;
+    return YES;
+}
+
+- (nullable NSString *)decompressEntry:(ChapterCacheEntry *)entry {
+    NSMutableData *utf8 = [NSMutableData dataWithLength:entry.utf8Length];
+    size_t size = compression_decode_buffer(utf8.mutableBytes, utf8.length,
+                                            entry.compressed.bytes, entry.compressed.length,
+                                            NULL, COMPRESSION_LZFSE);
+    if (size != entry.utf8Length) {
+        NSLog(@"❌ ChapterCache: 解压失败 %@", entry.key);
+        return nil;
+    }
+    return [[NSString alloc] initWithData:utf8 encoding:NSUTF8StringEncoding];
+}
+
+@end
@@ -0,0 +1,110 @@
+//
+//  ChapterOffsetIndex.h
+//  Read
+//
+//  章节偏移索引 - 垂直模式下按章节高度前缀和定位章节（不依赖 UIKit）
+//
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 章节偏移索引
+ *
+ * 职责：
+ *   1. 保存一段连续章节的高度，章节起始位置 = 顶部留白 + 之前所有章节高度之和
+ *   2. 按滚动位置查找章节、按章节查找起始位置，均为 O(log n)
+ *   3. 章节高度重新测量、向后追加、向前插入章节，均为 O(log n)（追加/插入为均摊）
+ *   4. 移除首尾章节（滑动窗口淘汰），多数情况 O(1)，移除锚点章节时按剩余章节重建
+ *
+ * 说明：
+ *   内部是两棵树状数组（Fenwick tree）：一棵存锚点章节及之后追加的章节，
+ *   一棵按倒序存向前插入的章节，向前插入时无需移动已有数据。
+ *   只在一个线程中使用（垂直模式下为主线程）。
+ *
+ * 使用示例：
+ *   ChapterOffsetIndex *index = [[ChapterOffsetIndex alloc] init];
+ *   index.topInset = 10;
+ *   [index appendChapter:12 height:3200];
+ *   [index appendChapter:13 height:2800];
+ *   NSInteger chapter = [index chapterAtOffset:scrollView.contentOffset.y];   // 12 或 13
+ */
+@interface ChapterOffsetIndex : NSObject
+
+/**
+ * 第一章之前的留白（第一章的起始位置）
+ */
+@property (assign, nonatomic) CGFloat topInset;
+
+/**
+ * 章节数
+ */
+@property (assign, nonatomic, readonly) NSUInteger count;
+
+/**
+ * 第一章 / 最后一章的章节索引（为空时为 -1）
+ */
+@property (assign, nonatomic, readonly) NSInteger firstChapterIndex;
+@property (assign, nonatomic, readonly) NSInteger lastChapterIndex;
+
+/**
+ * 所有章节的高度之和（不含顶部留白）
+ */
+@property (assign, nonatomic, readonly) CGFloat totalHeight;
+
+/**
+ * 是否包含章节
+ */
+- (BOOL)containsChapter:(NSInteger)chapterIndex;
+
+/**
+ * 在末尾追加章节（为空时成为第一章；与最后一章不相邻时先清空）
+ */
+- (void)appendChapter:(NSInteger)chapterIndex height:(CGFloat)height;
+
+/**
+ * 在开头插入章节，之后所有章节的起始位置下移 height（与第一章不相邻时先清空）
+ */
+- (void)prependChapter:(NSInteger)chapterIndex height:(CGFloat)height;
+
+/**
+ * 移除第一章，之后所有章节的起始位置上移其高度（顶部留白不变）
+ */
+- (void)removeFirstChapter;
+
+/**
+ * 移除最后一章
+ */
+- (void)removeLastChapter;
+
+/**
+ * 更新章节高度（重新测量后），之后所有章节的起始位置随之移动
+ */
+- (void)setHeight:(CGFloat)height forChapter:(NSInteger)chapterIndex;
+
+/**
+ * 章节高度（不包含时返回 0）
+ */
+- (CGFloat)heightForChapter:(NSInteger)chapterIndex;
+
+/**
+ * 章节起始位置（不包含时返回 0）
+ */
+- (CGFloat)offsetForChapter:(NSInteger)chapterIndex;
+
+/**
+ * 查找滚动位置所在的章节
+ * @return 章节索引；在第一章之前返回第一章，超出末尾返回最后一章，为空返回 -1
+ */
+- (NSInteger)chapterAtOffset:(CGFloat)offset;
+
+/**
+ * 清空（顶部留白保持不变）
+ */
+- (void)removeAllChapters;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,256 @@
+//
+//  ChapterOffsetIndex.m
+//  Read
+//
+//  章节偏移索引实现
+//
+
+#import "ChapterOffsetIndex.h"
+
+#pragma mark - 树状数组
+
+typedef struct {
+    double *tree;         // 下标从 1 开始，tree[i] 为 (i - lowbit(i), i] 区间之和
+    double *values;       // 下标从 0 开始，每个元素的原值
+    NSUInteger count;
+    NSUInteger capacity;
+} OffsetFenwick;
+
+static inline NSUInteger OffsetFenwickLowBit(NSUInteger i) {
+    return i & (~i + 1);
+}
+
+static void OffsetFenwickReserve(OffsetFenwick *fenwick, NSUInteger capacity) {
+    if (capacity <= fenwick->capacity) {
+        return;
+    }
+    NSUInteger newCapacity = MAX(capacity, MAX((NSUInteger)16, fenwick->capacity * 2));
+    fenwick->tree = realloc(fenwick->tree, (newCapacity + 1) * sizeof(double));
+    fenwick->values = realloc(fenwick->values, newCapacity * sizeof(double));
+    fenwick->capacity = newCapacity;
+}
+
+static void OffsetFenwickFree(OffsetFenwick *fenwick) {
+    free(fenwick->tree);
+    free(fenwick->values);
+    memset(fenwick, 0, sizeof(*fenwick));
+}
+
+// 前 n 个元素之和
+static double OffsetFenwickPrefix(const OffsetFenwick *fenwick, NSUInteger n) {
+    double sum = 0;
+    for (NSUInteger i = n; i > 0; i -= OffsetFenwickLowBit(i)) {
+        sum += fenwick->tree[i];
+    }
+    return sum;
+}
+
+static void OffsetFenwickAdd(OffsetFenwick *fenwick, NSUInteger position, double delta) {
+    for (NSUInteger i = position + 1; i <= fenwick->count; i += OffsetFenwickLowBit(i)) {
+        fenwick->tree[i] += delta;
+    }
+}
+
+static void OffsetFenwickPush(OffsetFenwick *fenwick, double value) {
+    OffsetFenwickReserve(fenwick, fenwick->count + 1);
+    NSUInteger i = ++fenwick->count;
+    fenwick->values[i - 1] = value;
+    // ⭐ 新节点覆盖的区间中，除自身外的元素都已在树中，两次前缀和即可求出
+    fenwick->tree[i] = value + OffsetFenwickPrefix(fenwick, i - 1) - OffsetFenwickPrefix(fenwick, i - OffsetFenwickLowBit(i));
+}
+
+// 前缀和不超过 value（strict 时为小于 value）的最大元素个数，要求所有元素非负
+static NSUInteger OffsetFenwickSearch(const OffsetFenwick *fenwick, double value, BOOL strict) {
+    NSUInteger step = 1;
+    while (step * 2 <= fenwick->count) {
+        step *= 2;
+    }
+
+    NSUInteger position = 0;
+    for (; step > 0 && fenwick->count > 0; step /= 2) {
+        NSUInteger next = position + step;
+        if (next > fenwick->count) {
+            continue;
+        }
+        double node = fenwick->tree[next];
+        if (strict ? node < value : node <= value) {
+            position = next;
+            value -= node;
+        }
+    }
+    return position;
+}
+
+#pragma mark - ChapterOffsetIndex
+
+@implementation ChapterOffsetIndex {
+    OffsetFenwick _forward;     // 锚点章节及之后追加的章节
+    OffsetFenwick _backward;    // 向前插入的章节，下标 0 为锚点前一章
+    NSInteger _anchorChapter;   // _forward 第 0 个元素对应的章节
+}
+
+- (void)dealloc {
+    OffsetFenwickFree(&_forward);
+    OffsetFenwickFree(&_backward);
+}
+
+#pragma mark - 属性
+
+- (NSUInteger)count {
+    return _forward.count + _backward.count;
+}
+
+- (NSInteger)firstChapterIndex {
+    return self.count > 0 ? _anchorChapter - (NSInteger)_backward.count : -1;
+}
+
+- (NSInteger)lastChapterIndex {
+    return self.count > 0 ? _anchorChapter + (NSInteger)_forward.count - 1 : -1;
+}
+
+- (CGFloat)totalHeight {
+    return OffsetFenwickPrefix(&_backward, _backward.count) + OffsetFenwickPrefix(&_forward, _forward.count);
+}
+
+- (BOOL)containsChapter:(NSInteger)chapterIndex {
+    return self.count > 0 && chapterIndex >= self.firstChapterIndex && chapterIndex <= self.lastChapterIndex;
+}
+
+#pragma mark - 修改
+
+- (void)appendChapter:(NSInteger)chapterIndex height:(CGFloat)height {
+    if (self.count > 0 && chapterIndex != self.lastChapterIndex + 1) {
+        [self removeAllChapters];
+    }
+    if (self.count == 0) {
+        _anchorChapter = chapterIndex;
+    }
+    OffsetFenwickPush(&_forward, MAX(height, 0));
+}
+
+- (void)prependChapter:(NSInteger)chapterIndex height:(CGFloat)height {
+    if (self.count == 0 || chapterIndex != self.firstChapterIndex - 1) {
+        [self removeAllChapters];
+        [self appendChapter:chapterIndex height:height];
+        return;
+    }
+    OffsetFenwickPush(&_backward, MAX(height, 0));
+}
+
+- (void)removeFirstChapter {
+    if (self.count == 0) {
+        return;
+    }
+    if (_backward.count > 0) {
+        // 树状数组去掉最后一个元素后，前面的节点不受影响
+        _backward.count--;
+        return;
+    }
+    [self rebuildFromChapter:_anchorChapter + 1 toChapter:self.lastChapterIndex];
+}
+
+- (void)removeLastChapter {
+    if (self.count == 0) {
+        return;
+    }
+    if (_forward.count > 1 || _backward.count == 0) {
+        _forward.count--;
+        return;
+    }
+    [self rebuildFromChapter:self.firstChapterIndex toChapter:_anchorChapter - 1];
+}
+
+- (void)setHeight:(CGFloat)height forChapter:(NSInteger)chapterIndex {
+    if (![self containsChapter:chapterIndex]) {
+        return;
+    }
+
+    // 向前插入的章节变高时，锚点之后的章节整体下移，而它自身及之前章节的位置不变
+    OffsetFenwick *fenwick = chapterIndex >= _anchorChapter ? &_forward : &_backward;
+    NSUInteger position = [self positionForChapter:chapterIndex];
+    double value = MAX(height, 0);
+    double delta = value - fenwick->values[position];
+    if (delta == 0) {
+        return;
+    }
+    fenwick->values[position] = value;
+    OffsetFenwickAdd(fenwick, position, delta);
+}
+
+- (void)removeAllChapters {
+    _forward.count = 0;
+    _backward.count = 0;
+    _anchorChapter = 0;
+}
+
+#pragma mark - 查询
+
+- (CGFloat)heightForChapter:(NSInteger)chapterIndex {
+    if (![self containsChapter:chapterIndex]) {
+        return 0;
+    }
+    const OffsetFenwick *fenwick = chapterIndex >= _anchorChapter ? &_forward : &_backward;
+    return fenwick->values[[self positionForChapter:chapterIndex]];
+}
+
+- (CGFloat)offsetForChapter:(NSInteger)chapterIndex {
+    if (![self containsChapter:chapterIndex]) {
+        return 0;
+    }
+
+    double backwardTotal = OffsetFenwickPrefix(&_backward, _backward.count);
+    NSUInteger position = [self positionForChapter:chapterIndex];
+    if (chapterIndex >= _anchorChapter) {
+        return self.topInset + backwardTotal + OffsetFenwickPrefix(&_forward, position);
+    }
+    // 锚点位置减去从该章到锚点前一章的高度
+    return self.topInset + backwardTotal - OffsetFenwickPrefix(&_backward, position + 1);
+}
+
+- (NSInteger)chapterAtOffset:(CGFloat)offset {
+    if (self.count == 0) {
+        return -1;
+    }
+
+    double backwardTotal = OffsetFenwickPrefix(&_backward, _backward.count);
+    double relative = offset - self.topInset;
+
+    if (relative >= backwardTotal || _backward.count == 0) {
+        // 起始位置不超过 offset 的最后一章（完全位于 offset 之前的章节数即为其下标）
+        NSUInteger position = OffsetFenwickSearch(&_forward, relative - backwardTotal, NO);
+        position = MIN(position, _forward.count - 1);
+        return _anchorChapter + (NSInteger)position;
+    }
+
+    // ⭐ 锚点之前：找到从锚点往上累计高度首次达到距离的章节
+    double distance = backwardTotal - relative;
+    NSUInteger position = OffsetFenwickSearch(&_backward, distance, YES);
+    position = MIN(position, _backward.count - 1);
+    return _anchorChapter - 1 - (NSInteger)position;
+}
+
+#pragma mark - 私有方法
+
+// 只保留 [first, last] 范围内的章节，全部放入 _forward 重建（锚点章节被移除时使用，窗口内章节很少）
+- (void)rebuildFromChapter:(NSInteger)first toChapter:(NSInteger)last {
+    NSUInteger keepCount = last >= first ? (NSUInteger)(last - first + 1) : 0;
+    double *heights = keepCount > 0 ? malloc(keepCount * sizeof(double)) : NULL;
+    for (NSUInteger i = 0; i < keepCount; i++) {
+        heights[i] = [self heightForChapter:first + (NSInteger)i];
+    }
+
+    [self removeAllChapters];
+    for (NSUInteger i = 0; i < keepCount; i++) {
+        [self appendChapter:first + (NSInteger)i height:heights[i]];
+    }
+    free(heights);
+}
+
+- (NSUInteger)positionForChapter:(NSInteger)chapterIndex {
+    if (chapterIndex >= _anchorChapter) {
+        return (NSUInteger)(chapterIndex - _anchorChapter);
+    }
+    return (NSUInteger)(_anchorChapter - 1 - chapterIndex);
+}
+
+@end
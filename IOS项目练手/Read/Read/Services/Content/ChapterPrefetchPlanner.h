@@ -0,0 +1,102 @@
+//
+//  ChapterPrefetchPlanner.h
+//  Read
+//
+//  章节预取规划器 - 按阅读速度和书源延迟决定预取多少章、何时预取
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 章节预取规划器
+ *
+ * 职责：
+ *   1. 估计阅读速度：章节切换时按上一章字数 / 停留时间更新（指数滑动平均），
+ *      样本不足时使用 ReadingStatsManager 的本次会话阅读速度
+ *   2. 估计书源延迟：记录每次预取的耗时，按书源保存（同一书源的阅读页之间共享）
+ *   3. 规划预取范围：向后预取的章数足够覆盖 kPrefetchHorizon 秒的阅读时间，
+ *      慢速书源多留余量（1 ~ 6 章）；最近向前翻过章节时再向前预取 1 章
+ *   4. 调度：同一时间只有一个预取请求，有前台加载时暂停，前台加载结束后继续
+ *
+ * 说明：
+ *   规划器不直接请求网络，具体的加载由 fetchBlock 完成（读缓存、请求、写缓存）。
+ *   已在内存或离线缓存中的章节通过 availabilityBlock 跳过。
+ *   只在主线程使用（调试构建下会断言）；fetchBlock 的完成回调可以在任意线程调用，规划器会回到主线程处理。
+ *
+ * 使用示例：
+ *   ChapterPrefetchPlanner *planner = [[ChapterPrefetchPlanner alloc] initWithChapterCount:chapters.count
+ *                                                                               sourceKey:bookSource.bookSourceUrl];
+ *   planner.availabilityBlock = ^BOOL(NSInteger index) { return cache[@(index)] != nil; };
+ *   planner.fetchBlock = ^(NSInteger index, void (^done)(BOOL success)) { ... done(YES); };
+ *   [planner readerDidEnterChapter:12 wordCount:3200];   // 章节切换时调用，会重新规划并开始预取
+ *
+ *   [planner beginForegroundFetch];                      // 前台加载期间预取让路
+ *   ... [planner endForegroundFetch];
+ */
+@interface ChapterPrefetchPlanner : NSObject
+
+/**
+ * 初始化
+ * @param chapterCount 章节总数
+ * @param sourceKey 书源标识（用于区分书源延迟，可以为空）
+ */
+- (instancetype)initWithChapterCount:(NSInteger)chapterCount
+                           sourceKey:(nullable NSString *)sourceKey NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * 章节是否已可用（内存或离线缓存），可用的章节不会预取
+ */
+@property (copy, nonatomic, nullable) BOOL (^availabilityBlock)(NSInteger chapterIndex);
+
+/**
+ * 加载一章（结束后调用 completion，可以在任意线程）
+ */
+@property (copy, nonatomic, nullable) void (^fetchBlock)(NSInteger chapterIndex, void (^completion)(BOOL success));
+
+/**
+ * 当前规划（最近一次 planAroundChapter: 的结果）
+ */
+@property (assign, nonatomic, readonly) NSInteger aheadCount;     // 向后预取章数
+@property (assign, nonatomic, readonly) NSInteger behindCount;    // 向前预取章数
+
+/**
+ * 当前估计（没有样本时为 0）
+ */
+@property (assign, nonatomic, readonly) double wordsPerSecond;           // 阅读速度（字/秒）
+@property (assign, nonatomic, readonly) NSTimeInterval sourceLatency;    // 书源单章加载耗时（秒）
+
+/**
+ * 进入章节：更新阅读速度，重新规划并开始预取
+ * @param chapterIndex 进入的章节
+ * @param wordCount 该章字数（未知时为 0）
+ */
+- (void)readerDidEnterChapter:(NSInteger)chapterIndex wordCount:(NSUInteger)wordCount;
+
+/**
+ * 以指定章节为中心重新规划并开始预取（不更新阅读速度，用于加载完成后补齐预取）
+ */
+- (void)planAroundChapter:(NSInteger)chapterIndex;
+
+/**
+ * 前台加载开始 / 结束（成对调用；期间不发起新的预取）
+ */
+- (void)beginForegroundFetch;
+- (void)endForegroundFetch;
+
+/**
+ * 记录一次书源加载耗时（前台加载也可以上报，用于估计延迟；线程安全）
+ */
+- (void)recordFetchLatency:(NSTimeInterval)latency;
+
+/**
+ * 停止预取（正在进行的请求完成后不再继续）
+ */
+- (void)cancel;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,263 @@
+//
+//  ChapterPrefetchPlanner.m
+//  Read
+//
+//  章节预取规划器实现
+//
+
+#import "ChapterPrefetchPlanner.h"
+#import "ReadingStatsManager.h"
+
+// 规划参数
+static const NSTimeInterval kPrefetchHorizon = 180;       // 预取的章节覆盖多少秒的阅读时间
+static const NSInteger kMinAheadCount = 1;
+static const NSInteger kMaxAheadCount = 6;
+static const NSInteger kDefaultAheadCount = 2;            // 还没有阅读速度时向后预取的章数
+static const NSTimeInterval kSlowSourceLatency = 2.0;     // 超过此耗时的书源多预取 1 章
+static const double kDefaultChapterWords = 3000;          // 还没有字数样本时的章节字数
+
+// 估计参数
+static const double kSmoothingFactor = 0.3;               // 指数滑动平均：新样本的权重
+static const NSTimeInterval kMinChapterDwell = 5;         // 停留不足 5 秒视为跳过，不计入阅读速度
+static const NSTimeInterval kMaxChapterDwell = 30 * 60;   // 停留超过 30 分钟视为离开，不计入阅读速度
+
+@interface ChapterPrefetchPlanner ()
+@property (assign, nonatomic) NSInteger chapterCount;
+@property (copy, nonatomic) NSString *sourceKey;
+
+// 阅读速度
+@property (assign, nonatomic, readwrite) double wordsPerSecond;
+@property (assign, nonatomic) double averageChapterWords;
+@property (assign, nonatomic) NSInteger lastChapterIndex;         // 上一次进入的章节（-1 表示没有）
+@property (assign, nonatomic) NSUInteger lastChapterWords;
+@property (assign, nonatomic) CFAbsoluteTime lastChapterEnterTime;
+@property (assign, nonatomic) BOOL isReadingBackward;             // 最近一次切换是否向前翻
+
+// 规划和调度
+@property (assign, nonatomic, readwrite) NSInteger aheadCount;
+@property (assign, nonatomic, readwrite) NSInteger behindCount;
+@property (strong, nonatomic) NSMutableArray<NSNumber *> *queue;  // 待预取的章节（近的在前）
+@property (strong, nonatomic) NSMutableSet<NSNumber *> *failedChapters;
+@property (assign, nonatomic) NSInteger inFlightChapter;           // 正在预取的章节（-1 表示没有）
+@property (assign, nonatomic) NSInteger foregroundCount;
+@property (assign, nonatomic) BOOL isCancelled;
+@end
+
+// ⭐ 规划和调度状态没有加锁，只允许在主线程访问
+#define PrefetchAssertMainThread() NSAssert([NSThread isMainThread], @"ChapterPrefetchPlanner 只能在主线程使用")
+
+@implementation ChapterPrefetchPlanner
+
+- (instancetype)initWithChapterCount:(NSInteger)chapterCount sourceKey:(nullable NSString *)sourceKey {
+    self = [super init];
+    if (self) {
+        _chapterCount = chapterCount;
+        _sourceKey = [sourceKey copy] ?: @"";
+        _averageChapterWords = kDefaultChapterWords;
+        _lastChapterIndex = -1;
+        _aheadCount = kDefaultAheadCount;
+        _queue = [NSMutableArray array];
+        _failedChapters = [NSMutableSet set];
+        _inFlightChapter = -1;
+    }
+    return self;
+}
+
+#pragma mark - 书源延迟（按书源共享）
+
++ (NSMutableDictionary<NSString *, NSNumber *> *)sourceLatencies {
+    static NSMutableDictionary *latencies;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        latencies = [NSMutableDictionary dictionary];
+    });
+    return latencies;
+}
+
+- (NSTimeInterval)sourceLatency {
+    NSMutableDictionary *latencies = [ChapterPrefetchPlanner sourceLatencies];
+    @synchronized (latencies) {
+        return [latencies[self.sourceKey] doubleValue];
+    }
+}
+
+// 书源延迟按书源共享，加锁后可以在任意线程上报
+- (void)recordFetchLatency:(NSTimeInterval)latency {
+    if (latency <= 0) {
+        return;
+    }
+
+    NSMutableDictionary *latencies = [ChapterPrefetchPlanner sourceLatencies];
+    @synchronized (latencies) {
+        NSNumber *current = latencies[self.sourceKey];
+        double value = current ? current.doubleValue + kSmoothingFactor * (latency - current.doubleValue) : latency;
+        latencies[self.sourceKey] = @(value);
+    }
+}
+
+#pragma mark - 阅读速度
+
+- (void)readerDidEnterChapter:(NSInteger)chapterIndex wordCount:(NSUInteger)wordCount {
+    PrefetchAssertMainThread();
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+
+    if (self.lastChapterIndex >= 0 && chapterIndex != self.lastChapterIndex) {
+        // ⭐ 顺序读完上一章才是有效样本（跳章、回翻不计入速度）
+        NSTimeInterval dwell = now - self.lastChapterEnterTime;
+        if (chapterIndex == self.lastChapterIndex + 1 && self.lastChapterWords > 0 &&
+            dwell >= kMinChapterDwell && dwell <= kMaxChapterDwell) {
+            double sample = self.lastChapterWords / dwell;
+            self.wordsPerSecond = self.wordsPerSecond > 0
+                ? self.wordsPerSecond + kSmoothingFactor * (sample - self.wordsPerSecond)
+                : sample;
+        }
+        self.isReadingBackward = chapterIndex < self.lastChapterIndex;
+        [self.failedChapters removeAllObjects];
+    }
+
+    if (wordCount > 0) {
+        self.averageChapterWords += kSmoothingFactor * (wordCount - self.averageChapterWords);
+    }
+
+    self.lastChapterIndex = chapterIndex;
+    self.lastChapterWords = wordCount;
+    self.lastChapterEnterTime = now;
+
+    [self planAroundChapter:chapterIndex];
+}
+
+/**
+ * 用于规划的阅读速度：优先使用本阅读页的章节样本，其次使用本次会话的统计
+ */
+- (double)effectiveWordsPerSecond {
+    if (self.wordsPerSecond > 0) {
+        return self.wordsPerSecond;
+    }
+    return [[ReadingStatsManager sharedManager] currentReadingSpeed];
+}
+
+#pragma mark - 规划
+
+- (void)planAroundChapter:(NSInteger)chapterIndex {
+    PrefetchAssertMainThread();
+    if (chapterIndex < 0 || chapterIndex >= self.chapterCount) {
+        return;
+    }
+
+    NSTimeInterval latency = self.sourceLatency;
+    double speed = [self effectiveWordsPerSecond];
+
+    // ⭐ 向后预取的章数：读完这些章节的时间 >= 预取视野 + 加载它们的时间
+    NSInteger ahead = kDefaultAheadCount;
+    if (speed > 0) {
+        NSTimeInterval secondsPerChapter = MAX(self.averageChapterWords / speed, 1);
+        ahead = (NSInteger)ceil((kPrefetchHorizon + 2 * latency) / secondsPerChapter);
+    }
+    if (latency > kSlowSourceLatency) {
+        ahead += 1;
+    }
+    self.aheadCount = MIN(MAX(ahead, kMinAheadCount), kMaxAheadCount);
+    self.behindCount = self.isReadingBackward ? 1 : 0;
+
+    // 近的章节优先：先向后，再向前
+    [self.queue removeAllObjects];
+    for (NSInteger i = 1; i <= self.aheadCount; i++) {
+        [self enqueueChapter:chapterIndex + i];
+    }
+    for (NSInteger i = 1; i <= self.behindCount; i++) {
+        [self enqueueChapter:chapterIndex - i];
+    }
+
+    [self pump];
+}
+
+- (void)enqueueChapter:(NSInteger)chapterIndex {
+    if (chapterIndex < 0 || chapterIndex >= self.chapterCount ||
+        chapterIndex == self.inFlightChapter ||
+        [self.failedChapters containsObject:@(chapterIndex)] ||
+        [self isChapterAvailable:chapterIndex]) {
+        return;
+    }
+    [self.queue addObject:@(chapterIndex)];
+}
+
+- (BOOL)isChapterAvailable:(NSInteger)chapterIndex {
+    return self.availabilityBlock && self.availabilityBlock(chapterIndex);
+}
+
+#pragma mark - 调度
+
+- (void)beginForegroundFetch {
+    PrefetchAssertMainThread();
+    self.foregroundCount += 1;
+}
+
+- (void)endForegroundFetch {
+    PrefetchAssertMainThread();
+    self.foregroundCount = MAX(self.foregroundCount - 1, 0);
+    if (self.foregroundCount == 0) {
+        [self pump];
+    }
+}
+
+- (void)cancel {
+    PrefetchAssertMainThread();
+    self.isCancelled = YES;
+    [self.queue removeAllObjects];
+}
+
+/**
+ * 发起下一个预取（一次只有一个，前台加载期间不发起）
+ */
+- (void)pump {
+    if (self.isCancelled || !self.fetchBlock ||
+        self.inFlightChapter >= 0 || self.foregroundCount > 0) {
+        return;
+    }
+
+    NSInteger chapterIndex = -1;
+    while (self.queue.count > 0) {
+        NSInteger candidate = self.queue.firstObject.integerValue;
+        [self.queue removeObjectAtIndex:0];
+        // 排队期间可能已被前台加载
+        if (![self isChapterAvailable:candidate]) {
+            chapterIndex = candidate;
+            break;
+        }
+    }
+    if (chapterIndex < 0) {
+        return;
+    }
+
+    self.inFlightChapter = chapterIndex;
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+
+    __weak typeof(self) weakSelf = self;
+    void (^finish)(BOOL) = ^(BOOL success) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf) {
+            return;
+        }
+
+        strongSelf.inFlightChapter = -1;
+        if (success) {
+            [strongSelf recordFetchLatency:CFAbsoluteTimeGetCurrent() - startTime];
+        } else {
+            [strongSelf.failedChapters addObject:@(chapterIndex)];
+        }
+        [strongSelf pump];
+    };
+
+    // 加载失败的回调可能在网络线程调用，统一回到主线程
+    self.fetchBlock(chapterIndex, ^(BOOL success) {
+        if ([NSThread isMainThread]) {
+            finish(success);
+        } else {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                finish(success);
+            });
+        }
+    });
+}
+
+@end
@@ -0,0 +1,80 @@
+//
+//  PaginationEngine.h
+//  Read
+//
+//  分页引擎 - 单遍扫描计算分页位置（不依赖 UIKit）
+//
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 排版参数（决定分页结果的全部输入）
+ */
+@interface PaginationLayout : NSObject <NSCopying>
+@property (copy, nonatomic, nullable) NSString *fontName;  // PostScript 名称，nil 表示系统字体
+@property (assign, nonatomic) CGFloat fontSize;            // 字号
+@property (assign, nonatomic) CGFloat lineSpacing;         // 行间距（行与行之间额外的距离）
+@property (assign, nonatomic) CGFloat paragraphSpacing;    // 段间距（换行符之后额外的距离）
+@property (assign, nonatomic) CGSize pageSize;             // 文本区域尺寸
+
+/**
+ * 便捷构造（系统字体，无额外行距）
+ */
++ (instancetype)layoutWithFontSize:(CGFloat)fontSize pageSize:(CGSize)pageSize;
+
+@end
+
+/**
+ * 分页引擎
+ *
+ * 职责：
+ *   1. 单遍扫描文本，逐字累加字宽折行，逐行累加行高分页
+ *   2. 按字体 + 字号缓存字宽表（汉字视为等宽，只查一次）
+ *   3. 折行遵循中文避头尾规则（标点不出现在行首，开引号不留在行尾），英文单词不拆开
+ *   4. 输出每页起始位置（UTF-16 下标）
+ *
+ * 说明：
+ *   只依赖 CoreText，可在命令行/单元测试中运行；
+ *   相比二分 + boundingRectWithSize，每页不再需要 O(log n) 次完整排版。
+ *
+ * 使用示例：
+ *   PaginationLayout *layout = [PaginationLayout layoutWithFontSize:17 pageSize:CGSizeMake(335, 600)];
+ *   NSArray<NSNumber *> *breaks = [[PaginationEngine sharedEngine] pageBreaksForText:content layout:layout];
+ *   // breaks[i] 是第 i 页的起始位置，第 i 页结束于 breaks[i + 1]（最后一页结束于 content.length）
+ */
+@interface PaginationEngine : NSObject
+
+// 单例（字宽缓存在所有调用方之间共享）
++ (instancetype)sharedEngine;
+
+/**
+ * 计算分页位置（线程安全）
+ * @param text 章节文本
+ * @param layout 排版参数
+ * @return 每页起始位置，至少包含一个元素 0（文本为空时返回空数组）
+ */
+- (NSArray<NSNumber *> *)pageBreaksForText:(NSString *)text layout:(PaginationLayout *)layout;
+
+/**
+ * 只对文本的一段分页（用于从阅读锚点开始的局部分页）
+ * @param range 分页范围，第一页从 range.location 开始，最后一页结束于范围末尾
+ * @param maxPages 最多计算的页数（0 表示到范围末尾）；提前停止时返回 maxPages + 1 个位置，
+ *                 最后一个是下一页的起始位置，即第 maxPages 页的结束位置
+ * @return 每页起始位置（章节内的绝对位置）
+ */
+- (NSArray<NSNumber *> *)pageBreaksForText:(NSString *)text
+                                    layout:(PaginationLayout *)layout
+                                     range:(NSRange)range
+                                  maxPages:(NSUInteger)maxPages;
+
+/**
+ * 清空字宽缓存（收到内存警告时调用）
+ */
+- (void)purgeMetricsCache;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,346 @@
+//
+//  PaginationEngine.m
+//  Read
+//
+//  分页引擎实现
+//
+
+#import "PaginationEngine.h"
+#import <CoreText/CoreText.h>
+#import "TraceRecorder.h"
+
+static const NSUInteger kPaginationMaxBacktrack = 32;   // 折行时最多回退的字符数（超过则强制断开）
+
+#pragma mark - PaginationLayout
+
+@implementation PaginationLayout
+
++ (instancetype)layoutWithFontSize:(CGFloat)fontSize pageSize:(CGSize)pageSize {
+    PaginationLayout *layout = [[PaginationLayout alloc] init];
+    layout.fontSize = fontSize;
+    layout.pageSize = pageSize;
+    return layout;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    PaginationLayout *copy = [[PaginationLayout allocWithZone:zone] init];
+    copy.fontName = self.fontName;
+    copy.fontSize = self.fontSize;
+    copy.lineSpacing = self.lineSpacing;
+    copy.paragraphSpacing = self.paragraphSpacing;
+    copy.pageSize = self.pageSize;
+    return copy;
+}
+
+- (BOOL)isEqual:(id)object {
+    if (![object isKindOfClass:[PaginationLayout class]]) {
+        return NO;
+    }
+    PaginationLayout *other = object;
+    return (self.fontName == other.fontName || [self.fontName isEqualToString:other.fontName]) &&
+           self.fontSize == other.fontSize &&
+           self.lineSpacing == other.lineSpacing &&
+           self.paragraphSpacing == other.paragraphSpacing &&
+           CGSizeEqualToSize(self.pageSize, other.pageSize);
+}
+
+- (NSUInteger)hash {
+    return self.fontName.hash ^ (NSUInteger)(self.fontSize * 1000) ^
+           ((NSUInteger)self.pageSize.width << 12) ^ ((NSUInteger)self.pageSize.height << 24);
+}
+
+@end
+
+#pragma mark - 字符分类
+
+static inline BOOL PaginationIsIdeograph(unichar c) {
+    return (c >= 0x4E00 && c <= 0x9FFF) || (c >= 0x3400 && c <= 0x4DBF) || (c >= 0xF900 && c <= 0xFAFF);
+}
+
+static inline BOOL PaginationIsSpace(unichar c) {
+    return c == ' ' || c == '\t' || c == 0x3000 || c == 0x00A0;
+}
+
+static inline BOOL PaginationIsWordChar(unichar c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '\'' || (c >= 0x00C0 && c <= 0x024F);
+}
+
+// 行首禁则：不能出现在行首的标点
+static inline BOOL PaginationIsNoStart(unichar c) {
+    switch (c) {
+        case 0xFF0C: case 0x3002: case 0x3001: case 0xFF1B: case 0xFF1A:   // ，。、；：
+        case 0xFF1F: case 0xFF01: case 0xFF09: case 0x300B: case 0x300D:   // ？！）》」
+        case 0x300F: case 0x3011: case 0x3015: case 0x3009: case 0x201D:   // 』】〕〉”
+        case 0x2019: case 0x2026: case 0x2014: case 0x00B7: case 0xFF5E:   // ’…—·～
+        case 0xFF3D: case 0xFF5D: case 0xFF0E:                             // ］｝．
+        case ',': case '.': case ';': case ':': case '?': case '!':
+        case ')': case ']': case '}': case '%':
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+// 行尾禁则：不能出现在行尾的标点
+static inline BOOL PaginationIsNoEnd(unichar c) {
+    switch (c) {
+        case 0xFF08: case 0x300A: case 0x300C: case 0x300E: case 0x3010:   // （《「『【
+        case 0x3014: case 0x3008: case 0x201C: case 0x2018: case 0xFF3B:   // 〔〈“‘［
+        case 0xFF5B:                                                       // ｛
+        case '(': case '[': case '{':
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+static inline BOOL PaginationCanBreakBefore(const unichar *chars, NSUInteger position) {
+    unichar previous = chars[position - 1];
+    unichar current = chars[position];
+
+    if (CFStringIsSurrogateLowCharacter(current) || PaginationIsSpace(current)) {
+        return NO;  // 空格挂在上一行末尾，代理对不拆开
+    }
+    if (PaginationIsNoStart(current) || PaginationIsNoEnd(previous)) {
+        return NO;
+    }
+    if (PaginationIsWordChar(previous) && PaginationIsWordChar(current)) {
+        return NO;  // 英文单词不拆开
+    }
+    return YES;
+}
+
+#pragma mark - 字宽表
+
+/**
+ * 单个字体 + 字号的度量缓存
+ * 字宽按 256 个码位一页延迟填充，已填充的页只读，读取无需加锁
+ */
+@interface PaginationFontMetrics : NSObject {
+@public
+    CTFontRef _font;
+    CGFloat _lineHeight;
+    CGFloat _ideographAdvance;
+    CGFloat _fallbackAdvance;
+    CGFloat *_pages[256];
+}
+- (instancetype)initWithFontName:(nullable NSString *)fontName size:(CGFloat)size;
+@end
+
+@implementation PaginationFontMetrics
+
+- (instancetype)initWithFontName:(nullable NSString *)fontName size:(CGFloat)size {
+    self = [super init];
+    if (self) {
+        _font = fontName.length > 0 ? CTFontCreateWithName((__bridge CFStringRef)fontName, size, NULL)
+                                    : CTFontCreateUIFontForLanguage(kCTFontUIFontSystem, size, NULL);
+        _lineHeight = ceil(CTFontGetAscent(_font) + CTFontGetDescent(_font) + CTFontGetLeading(_font));
+
+        // ⭐ 汉字几乎等宽：取“中”的字宽代表全部汉字，省去逐字查表
+        UniChar sample = 0x4E2D;
+        CGGlyph glyph = 0;
+        CGSize advance = CGSizeZero;
+        if (CTFontGetGlyphsForCharacters(_font, &sample, &glyph, 1)) {
+            CTFontGetAdvancesForGlyphs(_font, kCTFontOrientationHorizontal, &glyph, &advance, 1);
+        }
+        _ideographAdvance = advance.width > 0 ? advance.width : size;
+        _fallbackAdvance = size * 0.5;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    for (NSUInteger i = 0; i < 256; i++) {
+        free(_pages[i]);
+    }
+    if (_font) {
+        CFRelease(_font);
+    }
+}
+
+- (CGFloat *)fillPage:(NSUInteger)pageIndex {
+    @synchronized (self) {
+        CGFloat *existing = __atomic_load_n(&_pages[pageIndex], __ATOMIC_ACQUIRE);
+        if (existing) {
+            return existing;
+        }
+
+        UniChar characters[256];
+        CGGlyph glyphs[256];
+        CGSize advances[256];
+        for (NSUInteger i = 0; i < 256; i++) {
+            characters[i] = (UniChar)((pageIndex << 8) | i);
+        }
+        CTFontGetGlyphsForCharacters(_font, characters, glyphs, 256);
+        CTFontGetAdvancesForGlyphs(_font, kCTFontOrientationHorizontal, glyphs, advances, 256);
+
+        CGFloat *page = malloc(256 * sizeof(CGFloat));
+        for (NSUInteger i = 0; i < 256; i++) {
+            UniChar c = characters[i];
+            if (c < 0x20 || CFStringIsSurrogateLowCharacter(c)) {
+                page[i] = 0;
+            } else if (CFStringIsSurrogateHighCharacter(c)) {
+                page[i] = _ideographAdvance;   // 扩展区汉字、表情按全角计
+            } else if (glyphs[i] == 0) {
+                // 当前字体缺字，实际会走系统回退字体，按全角/半角估算
+                page[i] = c >= 0x2E80 ? _ideographAdvance : _fallbackAdvance;
+            } else {
+                page[i] = advances[i].width;
+            }
+        }
+
+        __atomic_store_n(&_pages[pageIndex], page, __ATOMIC_RELEASE);
+        return page;
+    }
+}
+
+static inline CGFloat PaginationAdvance(PaginationFontMetrics *metrics, unichar c) {
+    if (PaginationIsIdeograph(c)) {
+        return metrics->_ideographAdvance;
+    }
+    CGFloat *page = __atomic_load_n(&metrics->_pages[c >> 8], __ATOMIC_ACQUIRE);
+    if (!page) {
+        page = [metrics fillPage:c >> 8];
+    }
+    return page[c & 0xFF];
+}
+
+@end
+
+#pragma mark - PaginationEngine
+
+@interface PaginationEngine ()
+@property (strong, nonatomic) NSCache<NSString *, PaginationFontMetrics *> *metricsCache;
+@end
+
+@implementation PaginationEngine
+
++ (instancetype)sharedEngine {
+    static PaginationEngine *engine = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        engine = [[PaginationEngine alloc] init];
+    });
+    return engine;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _metricsCache = [[NSCache alloc] init];
+        _metricsCache.countLimit = 8;
+    }
+    return self;
+}
+
+- (PaginationFontMetrics *)metricsForLayout:(PaginationLayout *)layout {
+    NSString *key = [NSString stringWithFormat:@"%@|%.2f", layout.fontName ?: @"", layout.fontSize];
+    @synchronized (self) {
+        PaginationFontMetrics *metrics = [self.metricsCache objectForKey:key];
+        if (!metrics) {
+            metrics = [[PaginationFontMetrics alloc] initWithFontName:layout.fontName size:layout.fontSize];
+            [self.metricsCache setObject:metrics forKey:key];
+        }
+        return metrics;
+    }
+}
+
+- (void)purgeMetricsCache {
+    [self.metricsCache removeAllObjects];
+}
+
+#pragma mark - 分页
+
+- (NSArray<NSNumber *> *)pageBreaksForText:(NSString *)text layout:(PaginationLayout *)layout {
+    return [self pageBreaksForText:text layout:layout range:NSMakeRange(0, text.length) maxPages:0];
+}
+
+- (NSArray<NSNumber *> *)pageBreaksForText:(NSString *)text
+                                    layout:(PaginationLayout *)layout
+                                     range:(NSRange)range
+                                  maxPages:(NSUInteger)maxPages {
+    if (range.length == 0 || NSMaxRange(range) > text.length || layout.fontSize <= 0) {
+        return @[];
+    }
+
+    TRACE_SCOPE("paginate", "pageBreaks");
+
+    PaginationFontMetrics *metrics = [self metricsForLayout:layout];
+    CGFloat width = layout.pageSize.width;
+    CGFloat height = layout.pageSize.height;
+    CGFloat lineHeight = metrics->_lineHeight;
+    CGFloat lineSpacing = layout.lineSpacing;
+    CGFloat paragraphSpacing = layout.paragraphSpacing;
+
+    // 下标均相对于 range.location，输出时再换算成章节内的位置
+    NSUInteger length = range.length;
+    NSUInteger base = range.location;
+    unichar *chars = malloc(length * sizeof(unichar));
+    [text getCharacters:chars range:range];
+
+    NSMutableArray<NSNumber *> *breaks = [NSMutableArray arrayWithObject:@(base)];
+    __block CGFloat y = 0;               // 当前页已占用的高度
+    __block BOOL pageHasLines = NO;
+    __block BOOL finished = NO;          // 已达到 maxPages
+
+    // 放置一行：放不下时从该行开始新的一页
+    void (^placeLine)(NSUInteger, BOOL) = ^(NSUInteger start, BOOL endsParagraph) {
+        if (pageHasLines && y + lineHeight > height) {
+            [breaks addObject:@(base + start)];
+            y = 0;
+            if (maxPages > 0 && breaks.count > maxPages) {
+                finished = YES;
+                return;
+            }
+        }
+        y += lineHeight + lineSpacing + (endsParagraph ? paragraphSpacing : 0);
+        pageHasLines = YES;
+    };
+
+    NSUInteger lineStart = 0;
+    CGFloat x = 0;
+
+    for (NSUInteger i = 0; i < length && !finished; i++) {
+        unichar c = chars[i];
+
+        if (c == '\n') {
+            placeLine(lineStart, YES);
+            lineStart = i + 1;
+            x = 0;
+            continue;
+        }
+
+        CGFloat advance = PaginationAdvance(metrics, c);
+
+        // ⭐ 超出行宽：回退到最近的合法断点折行（空格允许挂在行尾）
+        if (x + advance > width && i > lineStart && !PaginationIsSpace(c)) {
+            NSUInteger breakAt = i;
+            NSUInteger minBreak = MAX(lineStart + 1, i > kPaginationMaxBacktrack ? i - kPaginationMaxBacktrack : 0);
+            for (NSUInteger p = i; p >= minBreak; p--) {
+                if (PaginationCanBreakBefore(chars, p)) {
+                    breakAt = p;
+                    break;
+                }
+            }
+
+            placeLine(lineStart, NO);
+            lineStart = breakAt;
+            x = 0;
+            for (NSUInteger j = breakAt; j < i; j++) {
+                x += PaginationAdvance(metrics, chars[j]);
+            }
+        }
+
+        x += advance;
+    }
+
+    if (!finished && lineStart < length) {
+        placeLine(lineStart, NO);
+    }
+
+    free(chars);
+    return breaks;
+}
+
+@end
@@ -0,0 +1,84 @@
+//
+//  PaginationScheduler.h
+//  Read
+//
+//  分页调度器 - 后台预分页相邻章节，按距离排优先级，排版变化时取消重来
+//
+
+#import <Foundation/Foundation.h>
+#import "PaginationEngine.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^PaginationSchedulerCompletion)(NSInteger chapterIndex, NSArray<NSNumber *> *pageBreaks);
+
+/**
+ * 分页调度器
+ *
+ * 职责：
+ *   1. 章节内容到达后在后台线程分页（经 PaginationCache，命中则无需排版）
+ *   2. 距当前章节越近优先级越高；当前章节变化时重新调整排队任务的优先级
+ *   3. 排版参数（字号、间距、尺寸）变化时取消所有进行中和排队的任务，丢弃旧结果
+ *   4. 只保留当前章节附近的分页结果
+ *
+ * 说明：
+ *   所有方法在主线程调用，完成回调也在主线程执行。
+ *
+ * 使用示例：
+ *   self.scheduler.layout = layout;
+ *   self.scheduler.currentChapterIndex = 12;
+ *   [self.scheduler schedulePaginationForChapter:13 text:content completion:^(NSInteger index, NSArray *breaks) {
+ *       // 生成页面
+ *   }];
+ */
+@interface PaginationScheduler : NSObject
+
+/**
+ * 当前排版参数（设置为不同的值会取消全部任务并清空结果）
+ */
+@property (copy, nonatomic, nullable) PaginationLayout *layout;
+
+/**
+ * 当前阅读的章节（决定任务优先级和结果保留范围）
+ */
+@property (assign, nonatomic) NSInteger currentChapterIndex;
+
+/**
+ * 结果保留范围（距当前章节的章数，默认 3）
+ */
+@property (assign, nonatomic) NSInteger retainDistance;
+
+/**
+ * 安排后台分页（同一章节已有结果时立即回调，已在排队时替换旧任务）
+ */
+- (void)schedulePaginationForChapter:(NSInteger)chapterIndex
+                                text:(NSString *)text
+                          completion:(nullable PaginationSchedulerCompletion)completion;
+
+/**
+ * 安排以阅读锚点为界的后台分页：锚点处固定为一页的开始，重新排版后当前页首字不变
+ * @param anchorOffset 锚点在章节中的位置（0 等同于普通分页，结果写入分页缓存；否则不写入）
+ */
+- (void)schedulePaginationForChapter:(NSInteger)chapterIndex
+                                text:(NSString *)text
+                        anchorOffset:(NSUInteger)anchorOffset
+                          completion:(nullable PaginationSchedulerCompletion)completion;
+
+/**
+ * 已完成的分页结果（对应当前排版参数）
+ */
+- (nullable NSArray<NSNumber *> *)pageBreaksForChapter:(NSInteger)chapterIndex;
+
+/**
+ * 章节是否正在排队或分页中
+ */
+- (BOOL)isSchedulingChapter:(NSInteger)chapterIndex;
+
+/**
+ * 取消所有任务并清空结果
+ */
+- (void)cancelAll;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,167 @@
+//
+//  PaginationScheduler.m
+//  Read
+//
+//  分页调度器实现
+//
+
+#import "PaginationScheduler.h"
+#import "PaginationCache.h"
+
+@interface PaginationScheduler ()
+@property (strong, nonatomic) NSOperationQueue *operationQueue;
+@property (strong, nonatomic) NSMutableDictionary<NSNumber *, NSOperation *> *pendingOperations;
+@property (strong, nonatomic) NSMutableDictionary<NSNumber *, NSArray<NSNumber *> *> *results;
+@property (assign, nonatomic) NSUInteger generation;   // 每次取消递增，丢弃过期任务的结果
+@end
+
+@implementation PaginationScheduler
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _operationQueue = [[NSOperationQueue alloc] init];
+        _operationQueue.name = @"com.read.pagination.scheduler";
+        _operationQueue.maxConcurrentOperationCount = 1;   // 排版本身已足够快，串行即可，避免与主线程争抢
+        _operationQueue.qualityOfService = NSQualityOfServiceUtility;
+
+        _pendingOperations = [NSMutableDictionary dictionary];
+        _results = [NSMutableDictionary dictionary];
+        _retainDistance = 3;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_operationQueue cancelAllOperations];
+}
+
+#pragma mark - 属性
+
+- (void)setLayout:(nullable PaginationLayout *)layout {
+    if (layout == _layout || [layout isEqual:_layout]) {
+        return;
+    }
+    _layout = [layout copy];
+    [self cancelAll];
+}
+
+- (void)setCurrentChapterIndex:(NSInteger)currentChapterIndex {
+    _currentChapterIndex = currentChapterIndex;
+
+    // ⭐ 重新调整排队任务的优先级，并丢弃远离当前位置的结果
+    [self.pendingOperations enumerateKeysAndObjectsUsingBlock:^(NSNumber *key, NSOperation *operation, BOOL *stop) {
+        operation.queuePriority = [self priorityForChapter:key.integerValue];
+    }];
+
+    for (NSNumber *key in self.results.allKeys) {
+        if (labs(key.integerValue - currentChapterIndex) > self.retainDistance) {
+            [self.results removeObjectForKey:key];
+        }
+    }
+}
+
+- (NSOperationQueuePriority)priorityForChapter:(NSInteger)chapterIndex {
+    NSInteger distance = labs(chapterIndex - self.currentChapterIndex);
+    if (distance == 0) return NSOperationQueuePriorityVeryHigh;
+    if (distance == 1) return NSOperationQueuePriorityHigh;
+    if (distance == 2) return NSOperationQueuePriorityNormal;
+    return NSOperationQueuePriorityLow;
+}
+
+#pragma mark - 调度
+
+- (void)schedulePaginationForChapter:(NSInteger)chapterIndex
+                                text:(NSString *)text
+                          completion:(nullable PaginationSchedulerCompletion)completion {
+    [self schedulePaginationForChapter:chapterIndex text:text anchorOffset:0 completion:completion];
+}
+
+- (void)schedulePaginationForChapter:(NSInteger)chapterIndex
+                                text:(NSString *)text
+                        anchorOffset:(NSUInteger)anchorOffset
+                          completion:(nullable PaginationSchedulerCompletion)completion {
+    if (!self.layout || text.length == 0) {
+        return;
+    }
+
+    NSNumber *key = @(chapterIndex);
+    NSArray<NSNumber *> *existing = self.results[key];
+    if (existing) {
+        if (completion) {
+            completion(chapterIndex, existing);
+        }
+        return;
+    }
+
+    [self.pendingOperations[key] cancel];
+
+    PaginationLayout *layout = self.layout;
+    NSString *chapterText = [text copy];
+    NSUInteger generation = self.generation;
+
+    NSBlockOperation *operation = [[NSBlockOperation alloc] init];
+    __weak NSBlockOperation *weakOperation = operation;
+    __weak typeof(self) weakSelf = self;
+
+    [operation addExecutionBlock:^{
+        NSBlockOperation *strongOperation = weakOperation;
+        if (!strongOperation || strongOperation.isCancelled) {
+            return;
+        }
+
+        NSArray<NSNumber *> *breaks;
+        if (anchorOffset == 0 || anchorOffset >= chapterText.length) {
+            breaks = [[PaginationCache sharedCache] pageBreaksForText:chapterText layout:layout];
+        } else {
+            // ⭐ 锚点前后分别分页，锚点处必定是一页的开始（锚点前一页可能不满）
+            PaginationEngine *engine = [PaginationEngine sharedEngine];
+            NSMutableArray<NSNumber *> *combined = [[engine pageBreaksForText:chapterText
+                                                                        layout:layout
+                                                                         range:NSMakeRange(0, anchorOffset)
+                                                                      maxPages:0] mutableCopy];
+            [combined addObjectsFromArray:[engine pageBreaksForText:chapterText
+                                                              layout:layout
+                                                               range:NSMakeRange(anchorOffset, chapterText.length - anchorOffset)
+                                                            maxPages:0]];
+            breaks = combined;
+        }
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            PaginationScheduler *strongSelf = weakSelf;
+            if (!strongSelf || strongOperation.isCancelled || generation != strongSelf.generation) {
+                return;
+            }
+            if (strongSelf.pendingOperations[key] == strongOperation) {
+                [strongSelf.pendingOperations removeObjectForKey:key];
+            }
+            if (labs(chapterIndex - strongSelf.currentChapterIndex) <= strongSelf.retainDistance) {
+                strongSelf.results[key] = breaks;
+            }
+            if (completion) {
+                completion(chapterIndex, breaks);
+            }
+        });
+    }];
+
+    operation.queuePriority = [self priorityForChapter:chapterIndex];
+    self.pendingOperations[key] = operation;
+    [self.operationQueue addOperation:operation];
+}
+
+- (nullable NSArray<NSNumber *> *)pageBreaksForChapter:(NSInteger)chapterIndex {
+    return self.results[@(chapterIndex)];
+}
+
+- (BOOL)isSchedulingChapter:(NSInteger)chapterIndex {
+    return self.pendingOperations[@(chapterIndex)] != nil;
+}
+
+- (void)cancelAll {
+    self.generation++;
+    [self.operationQueue cancelAllOperations];
+    [self.pendingOperations removeAllObjects];
+    [self.results removeAllObjects];
+}
+
+@end
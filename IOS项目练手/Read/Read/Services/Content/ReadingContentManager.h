@@ -17,7 +17,7 @@ NS_ASSUME_NONNULL_BEGIN
  *
  * 职责：
  *   1. 章节内容加载（网络 + 本地缓存）
- *   2. LRU 内存缓存管理
+ *   2. 内存缓存（全局共享的 ChapterCache，与阅读页共用同一份文本）
  *   3. 预加载策略
  *   4. 请求去重
  *
@@ -76,34 +76,36 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable NSString *)getCachedContent:(NSInteger)chapterIndex;
 
 /**
- * 判断章节是否已缓存
+ * 读取缓存的章节内容，但不记录命中率、不影响淘汰顺序（统计字数、预分页等探测用）
  * @param chapterIndex 章节索引
- * @return 是否已缓存
+ * @return 缓存的内容，如果没有则返回 nil
  */
-- (BOOL)isChapterCached:(NSInteger)chapterIndex;
+- (nullable NSString *)peekCachedContent:(NSInteger)chapterIndex;
 
 /**
- * 清除所有缓存
+ * 缓存章节内容（放入共享缓存，超出字节预算时按 LRU 淘汰）
+ * @param content 章节内容
+ * @param chapterIndex 章节索引
  */
-- (void)clearCache;
+- (void)cacheContent:(NSString *)content forChapter:(NSInteger)chapterIndex;
 
 /**
- * 清除指定章节缓存
+ * 判断章节是否已缓存（不影响淘汰顺序）
  * @param chapterIndex 章节索引
+ * @return 是否已缓存
  */
-- (void)clearCacheForChapter:(NSInteger)chapterIndex;
-
-#pragma mark - 缓存统计
+- (BOOL)isChapterCached:(NSInteger)chapterIndex;
 
 /**
- * 当前缓存的章节数量
+ * 清除本书的所有缓存
  */
-@property (nonatomic, readonly) NSInteger cachedChapterCount;
+- (void)clearCache;
 
 /**
- * 最大缓存章节数量（默认10章）
+ * 清除指定章节缓存
+ * @param chapterIndex 章节索引
  */
-@property (assign, nonatomic) NSInteger maxCacheCount;
+- (void)clearCacheForChapter:(NSInteger)chapterIndex;
 
 #pragma mark - 书籍信息
 
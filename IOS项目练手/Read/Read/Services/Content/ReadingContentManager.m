@@ -8,9 +8,8 @@
 #import "ReadingContentManager.h"
 #import "BookContentService.h"
 #import "BookContentManager.h"
-
-// 默认配置
-static const NSInteger kDefaultMaxCacheCount = 10;  // 默认最大缓存10章
+#import "ChapterCache.h"
+#import "MetricsRegistry.h"
 
 @interface ReadingContentManager ()
 
@@ -20,8 +19,7 @@ static const NSInteger kDefaultMaxCacheCount = 10;  // 默认最大缓存10章
 @property (strong, nonatomic, readwrite) BookSource *bookSource;
 
 // 缓存管理
-@property (strong, nonatomic) NSMutableDictionary<NSNumber *, NSString *> *contentCache;  // 内容缓存 {chapterIndex: content}
-@property (strong, nonatomic) NSMutableDictionary<NSNumber *, NSDate *> *cacheAccessTime;  // 访问时间 {chapterIndex: time}
+@property (strong, nonatomic) ChapterCache *contentCache;  // 内容缓存（全局共享，按 bookUrl + 章节索引）
 @property (strong, nonatomic) NSMutableSet<NSNumber *> *pendingRequests;  // 正在请求的章节（去重）
 
 // 服务
@@ -43,12 +41,9 @@ static const NSInteger kDefaultMaxCacheCount = 10;  // 默认最大缓存10章
         _chapters = chapters;
         _bookSource = bookSource;
 
-        _contentCache = [NSMutableDictionary dictionary];
-        _cacheAccessTime = [NSMutableDictionary dictionary];
+        _contentCache = [ChapterCache sharedCache];
         _pendingRequests = [NSMutableSet set];
 
-        _maxCacheCount = kDefaultMaxCacheCount;
-
         _contentService = [BookContentService sharedService];
         _storageManager = [BookContentManager sharedManager];
     }
@@ -72,10 +67,8 @@ static const NSInteger kDefaultMaxCacheCount = 10;  // 默认最大缓存10章
     }
 
     // 1. 先检查内存缓存
-    NSString *cachedContent = self.contentCache[@(chapterIndex)];
+    NSString *cachedContent = [self getCachedContent:chapterIndex];
     if (cachedContent) {
-        // 更新访问时间（LRU）
-        self.cacheAccessTime[@(chapterIndex)] = [NSDate date];
         if (completion) {
             completion(cachedContent, nil);
         }
@@ -107,9 +100,11 @@ static const NSInteger kDefaultMaxCacheCount = 10;  // 默认最大缓存10章
         return;
     }
 
-    // 5. 从网络加载
+    // 5. 从网络加载（分页正文抓到目录中的下一章为止）
+    NSString *nextChapterUrl = chapterIndex + 1 < self.chapters.count ? self.chapters[chapterIndex + 1].chapterUrl : nil;
     __weak typeof(self) weakSelf = self;
     [self.contentService fetchChapterContent:chapter.chapterUrl
+                              nextChapterUrl:nextChapterUrl
                                   bookSource:self.bookSource
                                      success:^(ChapterContent *chapterContent) {
         __strong typeof(weakSelf) self = weakSelf;
@@ -187,69 +182,30 @@ static const NSInteger kDefaultMaxCacheCount = 10;  // 默认最大缓存10章
 #pragma mark - 缓存管理
 
 - (void)cacheContent:(NSString *)content forChapter:(NSInteger)chapterIndex {
-    if (!content || content.length == 0) {
-        return;
-    }
-
-    // 存入缓存
-    self.contentCache[@(chapterIndex)] = content;
-    self.cacheAccessTime[@(chapterIndex)] = [NSDate date];
-
-    // LRU清理
-    [self trimCacheIfNeeded];
+    [self.contentCache setContent:content forBook:self.book.bookUrl chapter:chapterIndex];
 }
 
 - (nullable NSString *)getCachedContent:(NSInteger)chapterIndex {
-    NSString *content = self.contentCache[@(chapterIndex)];
-    if (content) {
-        // 更新访问时间
-        self.cacheAccessTime[@(chapterIndex)] = [NSDate date];
-    }
+    NSString *content = [self.contentCache contentForBook:self.book.bookUrl chapter:chapterIndex];
+    MetricsCount([MetricsRegistry sourceForBookSource:self.bookSource],
+                 content ? MetricCounterChapterCacheHit : MetricCounterChapterCacheMiss, 1);
     return content;
 }
 
+- (nullable NSString *)peekCachedContent:(NSInteger)chapterIndex {
+    return [self.contentCache peekContentForBook:self.book.bookUrl chapter:chapterIndex];
+}
+
 - (BOOL)isChapterCached:(NSInteger)chapterIndex {
-    return self.contentCache[@(chapterIndex)] != nil;
+    return [self.contentCache containsBook:self.book.bookUrl chapter:chapterIndex];
 }
 
 - (void)clearCache {
-    [self.contentCache removeAllObjects];
-    [self.cacheAccessTime removeAllObjects];
+    [self.contentCache removeAllContentForBook:self.book.bookUrl];
 }
 
 - (void)clearCacheForChapter:(NSInteger)chapterIndex {
-    [self.contentCache removeObjectForKey:@(chapterIndex)];
-    [self.cacheAccessTime removeObjectForKey:@(chapterIndex)];
-}
-
-#pragma mark - LRU 缓存清理
-
-/**
- * LRU 缓存清理：当缓存数量超过限制时，移除最久未访问的章节
- */
-- (void)trimCacheIfNeeded {
-    if (self.contentCache.count <= self.maxCacheCount) {
-        return;
-    }
-
-    // 按访问时间排序（最早访问的在前）
-    NSArray *sortedKeys = [self.cacheAccessTime keysSortedByValueUsingComparator:^NSComparisonResult(NSDate *time1, NSDate *time2) {
-        return [time1 compare:time2];
-    }];
-
-    // 移除最早访问的章节
-    NSInteger removeCount = self.contentCache.count - self.maxCacheCount;
-    for (NSInteger i = 0; i < removeCount && i < sortedKeys.count; i++) {
-        NSNumber *key = sortedKeys[i];
-        [self.contentCache removeObjectForKey:key];
-        [self.cacheAccessTime removeObjectForKey:key];
-    }
-}
-
-#pragma mark - 缓存统计
-
-- (NSInteger)cachedChapterCount {
-    return self.contentCache.count;
+    [self.contentCache removeContentForBook:self.book.bookUrl chapter:chapterIndex];
 }
 
 @end
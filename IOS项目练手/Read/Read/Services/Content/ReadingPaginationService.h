@@ -8,17 +8,31 @@
 #import <Foundation/Foundation.h>
 #import <UIKit/UIKit.h>
 #import "ChapterModel.h"
+#import "PaginationEngine.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 /**
  * 页面模型
+ *
+ * 只记录页面在章节文本中的范围，同一章节的所有页面共享一份不可变文本，
+ * 页面文字在显示时才生成。
  */
 @interface PageModel : NSObject
-@property (strong, nonatomic) ChapterModel *chapter;  // 所属章节
-@property (assign, nonatomic) NSInteger pageIndex;    // 页码（从0开始）
-@property (copy, nonatomic) NSString *pageContent;    // 页面内容
-@property (assign, nonatomic) NSInteger totalPages;   // 该章节总页数
+@property (strong, nonatomic) ChapterModel *chapter;             // 所属章节
+@property (assign, nonatomic) NSInteger pageIndex;               // 页码（从0开始）
+@property (assign, nonatomic) NSInteger totalPages;              // 该章节总页数
+@property (strong, nonatomic) NSString *chapterText;             // 章节全文（同章节各页共享，不复制）
+@property (assign, nonatomic) NSRange pageRange;                 // 本页在章节全文中的范围
+@property (strong, nonatomic, nullable) PaginationLayout *layout; // 分页时使用的排版参数（同章节共享）
+@property (copy, nonatomic, readonly) NSString *pageContent;     // 页面内容（按需截取）
+
+/**
+ * 生成本页的富文本（字号、行距、段距与分页时一致）
+ * @param textColor 文字颜色
+ */
+- (NSAttributedString *)attributedContentWithTextColor:(UIColor *)textColor;
+
 @end
 
 /**
@@ -30,7 +44,8 @@ NS_ASSUME_NONNULL_BEGIN
  *   3. 缓存分页结果
  *
  * 算法：
- *   使用二分查找 + boundingRectWithSize 精确计算每页容纳的文本量
+ *   由 PaginationEngine 单遍扫描文本，按缓存的字宽折行、按行高分页；
+ *   结果经 PaginationCache 持久化，相同排版参数下再次打开无需排版
  *
  * 使用示例：
  *   ReadingPaginationService *service = [[ReadingPaginationService alloc] init];
@@ -44,6 +59,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark - 文本分页
 
+/**
+ * 排版参数对应的文本属性（字体、行距、段距），显示时使用，保证与分页结果一致
+ */
++ (NSDictionary<NSAttributedStringKey, id> *)textAttributesForLayout:(PaginationLayout *)layout;
+
 /**
  * 将章节内容分页
  * @param content 章节内容
@@ -6,10 +6,28 @@
 //
 
 #import "ReadingPaginationService.h"
+#import "PaginationCache.h"
 
 #pragma mark - PageModel 实现
 
 @implementation PageModel
+
+- (NSString *)pageContent {
+    if (!self.chapterText || NSMaxRange(self.pageRange) > self.chapterText.length) {
+        return @"";
+    }
+    return [self.chapterText substringWithRange:self.pageRange];
+}
+
+- (NSAttributedString *)attributedContentWithTextColor:(UIColor *)textColor {
+    NSMutableDictionary *attributes = [NSMutableDictionary dictionary];
+    if (self.layout) {
+        [attributes addEntriesFromDictionary:[ReadingPaginationService textAttributesForLayout:self.layout]];
+    }
+    attributes[NSForegroundColorAttributeName] = textColor;
+    return [[NSAttributedString alloc] initWithString:self.pageContent attributes:attributes];
+}
+
 @end
 
 #pragma mark - ReadingPaginationService 实现
@@ -30,6 +48,19 @@
 
 #pragma mark - 文本分页
 
++ (NSDictionary<NSAttributedStringKey, id> *)textAttributesForLayout:(PaginationLayout *)layout {
+    UIFont *font = layout.fontName.length > 0 ? [UIFont fontWithName:layout.fontName size:layout.fontSize] : nil;
+
+    NSMutableParagraphStyle *style = [[NSMutableParagraphStyle alloc] init];
+    style.lineSpacing = layout.lineSpacing;
+    style.paragraphSpacing = layout.paragraphSpacing;
+
+    return @{
+        NSFontAttributeName: font ?: [UIFont systemFontOfSize:layout.fontSize],
+        NSParagraphStyleAttributeName: style
+    };
+}
+
 - (NSArray<PageModel *> *)paginateContent:(NSString *)content
                                   chapter:(ChapterModel *)chapter
                                     width:(CGFloat)width
@@ -40,101 +71,33 @@
         return @[];
     }
 
-    NSMutableArray<PageModel *> *pages = [NSMutableArray array];
-    NSInteger totalLength = content.length;
-    NSInteger currentIndex = 0;
-    NSInteger pageIndex = 0;
+    // ⭐ 优先读取持久化的分页缓存，未命中时由分页引擎单遍扫描
+    PaginationLayout *layout = [PaginationLayout layoutWithFontSize:fontSize pageSize:CGSizeMake(width, height)];
+    NSArray<NSNumber *> *breaks = [[PaginationCache sharedCache] pageBreaksForText:content layout:layout];
 
-    UIFont *font = [UIFont systemFontOfSize:fontSize];
-    CGSize constraintSize = CGSizeMake(width, height);
+    // 所有页面共享同一份不可变文本，只记录范围
+    NSString *chapterText = [content copy];
 
-    while (currentIndex < totalLength) {
-        // ⭐ 使用二分查找确定当前页能容纳的最大字符数
-        NSInteger pageLength = [self binarySearchPageLengthFrom:currentIndex
-                                                      totalText:content
-                                                           font:font
-                                                 constraintSize:constraintSize];
-
-        if (pageLength == 0) {
-            // 特殊情况：单个字符都放不下（理论上不会发生）
-            pageLength = 1;
-        }
-
-        // 提取页面内容
-        NSInteger endIndex = MIN(currentIndex + pageLength, totalLength);
-        NSString *pageContent = [content substringWithRange:NSMakeRange(currentIndex, endIndex - currentIndex)];
+    NSMutableArray<PageModel *> *pages = [NSMutableArray arrayWithCapacity:breaks.count];
+    for (NSInteger pageIndex = 0; pageIndex < breaks.count; pageIndex++) {
+        NSInteger startIndex = breaks[pageIndex].integerValue;
+        NSInteger endIndex = pageIndex + 1 < breaks.count ? breaks[pageIndex + 1].integerValue : chapterText.length;
 
         // 创建页面模型
         PageModel *page = [[PageModel alloc] init];
         page.chapter = chapter;
         page.pageIndex = pageIndex;
-        page.pageContent = pageContent;
+        page.chapterText = chapterText;
+        page.pageRange = NSMakeRange(startIndex, endIndex - startIndex);
+        page.layout = layout;
+        page.totalPages = breaks.count;
 
         [pages addObject:page];
-
-        // 移动到下一页
-        currentIndex = endIndex;
-        pageIndex++;
-    }
-
-    // 设置总页数
-    for (PageModel *page in pages) {
-        page.totalPages = pages.count;
     }
 
     return pages;
 }
 
-/**
- * ⭐ 二分查找：查找能容纳在指定尺寸内的最大字符数
- *
- * @param startIndex 起始位置
- * @param text 全文
- * @param font 字体
- * @param size 容器尺寸
- * @return 能容纳的最大字符数
- */
-- (NSInteger)binarySearchPageLengthFrom:(NSInteger)startIndex
-                              totalText:(NSString *)text
-                                   font:(UIFont *)font
-                         constraintSize:(CGSize)size {
-
-    NSInteger remainingLength = text.length - startIndex;
-    if (remainingLength == 0) {
-        return 0;
-    }
-
-    NSInteger left = 1;
-    NSInteger right = remainingLength;
-    NSInteger result = 1;
-
-    while (left <= right) {
-        NSInteger mid = (left + right) / 2;
-
-        // 提取子串
-        NSString *substring = [text substringWithRange:NSMakeRange(startIndex, mid)];
-
-        // 计算高度
-        CGRect boundingRect = [substring boundingRectWithSize:size
-                                                      options:NSStringDrawingUsesLineFragmentOrigin
-                                                   attributes:@{NSFontAttributeName: font}
-                                                      context:nil];
-
-        CGFloat textHeight = ceil(boundingRect.size.height);
-
-        if (textHeight <= size.height) {
-            // 能容纳，尝试更多
-            result = mid;
-            left = mid + 1;
-        } else {
-            // 容纳不下，减少
-            right = mid - 1;
-        }
-    }
-
-    return result;
-}
-
 #pragma mark - 分页缓存
 
 - (nullable NSArray<PageModel *> *)getCachedPagesForChapter:(NSInteger)chapterIndex {
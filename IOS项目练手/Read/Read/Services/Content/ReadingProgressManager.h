@@ -9,6 +9,7 @@
 #import <UIKit/UIKit.h>
 #import "BookModel.h"
 #import "ChapterModel.h"
+#import "ChapterOffsetIndex.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -26,8 +27,8 @@ NS_ASSUME_NONNULL_BEGIN
  *
  * 职责：
  *   1. 保存和恢复阅读进度（章节索引 + 滚动位置）
- *   2. 管理章节偏移量映射（用于垂直滚动模式）
- *   3. 提供线程安全的进度保存
+ *   2. 管理章节偏移量（用于垂直滚动模式，按章节高度前缀和索引，查找为 O(log n)）
+ *   3. 提供线程安全的进度保存（写入合并后由 ReadingProgressStore 防抖落盘）
  *
  * 使用示例：
  *   ReadingProgressManager *manager = [[ReadingProgressManager alloc] initWithBook:book];
@@ -54,7 +55,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)saveProgress:(CGFloat)scrollOffset chapterIndex:(NSInteger)chapterIndex;
 
 /**
- * 异步保存阅读进度（后台线程）
+ * 异步保存阅读进度（与 saveProgress 等价，保留兼容）
  * @param scrollOffset 滚动偏移量
  * @param chapterIndex 章节索引
  */
@@ -69,7 +70,12 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark - 章节偏移量管理（垂直模式）
 
 /**
- * 记录章节在滚动视图中的偏移量
+ * 章节偏移索引（章节高度测量后直接追加 / 更新高度）
+ */
+@property (strong, nonatomic, readonly) ChapterOffsetIndex *offsetIndex;
+
+/**
+ * 记录章节在滚动视图中的偏移量（换算为前一章的高度；与已有章节不相邻时重新开始）
  * @param offset Y 偏移量
  * @param chapterIndex 章节索引
  */
@@ -83,9 +89,9 @@ NS_ASSUME_NONNULL_BEGIN
 - (CGFloat)getChapterOffset:(NSInteger)chapterIndex;
 
 /**
- * 查找指定偏移量对应的章节
+ * 查找指定偏移量对应的章节（O(log n)）
  * @param offset 滚动偏移量
- * @return 章节索引，如果找不到则返回 -1
+ * @return 章节索引，在第一章之前返回第一章，没有记录则返回 -1
  */
 - (NSInteger)findChapterAtOffset:(CGFloat)offset;
 
@@ -103,14 +109,14 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark - 批量保存（防抖）
 
 /**
- * 开始防抖保存（1秒后自动保存）
+ * 开始防抖保存（停止写入1秒后落盘）
  * @param scrollOffset 滚动偏移量
  * @param chapterIndex 章节索引
  */
 - (void)scheduleDebouncedSave:(CGFloat)scrollOffset chapterIndex:(NSInteger)chapterIndex;
 
 /**
- * 立即保存（取消防抖）
+ * 立即保存（不等待防抖，异步落盘）
  */
 - (void)saveImmediately;
 
@@ -6,6 +6,7 @@
 //
 
 #import "ReadingProgressManager.h"
+#import "ReadingProgressStore.h"
 
 #pragma mark - ReadingProgress 实现
 
@@ -16,11 +17,9 @@
 
 @interface ReadingProgressManager ()
 @property (strong, nonatomic) BookModel *book;
-@property (strong, nonatomic) NSMutableDictionary<NSNumber *, NSNumber *> *chapterOffsets;  // {chapterIndex: offset}
-@property (strong, nonatomic) NSTimer *debounceSaveTimer;  // 防抖定时器
+@property (strong, nonatomic, readwrite) ChapterOffsetIndex *offsetIndex;
 @property (assign, nonatomic) CGFloat pendingScrollOffset;  // 待保存的滚动偏移
-@property (assign, nonatomic) NSInteger pendingChapterIndex;  // 待保存的章节索引
-@property (strong, nonatomic) dispatch_queue_t saveQueue;  // 保存队列
+@property (assign, nonatomic) NSInteger pendingChapterIndex;  // 待保存的章节索引（-1 表示无）
 @end
 
 @implementation ReadingProgressManager
@@ -31,16 +30,13 @@
     self = [super init];
     if (self) {
         _book = book;
-        _chapterOffsets = [NSMutableDictionary dictionary];
-        _saveQueue = dispatch_queue_create("com.read.progress.save", DISPATCH_QUEUE_SERIAL);
+        _offsetIndex = [[ChapterOffsetIndex alloc] init];
+        _pendingScrollOffset = -1;
+        _pendingChapterIndex = -1;
     }
     return self;
 }
 
-- (void)dealloc {
-    [self.debounceSaveTimer invalidate];
-}
-
 #pragma mark - 进度保存与恢复
 
 - (void)saveProgress:(CGFloat)scrollOffset chapterIndex:(NSInteger)chapterIndex {
@@ -48,22 +44,15 @@
         return;
     }
 
-    NSString *progressKey = [NSString stringWithFormat:@"ReadProgress_%@", self.book.bookUrl];
-    NSDictionary *progress = @{
-        @"chapterIndex": @(chapterIndex),
-        @"scrollOffset": @(scrollOffset),
-        @"lastReadTime": [NSDate date]
-    };
-
-    [[NSUserDefaults standardUserDefaults] setObject:progress forKey:progressKey];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    // ⭐ 只覆盖内存中的最新位置，由 ReadingProgressStore 合并后防抖落盘
+    [[ReadingProgressStore sharedStore] recordProgressForBook:self.book.bookUrl
+                                                 chapterIndex:chapterIndex
+                                                 scrollOffset:scrollOffset];
 }
 
 - (void)saveProgressAsync:(CGFloat)scrollOffset chapterIndex:(NSInteger)chapterIndex {
-    // 后台线程保存
-    dispatch_async(self.saveQueue, ^{
-        [self saveProgress:scrollOffset chapterIndex:chapterIndex];
-    });
+    // 写入本身只修改内存，无需再切换线程
+    [self saveProgress:scrollOffset chapterIndex:chapterIndex];
 }
 
 - (nullable ReadingProgress *)restoreProgress {
@@ -71,17 +60,15 @@
         return nil;
     }
 
-    NSString *progressKey = [NSString stringWithFormat:@"ReadProgress_%@", self.book.bookUrl];
-    NSDictionary *progress = [[NSUserDefaults standardUserDefaults] objectForKey:progressKey];
-
-    if (!progress) {
+    ReadingProgressEntry *entry = [[ReadingProgressStore sharedStore] latestProgressForBook:self.book.bookUrl];
+    if (!entry) {
         return nil;
     }
 
     ReadingProgress *result = [[ReadingProgress alloc] init];
-    result.chapterIndex = [progress[@"chapterIndex"] integerValue];
-    result.scrollOffset = [progress[@"scrollOffset"] floatValue];
-    result.lastReadTime = progress[@"lastReadTime"];
+    result.chapterIndex = entry.chapterIndex;
+    result.scrollOffset = entry.scrollOffset;
+    result.lastReadTime = entry.lastReadTime;
 
     return result;
 }
@@ -89,82 +76,74 @@
 #pragma mark - 章节偏移量管理
 
 - (void)setChapterOffset:(CGFloat)offset forChapter:(NSInteger)chapterIndex {
-    self.chapterOffsets[@(chapterIndex)] = @(offset);
-}
-
-- (CGFloat)getChapterOffset:(NSInteger)chapterIndex {
-    NSNumber *offset = self.chapterOffsets[@(chapterIndex)];
-    return offset ? offset.floatValue : 0;
-}
-
-- (NSInteger)findChapterAtOffset:(CGFloat)offset {
-    // ⭐ 使用二分查找（性能优化）
-    NSArray *sortedKeys = [self.chapterOffsets.allKeys sortedArrayUsingSelector:@selector(compare:)];
+    ChapterOffsetIndex *index = self.offsetIndex;
 
-    if (sortedKeys.count == 0) {
-        return -1;
+    if (index.count == 0) {
+        index.topInset = offset;
+        [index appendChapter:chapterIndex height:0];
+        return;
     }
 
-    // 二分查找
-    NSInteger left = 0;
-    NSInteger right = sortedKeys.count - 1;
-    NSInteger result = -1;
-
-    while (left <= right) {
-        NSInteger mid = (left + right) / 2;
-        NSNumber *chapterIndexNumber = sortedKeys[mid];
-        CGFloat chapterOffset = [self.chapterOffsets[chapterIndexNumber] floatValue];
-
-        if (chapterOffset <= offset) {
-            result = chapterIndexNumber.integerValue;
-            left = mid + 1;
-        } else {
-            right = mid - 1;
+    if (chapterIndex == index.firstChapterIndex) {
+        // 第一章移动：整体平移
+        index.topInset = offset;
+    } else if ([index containsChapter:chapterIndex] || chapterIndex == index.lastChapterIndex + 1) {
+        // 起始位置由前一章的高度决定
+        NSInteger previous = chapterIndex - 1;
+        [index setHeight:offset - [index offsetForChapter:previous] forChapter:previous];
+        if (chapterIndex > index.lastChapterIndex) {
+            [index appendChapter:chapterIndex height:0];
         }
+    } else if (chapterIndex == index.firstChapterIndex - 1 && offset <= index.topInset) {
+        [index prependChapter:chapterIndex height:index.topInset - offset];
+        index.topInset = offset;
+    } else {
+        // 不相邻：重新开始
+        [index removeAllChapters];
+        index.topInset = offset;
+        [index appendChapter:chapterIndex height:0];
     }
+}
 
-    return result;
+- (CGFloat)getChapterOffset:(NSInteger)chapterIndex {
+    return [self.offsetIndex offsetForChapter:chapterIndex];
+}
+
+- (NSInteger)findChapterAtOffset:(CGFloat)offset {
+    // ⭐ 前缀和索引上查找，不再每次排序
+    return [self.offsetIndex chapterAtOffset:offset];
 }
 
 - (NSDictionary<NSNumber *, NSNumber *> *)allChapterOffsets {
-    return [self.chapterOffsets copy];
+    ChapterOffsetIndex *index = self.offsetIndex;
+    NSMutableDictionary<NSNumber *, NSNumber *> *offsets = [NSMutableDictionary dictionaryWithCapacity:index.count];
+    CGFloat offset = index.topInset;
+    for (NSInteger chapterIndex = index.firstChapterIndex; index.count > 0 && chapterIndex <= index.lastChapterIndex; chapterIndex++) {
+        offsets[@(chapterIndex)] = @(offset);
+        offset += [index heightForChapter:chapterIndex];
+    }
+    return offsets;
 }
 
 - (void)clearChapterOffsets {
-    [self.chapterOffsets removeAllObjects];
+    [self.offsetIndex removeAllChapters];
 }
 
 #pragma mark - 防抖保存
 
 - (void)scheduleDebouncedSave:(CGFloat)scrollOffset chapterIndex:(NSInteger)chapterIndex {
-    // 保存待保存的值
+    // 保存待保存的值（防抖由 ReadingProgressStore 统一处理）
     self.pendingScrollOffset = scrollOffset;
     self.pendingChapterIndex = chapterIndex;
-
-    // 取消之前的定时器
-    [self.debounceSaveTimer invalidate];
-
-    // 1秒后保存
-    self.debounceSaveTimer = [NSTimer scheduledTimerWithTimeInterval:1.0
-                                                              target:self
-                                                            selector:@selector(executeDebouncedSave)
-                                                            userInfo:nil
-                                                             repeats:NO];
-}
-
-- (void)executeDebouncedSave {
-    [self saveProgressAsync:self.pendingScrollOffset chapterIndex:self.pendingChapterIndex];
+    [self saveProgress:scrollOffset chapterIndex:chapterIndex];
 }
 
 - (void)saveImmediately {
-    // 取消防抖定时器
-    [self.debounceSaveTimer invalidate];
-
-    // 立即保存
+    // 立即落盘
     if (self.pendingScrollOffset >= 0 && self.pendingChapterIndex >= 0) {
         [self saveProgress:self.pendingScrollOffset chapterIndex:self.pendingChapterIndex];
     }
+    [[ReadingProgressStore sharedStore] flush];
 }
 
 @end
-
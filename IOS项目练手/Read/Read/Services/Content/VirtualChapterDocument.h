@@ -0,0 +1,143 @@
+//
+//  VirtualChapterDocument.h
+//  Read
+//
+//  虚拟章节文档 - 垂直连续阅读只保留当前章节附近的滑动窗口（不依赖 UIKit）
+//
+
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+#import "ChapterOffsetIndex.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 章节片段（窗口中的一章，界面上对应一个独立的文本视图）
+ */
+@interface VirtualChapterSegment : NSObject
+@property (assign, nonatomic, readonly) NSInteger chapterIndex;  // 章节索引
+@property (copy, nonatomic, readonly) NSString *text;            // 显示文本（含章节标题和分隔线）
+@property (assign, nonatomic, readonly) CGFloat height;          // 测量高度
+@end
+
+/**
+ * 一次窗口变化（界面据此增删文本视图并调整滚动位置）
+ */
+@interface VirtualDocumentUpdate : NSObject
+@property (copy, nonatomic, readonly) NSArray<VirtualChapterSegment *> *insertedSegments;
+@property (copy, nonatomic, readonly) NSArray<VirtualChapterSegment *> *removedSegments;
+
+/**
+ * 滚动位置需要加上的偏移，使屏幕上的内容保持不动
+ * （在顶部插入或更新了当前章节之前的章节高度为正，移除顶部章节为负）
+ */
+@property (assign, nonatomic, readonly) CGFloat contentOffsetDelta;
+
+// 是否没有任何变化
+@property (assign, nonatomic, readonly, getter=isEmpty) BOOL empty;
+@end
+
+/**
+ * 虚拟章节文档
+ *
+ * 职责：
+ *   1. 只保留当前章节前后 windowRadius 章的片段，每章独立保存文本和测量高度
+ *   2. 追加 / 插入章节时淘汰窗口外的片段，内存不随阅读时长增长
+ *   3. 通过 ChapterOffsetIndex 维护片段位置，顶部插入或移除片段时给出滚动位置补偿
+ *
+ * 说明：
+ *   只负责窗口和位置计算，文本测量和视图由调用方完成，可在命令行/单元测试中运行。
+ *   文档坐标：第一个片段从 offsetIndex.topInset 开始，片段之间没有间隔。
+ *   只在一个线程中使用（主线程）。
+ *
+ * 使用示例：
+ *   VirtualChapterDocument *document = [[VirtualChapterDocument alloc] initWithOffsetIndex:index];
+ *   [view applyDocumentUpdate:[document resetWithChapter:12 text:text height:3200]];
+ *   VirtualDocumentUpdate *update = [document appendChapter:13 text:next height:2800];
+ *   update = [document updateCurrentChapter:13];   // 13 前后 2 章之外的片段被移除
+ *   scrollView.contentOffset = CGPointMake(0, scrollView.contentOffset.y + update.contentOffsetDelta);
+ */
+@interface VirtualChapterDocument : NSObject
+
+/**
+ * 初始化
+ * @param offsetIndex 片段位置索引（与进度管理器共用，滚动位置查找章节时结果一致）
+ */
+- (instancetype)initWithOffsetIndex:(ChapterOffsetIndex *)offsetIndex NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init;
+
+@property (strong, nonatomic, readonly) ChapterOffsetIndex *offsetIndex;
+
+/**
+ * 窗口半径（当前章节前后保留的章数，默认 2）
+ */
+@property (assign, nonatomic) NSInteger windowRadius;
+
+/**
+ * 最后一个片段之后的留白
+ */
+@property (assign, nonatomic) CGFloat bottomInset;
+
+/**
+ * 窗口中的片段（按章节顺序）
+ */
+@property (copy, nonatomic, readonly) NSArray<VirtualChapterSegment *> *segments;
+
+/**
+ * 当前章节（为空时为 -1）
+ */
+@property (assign, nonatomic, readonly) NSInteger currentChapterIndex;
+
+/**
+ * 文档总高度（顶部留白 + 片段高度 + 底部留白）
+ */
+@property (assign, nonatomic, readonly) CGFloat contentHeight;
+
+/**
+ * 清空并以一章开始（该章成为当前章节，位于顶部留白之后）
+ */
+- (VirtualDocumentUpdate *)resetWithChapter:(NSInteger)chapterIndex text:(NSString *)text height:(CGFloat)height;
+
+/**
+ * 在末尾追加一章
+ * @return 与最后一个片段不相邻或超出窗口时返回 nil
+ */
+- (nullable VirtualDocumentUpdate *)appendChapter:(NSInteger)chapterIndex text:(NSString *)text height:(CGFloat)height;
+
+/**
+ * 在开头插入一章（contentOffsetDelta 为插入的高度）
+ * @return 与第一个片段不相邻或超出窗口时返回 nil
+ */
+- (nullable VirtualDocumentUpdate *)prependChapter:(NSInteger)chapterIndex text:(NSString *)text height:(CGFloat)height;
+
+/**
+ * 上一章能否插入（与第一个片段相邻且在窗口内）；加载上一章之前先检查，避免加载、测量后被拒绝
+ */
+- (BOOL)canPrependChapter:(NSInteger)chapterIndex;
+
+/**
+ * 更新片段高度（重新测量后）；当前章节之前的片段高度变化会给出滚动补偿
+ */
+- (VirtualDocumentUpdate *)setHeight:(CGFloat)height forChapter:(NSInteger)chapterIndex;
+
+/**
+ * 切换当前章节并淘汰窗口外的片段
+ */
+- (VirtualDocumentUpdate *)updateCurrentChapter:(NSInteger)chapterIndex;
+
+/**
+ * 查询
+ */
+- (nullable VirtualChapterSegment *)segmentForChapter:(NSInteger)chapterIndex;
+- (CGFloat)offsetForChapter:(NSInteger)chapterIndex;
+- (NSInteger)chapterAtOffset:(CGFloat)offset;
+
+/**
+ * 清空所有片段
+ */
+- (VirtualDocumentUpdate *)removeAllSegments;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,238 @@
+//
+//  VirtualChapterDocument.m
+//  Read
+//
+//  虚拟章节文档实现
+//
+
+#import "VirtualChapterDocument.h"
+
+#pragma mark - VirtualChapterSegment
+
+@interface VirtualChapterSegment ()
+@property (assign, nonatomic, readwrite) NSInteger chapterIndex;
+@property (copy, nonatomic, readwrite) NSString *text;
+@property (assign, nonatomic, readwrite) CGFloat height;
+@end
+
+@implementation VirtualChapterSegment
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: chapter=%ld height=%.1f>",
+            NSStringFromClass([self class]), (long)self.chapterIndex, self.height];
+}
+
+@end
+
+#pragma mark - VirtualDocumentUpdate
+
+@interface VirtualDocumentUpdate ()
+@property (copy, nonatomic, readwrite) NSArray<VirtualChapterSegment *> *insertedSegments;
+@property (copy, nonatomic, readwrite) NSArray<VirtualChapterSegment *> *removedSegments;
+@property (assign, nonatomic, readwrite) CGFloat contentOffsetDelta;
+@end
+
+@implementation VirtualDocumentUpdate
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _insertedSegments = @[];
+        _removedSegments = @[];
+    }
+    return self;
+}
+
+- (BOOL)isEmpty {
+    return self.insertedSegments.count == 0 && self.removedSegments.count == 0 && self.contentOffsetDelta == 0;
+}
+
+@end
+
+#pragma mark - VirtualChapterDocument
+
+@interface VirtualChapterDocument ()
+@property (strong, nonatomic, readwrite) ChapterOffsetIndex *offsetIndex;
+@property (strong, nonatomic) NSMutableArray<VirtualChapterSegment *> *mutableSegments;
+@property (assign, nonatomic, readwrite) NSInteger currentChapterIndex;
+@end
+
+@implementation VirtualChapterDocument
+
+- (instancetype)initWithOffsetIndex:(ChapterOffsetIndex *)offsetIndex {
+    self = [super init];
+    if (self) {
+        _offsetIndex = offsetIndex;
+        _mutableSegments = [NSMutableArray array];
+        _currentChapterIndex = -1;
+        _windowRadius = 2;
+        [offsetIndex removeAllChapters];
+    }
+    return self;
+}
+
+- (instancetype)init {
+    return [self initWithOffsetIndex:[[ChapterOffsetIndex alloc] init]];
+}
+
+#pragma mark - 属性
+
+- (NSArray<VirtualChapterSegment *> *)segments {
+    return [self.mutableSegments copy];
+}
+
+- (CGFloat)contentHeight {
+    return self.offsetIndex.topInset + self.offsetIndex.totalHeight + self.bottomInset;
+}
+
+#pragma mark - 修改
+
+- (VirtualDocumentUpdate *)resetWithChapter:(NSInteger)chapterIndex text:(NSString *)text height:(CGFloat)height {
+    VirtualDocumentUpdate *update = [self removeAllSegments];
+
+    VirtualChapterSegment *segment = [self segmentWithChapter:chapterIndex text:text height:height];
+    [self.mutableSegments addObject:segment];
+    [self.offsetIndex appendChapter:chapterIndex height:segment.height];
+    self.currentChapterIndex = chapterIndex;
+
+    update.insertedSegments = @[segment];
+    return update;
+}
+
+- (nullable VirtualDocumentUpdate *)appendChapter:(NSInteger)chapterIndex text:(NSString *)text height:(CGFloat)height {
+    if (self.mutableSegments.count == 0) {
+        return [self resetWithChapter:chapterIndex text:text height:height];
+    }
+    if (chapterIndex != self.mutableSegments.lastObject.chapterIndex + 1 ||
+        chapterIndex > self.currentChapterIndex + self.windowRadius) {
+        return nil;
+    }
+
+    VirtualChapterSegment *segment = [self segmentWithChapter:chapterIndex text:text height:height];
+    [self.mutableSegments addObject:segment];
+    [self.offsetIndex appendChapter:chapterIndex height:segment.height];
+
+    VirtualDocumentUpdate *update = [[VirtualDocumentUpdate alloc] init];
+    update.insertedSegments = @[segment];
+    return update;
+}
+
+- (nullable VirtualDocumentUpdate *)prependChapter:(NSInteger)chapterIndex text:(NSString *)text height:(CGFloat)height {
+    if (self.mutableSegments.count == 0) {
+        return [self resetWithChapter:chapterIndex text:text height:height];
+    }
+    if (![self canPrependChapter:chapterIndex]) {
+        return nil;
+    }
+
+    VirtualChapterSegment *segment = [self segmentWithChapter:chapterIndex text:text height:height];
+    [self.mutableSegments insertObject:segment atIndex:0];
+    [self.offsetIndex prependChapter:chapterIndex height:segment.height];
+
+    // ⭐ 下面所有片段下移了 height，滚动位置同步下移，屏幕内容不动
+    VirtualDocumentUpdate *update = [[VirtualDocumentUpdate alloc] init];
+    update.insertedSegments = @[segment];
+    update.contentOffsetDelta = segment.height;
+    return update;
+}
+
+- (BOOL)canPrependChapter:(NSInteger)chapterIndex {
+    if (self.mutableSegments.count == 0) {
+        return YES;
+    }
+    return chapterIndex == self.mutableSegments.firstObject.chapterIndex - 1 &&
+           chapterIndex >= self.currentChapterIndex - self.windowRadius;
+}
+
+- (VirtualDocumentUpdate *)setHeight:(CGFloat)height forChapter:(NSInteger)chapterIndex {
+    VirtualDocumentUpdate *update = [[VirtualDocumentUpdate alloc] init];
+    VirtualChapterSegment *segment = [self segmentForChapter:chapterIndex];
+    if (!segment) {
+        return update;
+    }
+
+    CGFloat oldHeight = segment.height;
+    segment.height = MAX(height, 0);
+    [self.offsetIndex setHeight:segment.height forChapter:chapterIndex];
+
+    // 当前章节之前的片段变高 / 变矮，正在阅读的内容随之移动
+    if (chapterIndex < self.currentChapterIndex) {
+        update.contentOffsetDelta = segment.height - oldHeight;
+    }
+    return update;
+}
+
+- (VirtualDocumentUpdate *)updateCurrentChapter:(NSInteger)chapterIndex {
+    self.currentChapterIndex = chapterIndex;
+
+    NSMutableArray<VirtualChapterSegment *> *removed = [NSMutableArray array];
+    CGFloat delta = 0;
+
+    // 顶部淘汰：其下所有片段上移，滚动位置同步上移
+    while (self.mutableSegments.count > 1 &&
+           self.mutableSegments.firstObject.chapterIndex < chapterIndex - self.windowRadius) {
+        VirtualChapterSegment *segment = self.mutableSegments.firstObject;
+        delta -= segment.height;
+        [removed addObject:segment];
+        [self.mutableSegments removeObjectAtIndex:0];
+        [self.offsetIndex removeFirstChapter];
+    }
+
+    // 底部淘汰：不影响上方位置
+    while (self.mutableSegments.count > 1 &&
+           self.mutableSegments.lastObject.chapterIndex > chapterIndex + self.windowRadius) {
+        [removed addObject:self.mutableSegments.lastObject];
+        [self.mutableSegments removeLastObject];
+        [self.offsetIndex removeLastChapter];
+    }
+
+    VirtualDocumentUpdate *update = [[VirtualDocumentUpdate alloc] init];
+    update.removedSegments = removed;
+    update.contentOffsetDelta = delta;
+    return update;
+}
+
+- (VirtualDocumentUpdate *)removeAllSegments {
+    VirtualDocumentUpdate *update = [[VirtualDocumentUpdate alloc] init];
+    update.removedSegments = [self.mutableSegments copy];
+
+    [self.mutableSegments removeAllObjects];
+    [self.offsetIndex removeAllChapters];
+    self.currentChapterIndex = -1;
+    return update;
+}
+
+#pragma mark - 查询
+
+- (nullable VirtualChapterSegment *)segmentForChapter:(NSInteger)chapterIndex {
+    VirtualChapterSegment *first = self.mutableSegments.firstObject;
+    if (!first) {
+        return nil;
+    }
+    // 片段连续，直接按下标取
+    NSInteger position = chapterIndex - first.chapterIndex;
+    if (position < 0 || position >= (NSInteger)self.mutableSegments.count) {
+        return nil;
+    }
+    return self.mutableSegments[position];
+}
+
+- (CGFloat)offsetForChapter:(NSInteger)chapterIndex {
+    return [self.offsetIndex offsetForChapter:chapterIndex];
+}
+
+- (NSInteger)chapterAtOffset:(CGFloat)offset {
+    return [self.offsetIndex chapterAtOffset:offset];
+}
+
+#pragma mark - 私有方法
+
+- (VirtualChapterSegment *)segmentWithChapter:(NSInteger)chapterIndex text:(NSString *)text height:(CGFloat)height {
+    VirtualChapterSegment *segment = [[VirtualChapterSegment alloc] init];
+    segment.chapterIndex = chapterIndex;
+    segment.text = text;
+    segment.height = MAX(height, 0);
+    return segment;
+}
+
+@end
@@ -7,20 +7,10 @@
 
 #import <Foundation/Foundation.h>
 #import "BookSource.h"
+#import "SearchResultBook.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
-// 搜索结果书籍模型
-@interface SearchResultBook : NSObject
-@property (copy, nonatomic) NSString *name;           // 书名
-@property (copy, nonatomic) NSString *author;         // 作者
-@property (copy, nonatomic) NSString *bookUrl;        // 书籍详情URL
-@property (copy, nonatomic) NSString *intro;          // 简介
-@property (copy, nonatomic) NSString *lastChapter;    // 最新章节
-@property (copy, nonatomic) NSString *coverUrl;       // 封面URL
-@property (strong, nonatomic) BookSource *bookSource; // 来源书源
-@end
-
 // 搜索服务
 @interface BookSearchService : NSObject
 
@@ -48,6 +38,7 @@ NS_ASSUME_NONNULL_BEGIN
  * @param bookSources 书源数组
  * @param progress 进度回调（每完成一个书源）
  * @param completion 完成回调（所有书源搜索完成）
+ * 说明：按规则开销分从低到高发起请求，开销大的书源排在后面
  */
 - (void)searchBooks:(NSString *)keyword
         inBookSources:(NSArray<BookSource *> *)bookSources
@@ -7,11 +7,10 @@
 
 #import "BookSearchService.h"
 #import "NetworkManager.h"
-#import "HTMLParser.h"
-#import "RuleParser.h"
-
-@implementation SearchResultBook
-@end
+#import "SourceResponseParser.h"
+#import "MetricsRegistry.h"
+#import "RuleCostAnalyzer.h"
+#import "ParseExecutor.h"
 
 @interface BookSearchService ()
 @property (strong, nonatomic) NSOperationQueue *searchQueue;
@@ -72,6 +71,8 @@
     // 🚀 检查缓存
     NSString *cacheKey = [NSString stringWithFormat:@"%@_%@", keyword, bookSource.bookSourceName];
     NSArray *cachedResults = [self.searchCache objectForKey:cacheKey];
+    MetricsSource source = [MetricsRegistry sourceForBookSource:bookSource];
+    MetricsCount(source, cachedResults ? MetricCounterSearchCacheHit : MetricCounterSearchCacheMiss, 1);
     if (cachedResults) {
         // 缓存命中，直接返回
         if (success) {
@@ -152,7 +153,16 @@
     NSMutableArray<SearchResultBook *> *allBooks = [NSMutableArray array];
     dispatch_group_t group = dispatch_group_create();
 
-    for (BookSource *source in bookSources) {
+    // ⭐ 规则开销小的书源先发起，结果先到；未分析的（0 分）保持原顺序排在最前
+    NSArray<BookSource *> *orderedSources = [bookSources sortedArrayWithOptions:NSSortStable
+                                                                usingComparator:^NSComparisonResult(BookSource *a, BookSource *b) {
+        if (a.costScore == b.costScore) {
+            return NSOrderedSame;
+        }
+        return a.costScore < b.costScore ? NSOrderedAscending : NSOrderedDescending;
+    }];
+
+    for (BookSource *source in orderedSources) {
         if (!source.enabled) {
             continue;
         }
@@ -199,9 +209,10 @@
                    success:(void(^)(NSArray<SearchResultBook *> *books))success
                    failure:(void(^)(NSError *error))failure {
 
-    // 🚀 性能优化：在后台线程解析 HTML/JSON
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-        NSArray<SearchResultBook *> *books = [self parseHTML:html bookSource:bookSource];
+    // 🚀 性能优化：在解析线程池中解析 HTML/JSON；开销过大的书源降低优先级，不挤占其他书源
+    ParseExecutorPriority priority = [RuleCostAnalyzer isSlowBookSource:bookSource] ? ParseExecutorPriorityLow : ParseExecutorPriorityNormal;
+    [[ParseExecutor sharedExecutor] submitWithPriority:priority block:^{
+        NSArray<SearchResultBook *> *books = [SourceResponseParser booksFromSearchContent:html bookSource:bookSource];
 
         // 回到主线程返回结果
         dispatch_async(dispatch_get_main_queue(), ^{
@@ -218,86 +229,7 @@
                 }
             }
         });
-    });
-}
-
-// 实际的解析逻辑（在后台线程执行）
-- (NSArray<SearchResultBook *> *)parseHTML:(NSString *)html bookSource:(BookSource *)bookSource {
-
-    if (!html || html.length == 0) {
-        return nil;
-    }
-
-    RuleSearch *searchRule = bookSource.ruleSearch;
-    if (!searchRule) {
-        return nil;
-    }
-
-    // 使用 RuleParser 提取书籍列表（自动检测 JSON 或 HTML）
-    id bookListResult = [RuleParser extractFromContent:html withRule:searchRule.bookList];
-    NSArray *bookElements = nil;
-
-    if ([bookListResult isKindOfClass:[NSArray class]]) {
-        bookElements = bookListResult;
-    } else if ([bookListResult isKindOfClass:[NSDictionary class]]) {
-        bookElements = @[bookListResult];
-    } else if ([bookListResult isKindOfClass:[NSString class]]) {
-        bookElements = @[bookListResult];
-    } else {
-        return @[];
-    }
-
-    // 解析每本书的信息
-    NSMutableArray<SearchResultBook *> *books = [NSMutableArray array];
-
-    for (id bookElement in bookElements) {
-        SearchResultBook *book = [[SearchResultBook alloc] init];
-        book.bookSource = bookSource;
-
-        // 根据元素类型选择解析方式
-        if ([bookElement isKindOfClass:[NSDictionary class]]) {
-            // JSON 对象，直接提取字段
-            NSDictionary *bookDict = (NSDictionary *)bookElement;
-            book.name = [RuleParser extractFromJSON:bookDict withRule:searchRule.name];
-            book.author = [RuleParser extractFromJSON:bookDict withRule:searchRule.author];
-
-            // 提取书籍URL（可能需要模板替换）
-            NSString *bookUrlRule = searchRule.bookUrl;
-            if ([bookUrlRule containsString:@"{{$."]) {
-                book.bookUrl = [RuleParser applyTemplate:bookUrlRule withData:bookDict];
-            } else {
-                book.bookUrl = [RuleParser extractFromJSON:bookDict withRule:bookUrlRule];
-            }
-
-            book.intro = [RuleParser extractFromJSON:bookDict withRule:searchRule.intro];
-            book.lastChapter = [RuleParser extractFromJSON:bookDict withRule:searchRule.lastChapter];
-
-            // 封面URL（如果有）
-            if (searchRule.coverUrl) {
-                book.coverUrl = [RuleParser extractFromJSON:bookDict withRule:searchRule.coverUrl];
-            }
-        } else if ([bookElement isKindOfClass:[NSString class]]) {
-            // HTML 字符串，使用 HTMLParser
-            NSString *html = (NSString *)bookElement;
-            book.name = [HTMLParser extractFromHTML:html withRule:searchRule.name];
-            book.author = [HTMLParser extractFromHTML:html withRule:searchRule.author];
-            book.bookUrl = [HTMLParser extractFromHTML:html withRule:searchRule.bookUrl];
-            book.intro = [HTMLParser extractFromHTML:html withRule:searchRule.intro];
-            book.lastChapter = [HTMLParser extractFromHTML:html withRule:searchRule.lastChapter];
-        }
-
-        // 处理相对URL
-        if (book.bookUrl && ![book.bookUrl hasPrefix:@"http"]) {
-            book.bookUrl = [self absoluteURL:book.bookUrl baseURL:bookSource.bookSourceUrl];
-        }
-
-        // 如果书名不为空，添加到结果
-        if (book.name && book.name.length > 0) {
-            [books addObject:book];
-        }
-    }
-
-    return books;
+    }];
 }
 
 #pragma mark - URL 处理
@@ -355,27 +287,6 @@
     return result;
 }
 
-- (NSString *)absoluteURL:(NSString *)relativeURL baseURL:(NSString *)baseURL {
-    if ([relativeURL hasPrefix:@"http"]) {
-        return relativeURL;
-    }
-
-    // 移除 baseURL 末尾的斜杠和 # 符号
-    if ([baseURL hasSuffix:@"#"]) {
-        baseURL = [baseURL substringToIndex:baseURL.length - 1];
-    }
-    if ([baseURL hasSuffix:@"/"]) {
-        baseURL = [baseURL substringToIndex:baseURL.length - 1];
-    }
-
-    // 处理相对路径
-    if ([relativeURL hasPrefix:@"/"]) {
-        return [baseURL stringByAppendingString:relativeURL];
-    } else {
-        return [baseURL stringByAppendingFormat:@"/%@", relativeURL];
-    }
-}
-
 - (NSDictionary<NSString *, NSString *> *)parseHeaders:(NSString *)headerString {
     if (!headerString || headerString.length == 0) {
         return nil;
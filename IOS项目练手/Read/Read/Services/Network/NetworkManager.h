@@ -6,6 +6,7 @@
 //
 
 #import <Foundation/Foundation.h>
+#import "ParseExecutor.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -46,6 +47,17 @@ typedef void(^NetworkFailureBlock)(NSError *error);
     success:(NetworkSuccessBlock)success
     failure:(NetworkFailureBlock)failure;
 
+/**
+ * 发送 GET 请求（指定优先级）
+ * @param priority 高优先级（阅读页的目录和正文）不在解析积压后面排队，直接发出
+ */
+- (void)GET:(NSString *)urlString
+    headers:(nullable NSDictionary<NSString *, NSString *> *)headers
+   encoding:(nullable NSString *)encoding
+   priority:(ParseExecutorPriority)priority
+    success:(NetworkSuccessBlock)success
+    failure:(NetworkFailureBlock)failure;
+
 /**
  * 发送 POST 请求
  * @param urlString 请求URL
@@ -89,6 +101,22 @@ typedef void(^NetworkFailureBlock)(NSError *error);
  */
 - (void)cancelAllRequests;
 
+#pragma mark - 回放
+
+/**
+ * 回放服务器地址（nil 表示直连）
+ */
+@property (strong, nonatomic, readonly, nullable) NSURL *replayBaseURL;
+
+/**
+ * 把所有请求转发到本地回放服务器（压测用，见 Benchmarks/ReplayServer）
+ * 原始 URL scheme://host/path?query 改写为 baseURL/scheme/host/path?query，服务器据此返回录制的响应
+ * @param baseURL 回放服务器地址，nil 恢复直连
+ * @param hostCount 被回放的站点数：所有站点合并到同一个本地地址后，每站点连接数上限按此放大，
+ *                  保持和直连时相同的总并发
+ */
+- (void)setReplayBaseURL:(nullable NSURL *)baseURL hostCount:(NSUInteger)hostCount;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -6,10 +6,17 @@
 //
 
 #import "NetworkManager.h"
+#import "TraceRecorder.h"
+#import "MetricsRegistry.h"
+#import "ParseExecutor.h"
+
+static const NSInteger kMaxConnectionsPerHost = 5;
 
 @interface NetworkManager ()
 @property (strong, nonatomic) NSURLSession *session;
 @property (strong, nonatomic) NSMutableArray<NSURLSessionTask *> *tasks;
+@property (strong, nonatomic, readwrite, nullable) NSURL *replayBaseURL;
+@property (assign, nonatomic) NSUInteger cancelGeneration;   // 每次取消全部请求时递增，排队中的请求据此放弃
 @end
 
 @implementation NetworkManager
@@ -26,19 +33,25 @@
 - (instancetype)init {
     self = [super init];
     if (self) {
-        // 配置 URLSession
-        NSURLSessionConfiguration *config = [NSURLSessionConfiguration defaultSessionConfiguration];
-        config.timeoutIntervalForRequest = 15.0;  // 15秒超时（平衡速度与可靠性）
-        config.timeoutIntervalForResource = 30.0;  // 资源总超时30秒
-        config.HTTPMaximumConnectionsPerHost = 5;
-        config.requestCachePolicy = NSURLRequestReturnCacheDataElseLoad;  // 优先使用缓存
-
-        _session = [NSURLSession sessionWithConfiguration:config];
+        _session = [self sessionWithMaxConnectionsPerHost:kMaxConnectionsPerHost
+                                              cachePolicy:NSURLRequestReturnCacheDataElseLoad];  // 优先使用缓存
         _tasks = [NSMutableArray array];
     }
     return self;
 }
 
+- (NSURLSession *)sessionWithMaxConnectionsPerHost:(NSInteger)maxConnections
+                                       cachePolicy:(NSURLRequestCachePolicy)cachePolicy {
+    // 配置 URLSession
+    NSURLSessionConfiguration *config = [NSURLSessionConfiguration defaultSessionConfiguration];
+    config.timeoutIntervalForRequest = 15.0;  // 15秒超时（平衡速度与可靠性）
+    config.timeoutIntervalForResource = 30.0;  // 资源总超时30秒
+    config.HTTPMaximumConnectionsPerHost = maxConnections;
+    config.requestCachePolicy = cachePolicy;
+
+    return [NSURLSession sessionWithConfiguration:config];
+}
+
 #pragma mark - GET 请求
 
 - (void)GET:(NSString *)urlString
@@ -53,6 +66,15 @@
    encoding:(nullable NSString *)encoding
     success:(NetworkSuccessBlock)success
     failure:(NetworkFailureBlock)failure {
+    [self GET:urlString headers:headers encoding:encoding priority:ParseExecutorPriorityNormal success:success failure:failure];
+}
+
+- (void)GET:(NSString *)urlString
+    headers:(nullable NSDictionary<NSString *, NSString *> *)headers
+   encoding:(nullable NSString *)encoding
+   priority:(ParseExecutorPriority)priority
+    success:(NetworkSuccessBlock)success
+    failure:(NetworkFailureBlock)failure {
 
     if (!urlString || urlString.length == 0) {
         if (failure) {
@@ -91,7 +113,7 @@
         }
     }
 
-    [self sendRequest:request encoding:encoding success:success failure:failure];
+    [self sendRequest:request encoding:encoding priority:priority success:success failure:failure];
 }
 
 #pragma mark - POST 请求
@@ -142,7 +164,7 @@
         request.HTTPBody = [bodyString dataUsingEncoding:NSUTF8StringEncoding];
     }
 
-    [self sendRequest:request encoding:encoding success:success failure:failure];
+    [self sendRequest:request encoding:encoding priority:ParseExecutorPriorityNormal success:success failure:failure];
 }
 
 - (void)POST:(NSString *)urlString
@@ -181,18 +203,61 @@
         request.HTTPBody = [body dataUsingEncoding:NSUTF8StringEncoding];
     }
 
-    [self sendRequest:request encoding:encoding success:success failure:failure];
+    [self sendRequest:request encoding:encoding priority:ParseExecutorPriorityNormal success:success failure:failure];
 }
 
 #pragma mark - 通用请求发送
 
 - (void)sendRequest:(NSURLRequest *)request
            encoding:(nullable NSString *)encoding
+           priority:(ParseExecutorPriority)priority
             success:(NetworkSuccessBlock)success
             failure:(NetworkFailureBlock)failure {
 
+    // 按原始站点归属（回放时 URL 会被改写到本地）
+    MetricsSource source = [MetricsRegistry sourceWithName:nil host:request.URL.host];
+
+    if (self.replayBaseURL) {
+        NSMutableURLRequest *replayRequest = [request mutableCopy];
+        replayRequest.URL = [self replayURLForURL:request.URL];
+        request = replayRequest;
+    }
+
+    // ⭐ 解析积压已满时暂缓发出请求：响应到达后总要解析，不再多读进更多响应体（阅读页请求不排队）
+    NSUInteger generation = self.cancelGeneration;
+    [[ParseExecutor sharedExecutor] performWithPriority:priority whenAccepting:^{
+        if (generation != self.cancelGeneration) {
+            // 排队期间调用了 cancelAllRequests
+            [[ParseExecutor sharedExecutor] endAdmission];
+            if (failure) {
+                failure([NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]);
+            }
+            return;
+        }
+        [self startRequest:request source:source encoding:encoding success:success failure:failure];
+    }];
+}
+
+/**
+ * 发出请求（主线程，已获得解析准入，回调执行完后归还）
+ */
+- (void)startRequest:(NSURLRequest *)request
+              source:(MetricsSource)source
+            encoding:(nullable NSString *)encoding
+             success:(NetworkSuccessBlock)success
+             failure:(NetworkFailureBlock)failure {
+    TraceSpan requestSpan = TraceSpanBegin("network", "request");
+    uint64_t requestStart = MetricsNow();
     NSURLSessionDataTask *task = [self.session dataTaskWithRequest:request
                                                  completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        TRACE_END_ASYNC(requestSpan, request.URL.absoluteString.UTF8String, (int64_t)data.length);
+        MetricsRecordTime(source, MetricTimerRequest, MetricsNow() - requestStart);
+        if (error || !data) {
+            MetricsCount(source, MetricCounterRequestErrors, 1);
+        } else {
+            MetricsCount(source, MetricCounterRequestBytes, data.length);
+        }
+
         // 从任务列表中移除
         dispatch_async(dispatch_get_main_queue(), ^{
             [self.tasks removeObject:task];
@@ -203,6 +268,7 @@
                 if (failure) {
                     failure(error);
                 }
+                [[ParseExecutor sharedExecutor] endAdmission];
             });
             return;
         }
@@ -215,21 +281,28 @@
                 if (failure) {
                     failure(emptyError);
                 }
+                [[ParseExecutor sharedExecutor] endAdmission];
             });
             return;
         }
 
         // 解析 HTML（使用指定的编码）
+        TraceSpan decodeSpan = TraceSpanBegin("network", "decode");
+        uint64_t decodeStart = MetricsNow();
         NSString *html = [self parseHTMLFromData:data encoding:encoding];
+        MetricsRecordTime(source, MetricTimerDecode, MetricsNow() - decodeStart);
+        TRACE_END(decodeSpan, encoding.UTF8String, (int64_t)data.length);
 
         if (!html) {
             html = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] ?: @"";
         }
 
+        // 成功回调中把响应交给解析任务后再归还名额
         dispatch_async(dispatch_get_main_queue(), ^{
             if (success) {
                 success(data, html);
             }
+            [[ParseExecutor sharedExecutor] endAdmission];
         });
     }];
 
@@ -313,7 +386,7 @@
     }
 
 
-    NSURLSessionDataTask *task = [self.session dataTaskWithURL:url
+    NSURLSessionDataTask *task = [self.session dataTaskWithURL:[self replayURLForURL:url]
                                              completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
         dispatch_async(dispatch_get_main_queue(), ^{
             [self.tasks removeObject:task];
@@ -355,6 +428,7 @@
 #pragma mark - 任务管理
 
 - (void)cancelAllRequests {
+    self.cancelGeneration++;
 
     for (NSURLSessionTask *task in self.tasks) {
         [task cancel];
@@ -363,5 +437,36 @@
     [self.tasks removeAllObjects];
 }
 
+#pragma mark - 回放
+
+- (void)setReplayBaseURL:(nullable NSURL *)baseURL hostCount:(NSUInteger)hostCount {
+    self.replayBaseURL = baseURL;
+
+    // ⭐ 回放时不走 URL 缓存，每个请求都经过回放服务器的延迟和带宽模拟
+    NSURLSession *oldSession = self.session;
+    if (baseURL) {
+        self.session = [self sessionWithMaxConnectionsPerHost:kMaxConnectionsPerHost * MAX(hostCount, 1)
+                                                  cachePolicy:NSURLRequestReloadIgnoringLocalCacheData];
+    } else {
+        self.session = [self sessionWithMaxConnectionsPerHost:kMaxConnectionsPerHost
+                                                  cachePolicy:NSURLRequestReturnCacheDataElseLoad];
+    }
+    [oldSession finishTasksAndInvalidate];
+}
+
+- (NSURL *)replayURLForURL:(NSURL *)url {
+    if (!self.replayBaseURL || !url.host) {
+        return url;
+    }
+
+    NSURLComponents *original = [NSURLComponents componentsWithURL:url resolvingAgainstBaseURL:YES];
+    NSURLComponents *replay = [NSURLComponents componentsWithURL:self.replayBaseURL resolvingAgainstBaseURL:YES];
+    NSString *host = original.port ? [NSString stringWithFormat:@"%@:%@", original.host, original.port] : original.host;
+    replay.percentEncodedPath = [NSString stringWithFormat:@"/%@/%@%@",
+                                 original.scheme, host, original.percentEncodedPath.length > 0 ? original.percentEncodedPath : @"/"];
+    replay.percentEncodedQuery = original.percentEncodedQuery;
+    return replay.URL ?: url;
+}
+
 @end
 
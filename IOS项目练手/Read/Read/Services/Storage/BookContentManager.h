@@ -6,6 +6,7 @@
 //
 
 #import <Foundation/Foundation.h>
+#import "ChapterSearchIndex.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -46,6 +47,14 @@ NS_ASSUME_NONNULL_BEGIN
 // 获取书籍的所有已下载章节
 - (NSArray<Chapter *> *)downloadedChaptersForBookId:(NSString *)bookId;
 
+#pragma mark - 全文搜索
+
+// 获取书籍的全文索引（保存章节时自动更新）
+- (ChapterSearchIndex *)searchIndexForBookId:(NSString *)bookId;
+
+// 在已下载章节中搜索文本，返回章节索引和偏移
+- (NSArray<ChapterSearchHit *> *)searchText:(NSString *)text inBookId:(NSString *)bookId limit:(NSUInteger)limit;
+
 #pragma mark - 缓存管理
 
 // 获取缓存大小（字节）
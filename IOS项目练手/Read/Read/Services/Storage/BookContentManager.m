@@ -6,12 +6,18 @@
 //
 
 #import "BookContentManager.h"
+#import "ChapterSearchIndex.h"
+#import "TraceRecorder.h"
+#import <UIKit/UIKit.h>
+
+static NSString * const kSearchIndexFileName = @"search.idx";
 
 @implementation Chapter
 @end
 
 @interface BookContentManager ()
 @property (copy, nonatomic) NSString *cacheDirectory;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, ChapterSearchIndex *> *searchIndexes;  // 每本书一个实例，不能被淘汰（受 @synchronized(self) 保护）
 @end
 
 @implementation BookContentManager
@@ -37,6 +43,13 @@
         if (![fm fileExistsAtPath:_cacheDirectory]) {
             [fm createDirectoryAtPath:_cacheDirectory withIntermediateDirectories:YES attributes:nil error:nil];
         }
+
+        _searchIndexes = [NSMutableDictionary dictionary];
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(didReceiveMemoryWarning)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
     }
     return self;
 }
@@ -62,6 +75,8 @@
         return NO;
     }
 
+    TRACE_SCOPE("storage", "saveChapter");
+
     // 确保书籍目录存在
     NSString *bookDir = [self directoryForBookId:chapter.bookId];
     NSFileManager *fm = [NSFileManager defaultManager];
@@ -92,9 +107,17 @@
     }
 
     NSString *filePath = [self filePathForBookId:chapter.bookId chapterId:chapter.chapterId];
+    BOOL overwriting = [fm fileExistsAtPath:filePath];
     BOOL success = [jsonData writeToFile:filePath atomically:YES];
 
     if (success) {
+        // ⭐ 顺带更新全文索引（在索引队列上异步完成，不阻塞保存）；覆盖已有章节时替换旧的倒排
+        ChapterSearchIndex *index = [self searchIndexForBookId:chapter.bookId];
+        if (overwriting) {
+            [index replaceChapter:chapter.chapterId.integerValue content:chapter.content];
+        } else {
+            [index addChapter:chapter.chapterId.integerValue content:chapter.content];
+        }
     } else {
     }
 
@@ -102,6 +125,7 @@
 }
 
 - (nullable Chapter *)loadChapterWithBookId:(NSString *)bookId chapterId:(NSString *)chapterId {
+    TRACE_SCOPE("storage", "loadChapter");
     NSString *filePath = [self filePathForBookId:bookId chapterId:chapterId];
 
     if (![[NSFileManager defaultManager] fileExistsAtPath:filePath]) {
@@ -158,12 +182,19 @@
     NSString *bookDir = [self directoryForBookId:bookId];
     NSFileManager *fm = [NSFileManager defaultManager];
 
-    if (![fm fileExistsAtPath:bookDir]) {
-        return YES; // 目录不存在，视为删除成功
-    }
-
     NSError *error = nil;
-    BOOL success = [fm removeItemAtPath:bookDir error:&error];
+    BOOL success;
+    @synchronized (self) {
+        // 索引文件在书籍目录内，一并删除（先等待已排队的写入，避免删除后又建回目录）
+        [self.searchIndexes[bookId] removeAllEntries];
+        [self.searchIndexes removeObjectForKey:bookId];
+
+        if (![fm fileExistsAtPath:bookDir]) {
+            return YES; // 目录不存在，视为删除成功
+        }
+
+        success = [fm removeItemAtPath:bookDir error:&error];
+    }
 
     if (success) {
     } else {
@@ -205,6 +236,50 @@
     return chapters;
 }
 
+#pragma mark - 全文搜索
+
+- (ChapterSearchIndex *)searchIndexForBookId:(NSString *)bookId {
+    @synchronized (self) {
+        ChapterSearchIndex *index = self.searchIndexes[bookId];
+        if (!index) {
+            NSString *path = [[self directoryForBookId:bookId] stringByAppendingPathComponent:kSearchIndexFileName];
+            index = [[ChapterSearchIndex alloc] initWithFilePath:path];
+            self.searchIndexes[bookId] = index;
+            [self indexDownloadedChaptersForBookId:bookId index:index];
+        }
+        return index;
+    }
+}
+
+- (NSArray<ChapterSearchHit *> *)searchText:(NSString *)text inBookId:(NSString *)bookId limit:(NSUInteger)limit {
+    if (text.length == 0 || bookId.length == 0) {
+        return @[];
+    }
+    return [[self searchIndexForBookId:bookId] search:text limit:limit];
+}
+
+// 补齐索引建立之前已下载的章节
+- (void)indexDownloadedChaptersForBookId:(NSString *)bookId index:(ChapterSearchIndex *)index {
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        NSArray<NSString *> *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:[self directoryForBookId:bookId] error:nil];
+        for (NSString *fileName in files) {
+            if (![fileName hasSuffix:@".json"]) {
+                continue;
+            }
+            NSString *chapterId = [fileName stringByDeletingPathExtension];
+            if ([index containsChapter:chapterId.integerValue]) {
+                continue;
+            }
+            @autoreleasepool {
+                Chapter *chapter = [self loadChapterWithBookId:bookId chapterId:chapterId];
+                if (chapter.content.length > 0) {
+                    [index addChapter:chapterId.integerValue content:chapter.content];
+                }
+            }
+        }
+    });
+}
+
 #pragma mark - 缓存管理
 
 - (unsigned long long)getCacheSize {
@@ -240,12 +315,20 @@
     }
 
     NSError *error = nil;
-    BOOL success = [fm removeItemAtPath:self.cacheDirectory error:&error];
+    BOOL success;
+    @synchronized (self) {
+        for (ChapterSearchIndex *index in self.searchIndexes.allValues) {
+            [index removeAllEntries];
+        }
+        [self.searchIndexes removeAllObjects];
 
-    if (success) {
-        // 重新创建缓存目录
-        [fm createDirectoryAtPath:self.cacheDirectory withIntermediateDirectories:YES attributes:nil error:nil];
-    } else {
+        success = [fm removeItemAtPath:self.cacheDirectory error:&error];
+
+        if (success) {
+            // 重新创建缓存目录
+            [fm createDirectoryAtPath:self.cacheDirectory withIntermediateDirectories:YES attributes:nil error:nil];
+        } else {
+        }
     }
 
     return success;
@@ -255,6 +338,17 @@
     return [self deleteAllChaptersForBookId:bookId];
 }
 
+#pragma mark - 内存紧张
+
+- (void)didReceiveMemoryWarning {
+    // 只释放内存中的倒排表，实例保留（保证每本书只有一个实例写索引文件）
+    @synchronized (self) {
+        for (ChapterSearchIndex *index in self.searchIndexes.allValues) {
+            [index unloadFromMemory];
+        }
+    }
+}
+
 // 格式化缓存大小
 + (NSString *)formatCacheSize:(unsigned long long)size {
     if (size < 1024) {
@@ -0,0 +1,39 @@
+//
+//  BookSourceImporter.h
+//  Read
+//
+//  书源流式导入器 - 逐个解析 JSON 数组元素，避免整体反序列化
+//
+
+#import <Foundation/Foundation.h>
+#import "BookSource.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 书源流式导入器
+ *
+ * 职责：
+ *   1. 扫描 JSON 数组的字节流，逐个切出元素并单独反序列化
+ *   2. 每解析出一个书源立即回调，内存中同时只存在一个元素的字典
+ *   3. 按已处理字节数报告进度
+ *
+ * 使用示例：
+ *   [BookSourceImporter enumerateBookSourcesInData:data usingBlock:^(BookSource *source, double fraction, BOOL *stop) {
+ *       [sources addObject:source];
+ *   }];
+ */
+@interface BookSourceImporter : NSObject
+
+/**
+ * 逐个解析书源
+ * @param data JSON 数据（顶层为数组或单个书源对象）
+ * @param block 每个书源回调一次，fraction 为已处理字节比例（0~1）
+ * @return 顶层结构合法返回 YES（单个元素损坏只会被跳过）
+ */
++ (BOOL)enumerateBookSourcesInData:(NSData *)data
+                        usingBlock:(void (^)(BookSource *source, double fraction, BOOL *stop))block;
+
+@end
+
+NS_ASSUME_NONNULL_END
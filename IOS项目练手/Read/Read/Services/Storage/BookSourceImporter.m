@@ -0,0 +1,148 @@
+//
+//  BookSourceImporter.m
+//  Read
+//
+//  书源流式导入器实现
+//
+
+#import "BookSourceImporter.h"
+
+#pragma mark - 字节扫描
+
+static NSUInteger ImporterSkipWhitespace(const uint8_t *bytes, NSUInteger length, NSUInteger index) {
+    while (index < length) {
+        uint8_t c = bytes[index];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            break;
+        }
+        index++;
+    }
+    return index;
+}
+
+/**
+ * 找到从 start 开始的 JSON 值的结束位置（返回值之后的下标），结构不完整时返回 NSNotFound
+ */
+static NSUInteger ImporterFindValueEnd(const uint8_t *bytes, NSUInteger length, NSUInteger start) {
+    NSInteger depth = 0;
+    BOOL inString = NO;
+
+    for (NSUInteger i = start; i < length; i++) {
+        uint8_t c = bytes[i];
+
+        if (inString) {
+            if (c == '\\') {
+                i++;  // 跳过转义字符
+            } else if (c == '"') {
+                inString = NO;
+                if (depth == 0) {
+                    return i + 1;
+                }
+            }
+            continue;
+        }
+
+        switch (c) {
+            case '"':
+                inString = YES;
+                break;
+            case '{':
+            case '[':
+                depth++;
+                break;
+            case '}':
+            case ']':
+                if (depth == 0) {
+                    return i;  // 标量值后紧跟数组结束
+                }
+                depth--;
+                if (depth == 0) {
+                    return i + 1;
+                }
+                break;
+            case ',':
+                if (depth == 0) {
+                    return i;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return depth == 0 && !inString ? length : NSNotFound;
+}
+
+@implementation BookSourceImporter
+
++ (BOOL)enumerateBookSourcesInData:(NSData *)data
+                        usingBlock:(void (^)(BookSource *source, double fraction, BOOL *stop))block {
+    const uint8_t *bytes = data.bytes;
+    NSUInteger length = data.length;
+    NSUInteger index = 0;
+
+    // 跳过 UTF-8 BOM
+    if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+        index = 3;
+    }
+    index = ImporterSkipWhitespace(bytes, length, index);
+    if (index >= length) {
+        return NO;
+    }
+
+    // 单个书源对象
+    if (bytes[index] == '{') {
+        NSDictionary *json = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+        if (![json isKindOfClass:[NSDictionary class]]) {
+            return NO;
+        }
+        BOOL stop = NO;
+        block([BookSource bookSourceFromJSON:json], 1.0, &stop);
+        return YES;
+    }
+
+    if (bytes[index] != '[') {
+        return NO;
+    }
+    index++;
+
+    BOOL stop = NO;
+    while (!stop) {
+        index = ImporterSkipWhitespace(bytes, length, index);
+        if (index >= length) {
+            return NO;  // 缺少 ]
+        }
+        if (bytes[index] == ']') {
+            return YES;
+        }
+
+        NSUInteger end = ImporterFindValueEnd(bytes, length, index);
+        if (end == NSNotFound || end <= index) {
+            return NO;
+        }
+
+        if (bytes[index] == '{') {
+            @autoreleasepool {
+                // ⭐ 只反序列化当前元素，不复制字节
+                NSData *element = [NSData dataWithBytesNoCopy:(void *)(bytes + index)
+                                                       length:end - index
+                                                 freeWhenDone:NO];
+                NSDictionary *json = [NSJSONSerialization JSONObjectWithData:element options:0 error:nil];
+                if ([json isKindOfClass:[NSDictionary class]]) {
+                    block([BookSource bookSourceFromJSON:json], (double)end / length, &stop);
+                } else {
+                    NSLog(@"⚠️ 跳过无法解析的书源（偏移 %lu）", (unsigned long)index);
+                }
+            }
+        }
+
+        index = ImporterSkipWhitespace(bytes, length, end);
+        if (index < length && bytes[index] == ',') {
+            index++;
+        }
+    }
+
+    return YES;
+}
+
+@end
@@ -27,6 +27,9 @@ NS_ASSUME_NONNULL_BEGIN
 // 根据分组获取书源
 - (NSArray<BookSource *> *)bookSourcesInGroup:(NSString *)group;
 
+// 获取所有分组（按首次出现顺序）
+- (NSArray<NSString *> *)allGroups;
+
 // 添加书源
 - (BOOL)addBookSource:(BookSource *)source;
 
@@ -42,13 +45,23 @@ NS_ASSUME_NONNULL_BEGIN
 // 从 JSON 文件导入书源
 - (BOOL)importBookSourcesFromFile:(NSString *)filePath;
 
+/**
+ * 流式导入书源（后台逐个解析，适合数千条的书源包）
+ * @param data JSON 数据（数组或单个书源）
+ * @param progress 进度回调（主线程），importedCount 为已解析数量
+ * @param completion 完成回调（主线程）
+ */
+- (void)importBookSourcesFromData:(NSData *)data
+                         progress:(nullable void (^)(NSUInteger importedCount, double fraction))progress
+                       completion:(nullable void (^)(NSUInteger importedCount, BOOL success))completion;
+
 // 导出所有书源为 JSON 数组
 - (NSArray *)exportBookSourcesToJSONArray;
 
-// 保存到本地
+// 保存到本地（二进制快照，立即写入；单个书源的增删改会合并后延迟写入）
 - (BOOL)saveToLocal;
 
-// 从本地加载（优先从 Documents 读取，不存在则从 Bundle 读取）
+// 从本地加载（优先读取 Documents 中的快照，不存在则从 Bundle 读取）
 - (BOOL)loadFromLocal;
 
 // 重置为默认书源（从 Bundle 重新加载）
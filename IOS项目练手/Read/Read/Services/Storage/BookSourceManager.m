@@ -6,10 +6,24 @@
 //
 
 #import "BookSourceManager.h"
+#import <UIKit/UIKit.h>
+#import "BookSourceSnapshot.h"
+#import "BookSourceImporter.h"
+#import "RuleCostAnalyzer.h"
+
+static const NSUInteger kImportProgressBatch = 200;  // 每解析多少条报告一次进度
+static const NSTimeInterval kSaveDebounceInterval = 1.0;  // 单个书源修改后延迟写入快照的时间
 
 @interface BookSourceManager ()
 @property (strong, nonatomic) NSMutableArray<BookSource *> *bookSources;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, BookSource *> *nameIndex;   // 名称 -> 书源
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSMutableArray<BookSource *> *> *groupIndex;  // 分组 -> 书源
+@property (strong, nonatomic) NSMutableArray<NSString *> *groupOrder;  // 分组首次出现顺序
 @property (copy, nonatomic) NSString *dataFilePath;
+@property (copy, nonatomic) NSString *legacyJSONFilePath;  // 旧版 JSON 存储路径
+@property (strong, nonatomic) dispatch_queue_t ioQueue;    // 快照写盘队列
+@property (strong, nonatomic) dispatch_source_t saveTimer; // 防抖定时器（主线程触发）
+@property (assign, nonatomic) BOOL savePending;            // 有未写入的修改
 @end
 
 @implementation BookSourceManager
@@ -27,10 +41,34 @@
     self = [super init];
     if (self) {
         _bookSources = [NSMutableArray array];
+        _nameIndex = [NSMutableDictionary dictionary];
+        _groupIndex = [NSMutableDictionary dictionary];
+        _groupOrder = [NSMutableArray array];
 
         // 设置数据文件路径
         NSString *docPath = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) firstObject];
-        _dataFilePath = [docPath stringByAppendingPathComponent:@"book_sources.json"];
+        _dataFilePath = [docPath stringByAppendingPathComponent:@"book_sources.bin"];
+        _legacyJSONFilePath = [docPath stringByAppendingPathComponent:@"book_sources.json"];
+        _ioQueue = dispatch_queue_create("com.read.booksource.save", DISPATCH_QUEUE_SERIAL);
+
+        // ⭐ 防抖：连续切换/删除多个书源只重写一次快照
+        // 书源数组只在主线程修改，所以定时器在主线程触发、在主线程编码，写盘放到 ioQueue
+        _saveTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_main_queue());
+        dispatch_source_set_timer(_saveTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        __weak typeof(self) weakSelf = self;
+        dispatch_source_set_event_handler(_saveTimer, ^{
+            [weakSelf flushPendingSave];
+        });
+        dispatch_resume(_saveTimer);
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(flushPendingSaveAndWait)
+                                                     name:UIApplicationDidEnterBackgroundNotification
+                                                   object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(flushPendingSaveAndWait)
+                                                     name:UIApplicationWillTerminateNotification
+                                                   object:nil];
 
         // 加载数据
         [self loadFromLocal];
@@ -38,6 +76,11 @@
     return self;
 }
 
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    dispatch_source_cancel(_saveTimer);
+}
+
 #pragma mark - 查询
 
 - (NSArray<BookSource *> *)allBookSources {
@@ -45,36 +88,70 @@
 }
 
 - (NSArray<BookSource *> *)enabledBookSources {
-    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"enabled == YES"];
-    return [self.bookSources filteredArrayUsingPredicate:predicate];
-}
-
-- (NSArray<BookSource *> *)bookSourcesInGroup:(NSString *)group {
-    // 手动过滤，避免 NSNull 问题
     NSMutableArray *result = [NSMutableArray array];
     for (BookSource *source in self.bookSources) {
-        NSString *sourceGroup = source.bookSourceGroup;
-        // 安全地比较，过滤 NSNull
-        if (sourceGroup &&
-            ![sourceGroup isKindOfClass:[NSNull class]] &&
-            [sourceGroup isEqualToString:group]) {
+        if (source.enabled) {
             [result addObject:source];
         }
     }
     return result;
 }
 
+- (NSArray<BookSource *> *)bookSourcesInGroup:(NSString *)group {
+    if (!group) {
+        return @[];
+    }
+    return [self.groupIndex[group] copy] ?: @[];
+}
+
+- (NSArray<NSString *> *)allGroups {
+    return [self.groupOrder copy];
+}
+
 - (BookSource *)getBookSourceByName:(NSString *)name {
     if (!name || name.length == 0) {
         return nil;
     }
+    return self.nameIndex[name];
+}
 
-    for (BookSource *source in self.bookSources) {
-        if ([source.bookSourceName isEqualToString:name]) {
-            return source;
+#pragma mark - 索引
+
+- (void)indexBookSource:(BookSource *)source {
+    // 同名时保留最先出现的书源，与原先线性查找的结果一致
+    NSString *name = source.bookSourceName;
+    if ([name isKindOfClass:[NSString class]] && name.length > 0 && !self.nameIndex[name]) {
+        self.nameIndex[name] = source;
+    }
+
+    // 过滤 NSNull 和空分组
+    NSString *group = source.bookSourceGroup;
+    if ([group isKindOfClass:[NSString class]] && group.length > 0) {
+        NSMutableArray *sources = self.groupIndex[group];
+        if (!sources) {
+            sources = [NSMutableArray array];
+            self.groupIndex[group] = sources;
+            [self.groupOrder addObject:group];
         }
+        [sources addObject:source];
+    }
+}
+
+- (void)rebuildIndexes {
+    [self.nameIndex removeAllObjects];
+    [self.groupIndex removeAllObjects];
+    [self.groupOrder removeAllObjects];
+
+    for (BookSource *source in self.bookSources) {
+        [self indexBookSource:source];
+    }
+}
+
+- (void)appendBookSources:(NSArray<BookSource *> *)sources {
+    [self.bookSources addObjectsFromArray:sources];
+    for (BookSource *source in sources) {
+        [self indexBookSource:source];
     }
-    return nil;
 }
 
 #pragma mark - 增删改
@@ -84,8 +161,12 @@
         return NO;
     }
 
-    [self.bookSources addObject:source];
-    return [self saveToLocal];
+    if (source.enabled) {
+        [RuleCostAnalyzer warmUpBookSource:source];
+    }
+    [self appendBookSources:@[source]];
+    [self scheduleSave];
+    return YES;
 }
 
 - (BOOL)removeBookSource:(BookSource *)source {
@@ -94,7 +175,9 @@
     }
 
     [self.bookSources removeObject:source];
-    return [self saveToLocal];
+    [self rebuildIndexes];
+    [self scheduleSave];
+    return YES;
 }
 
 - (BOOL)updateBookSource:(BookSource *)source {
@@ -102,8 +185,10 @@
         return NO;
     }
 
-    // 直接保存，因为 source 是引用类型，已经被修改了
-    return [self saveToLocal];
+    // source 是引用类型，已经被修改了；名称/分组可能变化，重建索引
+    [self rebuildIndexes];
+    [self scheduleSave];
+    return YES;
 }
 
 #pragma mark - 导入导出
@@ -113,29 +198,74 @@
         return NO;
     }
 
+    NSMutableArray<BookSource *> *sources = [NSMutableArray arrayWithCapacity:jsonArray.count];
     for (NSDictionary *json in jsonArray) {
+        if (![json isKindOfClass:[NSDictionary class]]) {
+            continue;
+        }
         BookSource *source = [BookSource bookSourceFromJSON:json];
         if (source) {
-            [self.bookSources addObject:source];
+            [RuleCostAnalyzer analyzeBookSource:source];
+            [sources addObject:source];
         }
     }
 
+    [self appendBookSources:sources];
     return [self saveToLocal];
 }
 
 - (BOOL)importBookSourcesFromFile:(NSString *)filePath {
-    NSData *data = [NSData dataWithContentsOfFile:filePath];
+    NSData *data = [NSData dataWithContentsOfFile:filePath options:NSDataReadingMappedIfSafe error:nil];
     if (!data) {
         return NO;
     }
 
-    NSError *error = nil;
-    NSArray *jsonArray = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
-    if (error || ![jsonArray isKindOfClass:[NSArray class]]) {
+    NSMutableArray<BookSource *> *sources = [NSMutableArray array];
+    BOOL valid = [BookSourceImporter enumerateBookSourcesInData:data usingBlock:^(BookSource *source, double fraction, BOOL *stop) {
+        [RuleCostAnalyzer analyzeBookSource:source];
+        [sources addObject:source];
+    }];
+    if (!valid || sources.count == 0) {
         return NO;
     }
 
-    return [self importBookSourcesFromJSONArray:jsonArray];
+    [self appendBookSources:sources];
+    return [self saveToLocal];
+}
+
+- (void)importBookSourcesFromData:(NSData *)data
+                         progress:(void (^)(NSUInteger, double))progress
+                       completion:(void (^)(NSUInteger, BOOL))completion {
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSMutableArray<BookSource *> *sources = [NSMutableArray array];
+
+        BOOL valid = [BookSourceImporter enumerateBookSourcesInData:data usingBlock:^(BookSource *source, double fraction, BOOL *stop) {
+            [RuleCostAnalyzer analyzeBookSource:source];
+            [sources addObject:source];
+
+            if (progress && sources.count % kImportProgressBatch == 0) {
+                NSUInteger count = sources.count;
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    progress(count, fraction);
+                });
+            }
+        }];
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            BOOL success = valid && sources.count > 0;
+            if (success) {
+                // ⭐ 书源数组只在主线程修改
+                [self appendBookSources:sources];
+                success = [self saveToLocal];
+            }
+            if (progress) {
+                progress(sources.count, 1.0);
+            }
+            if (completion) {
+                completion(sources.count, success);
+            }
+        });
+    });
 }
 
 - (NSArray *)exportBookSourcesToJSONArray {
@@ -154,22 +284,62 @@
 #pragma mark - 持久化
 
 - (BOOL)saveToLocal {
-    NSArray *jsonArray = [self exportBookSourcesToJSONArray];
+    // 取消尚未触发的延迟写入，这次写入已经包含了它的修改
+    self.savePending = NO;
+    dispatch_source_set_timer(self.saveTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+
+    // 二进制快照：未访问过的规则原样写回，不经过 JSON 序列化
+    NSData *data = [BookSourceSnapshot dataWithBookSources:self.bookSources];
+    __block BOOL success = NO;
+    dispatch_sync(self.ioQueue, ^{
+        success = [BookSourceSnapshot writeData:data toPath:self.dataFilePath];
+    });
+    return success;
+}
 
-    NSError *error = nil;
-    NSData *data = [NSJSONSerialization dataWithJSONObject:jsonArray options:NSJSONWritingPrettyPrinted error:&error];
-    if (error) {
-        return NO;
+- (void)scheduleSave {
+    self.savePending = YES;
+    uint64_t delay = (uint64_t)(kSaveDebounceInterval * NSEC_PER_SEC);
+    dispatch_source_set_timer(self.saveTimer, dispatch_time(DISPATCH_TIME_NOW, delay), DISPATCH_TIME_FOREVER, delay / 10);
+}
+
+- (void)flushPendingSave {
+    if (!self.savePending) {
+        return;
     }
+    self.savePending = NO;
 
-    BOOL success = [data writeToFile:self.dataFilePath atomically:YES];
-    return success;
+    // 编码在主线程（读取书源），写盘在 ioQueue
+    NSData *data = [BookSourceSnapshot dataWithBookSources:self.bookSources];
+    NSString *path = self.dataFilePath;
+    dispatch_async(self.ioQueue, ^{
+        [BookSourceSnapshot writeData:data toPath:path];
+    });
+}
+
+- (void)flushPendingSaveAndWait {
+    if (self.savePending) {
+        [self saveToLocal];
+    } else {
+        dispatch_sync(self.ioQueue, ^{});
+    }
 }
 
 - (BOOL)loadFromLocal {
-    // 优先从 Documents 目录加载
+    // 优先从 Documents 目录加载快照
     if ([[NSFileManager defaultManager] fileExistsAtPath:self.dataFilePath]) {
-        return [self loadFromDocuments];
+        if ([self loadFromDocuments]) {
+            return YES;
+        }
+    }
+
+    // 旧版本的 JSON 存储，加载后迁移为快照
+    if ([[NSFileManager defaultManager] fileExistsAtPath:self.legacyJSONFilePath]) {
+        NSData *data = [NSData dataWithContentsOfFile:self.legacyJSONFilePath options:NSDataReadingMappedIfSafe error:nil];
+        if (data && [self parseJSONData:data] && [self saveToLocal]) {
+            [[NSFileManager defaultManager] removeItemAtPath:self.legacyJSONFilePath error:nil];
+            return YES;
+        }
     }
 
     // Documents 不存在，从 Bundle 加载默认书源
@@ -178,12 +348,15 @@
 
 // 从 Documents 目录加载
 - (BOOL)loadFromDocuments {
-    NSData *data = [NSData dataWithContentsOfFile:self.dataFilePath];
-    if (!data) {
+    NSArray<BookSource *> *sources = [BookSourceSnapshot readBookSourcesFromPath:self.dataFilePath];
+    if (!sources) {
         return NO;
     }
 
-    return [self parseJSONData:data];
+    [self.bookSources removeAllObjects];
+    [self rebuildIndexes];
+    [self appendBookSources:sources];
+    return YES;
 }
 
 // 从 Bundle 加载默认书源
@@ -209,21 +382,20 @@
     return success;
 }
 
-// 解析 JSON 数据
+// 解析 JSON 数据（逐个元素解析）
 - (BOOL)parseJSONData:(NSData *)data {
-    NSError *error = nil;
-    NSArray *jsonArray = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
-    if (error || ![jsonArray isKindOfClass:[NSArray class]]) {
+    NSMutableArray<BookSource *> *sources = [NSMutableArray array];
+    BOOL valid = [BookSourceImporter enumerateBookSourcesInData:data usingBlock:^(BookSource *source, double fraction, BOOL *stop) {
+        [RuleCostAnalyzer analyzeBookSource:source];
+        [sources addObject:source];
+    }];
+    if (!valid) {
         return NO;
     }
 
     [self.bookSources removeAllObjects];
-    for (NSDictionary *json in jsonArray) {
-        BookSource *source = [BookSource bookSourceFromJSON:json];
-        if (source) {
-            [self.bookSources addObject:source];
-        }
-    }
+    [self rebuildIndexes];
+    [self appendBookSources:sources];
 
     return YES;
 }
@@ -232,8 +404,10 @@
 - (BOOL)resetToDefaultBookSources {
 
     // 删除 Documents 中的文件
-    if ([[NSFileManager defaultManager] fileExistsAtPath:self.dataFilePath]) {
-        [[NSFileManager defaultManager] removeItemAtPath:self.dataFilePath error:nil];
+    for (NSString *path in @[self.dataFilePath, self.legacyJSONFilePath]) {
+        if ([[NSFileManager defaultManager] fileExistsAtPath:path]) {
+            [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+        }
     }
 
     // 从 Bundle 重新加载
@@ -285,7 +459,9 @@
     };
 
     BookSource *source = [BookSource bookSourceFromJSON:json];
-    [self.bookSources addObject:source];
+    [self.bookSources removeAllObjects];
+    [self rebuildIndexes];
+    [self appendBookSources:@[source]];
     [self saveToLocal];
 }
 
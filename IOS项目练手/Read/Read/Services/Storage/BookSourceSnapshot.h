@@ -0,0 +1,47 @@
+//
+//  BookSourceSnapshot.h
+//  Read
+//
+//  书源二进制快照 - 紧凑持久化，规则延迟解码
+//
+
+#import <Foundation/Foundation.h>
+#import "BookSource.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 书源二进制快照
+ *
+ * 职责：
+ *   1. 把书源列表写成紧凑的二进制文件（不做 JSON 美化）
+ *   2. 加载时只解码基本字段，规则以原始字节挂在 BookSource 上，首次访问才解析
+ *   3. 未解码过的规则保存时原样写回，不经过 JSON 序列化
+ *
+ * 文件格式：
+ *   文件头：魔数 "BSS1" + 版本 + 书源数量（各 4 字节）
+ *   每个书源：整数字段 + 长度前缀的 UTF-8 字符串 + 规则开销分和警告 + 长度前缀的规则数据
+ *   版本不一致的快照直接返回 nil，由调用方回退到 Bundle 重新加载
+ */
+@interface BookSourceSnapshot : NSObject
+
+/**
+ * 读取快照
+ * @return 书源列表；文件不存在或格式不匹配时返回 nil
+ */
++ (nullable NSArray<BookSource *> *)readBookSourcesFromPath:(NSString *)path;
+
+/**
+ * 写入快照（原子写入）
+ */
++ (BOOL)writeBookSources:(NSArray<BookSource *> *)bookSources toPath:(NSString *)path;
+
+/**
+ * 分两步写入：编码需要读取书源（在修改书源的线程调用），写文件可以放到后台队列
+ */
++ (NSData *)dataWithBookSources:(NSArray<BookSource *> *)bookSources;
++ (BOOL)writeData:(NSData *)data toPath:(NSString *)path;
+
+@end
+
+NS_ASSUME_NONNULL_END
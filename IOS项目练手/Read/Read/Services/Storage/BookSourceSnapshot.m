@@ -0,0 +1,224 @@
+//
+//  BookSourceSnapshot.m
+//  Read
+//
+//  书源二进制快照实现
+//
+
+#import "BookSourceSnapshot.h"
+
+static const uint32_t kSnapshotMagic = 0x31535342;    // "BSS1"
+static const uint32_t kSnapshotVersion = 2;           // 2：增加规则开销分和警告
+static const uint32_t kSnapshotNilLength = UINT32_MAX; // 字符串为 nil 的标记
+
+typedef NS_OPTIONS(uint8_t, SnapshotSourceFlags) {
+    SnapshotSourceFlagEnabled = 1 << 0,
+    SnapshotSourceFlagCookieJar = 1 << 1,
+    SnapshotSourceFlagExplore = 1 << 2
+};
+
+#pragma mark - 读取游标
+
+typedef struct {
+    const uint8_t *bytes;
+    NSUInteger length;
+    NSUInteger offset;
+    BOOL failed;
+} SnapshotCursor;
+
+static BOOL SnapshotRead(SnapshotCursor *cursor, void *out, NSUInteger size) {
+    if (cursor->failed || cursor->offset + size > cursor->length) {
+        cursor->failed = YES;
+        return NO;
+    }
+    memcpy(out, cursor->bytes + cursor->offset, size);
+    cursor->offset += size;
+    return YES;
+}
+
+static uint32_t SnapshotReadUInt32(SnapshotCursor *cursor) {
+    uint32_t value = 0;
+    SnapshotRead(cursor, &value, sizeof(value));
+    return value;
+}
+
+static NSString *SnapshotReadString(SnapshotCursor *cursor) {
+    uint32_t length = SnapshotReadUInt32(cursor);
+    if (cursor->failed || length == kSnapshotNilLength) {
+        return nil;
+    }
+    if (cursor->offset + length > cursor->length) {
+        cursor->failed = YES;
+        return nil;
+    }
+    NSString *string = [[NSString alloc] initWithBytes:cursor->bytes + cursor->offset
+                                                length:length
+                                              encoding:NSUTF8StringEncoding];
+    cursor->offset += length;
+    return string;
+}
+
+static NSData *SnapshotReadData(SnapshotCursor *cursor) {
+    uint32_t length = SnapshotReadUInt32(cursor);
+    if (cursor->failed || length == kSnapshotNilLength) {
+        return nil;
+    }
+    if (cursor->offset + length > cursor->length) {
+        cursor->failed = YES;
+        return nil;
+    }
+    NSData *data = [NSData dataWithBytes:cursor->bytes + cursor->offset length:length];
+    cursor->offset += length;
+    return data;
+}
+
+#pragma mark - 写入辅助
+
+static void SnapshotWriteUInt32(NSMutableData *data, uint32_t value) {
+    [data appendBytes:&value length:sizeof(value)];
+}
+
+static void SnapshotWriteString(NSMutableData *data, NSString *string) {
+    if (![string isKindOfClass:[NSString class]]) {
+        SnapshotWriteUInt32(data, kSnapshotNilLength);
+        return;
+    }
+    NSData *bytes = [string dataUsingEncoding:NSUTF8StringEncoding];
+    SnapshotWriteUInt32(data, (uint32_t)bytes.length);
+    [data appendData:bytes];
+}
+
+static void SnapshotWriteData(NSMutableData *data, NSData *bytes) {
+    if (!bytes) {
+        SnapshotWriteUInt32(data, kSnapshotNilLength);
+        return;
+    }
+    SnapshotWriteUInt32(data, (uint32_t)bytes.length);
+    [data appendData:bytes];
+}
+
+@implementation BookSourceSnapshot
+
++ (nullable NSArray<BookSource *> *)readBookSourcesFromPath:(NSString *)path {
+    NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:nil];
+    if (!data) {
+        return nil;
+    }
+
+    SnapshotCursor cursor = {data.bytes, data.length, 0, NO};
+    uint32_t magic = SnapshotReadUInt32(&cursor);
+    uint32_t version = SnapshotReadUInt32(&cursor);
+    uint32_t count = SnapshotReadUInt32(&cursor);
+    if (cursor.failed || magic != kSnapshotMagic || version != kSnapshotVersion) {
+        NSLog(@"⚠️ 书源快照格式不匹配: %@", path);
+        return nil;
+    }
+
+    NSMutableArray<BookSource *> *sources = [NSMutableArray arrayWithCapacity:count];
+    for (uint32_t i = 0; i < count; i++) {
+        @autoreleasepool {
+            int64_t lastUpdateTime = 0;
+            int32_t scalars[4] = {0};   // type, customOrder, respondTime, weight
+            uint8_t flags = 0;
+            SnapshotRead(&cursor, &lastUpdateTime, sizeof(lastUpdateTime));
+            SnapshotRead(&cursor, scalars, sizeof(scalars));
+            SnapshotRead(&cursor, &flags, sizeof(flags));
+
+            BookSource *source = [[BookSource alloc] init];
+            source.lastUpdateTime = lastUpdateTime;
+            source.bookSourceType = scalars[0];
+            source.customOrder = scalars[1];
+            source.respondTime = scalars[2];
+            source.weight = scalars[3];
+            source.enabled = (flags & SnapshotSourceFlagEnabled) != 0;
+            source.enabledCookieJar = (flags & SnapshotSourceFlagCookieJar) != 0;
+            source.enabledExplore = (flags & SnapshotSourceFlagExplore) != 0;
+
+            source.bookSourceComment = SnapshotReadString(&cursor);
+            source.bookSourceGroup = SnapshotReadString(&cursor);
+            source.bookSourceName = SnapshotReadString(&cursor);
+            source.bookSourceUrl = SnapshotReadString(&cursor);
+            source.exploreUrl = SnapshotReadString(&cursor);
+            source.header = SnapshotReadString(&cursor);
+            source.searchUrl = SnapshotReadString(&cursor);
+
+            int32_t costScore = 0;
+            SnapshotRead(&cursor, &costScore, sizeof(costScore));
+            source.costScore = costScore;
+            NSString *warnings = SnapshotReadString(&cursor);
+            source.costWarnings = warnings.length > 0 ? [warnings componentsSeparatedByString:@"\n"] : nil;
+
+            // ⭐ 规则只保存原始字节，首次访问时才解析
+            NSData *ruleData = SnapshotReadData(&cursor);
+
+            if (cursor.failed) {
+                NSLog(@"❌ 书源快照已损坏（第 %u 条）: %@", i, path);
+                return nil;
+            }
+            if (ruleData) {
+                [source setLazyRuleData:ruleData];
+            }
+            [sources addObject:source];
+        }
+    }
+
+    return sources;
+}
+
++ (BOOL)writeBookSources:(NSArray<BookSource *> *)bookSources toPath:(NSString *)path {
+    return [self writeData:[self dataWithBookSources:bookSources] toPath:path];
+}
+
++ (NSData *)dataWithBookSources:(NSArray<BookSource *> *)bookSources {
+    NSMutableData *data = [NSMutableData dataWithCapacity:bookSources.count * 512];
+    SnapshotWriteUInt32(data, kSnapshotMagic);
+    SnapshotWriteUInt32(data, kSnapshotVersion);
+    SnapshotWriteUInt32(data, (uint32_t)bookSources.count);
+
+    for (BookSource *source in bookSources) {
+        @autoreleasepool {
+            int64_t lastUpdateTime = source.lastUpdateTime;
+            int32_t scalars[4] = {
+                (int32_t)source.bookSourceType,
+                (int32_t)source.customOrder,
+                (int32_t)source.respondTime,
+                (int32_t)source.weight
+            };
+            uint8_t flags = 0;
+            if (source.enabled) flags |= SnapshotSourceFlagEnabled;
+            if (source.enabledCookieJar) flags |= SnapshotSourceFlagCookieJar;
+            if (source.enabledExplore) flags |= SnapshotSourceFlagExplore;
+
+            [data appendBytes:&lastUpdateTime length:sizeof(lastUpdateTime)];
+            [data appendBytes:scalars length:sizeof(scalars)];
+            [data appendBytes:&flags length:sizeof(flags)];
+
+            SnapshotWriteString(data, source.bookSourceComment);
+            SnapshotWriteString(data, source.bookSourceGroup);
+            SnapshotWriteString(data, source.bookSourceName);
+            SnapshotWriteString(data, source.bookSourceUrl);
+            SnapshotWriteString(data, source.exploreUrl);
+            SnapshotWriteString(data, source.header);
+            SnapshotWriteString(data, source.searchUrl);
+
+            int32_t costScore = (int32_t)MIN(source.costScore, (NSInteger)INT32_MAX);
+            [data appendBytes:&costScore length:sizeof(costScore)];
+            SnapshotWriteString(data, [source.costWarnings componentsJoinedByString:@"\n"]);
+
+            SnapshotWriteData(data, [source compactRuleData]);
+        }
+    }
+
+    return data;
+}
+
++ (BOOL)writeData:(NSData *)data toPath:(NSString *)path {
+    NSError *error = nil;
+    BOOL success = [data writeToFile:path options:NSDataWritingAtomic error:&error];
+    if (!success) {
+        NSLog(@"❌ 书源快照写入失败: %@", error.localizedDescription);
+    }
+    return success;
+}
+
+@end
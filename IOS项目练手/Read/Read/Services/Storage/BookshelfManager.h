@@ -25,7 +25,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (BOOL)addBook:(BookModel *)book;
 
 /**
- * 删除书籍
+ * 删除书籍（同时删除该书的阅读进度）
  * @param bookId 书籍ID
  */
 - (void)removeBookWithId:(NSString *)bookId;
@@ -54,7 +54,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (NSArray<BookModel *> *)getAllBooks;
 
 /**
- * 清空指定类型的书架
+ * 清空指定类型的书架（同时删除这些书的阅读进度）
  * @param type 书籍类型
  */
 - (void)clearBooksWithType:(BookType)type;
@@ -6,6 +6,7 @@
 //
 
 #import "BookshelfManager.h"
+#import "ReadingProgressStore.h"
 
 @interface BookshelfManager ()
 @property (strong, nonatomic) NSMutableArray<BookModel *> *books;
@@ -199,6 +200,7 @@
 
     NSInteger index = [self indexOfBookWithId:bookId];
     if (index != NSNotFound) {
+        [self removeProgressForBook:self.books[index]];
         [self.books removeObjectAtIndex:index];
         [self saveDataAsync]; // 异步保存
     }
@@ -237,6 +239,7 @@
     for (BookModel *book in self.books) {
         if (book.bookType == type) {
             [toRemove addObject:book];
+            [self removeProgressForBook:book];
         }
     }
     [self.books removeObjectsInArray:toRemove];
@@ -245,6 +248,13 @@
 
 #pragma mark - 辅助方法
 
+// 阅读进度按书籍 URL 保存，移出书架后不再需要
+- (void)removeProgressForBook:(BookModel *)book {
+    if (book.bookUrl.length > 0) {
+        [[ReadingProgressStore sharedStore] removeProgressForBook:book.bookUrl];
+    }
+}
+
 - (NSInteger)indexOfBookWithId:(NSString *)bookId {
     if (!bookId) return NSNotFound;
 
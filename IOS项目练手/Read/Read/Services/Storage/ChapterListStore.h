@@ -0,0 +1,59 @@
+//
+//  ChapterListStore.h
+//  Read
+//
+//  目录持久化存储 - 每本书一个内存映射的紧凑二进制目录文件
+//
+
+#import <Foundation/Foundation.h>
+#import "ChapterModel.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 目录持久化存储
+ *
+ * 职责：
+ *   1. 每本书的章节列表保存为一个紧凑的二进制文件（重启后仍可秒开）
+ *   2. 提取所有章节URL的公共前缀，只存后缀；名称和URL后缀放在字符串表
+ *   3. 定长索引（每章 20 字节），按下标 O(1) 定位
+ *   4. 文件以内存映射方式读取，ChapterModel 在首次访问时才创建
+ *   5. 后台刷新时只对比尾部，返回新增章节
+ *
+ * 文件格式：
+ *   文件头 32 字节 | 公共前缀 | 定长索引 | 字符串表（UTF-8）
+ *
+ * 使用示例：
+ *   NSArray<ChapterModel *> *chapters = [[ChapterListStore sharedStore] chapterListForBookUrl:book.bookUrl];
+ *   NSArray<ChapterModel *> *newChapters = [[ChapterListStore sharedStore] reconcileChapterList:fresh forBookUrl:book.bookUrl];
+ */
+@interface ChapterListStore : NSObject
+
+// 单例
++ (instancetype)sharedStore;
+
+/**
+ * 读取持久化的章节列表（内存映射，延迟解码）
+ * @return 没有缓存时返回 nil
+ */
+- (nullable NSArray<ChapterModel *> *)chapterListForBookUrl:(NSString *)bookUrl;
+
+/**
+ * 保存章节列表（整体覆盖，原子写入）
+ */
+- (BOOL)saveChapterList:(NSArray<ChapterModel *> *)chapters forBookUrl:(NSString *)bookUrl;
+
+/**
+ * 与已保存的目录对比，有变化时写入
+ * @return 新增的尾部章节；目录被整体替换时返回全部章节；无变化返回空数组
+ */
+- (NSArray<ChapterModel *> *)reconcileChapterList:(NSArray<ChapterModel *> *)chapters forBookUrl:(NSString *)bookUrl;
+
+/**
+ * 删除某本书的目录
+ */
+- (void)removeChapterListForBookUrl:(NSString *)bookUrl;
+
+@end
+
+NS_ASSUME_NONNULL_END
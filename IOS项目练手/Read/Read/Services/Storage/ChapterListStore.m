@@ -0,0 +1,316 @@
+//
+//  ChapterListStore.m
+//  Read
+//
+//  目录持久化存储实现
+//
+
+#import "ChapterListStore.h"
+#import "NSString+Digest.h"
+
+#pragma mark - 文件格式
+
+static const uint32_t kChapterListMagic = 0x31434F54;      // "TOC1"
+static const uint32_t kChapterListVersion = 1;
+static const uint32_t kChapterListFullURLFlag = 0x80000000; // URL 未共享公共前缀
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t baseLength;      // 公共前缀字节数（紧随文件头）
+    uint32_t indexOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsLength;
+    uint32_t reserved;
+} ChapterListFileHeader;      // 32 字节
+
+typedef struct {
+    int32_t chapterIndex;
+    uint32_t urlOffset;
+    uint32_t urlLength;       // 最高位为 kChapterListFullURLFlag
+    uint32_t nameOffset;
+    uint32_t nameLength;
+} ChapterListIndexEntry;      // 20 字节
+
+#pragma mark - 延迟解码的章节数组
+
+/**
+ * 基于内存映射文件的只读数组，按下标访问时才创建 ChapterModel
+ */
+@interface ChapterListMappedArray : NSArray
+- (nullable instancetype)initWithMappedData:(NSData *)data;
+@end
+
+@implementation ChapterListMappedArray {
+    NSData *_data;                          // 持有映射，保证指针有效
+    const ChapterListIndexEntry *_entries;
+    const uint8_t *_strings;
+    uint32_t _stringsLength;
+    NSString *_baseURL;
+    NSUInteger _count;
+    NSPointerArray *_decoded;               // 已解码的章节
+}
+
+- (nullable instancetype)initWithMappedData:(NSData *)data {
+    if (data.length < sizeof(ChapterListFileHeader)) {
+        return nil;
+    }
+
+    ChapterListFileHeader header;
+    memcpy(&header, data.bytes, sizeof(header));
+    if (header.magic != kChapterListMagic || header.version != kChapterListVersion) {
+        return nil;
+    }
+
+    // 边界校验，防止截断的文件导致越界读取
+    uint64_t indexEnd = (uint64_t)header.indexOffset + (uint64_t)header.count * sizeof(ChapterListIndexEntry);
+    uint64_t stringsEnd = (uint64_t)header.stringsOffset + header.stringsLength;
+    if (sizeof(header) + (uint64_t)header.baseLength > data.length || indexEnd > data.length || stringsEnd > data.length) {
+        return nil;
+    }
+
+    self = [super init];
+    if (self) {
+        _data = data;
+        _count = header.count;
+        _entries = (const ChapterListIndexEntry *)((const uint8_t *)data.bytes + header.indexOffset);
+        _strings = (const uint8_t *)data.bytes + header.stringsOffset;
+        _stringsLength = header.stringsLength;
+        _baseURL = [[NSString alloc] initWithBytes:(const uint8_t *)data.bytes + sizeof(header)
+                                            length:header.baseLength
+                                          encoding:NSUTF8StringEncoding] ?: @"";
+        _decoded = [NSPointerArray strongObjectsPointerArray];
+        _decoded.count = _count;
+    }
+    return self;
+}
+
+- (NSUInteger)count {
+    return _count;
+}
+
+- (id)objectAtIndex:(NSUInteger)index {
+    if (index >= _count) {
+        [NSException raise:NSRangeException
+                    format:@"index %lu beyond bounds [0 .. %lu]", (unsigned long)index, (unsigned long)_count];
+    }
+
+    @synchronized (self) {
+        ChapterModel *chapter = (__bridge ChapterModel *)[_decoded pointerAtIndex:index];
+        if (chapter) {
+            return chapter;
+        }
+
+        ChapterListIndexEntry entry;
+        memcpy(&entry, &_entries[index], sizeof(entry));
+
+        NSString *name = [self stringAtOffset:entry.nameOffset length:entry.nameLength];
+        BOOL fullURL = (entry.urlLength & kChapterListFullURLFlag) != 0;
+        NSString *urlPart = [self stringAtOffset:entry.urlOffset length:entry.urlLength & ~kChapterListFullURLFlag];
+        NSString *url = fullURL ? urlPart : [_baseURL stringByAppendingString:urlPart];
+
+        chapter = [ChapterModel chapterWithName:name url:url index:entry.chapterIndex];
+        [_decoded replacePointerAtIndex:index withPointer:(__bridge void *)chapter];
+        return chapter;
+    }
+}
+
+- (NSString *)stringAtOffset:(uint32_t)offset length:(uint32_t)length {
+    if ((uint64_t)offset + length > _stringsLength) {
+        return @"";
+    }
+    return [[NSString alloc] initWithBytes:_strings + offset length:length encoding:NSUTF8StringEncoding] ?: @"";
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    // 不可变，直接返回自身
+    return self;
+}
+
+@end
+
+#pragma mark - ChapterListStore
+
+@interface ChapterListStore ()
+@property (copy, nonatomic) NSString *storeDirectory;
+@end
+
+@implementation ChapterListStore
+
++ (instancetype)sharedStore {
+    static ChapterListStore *store = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        store = [[ChapterListStore alloc] init];
+    });
+    return store;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        NSString *documentsPath = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) firstObject];
+        _storeDirectory = [documentsPath stringByAppendingPathComponent:@"TocCache"];
+        [[NSFileManager defaultManager] createDirectoryAtPath:_storeDirectory
+                                  withIntermediateDirectories:YES
+                                                   attributes:nil
+                                                        error:nil];
+    }
+    return self;
+}
+
+#pragma mark - 读取
+
+- (nullable NSArray<ChapterModel *> *)chapterListForBookUrl:(NSString *)bookUrl {
+    if (bookUrl.length == 0) {
+        return nil;
+    }
+
+    // ⭐ 内存映射：覆盖写入是原子替换，已映射的旧文件仍然有效
+    NSData *data = [NSData dataWithContentsOfFile:[self filePathForBookUrl:bookUrl]
+                                          options:NSDataReadingMappedAlways
+                                            error:nil];
+    if (!data) {
+        return nil;
+    }
+
+    ChapterListMappedArray *chapters = [[ChapterListMappedArray alloc] initWithMappedData:data];
+    if (!chapters) {
+        NSLog(@"⚠️ 目录缓存已损坏，忽略: %@", bookUrl);
+        return nil;
+    }
+    return chapters.count > 0 ? chapters : nil;
+}
+
+#pragma mark - 写入
+
+- (BOOL)saveChapterList:(NSArray<ChapterModel *> *)chapters forBookUrl:(NSString *)bookUrl {
+    if (bookUrl.length == 0 || chapters.count == 0) {
+        return NO;
+    }
+
+    NSMutableArray<NSData *> *urlBytes = [NSMutableArray arrayWithCapacity:chapters.count];
+    for (ChapterModel *chapter in chapters) {
+        [urlBytes addObject:[chapter.chapterUrl dataUsingEncoding:NSUTF8StringEncoding] ?: [NSData data]];
+    }
+    NSData *base = [self commonPrefixOfURLs:urlBytes];
+
+    NSMutableData *strings = [NSMutableData data];
+    NSMutableData *index = [NSMutableData dataWithCapacity:chapters.count * sizeof(ChapterListIndexEntry)];
+
+    for (NSUInteger i = 0; i < chapters.count; i++) {
+        @autoreleasepool {
+            ChapterModel *chapter = chapters[i];
+            NSData *url = urlBytes[i];
+            NSData *name = [chapter.chapterName dataUsingEncoding:NSUTF8StringEncoding] ?: [NSData data];
+
+            ChapterListIndexEntry entry = {0};
+            entry.chapterIndex = (int32_t)chapter.chapterIndex;
+
+            // URL 只存公共前缀之后的部分
+            BOOL shared = base.length > 0 && url.length >= base.length && memcmp(url.bytes, base.bytes, base.length) == 0;
+            NSUInteger skip = shared ? base.length : 0;
+            entry.urlOffset = (uint32_t)strings.length;
+            entry.urlLength = (uint32_t)(url.length - skip) | (shared ? 0 : kChapterListFullURLFlag);
+            [strings appendBytes:(const uint8_t *)url.bytes + skip length:url.length - skip];
+
+            entry.nameOffset = (uint32_t)strings.length;
+            entry.nameLength = (uint32_t)name.length;
+            [strings appendData:name];
+
+            [index appendBytes:&entry length:sizeof(entry)];
+        }
+    }
+
+    ChapterListFileHeader header = {0};
+    header.magic = kChapterListMagic;
+    header.version = kChapterListVersion;
+    header.count = (uint32_t)chapters.count;
+    header.baseLength = (uint32_t)base.length;
+    header.indexOffset = (uint32_t)(sizeof(header) + base.length);
+    header.stringsOffset = header.indexOffset + (uint32_t)index.length;
+    header.stringsLength = (uint32_t)strings.length;
+
+    NSMutableData *file = [NSMutableData dataWithCapacity:header.stringsOffset + strings.length];
+    [file appendBytes:&header length:sizeof(header)];
+    [file appendData:base];
+    [file appendData:index];
+    [file appendData:strings];
+
+    NSError *error = nil;
+    BOOL success = [file writeToFile:[self filePathForBookUrl:bookUrl] options:NSDataWritingAtomic error:&error];
+    if (!success) {
+        NSLog(@"❌ 目录缓存写入失败: %@", error.localizedDescription);
+    }
+    return success;
+}
+
+- (NSArray<ChapterModel *> *)reconcileChapterList:(NSArray<ChapterModel *> *)chapters forBookUrl:(NSString *)bookUrl {
+    if (chapters.count == 0) {
+        return @[];
+    }
+
+    NSArray<ChapterModel *> *stored = [self chapterListForBookUrl:bookUrl];
+    if (!stored) {
+        [self saveChapterList:chapters forBookUrl:bookUrl];
+        return chapters;
+    }
+
+    // ⭐ 只对比首章和已保存的最后一章（只解码这两个），一致则认为前面部分未变
+    NSUInteger storedCount = stored.count;
+    BOOL sameHead = storedCount <= chapters.count &&
+                    [stored.firstObject.chapterUrl isEqualToString:chapters.firstObject.chapterUrl] &&
+                    [stored[storedCount - 1].chapterUrl isEqualToString:chapters[storedCount - 1].chapterUrl];
+
+    if (!sameHead) {
+        // 目录被整体调整（换源、重排），整体替换
+        [self saveChapterList:chapters forBookUrl:bookUrl];
+        return chapters;
+    }
+
+    if (storedCount == chapters.count) {
+        return @[];
+    }
+
+    [self saveChapterList:chapters forBookUrl:bookUrl];
+    return [chapters subarrayWithRange:NSMakeRange(storedCount, chapters.count - storedCount)];
+}
+
+- (void)removeChapterListForBookUrl:(NSString *)bookUrl {
+    [[NSFileManager defaultManager] removeItemAtPath:[self filePathForBookUrl:bookUrl] error:nil];
+}
+
+#pragma mark - 辅助方法
+
+- (NSData *)commonPrefixOfURLs:(NSArray<NSData *> *)urls {
+    NSData *first = urls.firstObject;
+    NSUInteger prefixLength = first.length;
+    const uint8_t *firstBytes = first.bytes;
+
+    for (NSData *url in urls) {
+        NSUInteger limit = MIN(prefixLength, url.length);
+        const uint8_t *bytes = url.bytes;
+        NSUInteger i = 0;
+        while (i < limit && bytes[i] == firstBytes[i]) {
+            i++;
+        }
+        prefixLength = i;
+        if (prefixLength == 0) {
+            break;
+        }
+    }
+
+    // 截断到最后一个 '/'，既保证是完整路径段，也不会切断多字节字符
+    while (prefixLength > 0 && firstBytes[prefixLength - 1] != '/') {
+        prefixLength--;
+    }
+    return [first subdataWithRange:NSMakeRange(0, prefixLength)];
+}
+
+- (NSString *)filePathForBookUrl:(NSString *)bookUrl {
+    NSString *name = [[bookUrl sha1String] stringByAppendingPathExtension:@"toc"];
+    return [self.storeDirectory stringByAppendingPathComponent:name];
+}
+
+@end
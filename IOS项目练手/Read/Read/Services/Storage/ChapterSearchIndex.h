@@ -0,0 +1,85 @@
+//
+//  ChapterSearchIndex.h
+//  Read
+//
+//  章节全文索引 - 每本书一个增量倒排索引
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 搜索命中
+ */
+@interface ChapterSearchHit : NSObject
+@property (assign, nonatomic) NSInteger chapterIndex;  // 章节索引
+@property (assign, nonatomic) NSUInteger offset;       // 在章节正文中的位置（UTF-16 下标）
+@end
+
+/**
+ * 章节全文索引
+ *
+ * 职责：
+ *   1. 分词：中日韩汉字按相邻两字切分（bigram），拉丁字母/数字按单词切分（不区分大小写）
+ *   2. 倒排表按词项存储，章节号和位置都做差值 + varint 压缩
+ *   3. 每加入一章就在索引文件尾部追加一个带校验的段，崩溃只会丢失最后一段；
+ *      同一章有多个段时以最后一个为准（章节内容被覆盖后重新索引）
+ *   4. 查询返回章节索引和偏移，按章节、位置排序
+ *
+ * 说明：
+ *   多个词项的查询按短语匹配（相对位置与查询串一致）；
+ *   单个汉字的查询（包括混合查询中孤立的汉字）通过扫描词典中包含该字的二元组完成。
+ *   同一个文件只能有一个实例（写入在实例自己的串行队列上排队），由 BookContentManager 按书籍持有。
+ *
+ * 使用示例：
+ *   ChapterSearchIndex *index = [[ChapterSearchIndex alloc] initWithFilePath:path];
+ *   [index addChapter:12 content:content];
+ *   NSArray<ChapterSearchHit *> *hits = [index search:@"张三丰" limit:50];
+ */
+@interface ChapterSearchIndex : NSObject
+
+/**
+ * 初始化（索引文件在首次使用时才加载）
+ * @param filePath 索引文件路径
+ */
+- (instancetype)initWithFilePath:(NSString *)filePath;
+
+/**
+ * 把一章加入索引（异步，已索引过的章节会被忽略）
+ */
+- (void)addChapter:(NSInteger)chapterIndex content:(NSString *)content;
+
+/**
+ * 章节内容被覆盖后重新索引（异步）：先移除该章的旧倒排，再加入新内容
+ * 需要扫描所有倒排表，只在覆盖已保存的章节时调用
+ */
+- (void)replaceChapter:(NSInteger)chapterIndex content:(NSString *)content;
+
+/**
+ * 章节是否已经在索引中
+ */
+- (BOOL)containsChapter:(NSInteger)chapterIndex;
+
+/**
+ * 查询
+ * @param query 查询文本
+ * @param limit 最多返回的命中数（0 表示不限）
+ * @return 命中列表（按章节、位置排序）
+ */
+- (NSArray<ChapterSearchHit *> *)search:(NSString *)query limit:(NSUInteger)limit;
+
+/**
+ * 清空索引并删除文件
+ * 等待已排队的写入完成；之后再加入的章节一律忽略，需要重新创建实例
+ */
+- (void)removeAllEntries;
+
+/**
+ * 释放内存中的倒排表（文件保留，下次使用时重新加载）
+ */
+- (void)unloadFromMemory;
+
+@end
+
+NS_ASSUME_NONNULL_END
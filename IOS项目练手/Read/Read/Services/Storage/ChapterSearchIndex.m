@@ -0,0 +1,797 @@
+//
+//  ChapterSearchIndex.m
+//  Read
+//
+//  章节全文索引实现
+//
+
+#import "ChapterSearchIndex.h"
+
+#pragma mark - 文件格式
+
+static const uint32_t kSearchIndexMagic = 0x31495343;    // "CSI1"
+static const uint32_t kSearchSegmentMagic = 0x4D474553;  // "SEGM"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t payloadLength;
+    int32_t chapterIndex;
+    uint32_t checksum;       // FNV-1a(payload)
+} SearchSegmentHeader;
+
+#pragma mark - 词项编码
+
+// 词项统一编码为 64 位整数，高位区分类型，0 保留为空槽
+static const uint64_t kTermTagBigram = 1ULL << 32;       // 汉字二元组：tag | c1 << 16 | c2
+static const uint64_t kTermTagUnigram = 2ULL << 32;      // 孤立的单个汉字：tag | c
+static const uint64_t kTermTagWord = 1ULL << 63;         // 拉丁单词：tag | FNV-1a64(小写)
+
+static inline BOOL SearchIsCJK(unichar c) {
+    return (c >= 0x4E00 && c <= 0x9FFF) || (c >= 0x3400 && c <= 0x4DBF) || (c >= 0xF900 && c <= 0xFAFF);
+}
+
+static inline BOOL SearchIsWordChar(unichar c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+static inline uint64_t SearchBigramKey(unichar c1, unichar c2) {
+    return kTermTagBigram | ((uint64_t)c1 << 16) | c2;
+}
+
+static uint32_t SearchChecksum(const uint8_t *bytes, NSUInteger length) {
+    uint32_t hash = 2166136261u;
+    for (NSUInteger i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+#pragma mark - 分词
+
+typedef struct {
+    uint64_t key;
+    uint32_t position;
+} SearchToken;
+
+typedef struct {
+    SearchToken *items;
+    NSUInteger count;
+    NSUInteger capacity;
+} SearchTokenList;
+
+static void SearchTokenListAppend(SearchTokenList *list, uint64_t key, uint32_t position) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 256;
+        list->items = realloc(list->items, list->capacity * sizeof(SearchToken));
+    }
+    list->items[list->count++] = (SearchToken){key, position};
+}
+
+static void SearchTokenize(const unichar *chars, NSUInteger length, SearchTokenList *tokens) {
+    NSUInteger i = 0;
+    while (i < length) {
+        unichar c = chars[i];
+
+        if (SearchIsCJK(c)) {
+            NSUInteger runStart = i;
+            while (i + 1 < length && SearchIsCJK(chars[i + 1])) {
+                SearchTokenListAppend(tokens, SearchBigramKey(chars[i], chars[i + 1]), (uint32_t)i);
+                i++;
+            }
+            if (i == runStart) {
+                SearchTokenListAppend(tokens, kTermTagUnigram | c, (uint32_t)i);
+            }
+            i++;
+        } else if (SearchIsWordChar(c)) {
+            NSUInteger start = i;
+            uint64_t hash = 14695981039346656037ULL;
+            while (i < length && SearchIsWordChar(chars[i])) {
+                unichar lower = (chars[i] >= 'A' && chars[i] <= 'Z') ? chars[i] + 32 : chars[i];
+                hash ^= lower;
+                hash *= 1099511628211ULL;
+                i++;
+            }
+            SearchTokenListAppend(tokens, kTermTagWord | (hash & ~kTermTagWord), (uint32_t)start);
+        } else {
+            i++;
+        }
+    }
+}
+
+static int SearchTokenCompare(const void *a, const void *b) {
+    const SearchToken *x = a;
+    const SearchToken *y = b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    if (x->position != y->position) return x->position < y->position ? -1 : 1;
+    return 0;
+}
+
+#pragma mark - varint
+
+static void SearchAppendVarint(NSMutableData *data, uint64_t value) {
+    uint8_t buffer[10];
+    NSUInteger length = 0;
+    while (value >= 0x80) {
+        buffer[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    buffer[length++] = (uint8_t)value;
+    [data appendBytes:buffer length:length];
+}
+
+static BOOL SearchReadVarint(const uint8_t *bytes, NSUInteger length, NSUInteger *offset, uint64_t *value) {
+    uint64_t result = 0;
+    int shift = 0;
+    while (*offset < length && shift < 64) {
+        uint8_t byte = bytes[(*offset)++];
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return YES;
+        }
+        shift += 7;
+    }
+    return NO;
+}
+
+static inline uint64_t SearchZigZag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t SearchUnZigZag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+#pragma mark - 词典（开放寻址哈希表）
+
+/**
+ * 每个词项一条倒排表，由若干块组成：
+ *   [zigzag varint 章节差值][varint 位置数][varint 位置差值...]
+ * 章节可能乱序加入，所以章节差值用 zigzag 编码
+ */
+@interface SearchPostingList : NSObject {
+@public
+    NSMutableData *_bytes;
+    int32_t _lastChapter;
+}
+@end
+
+@implementation SearchPostingList
+@end
+
+#pragma mark - ChapterSearchHit
+
+@implementation ChapterSearchHit
+@end
+
+#pragma mark - ChapterSearchIndex
+
+@interface ChapterSearchIndex () {
+    uint64_t *_keys;                 // 0 表示空槽
+    uint32_t *_slots;                // 指向 _postings 的下标
+    uint32_t _tableCapacity;         // 2 的幂
+    uint32_t _termCount;
+}
+@property (copy, nonatomic) NSString *filePath;
+@property (strong, nonatomic) NSMutableArray<SearchPostingList *> *postings;
+@property (strong, nonatomic) NSMutableIndexSet *indexedChapters;
+@property (strong, nonatomic) dispatch_queue_t indexQueue;
+@property (assign, nonatomic) BOOL loaded;
+@property (assign, nonatomic) BOOL invalidated;      // 已清空：之后排队的写入全部丢弃
+@end
+
+@implementation ChapterSearchIndex
+
+- (instancetype)initWithFilePath:(NSString *)filePath {
+    self = [super init];
+    if (self) {
+        _filePath = [filePath copy];
+        _postings = [NSMutableArray array];
+        _indexedChapters = [NSMutableIndexSet indexSet];
+        _indexQueue = dispatch_queue_create("com.read.search.index", DISPATCH_QUEUE_SERIAL);
+        [self resetTableWithCapacity:1024];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_keys);
+    free(_slots);
+}
+
+#pragma mark - 哈希表
+
+- (void)resetTableWithCapacity:(uint32_t)capacity {
+    free(_keys);
+    free(_slots);
+    _keys = calloc(capacity, sizeof(uint64_t));
+    _slots = calloc(capacity, sizeof(uint32_t));
+    _tableCapacity = capacity;
+    _termCount = 0;
+}
+
+static inline uint32_t SearchHashSlot(uint64_t key, uint32_t capacity) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (uint32_t)key & (capacity - 1);
+}
+
+- (nullable SearchPostingList *)postingListForKey:(uint64_t)key {
+    uint32_t slot = SearchHashSlot(key, _tableCapacity);
+    while (_keys[slot] != 0) {
+        if (_keys[slot] == key) {
+            return self.postings[_slots[slot]];
+        }
+        slot = (slot + 1) & (_tableCapacity - 1);
+    }
+    return nil;
+}
+
+- (SearchPostingList *)postingListCreatingForKey:(uint64_t)key {
+    uint32_t slot = SearchHashSlot(key, _tableCapacity);
+    while (_keys[slot] != 0) {
+        if (_keys[slot] == key) {
+            return self.postings[_slots[slot]];
+        }
+        slot = (slot + 1) & (_tableCapacity - 1);
+    }
+
+    SearchPostingList *list = [[SearchPostingList alloc] init];
+    list->_bytes = [NSMutableData data];
+    list->_lastChapter = 0;
+    _keys[slot] = key;
+    _slots[slot] = (uint32_t)self.postings.count;
+    [self.postings addObject:list];
+    _termCount++;
+
+    // 装载率超过 0.7 时扩容
+    if ((uint64_t)_termCount * 10 > (uint64_t)_tableCapacity * 7) {
+        [self growTable];
+    }
+    return list;
+}
+
+- (void)growTable {
+    uint64_t *oldKeys = _keys;
+    uint32_t *oldSlots = _slots;
+    uint32_t oldCapacity = _tableCapacity;
+
+    _tableCapacity = oldCapacity * 2;
+    _keys = calloc(_tableCapacity, sizeof(uint64_t));
+    _slots = calloc(_tableCapacity, sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < oldCapacity; i++) {
+        if (oldKeys[i] == 0) {
+            continue;
+        }
+        uint32_t slot = SearchHashSlot(oldKeys[i], _tableCapacity);
+        while (_keys[slot] != 0) {
+            slot = (slot + 1) & (_tableCapacity - 1);
+        }
+        _keys[slot] = oldKeys[i];
+        _slots[slot] = oldSlots[i];
+    }
+
+    free(oldKeys);
+    free(oldSlots);
+}
+
+#pragma mark - 加入章节
+
+- (void)addChapter:(NSInteger)chapterIndex content:(NSString *)content {
+    if (content.length == 0 || chapterIndex < 0) {
+        return;
+    }
+
+    dispatch_async(self.indexQueue, ^{
+        @autoreleasepool {
+            if (self.invalidated) {
+                return;
+            }
+            [self loadIfNeeded];
+            if ([self.indexedChapters containsIndex:chapterIndex]) {
+                return;
+            }
+
+            NSData *payload = [self buildSegmentPayloadForContent:content];
+            [self applySegmentPayload:payload chapter:(int32_t)chapterIndex];
+            [self appendSegmentPayload:payload chapter:(int32_t)chapterIndex];
+        }
+    });
+}
+
+- (void)replaceChapter:(NSInteger)chapterIndex content:(NSString *)content {
+    if (content.length == 0 || chapterIndex < 0) {
+        return;
+    }
+
+    dispatch_async(self.indexQueue, ^{
+        @autoreleasepool {
+            if (self.invalidated) {
+                return;
+            }
+            [self loadIfNeeded];
+            if ([self.indexedChapters containsIndex:chapterIndex]) {
+                [self removePostingsForChapter:(int32_t)chapterIndex];
+            }
+
+            // 文件中旧的段保留，加载时同一章以最后一个段为准
+            NSData *payload = [self buildSegmentPayloadForContent:content];
+            [self applySegmentPayload:payload chapter:(int32_t)chapterIndex];
+            [self appendSegmentPayload:payload chapter:(int32_t)chapterIndex];
+        }
+    });
+}
+
+- (BOOL)containsChapter:(NSInteger)chapterIndex {
+    __block BOOL contains = NO;
+    dispatch_sync(self.indexQueue, ^{
+        [self loadIfNeeded];
+        contains = [self.indexedChapters containsIndex:chapterIndex];
+    });
+    return contains;
+}
+
+/**
+ * 段数据：[varint 词项数] 之后每个词项 [u64 词项][varint 位置数][varint 位置差值...]
+ */
+- (NSData *)buildSegmentPayloadForContent:(NSString *)content {
+    NSUInteger length = content.length;
+    unichar *chars = malloc(length * sizeof(unichar));
+    [content getCharacters:chars range:NSMakeRange(0, length)];
+
+    SearchTokenList tokens = {0};
+    SearchTokenize(chars, length, &tokens);
+    free(chars);
+
+    qsort(tokens.items, tokens.count, sizeof(SearchToken), SearchTokenCompare);
+
+    // 统计不同词项数
+    NSUInteger termCount = 0;
+    for (NSUInteger i = 0; i < tokens.count; i++) {
+        if (i == 0 || tokens.items[i].key != tokens.items[i - 1].key) {
+            termCount++;
+        }
+    }
+
+    NSMutableData *payload = [NSMutableData dataWithCapacity:tokens.count * 2 + termCount * 9];
+    SearchAppendVarint(payload, termCount);
+
+    NSUInteger i = 0;
+    while (i < tokens.count) {
+        uint64_t key = tokens.items[i].key;
+        NSUInteger end = i;
+        while (end < tokens.count && tokens.items[end].key == key) {
+            end++;
+        }
+
+        [payload appendBytes:&key length:sizeof(key)];
+        SearchAppendVarint(payload, end - i);
+        uint32_t previous = 0;
+        for (NSUInteger j = i; j < end; j++) {
+            SearchAppendVarint(payload, tokens.items[j].position - previous);
+            previous = tokens.items[j].position;
+        }
+        i = end;
+    }
+
+    free(tokens.items);
+    return payload;
+}
+
+- (BOOL)applySegmentPayload:(NSData *)payload chapter:(int32_t)chapter {
+    const uint8_t *bytes = payload.bytes;
+    NSUInteger length = payload.length;
+    NSUInteger offset = 0;
+
+    uint64_t termCount = 0;
+    if (!SearchReadVarint(bytes, length, &offset, &termCount)) {
+        return NO;
+    }
+
+    for (uint64_t t = 0; t < termCount; t++) {
+        if (offset + sizeof(uint64_t) > length) {
+            return NO;
+        }
+        uint64_t key;
+        memcpy(&key, bytes + offset, sizeof(key));
+        offset += sizeof(key);
+
+        // 位置部分原样拷贝：先读出它的字节范围
+        NSUInteger positionsStart = offset;
+        uint64_t positionCount = 0;
+        if (!SearchReadVarint(bytes, length, &offset, &positionCount)) {
+            return NO;
+        }
+        for (uint64_t p = 0; p < positionCount; p++) {
+            uint64_t delta;
+            if (!SearchReadVarint(bytes, length, &offset, &delta)) {
+                return NO;
+            }
+        }
+
+        SearchPostingList *list = [self postingListCreatingForKey:key];
+        SearchAppendVarint(list->_bytes, SearchZigZag((int64_t)chapter - list->_lastChapter));
+        [list->_bytes appendBytes:bytes + positionsStart length:offset - positionsStart];
+        list->_lastChapter = chapter;
+    }
+
+    [self.indexedChapters addIndex:chapter];
+    return YES;
+}
+
+/**
+ * 从所有倒排表中移除一章的块，其余块的章节差值按新的前一块重新编码
+ */
+- (void)removePostingsForChapter:(int32_t)target {
+    for (SearchPostingList *list in self.postings) {
+        const uint8_t *bytes = list->_bytes.bytes;
+        NSUInteger length = list->_bytes.length;
+        NSUInteger offset = 0;
+        int64_t chapter = 0;
+        BOOL found = NO;
+
+        // 先确认包含该章，大部分倒排表不需要改写
+        while (offset < length && !found) {
+            uint64_t zigzag, count, delta;
+            if (!SearchReadVarint(bytes, length, &offset, &zigzag) ||
+                !SearchReadVarint(bytes, length, &offset, &count)) {
+                break;
+            }
+            chapter += SearchUnZigZag(zigzag);
+            found = chapter == target;
+            for (uint64_t i = 0; i < count; i++) {
+                SearchReadVarint(bytes, length, &offset, &delta);
+            }
+        }
+        if (!found) {
+            continue;
+        }
+
+        NSMutableData *rewritten = [NSMutableData dataWithCapacity:length];
+        int64_t previous = 0;
+        offset = 0;
+        chapter = 0;
+        while (offset < length) {
+            uint64_t zigzag, count, delta;
+            if (!SearchReadVarint(bytes, length, &offset, &zigzag)) {
+                break;
+            }
+            chapter += SearchUnZigZag(zigzag);
+            NSUInteger positionsStart = offset;
+            if (!SearchReadVarint(bytes, length, &offset, &count)) {
+                break;
+            }
+            for (uint64_t i = 0; i < count; i++) {
+                SearchReadVarint(bytes, length, &offset, &delta);
+            }
+            if (chapter == target) {
+                continue;
+            }
+            SearchAppendVarint(rewritten, SearchZigZag(chapter - previous));
+            [rewritten appendBytes:bytes + positionsStart length:offset - positionsStart];
+            previous = chapter;
+        }
+
+        list->_bytes = rewritten;
+        list->_lastChapter = (int32_t)previous;
+    }
+
+    [self.indexedChapters removeIndex:target];
+}
+
+#pragma mark - 持久化
+
+- (void)appendSegmentPayload:(NSData *)payload chapter:(int32_t)chapter {
+    NSFileManager *fm = [NSFileManager defaultManager];
+    if (![fm fileExistsAtPath:self.filePath]) {
+        [fm createDirectoryAtPath:[self.filePath stringByDeletingLastPathComponent]
+      withIntermediateDirectories:YES
+                       attributes:nil
+                            error:nil];
+        uint32_t magic = kSearchIndexMagic;
+        [[NSData dataWithBytes:&magic length:sizeof(magic)] writeToFile:self.filePath atomically:YES];
+    }
+
+    SearchSegmentHeader header;
+    header.magic = kSearchSegmentMagic;
+    header.payloadLength = (uint32_t)payload.length;
+    header.chapterIndex = chapter;
+    header.checksum = SearchChecksum(payload.bytes, payload.length);
+
+    NSMutableData *segment = [NSMutableData dataWithCapacity:sizeof(header) + payload.length];
+    [segment appendBytes:&header length:sizeof(header)];
+    [segment appendData:payload];
+
+    NSFileHandle *handle = [NSFileHandle fileHandleForWritingAtPath:self.filePath];
+    [handle seekToEndOfFile];
+    [handle writeData:segment];
+    [handle closeFile];
+}
+
+- (void)loadIfNeeded {
+    if (self.loaded) {
+        return;
+    }
+    self.loaded = YES;
+
+    NSData *data = [NSData dataWithContentsOfFile:self.filePath options:NSDataReadingMappedIfSafe error:nil];
+    if (data.length < sizeof(uint32_t)) {
+        return;
+    }
+
+    const uint8_t *bytes = data.bytes;
+    uint32_t magic;
+    memcpy(&magic, bytes, sizeof(magic));
+    if (magic != kSearchIndexMagic) {
+        NSLog(@"⚠️ 全文索引格式不匹配，重建: %@", self.filePath);
+        [[NSFileManager defaultManager] removeItemAtPath:self.filePath error:nil];
+        return;
+    }
+
+    // 第一遍：校验各段，记下每章最后一个段的位置（章节重新索引过时前面的段已过期）
+    NSMutableDictionary<NSNumber *, NSNumber *> *latestSegments = [NSMutableDictionary dictionary];
+    NSUInteger offset = sizeof(uint32_t);
+    while (offset + sizeof(SearchSegmentHeader) <= data.length) {
+        SearchSegmentHeader header;
+        memcpy(&header, bytes + offset, sizeof(header));
+        NSUInteger payloadStart = offset + sizeof(header);
+        if (header.magic != kSearchSegmentMagic ||
+            payloadStart + header.payloadLength > data.length ||
+            SearchChecksum(bytes + payloadStart, header.payloadLength) != header.checksum) {
+            break;
+        }
+        latestSegments[@(header.chapterIndex)] = @(offset);
+        offset = payloadStart + header.payloadLength;
+    }
+
+    // 第二遍：只应用每章最后一个段
+    for (NSNumber *segmentOffset in latestSegments.allValues) {
+        @autoreleasepool {
+            SearchSegmentHeader header;
+            memcpy(&header, bytes + segmentOffset.unsignedIntegerValue, sizeof(header));
+            NSData *payload = [NSData dataWithBytesNoCopy:(void *)(bytes + segmentOffset.unsignedIntegerValue + sizeof(header))
+                                                   length:header.payloadLength
+                                             freeWhenDone:NO];
+            [self applySegmentPayload:payload chapter:header.chapterIndex];
+        }
+    }
+
+    // 崩溃留下的半个段：截断
+    if (offset < data.length) {
+        NSFileHandle *handle = [NSFileHandle fileHandleForWritingAtPath:self.filePath];
+        [handle truncateFileAtOffset:offset];
+        [handle closeFile];
+    }
+}
+
+- (void)removeAllEntries {
+    // 同步执行：排在前面的写入先完成，排在后面的看到 invalidated 后丢弃，不会再建回目录
+    dispatch_sync(self.indexQueue, ^{
+        [self.postings removeAllObjects];
+        [self.indexedChapters removeAllIndexes];
+        [self resetTableWithCapacity:1024];
+        self.loaded = YES;
+        self.invalidated = YES;
+        [[NSFileManager defaultManager] removeItemAtPath:self.filePath error:nil];
+    });
+}
+
+- (void)unloadFromMemory {
+    dispatch_async(self.indexQueue, ^{
+        if (self.invalidated || !self.loaded) {
+            return;
+        }
+        [self.postings removeAllObjects];
+        [self.indexedChapters removeAllIndexes];
+        [self resetTableWithCapacity:1024];
+        self.loaded = NO;
+    });
+}
+
+#pragma mark - 查询
+
+/**
+ * 解码一条倒排表，结果为按 (章节 << 32 | 位置) 排序的数组
+ * @param shift 位置额外偏移（单字查询中作为二元组第二个字时为 1）
+ */
+- (void)decodePostingList:(SearchPostingList *)list shift:(uint32_t)shift into:(NSMutableData *)output {
+    const uint8_t *bytes = list->_bytes.bytes;
+    NSUInteger length = list->_bytes.length;
+    NSUInteger offset = 0;
+    int64_t chapter = 0;
+
+    while (offset < length) {
+        uint64_t zigzag, count;
+        if (!SearchReadVarint(bytes, length, &offset, &zigzag) ||
+            !SearchReadVarint(bytes, length, &offset, &count)) {
+            return;
+        }
+        chapter += SearchUnZigZag(zigzag);
+
+        uint64_t position = 0;
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t delta;
+            if (!SearchReadVarint(bytes, length, &offset, &delta)) {
+                return;
+            }
+            position += delta;
+            uint64_t entry = ((uint64_t)chapter << 32) | (uint32_t)(position + shift);
+            [output appendBytes:&entry length:sizeof(entry)];
+        }
+    }
+}
+
+static int SearchEntryCompare(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static void SearchSortEntries(NSMutableData *entries) {
+    qsort(entries.mutableBytes, entries.length / sizeof(uint64_t), sizeof(uint64_t), SearchEntryCompare);
+}
+
+static BOOL SearchContainsEntry(NSData *entries, uint64_t target) {
+    const uint64_t *items = entries.bytes;
+    NSUInteger low = 0;
+    NSUInteger high = entries.length / sizeof(uint64_t);
+    while (low < high) {
+        NSUInteger mid = (low + high) / 2;
+        if (items[mid] < target) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < entries.length / sizeof(uint64_t) && items[low] == target;
+}
+
+- (NSArray<ChapterSearchHit *> *)search:(NSString *)query limit:(NSUInteger)limit {
+    NSString *trimmed = [query stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+    if (trimmed.length == 0) {
+        return @[];
+    }
+
+    __block NSMutableData *matches = [NSMutableData data];
+    dispatch_sync(self.indexQueue, ^{
+        [self loadIfNeeded];
+        if (trimmed.length == 1 && SearchIsCJK([trimmed characterAtIndex:0])) {
+            matches = [self matchSingleCharacter:[trimmed characterAtIndex:0]];
+        } else {
+            matches = [self matchPhrase:trimmed];
+        }
+    });
+
+    NSUInteger count = matches.length / sizeof(uint64_t);
+    if (limit > 0) {
+        count = MIN(count, limit);
+    }
+
+    const uint64_t *items = matches.bytes;
+    NSMutableArray<ChapterSearchHit *> *hits = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        ChapterSearchHit *hit = [[ChapterSearchHit alloc] init];
+        hit.chapterIndex = (NSInteger)(int32_t)(items[i] >> 32);
+        hit.offset = (NSUInteger)(items[i] & 0xFFFFFFFF);
+        [hits addObject:hit];
+    }
+    return hits;
+}
+
+- (NSMutableData *)matchPhrase:(NSString *)query {
+    NSUInteger length = query.length;
+    unichar *chars = malloc(length * sizeof(unichar));
+    [query getCharacters:chars range:NSMakeRange(0, length)];
+    SearchTokenList tokens = {0};
+    SearchTokenize(chars, length, &tokens);
+    free(chars);
+
+    NSMutableData *result = [NSMutableData data];
+    if (tokens.count == 0) {
+        free(tokens.items);
+        return result;
+    }
+
+    // 解码每个词项；任何一个不存在则无结果
+    NSMutableArray<NSMutableData *> *lists = [NSMutableArray arrayWithCapacity:tokens.count];
+    NSUInteger anchor = 0;
+    for (NSUInteger i = 0; i < tokens.count; i++) {
+        uint64_t key = tokens.items[i].key;
+        NSMutableData *entries;
+        if ((key & ~0xFFFFULL) == kTermTagUnigram) {
+            // 查询里孤立的汉字（如 "A张"）在正文中多半属于某个二元组，按单字取出它的所有出现位置
+            entries = [self matchSingleCharacter:(unichar)(key & 0xFFFF)];
+            if (entries.length == 0) {
+                free(tokens.items);
+                return result;
+            }
+        } else {
+            SearchPostingList *list = [self postingListForKey:key];
+            if (!list) {
+                free(tokens.items);
+                return result;
+            }
+            entries = [NSMutableData data];
+            [self decodePostingList:list shift:0 into:entries];
+            SearchSortEntries(entries);
+        }
+        [lists addObject:entries];
+        if (entries.length < lists[anchor].length) {
+            anchor = i;
+        }
+    }
+
+    // ⭐ 以最短的倒排表为锚点，逐个验证其他词项的相对位置
+    const uint64_t *anchorItems = lists[anchor].bytes;
+    NSUInteger anchorCount = lists[anchor].length / sizeof(uint64_t);
+    uint32_t anchorRelative = tokens.items[anchor].position;
+
+    for (NSUInteger i = 0; i < anchorCount; i++) {
+        uint64_t chapter = anchorItems[i] >> 32;
+        uint32_t position = (uint32_t)(anchorItems[i] & 0xFFFFFFFF);
+        if (position < anchorRelative) {
+            continue;
+        }
+        uint32_t start = position - anchorRelative;
+
+        BOOL matched = YES;
+        for (NSUInteger k = 0; k < tokens.count && matched; k++) {
+            if (k == anchor) {
+                continue;
+            }
+            uint64_t target = (chapter << 32) | (start + tokens.items[k].position);
+            matched = SearchContainsEntry(lists[k], target);
+        }
+
+        if (matched) {
+            uint64_t entry = (chapter << 32) | start;
+            [result appendBytes:&entry length:sizeof(entry)];
+        }
+    }
+
+    free(tokens.items);
+    return result;
+}
+
+- (NSMutableData *)matchSingleCharacter:(unichar)c {
+    // 单字没有独立的词项，合并“以它开头”和“以它结尾”的二元组以及孤立单字
+    NSMutableData *entries = [NSMutableData data];
+    for (uint32_t slot = 0; slot < _tableCapacity; slot++) {
+        uint64_t key = _keys[slot];
+        if ((key & ~0xFFFFFFFFULL) != kTermTagBigram) {
+            continue;
+        }
+        unichar first = (unichar)((key >> 16) & 0xFFFF);
+        unichar second = (unichar)(key & 0xFFFF);
+        if (first == c) {
+            [self decodePostingList:self.postings[_slots[slot]] shift:0 into:entries];
+        }
+        if (second == c) {
+            [self decodePostingList:self.postings[_slots[slot]] shift:1 into:entries];
+        }
+    }
+
+    SearchPostingList *unigram = [self postingListForKey:kTermTagUnigram | c];
+    if (unigram) {
+        [self decodePostingList:unigram shift:0 into:entries];
+    }
+
+    SearchSortEntries(entries);
+
+    // 去重（同一位置可能同时作为前一个二元组的第二字和后一个二元组的第一字）
+    uint64_t *items = entries.mutableBytes;
+    NSUInteger count = entries.length / sizeof(uint64_t);
+    NSUInteger unique = 0;
+    for (NSUInteger i = 0; i < count; i++) {
+        if (unique == 0 || items[unique - 1] != items[i]) {
+            items[unique++] = items[i];
+        }
+    }
+    entries.length = unique * sizeof(uint64_t);
+    return entries;
+}
+
+@end
@@ -0,0 +1,53 @@
+//
+//  PaginationCache.h
+//  Read
+//
+//  分页缓存 - 持久化每章的分页位置，相同排版参数下重新打开无需再排版
+//
+
+#import <Foundation/Foundation.h>
+#import "PaginationEngine.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 分页缓存
+ *
+ * 职责：
+ *   1. 以（章节内容哈希、字体、字号、行距、段距、宽高）为键保存每页起始位置
+ *   2. 内存 + 磁盘两级：内存 NSCache，磁盘每条一个小文件（4 字节/页）
+ *   3. 磁盘按最近访问时间 LRU 淘汰，跨启动复用
+ *   4. 未命中时调用 PaginationEngine 计算并写回
+ *
+ * 使用示例：
+ *   NSArray<NSNumber *> *breaks = [[PaginationCache sharedCache] pageBreaksForText:content layout:layout];
+ */
+@interface PaginationCache : NSObject
+
+// 单例
++ (instancetype)sharedCache;
+
+/**
+ * 获取分页位置，未命中时同步计算并写入缓存
+ */
+- (NSArray<NSNumber *> *)pageBreaksForText:(NSString *)text layout:(PaginationLayout *)layout;
+
+/**
+ * 只查缓存，不计算
+ * @return 未命中返回 nil
+ */
+- (nullable NSArray<NSNumber *> *)cachedPageBreaksForText:(NSString *)text layout:(PaginationLayout *)layout;
+
+/**
+ * 写入缓存（磁盘写入异步进行）
+ */
+- (void)storePageBreaks:(NSArray<NSNumber *> *)breaks forText:(NSString *)text layout:(PaginationLayout *)layout;
+
+/**
+ * 清空缓存
+ */
+- (void)removeAllEntries;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,281 @@
+//
+//  PaginationCache.m
+//  Read
+//
+//  分页缓存实现
+//
+
+#import "PaginationCache.h"
+#import "NSString+Digest.h"
+#import "MetricsRegistry.h"
+
+#pragma mark - 文件格式
+
+static const uint32_t kPaginationCacheMagic = 0x31434750;   // "PGC1"
+static const uint32_t kPaginationCacheVersion = 1;          // 分页规则变化时递增，旧条目自动失效
+static const NSUInteger kPaginationCacheMaxEntries = 2000;  // 磁盘最多保留的条目数
+static const NSUInteger kPaginationCacheMemoryLimit = 64;   // 内存最多保留的条目数
+static const NSTimeInterval kPaginationCacheTouchInterval = 60;  // 同一条目的文件修改时间最多每分钟更新一次
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t textLength;     // 校验：内容长度不一致视为失效
+    uint32_t count;
+    uint32_t checksum;       // FNV-1a(offsets)
+} PaginationCacheHeader;
+
+static uint32_t PaginationCacheChecksum(const uint8_t *bytes, NSUInteger length) {
+    uint32_t hash = 2166136261u;
+    for (NSUInteger i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+@interface PaginationCache ()
+@property (copy, nonatomic) NSString *cacheDirectory;
+@property (strong, nonatomic) NSCache<NSString *, NSArray<NSNumber *> *> *memoryCache;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSNumber *> *accessTimes;  // 仅在 ioQueue 访问
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSNumber *> *fileTimes;    // 已写到文件修改时间上的访问时间（仅在 ioQueue 访问）
+@property (strong, nonatomic) dispatch_queue_t ioQueue;
+@end
+
+@implementation PaginationCache
+
++ (instancetype)sharedCache {
+    static PaginationCache *cache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [[PaginationCache alloc] init];
+    });
+    return cache;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        // 可重新计算的数据放在 Caches 目录，系统空间不足时可被清理
+        NSString *cachesPath = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) firstObject];
+        _cacheDirectory = [cachesPath stringByAppendingPathComponent:@"PaginationCache"];
+        [[NSFileManager defaultManager] createDirectoryAtPath:_cacheDirectory
+                                  withIntermediateDirectories:YES
+                                                   attributes:nil
+                                                        error:nil];
+
+        _memoryCache = [[NSCache alloc] init];
+        _memoryCache.countLimit = kPaginationCacheMemoryLimit;
+        _ioQueue = dispatch_queue_create("com.read.pagination.cache", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+#pragma mark - 查询
+
+- (NSArray<NSNumber *> *)pageBreaksForText:(NSString *)text layout:(PaginationLayout *)layout {
+    NSString *key = [self keyForText:text layout:layout];
+    NSArray<NSNumber *> *breaks = [self cachedPageBreaksForKey:key textLength:text.length];
+    if (breaks) {
+        return breaks;
+    }
+
+    breaks = [[PaginationEngine sharedEngine] pageBreaksForText:text layout:layout];
+    [self storePageBreaks:breaks forKey:key textLength:text.length];
+    return breaks;
+}
+
+- (nullable NSArray<NSNumber *> *)cachedPageBreaksForText:(NSString *)text layout:(PaginationLayout *)layout {
+    return [self cachedPageBreaksForKey:[self keyForText:text layout:layout] textLength:text.length];
+}
+
+- (nullable NSArray<NSNumber *> *)cachedPageBreaksForKey:(NSString *)key textLength:(NSUInteger)textLength {
+    NSArray<NSNumber *> *breaks = [self.memoryCache objectForKey:key];
+    if (breaks) {
+        MetricsCount(MetricsCurrentSource(), MetricCounterPaginationCacheHit, 1);
+        [self touchKey:key];
+        return breaks;
+    }
+
+    // ⭐ 条目只有几百字节，直接在调用线程读取
+    NSData *data = [NSData dataWithContentsOfFile:[self filePathForKey:key]];
+    breaks = [self decodePageBreaks:data textLength:textLength];
+    MetricsCount(MetricsCurrentSource(), breaks ? MetricCounterPaginationCacheHit : MetricCounterPaginationCacheMiss, 1);
+    if (!breaks) {
+        return nil;
+    }
+
+    [self.memoryCache setObject:breaks forKey:key];
+    [self touchKey:key];
+    return breaks;
+}
+
+#pragma mark - 写入
+
+- (void)storePageBreaks:(NSArray<NSNumber *> *)breaks forText:(NSString *)text layout:(PaginationLayout *)layout {
+    [self storePageBreaks:breaks forKey:[self keyForText:text layout:layout] textLength:text.length];
+}
+
+- (void)storePageBreaks:(NSArray<NSNumber *> *)breaks forKey:(NSString *)key textLength:(NSUInteger)textLength {
+    if (breaks.count == 0) {
+        return;
+    }
+    [self.memoryCache setObject:breaks forKey:key];
+
+    NSData *data = [self encodePageBreaks:breaks textLength:textLength];
+    dispatch_async(self.ioQueue, ^{
+        [self loadAccessTimesIfNeeded];
+        if (![data writeToFile:[self filePathForKey:key] atomically:YES]) {
+            NSLog(@"⚠️ 分页缓存写入失败: %@", key);
+            return;
+        }
+        NSNumber *now = @([NSDate timeIntervalSinceReferenceDate]);
+        self.accessTimes[key] = now;
+        self.fileTimes[key] = now;
+        [self evictIfNeeded];
+    });
+}
+
+- (void)removeAllEntries {
+    [self.memoryCache removeAllObjects];
+    dispatch_async(self.ioQueue, ^{
+        NSFileManager *fm = [NSFileManager defaultManager];
+        [fm removeItemAtPath:self.cacheDirectory error:nil];
+        [fm createDirectoryAtPath:self.cacheDirectory withIntermediateDirectories:YES attributes:nil error:nil];
+        self.accessTimes = [NSMutableDictionary dictionary];
+        self.fileTimes = [NSMutableDictionary dictionary];
+    });
+}
+
+#pragma mark - LRU
+
+- (void)touchKey:(NSString *)key {
+    dispatch_async(self.ioQueue, ^{
+        [self loadAccessTimesIfNeeded];
+        NSDate *now = [NSDate date];
+        self.accessTimes[key] = @(now.timeIntervalSinceReferenceDate);
+
+        // 访问时间记在文件修改时间上，重启后据此恢复 LRU 顺序
+        // ⭐ 翻页时每次内存命中都会走到这里，同一条目一分钟内只写一次（重启后的顺序最多差一分钟）
+        if (now.timeIntervalSinceReferenceDate - self.fileTimes[key].doubleValue < kPaginationCacheTouchInterval) {
+            return;
+        }
+        self.fileTimes[key] = @(now.timeIntervalSinceReferenceDate);
+        [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate: now}
+                                         ofItemAtPath:[self filePathForKey:key]
+                                                error:nil];
+    });
+}
+
+- (void)loadAccessTimesIfNeeded {
+    if (self.accessTimes) {
+        return;
+    }
+    self.accessTimes = [NSMutableDictionary dictionary];
+    self.fileTimes = [NSMutableDictionary dictionary];
+
+    NSArray<NSURL *> *files = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:[NSURL fileURLWithPath:self.cacheDirectory]
+                                                            includingPropertiesForKeys:@[NSURLContentModificationDateKey]
+                                                                               options:NSDirectoryEnumerationSkipsHiddenFiles
+                                                                                 error:nil];
+    for (NSURL *url in files) {
+        NSDate *modified = nil;
+        [url getResourceValue:&modified forKey:NSURLContentModificationDateKey error:nil];
+        NSString *key = url.lastPathComponent.stringByDeletingPathExtension;
+        self.accessTimes[key] = @(modified.timeIntervalSinceReferenceDate);
+        self.fileTimes[key] = self.accessTimes[key];
+    }
+}
+
+- (void)evictIfNeeded {
+    if (self.accessTimes.count <= kPaginationCacheMaxEntries) {
+        return;
+    }
+
+    // 一次淘汰到 90%，避免每次写入都触发排序
+    NSArray<NSString *> *keys = [self.accessTimes keysSortedByValueUsingSelector:@selector(compare:)];
+    NSUInteger removeCount = self.accessTimes.count - kPaginationCacheMaxEntries * 9 / 10;
+    NSFileManager *fm = [NSFileManager defaultManager];
+    for (NSUInteger i = 0; i < removeCount; i++) {
+        [fm removeItemAtPath:[self filePathForKey:keys[i]] error:nil];
+        [self.accessTimes removeObjectForKey:keys[i]];
+        [self.fileTimes removeObjectForKey:keys[i]];
+    }
+}
+
+#pragma mark - 编解码
+
+- (NSData *)encodePageBreaks:(NSArray<NSNumber *> *)breaks textLength:(NSUInteger)textLength {
+    NSMutableData *offsets = [NSMutableData dataWithLength:breaks.count * sizeof(uint32_t)];
+    uint32_t *items = offsets.mutableBytes;
+    for (NSUInteger i = 0; i < breaks.count; i++) {
+        items[i] = (uint32_t)breaks[i].unsignedIntegerValue;
+    }
+
+    PaginationCacheHeader header;
+    header.magic = kPaginationCacheMagic;
+    header.version = kPaginationCacheVersion;
+    header.textLength = (uint32_t)textLength;
+    header.count = (uint32_t)breaks.count;
+    header.checksum = PaginationCacheChecksum(offsets.bytes, offsets.length);
+
+    NSMutableData *data = [NSMutableData dataWithCapacity:sizeof(header) + offsets.length];
+    [data appendBytes:&header length:sizeof(header)];
+    [data appendData:offsets];
+    return data;
+}
+
+- (nullable NSArray<NSNumber *> *)decodePageBreaks:(nullable NSData *)data textLength:(NSUInteger)textLength {
+    if (data.length < sizeof(PaginationCacheHeader)) {
+        return nil;
+    }
+
+    PaginationCacheHeader header;
+    memcpy(&header, data.bytes, sizeof(header));
+    NSUInteger offsetsLength = (NSUInteger)header.count * sizeof(uint32_t);
+    if (header.magic != kPaginationCacheMagic ||
+        header.version != kPaginationCacheVersion ||
+        header.textLength != textLength ||
+        header.count == 0 ||
+        sizeof(header) + offsetsLength != data.length) {
+        return nil;
+    }
+
+    const uint8_t *offsetBytes = (const uint8_t *)data.bytes + sizeof(header);
+    if (PaginationCacheChecksum(offsetBytes, offsetsLength) != header.checksum) {
+        return nil;
+    }
+
+    NSMutableArray<NSNumber *> *breaks = [NSMutableArray arrayWithCapacity:header.count];
+    uint32_t previous = 0;
+    for (uint32_t i = 0; i < header.count; i++) {
+        uint32_t offset;
+        memcpy(&offset, offsetBytes + i * sizeof(uint32_t), sizeof(offset));
+        if (offset >= textLength || (i > 0 && offset <= previous)) {
+            return nil;
+        }
+        [breaks addObject:@(offset)];
+        previous = offset;
+    }
+    return breaks;
+}
+
+#pragma mark - 键与路径
+
+- (NSString *)keyForText:(NSString *)text layout:(PaginationLayout *)layout {
+    NSString *composite = [NSString stringWithFormat:@"%@|%@|%.2f|%.2f|%.2f|%.1fx%.1f",
+                           [text sha1String],
+                           layout.fontName ?: @"system",
+                           layout.fontSize,
+                           layout.lineSpacing,
+                           layout.paragraphSpacing,
+                           layout.pageSize.width,
+                           layout.pageSize.height];
+    return [composite sha1String];
+}
+
+- (NSString *)filePathForKey:(NSString *)key {
+    return [self.cacheDirectory stringByAppendingPathComponent:[key stringByAppendingPathExtension:@"pg"]];
+}
+
+@end
@@ -0,0 +1,73 @@
+//
+//  ReadingProgressStore.h
+//  Read
+//
+//  阅读进度存储 - 合并写入 + 每本书一个定长追加日志
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 单条进度记录
+ */
+@interface ReadingProgressEntry : NSObject
+@property (assign, nonatomic) NSInteger chapterIndex;   // 章节索引
+@property (assign, nonatomic) double scrollOffset;      // 滚动偏移量（章节内的位置）
+@property (strong, nonatomic) NSDate *lastReadTime;     // 最后阅读时间
+@end
+
+/**
+ * 阅读进度存储
+ *
+ * 职责：
+ *   1. 每本书只在内存中保留最新位置，频繁写入只覆盖内存
+ *   2. 防抖刷盘（持续滚动时最长延迟5秒），进入后台时同步刷盘
+ *   3. 每本书一个 16 槽 × 32 字节的环形日志文件，带序号和校验和；
+ *      写入中途崩溃只会损坏一个槽，恢复时取序号最大的有效记录
+ *   4. 恢复时只读取这一个 512 字节的文件
+ *
+ * 说明：
+ *   滚动偏移是章节内的位置（不是竖向窗口内的绝对位置），窗口重建后仍然有效。
+ *
+ * 使用示例：
+ *   [[ReadingProgressStore sharedStore] recordProgressForBook:url chapterIndex:5 scrollOffset:320];
+ *   ReadingProgressEntry *entry = [[ReadingProgressStore sharedStore] latestProgressForBook:url];
+ */
+@interface ReadingProgressStore : NSObject
+
+// 单例
++ (instancetype)sharedStore;
+
+/**
+ * 记录最新进度（仅更新内存并安排防抖刷盘，任意线程可调用）
+ */
+- (void)recordProgressForBook:(NSString *)bookUrl
+                 chapterIndex:(NSInteger)chapterIndex
+                 scrollOffset:(double)scrollOffset;
+
+/**
+ * 获取最新进度（优先内存，其次读取日志文件）
+ * @return 没有记录时返回 nil
+ */
+- (nullable ReadingProgressEntry *)latestProgressForBook:(NSString *)bookUrl;
+
+/**
+ * 删除某本书的进度
+ */
+- (void)removeProgressForBook:(NSString *)bookUrl;
+
+/**
+ * 立即异步刷盘
+ */
+- (void)flush;
+
+/**
+ * 同步刷盘（进入后台时调用）
+ */
+- (void)flushAndWait;
+
+@end
+
+NS_ASSUME_NONNULL_END
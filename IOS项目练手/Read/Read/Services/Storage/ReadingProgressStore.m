@@ -0,0 +1,332 @@
+//
+//  ReadingProgressStore.m
+//  Read
+//
+//  阅读进度存储实现
+//
+
+#import "ReadingProgressStore.h"
+#import "AppConfig.h"
+#import "NSString+Digest.h"
+#import <UIKit/UIKit.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#pragma mark - 日志格式
+
+static const uint32_t kProgressRecordMagic = 0x32525052;   // "RPR2"：滚动偏移是章节内的位置
+static const uint32_t kProgressLogSlots = 16;
+static const NSTimeInterval kProgressMaxFlushDelay = 5.0;  // 持续写入时的最长刷盘延迟
+static NSString * const kLegacyProgressKeyFormat = @"ReadProgress_%@";
+
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;       // 单调递增，最大者为最新
+    int32_t chapterIndex;
+    uint32_t checksum;
+    double scrollOffset;
+    double timestamp;        // timeIntervalSince1970
+} ProgressLogRecord;         // 32 字节，对齐写入
+
+static uint32_t ProgressLogChecksum(ProgressLogRecord record) {
+    record.checksum = 0;
+    const uint8_t *bytes = (const uint8_t *)&record;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(record); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+#pragma mark - ReadingProgressEntry
+
+@implementation ReadingProgressEntry
+@end
+
+#pragma mark - 单本书的内存状态
+
+@interface ReadingProgressBookState : NSObject
+@property (strong, nonatomic) ReadingProgressEntry *entry;
+@property (assign, nonatomic) uint32_t nextSequence;  // 0 表示尚未从文件读取
+@property (assign, nonatomic) BOOL dirty;
+@end
+
+@implementation ReadingProgressBookState
+@end
+
+#pragma mark - ReadingProgressStore
+
+@interface ReadingProgressStore ()
+@property (strong, nonatomic) NSMutableDictionary<NSString *, ReadingProgressBookState *> *books;
+@property (copy, nonatomic) NSString *logDirectory;
+@property (strong, nonatomic) dispatch_queue_t ioQueue;
+@property (strong, nonatomic) dispatch_source_t debounceTimer;
+@property (assign, nonatomic) NSTimeInterval dirtySince;  // 最早一次未刷盘写入的时间，0 表示无
+@end
+
+@implementation ReadingProgressStore
+
++ (instancetype)sharedStore {
+    static ReadingProgressStore *store = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        store = [[ReadingProgressStore alloc] init];
+    });
+    return store;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _books = [NSMutableDictionary dictionary];
+        _ioQueue = dispatch_queue_create("com.read.progress.save", DISPATCH_QUEUE_SERIAL);
+
+        NSString *documentsPath = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) firstObject];
+        _logDirectory = [documentsPath stringByAppendingPathComponent:@"ReadingProgress"];
+        [[NSFileManager defaultManager] createDirectoryAtPath:_logDirectory
+                                  withIntermediateDirectories:YES
+                                                   attributes:nil
+                                                        error:nil];
+
+        // 防抖定时器：每次写入时重新设定触发时间
+        _debounceTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _ioQueue);
+        dispatch_source_set_timer(_debounceTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        __weak typeof(self) weakSelf = self;
+        dispatch_source_set_event_handler(_debounceTimer, ^{
+            [weakSelf flushOnIOQueue];
+        });
+        dispatch_resume(_debounceTimer);
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(flushAndWait)
+                                                     name:UIApplicationDidEnterBackgroundNotification
+                                                   object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(flushAndWait)
+                                                     name:UIApplicationWillTerminateNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+#pragma mark - 写入
+
+- (void)recordProgressForBook:(NSString *)bookUrl
+                 chapterIndex:(NSInteger)chapterIndex
+                 scrollOffset:(double)scrollOffset {
+    if (bookUrl.length == 0) {
+        return;
+    }
+
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    BOOL shouldRearm;
+
+    @synchronized (self) {
+        ReadingProgressBookState *state = self.books[bookUrl];
+        if (!state) {
+            state = [[ReadingProgressBookState alloc] init];
+            self.books[bookUrl] = state;
+        }
+
+        ReadingProgressEntry *entry = [[ReadingProgressEntry alloc] init];
+        entry.chapterIndex = chapterIndex;
+        entry.scrollOffset = scrollOffset;
+        entry.lastReadTime = [NSDate date];
+        state.entry = entry;
+        state.dirty = YES;
+
+        if (self.dirtySince == 0) {
+            self.dirtySince = now;
+        }
+        // ⭐ 持续滚动时不再推迟，保证最长 kProgressMaxFlushDelay 内落盘
+        shouldRearm = (now - self.dirtySince) < kProgressMaxFlushDelay;
+    }
+
+    if (shouldRearm) {
+        uint64_t delay = (uint64_t)(AppConfig.progressSaveDebounceInterval * NSEC_PER_SEC);
+        dispatch_source_set_timer(self.debounceTimer, dispatch_time(DISPATCH_TIME_NOW, delay), DISPATCH_TIME_FOREVER, delay / 10);
+    }
+}
+
+- (void)removeProgressForBook:(NSString *)bookUrl {
+    @synchronized (self) {
+        [self.books removeObjectForKey:bookUrl];
+    }
+
+    dispatch_async(self.ioQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtPath:[self logPathForBook:bookUrl] error:nil];
+    });
+}
+
+#pragma mark - 读取
+
+- (nullable ReadingProgressEntry *)latestProgressForBook:(NSString *)bookUrl {
+    if (bookUrl.length == 0) {
+        return nil;
+    }
+
+    @synchronized (self) {
+        ReadingProgressEntry *cached = self.books[bookUrl].entry;
+        if (cached) {
+            return cached;
+        }
+    }
+
+    __block ReadingProgressEntry *entry = nil;
+    __block uint32_t sequence = 0;
+    dispatch_sync(self.ioQueue, ^{
+        entry = [self readLatestRecordForBook:bookUrl sequence:&sequence];
+    });
+
+    if (!entry) {
+        return [self migrateLegacyProgressForBook:bookUrl];
+    }
+
+    @synchronized (self) {
+        ReadingProgressBookState *state = self.books[bookUrl];
+        if (!state) {
+            state = [[ReadingProgressBookState alloc] init];
+            state.entry = entry;
+            state.nextSequence = sequence + 1;
+            self.books[bookUrl] = state;
+        }
+        return state.entry;
+    }
+}
+
+- (nullable ReadingProgressEntry *)migrateLegacyProgressForBook:(NSString *)bookUrl {
+    // 旧版本把进度字典存在 NSUserDefaults 中，读到后转入日志并删除
+    NSString *legacyKey = [NSString stringWithFormat:kLegacyProgressKeyFormat, bookUrl];
+    NSDictionary *progress = [[NSUserDefaults standardUserDefaults] objectForKey:legacyKey];
+    if (![progress isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+
+    // 旧版本的滚动偏移是竖向窗口内的绝对位置，窗口起点没有保存，无法换算：只保留章节
+    [self recordProgressForBook:bookUrl
+                   chapterIndex:[progress[@"chapterIndex"] integerValue]
+                   scrollOffset:0];
+    [[NSUserDefaults standardUserDefaults] removeObjectForKey:legacyKey];
+
+    @synchronized (self) {
+        return self.books[bookUrl].entry;
+    }
+}
+
+#pragma mark - 刷盘
+
+- (void)flush {
+    dispatch_async(self.ioQueue, ^{
+        [self flushOnIOQueue];
+    });
+}
+
+- (void)flushAndWait {
+    dispatch_sync(self.ioQueue, ^{
+        [self flushOnIOQueue];
+    });
+}
+
+- (void)flushOnIOQueue {
+    NSMutableDictionary<NSString *, ReadingProgressBookState *> *dirtyBooks = [NSMutableDictionary dictionary];
+
+    @synchronized (self) {
+        [self.books enumerateKeysAndObjectsUsingBlock:^(NSString *bookUrl, ReadingProgressBookState *state, BOOL *stop) {
+            if (state.dirty) {
+                state.dirty = NO;
+                dirtyBooks[bookUrl] = state;
+            }
+        }];
+        self.dirtySince = 0;
+    }
+
+    [dirtyBooks enumerateKeysAndObjectsUsingBlock:^(NSString *bookUrl, ReadingProgressBookState *state, BOOL *stop) {
+        ReadingProgressEntry *entry;
+        uint32_t sequence;
+        @synchronized (self) {
+            entry = state.entry;
+            if (state.nextSequence == 0) {
+                uint32_t lastSequence = 0;
+                [self readLatestRecordForBook:bookUrl sequence:&lastSequence];
+                state.nextSequence = lastSequence + 1;
+            }
+            sequence = state.nextSequence++;
+        }
+        [self writeEntry:entry sequence:sequence forBook:bookUrl];
+    }];
+}
+
+- (void)writeEntry:(ReadingProgressEntry *)entry sequence:(uint32_t)sequence forBook:(NSString *)bookUrl {
+    ProgressLogRecord record = {0};
+    record.magic = kProgressRecordMagic;
+    record.sequence = sequence;
+    record.chapterIndex = (int32_t)entry.chapterIndex;
+    record.scrollOffset = entry.scrollOffset;
+    record.timestamp = entry.lastReadTime.timeIntervalSince1970;
+    record.checksum = ProgressLogChecksum(record);
+
+    NSString *path = [self logPathForBook:bookUrl];
+    int fd = open(path.fileSystemRepresentation, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        NSLog(@"❌ 阅读进度写入失败: %@", path);
+        return;
+    }
+
+    // ⭐ 环形覆盖最旧的槽，其余槽保持不变，单槽写坏时仍可回退到上一条
+    off_t offset = (off_t)(sequence % kProgressLogSlots) * sizeof(ProgressLogRecord);
+    if (pwrite(fd, &record, sizeof(record), offset) != sizeof(record)) {
+        NSLog(@"❌ 阅读进度写入不完整: %@", path);
+    }
+    close(fd);
+}
+
+- (nullable ReadingProgressEntry *)readLatestRecordForBook:(NSString *)bookUrl sequence:(uint32_t *)sequence {
+    *sequence = 0;
+
+    int fd = open([self logPathForBook:bookUrl].fileSystemRepresentation, O_RDONLY);
+    if (fd < 0) {
+        return nil;
+    }
+
+    ProgressLogRecord records[kProgressLogSlots];
+    ssize_t length = pread(fd, records, sizeof(records), 0);
+    close(fd);
+    if (length <= 0) {
+        return nil;
+    }
+
+    const ProgressLogRecord *latest = NULL;
+    NSUInteger count = (NSUInteger)length / sizeof(ProgressLogRecord);
+    for (NSUInteger i = 0; i < count; i++) {
+        const ProgressLogRecord *record = &records[i];
+        if (record->magic != kProgressRecordMagic ||
+            record->checksum != ProgressLogChecksum(*record)) {
+            continue;
+        }
+        if (!latest || record->sequence > latest->sequence) {
+            latest = record;
+        }
+    }
+
+    if (!latest) {
+        return nil;
+    }
+
+    *sequence = latest->sequence;
+    ReadingProgressEntry *entry = [[ReadingProgressEntry alloc] init];
+    entry.chapterIndex = latest->chapterIndex;
+    entry.scrollOffset = latest->scrollOffset;
+    entry.lastReadTime = [NSDate dateWithTimeIntervalSince1970:latest->timestamp];
+    return entry;
+}
+
+#pragma mark - 路径
+
+- (NSString *)logPathForBook:(NSString *)bookUrl {
+    NSString *name = [[bookUrl sha1String] stringByAppendingPathExtension:@"log"];
+    return [self.logDirectory stringByAppendingPathComponent:name];
+}
+
+@end
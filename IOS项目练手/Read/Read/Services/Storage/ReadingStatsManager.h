@@ -45,7 +45,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (NSInteger)getTodayReadingDuration;
 
 /**
- * 获取本周阅读时长（秒）
+ * 获取本周阅读时长（秒，自然周，周一开始）
  */
 - (NSInteger)getThisWeekReadingDuration;
 
@@ -91,6 +91,13 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)addReadingWords:(NSInteger)words;
 
+/**
+ * 本次阅读会话的阅读速度（字/秒）
+ * 按已读完章节的字数 / 会话时长估算（最近一次增加的字数是刚进入的章节，不计入）；
+ * 没有会话或会话不足 1 分钟时返回 0
+ */
+- (double)currentReadingSpeed;
+
 #pragma mark - 数据清理
 
 /**
@@ -6,6 +6,15 @@
 //
 
 #import "ReadingStatsManager.h"
+#import "ReadingStatsStore.h"
+#import "AppConfig.h"
+#import <UIKit/UIKit.h>
+
+static NSString * const kStatsStoreFileName = @"reading_stats.bin";
+static NSString * const kReadingRecordsKey = @"ReadingRecords";
+static NSString * const kReadBooksKey = @"ReadBooks";
+static const NSUInteger kMaxStoredRecords = 100;  // 最多保存的阅读记录
+static const NSUInteger kMaxRecentRecords = 20;   // 最近记录返回条数
 
 // 阅读记录模型实现
 @implementation ReadingRecord
@@ -37,8 +46,14 @@
 // 阅读统计管理器实现
 @interface ReadingStatsManager ()
 @property (strong, nonatomic) NSDate *sessionStartTime;  // 当前阅读会话开始时间
+@property (assign, nonatomic) NSInteger sessionWords;     // 当前会话累计的阅读字数
+@property (assign, nonatomic) NSInteger lastAddedWords;   // 最近一次增加的字数（刚进入的章节）
 @property (copy, nonatomic) NSString *currentBookUrl;
 @property (copy, nonatomic) NSString *currentBookTitle;
+@property (strong, nonatomic) ReadingStatsStore *store;                    // 时长/字数/章节计数
+@property (strong, nonatomic) NSMutableArray<ReadingRecord *> *records;    // 阅读记录（内存）
+@property (strong, nonatomic) NSMutableSet<NSString *> *readBooks;         // 已读书籍（内存）
+@property (assign, nonatomic) BOOL recordsDirty;                           // 记录是否待持久化
 @end
 
 @implementation ReadingStatsManager
@@ -55,8 +70,29 @@
 - (instancetype)init {
     self = [super init];
     if (self) {
-        // 初始化时清理过期数据（超过30天的记录）
+        NSString *documentsPath = [NSSearchPathForDirectoriesInDomains(NSDocumentDirectory, NSUserDomainMask, YES) firstObject];
+        NSString *storePath = [documentsPath stringByAppendingPathComponent:kStatsStoreFileName];
+        BOOL needsMigration = ![[NSFileManager defaultManager] fileExistsAtPath:storePath];
+
+        _store = [[ReadingStatsStore alloc] initWithFilePath:storePath flushInterval:AppConfig.statsFlushInterval];
+        if (needsMigration) {
+            [self migrateLegacyDailyStats];
+        }
+
+        [self loadRecords];
+
+        // 初始化时清理过期数据（超过30天的按天数据折叠进月归档）
         [self cleanupOldRecords];
+
+        // ⭐ 进入后台/退出时把内存中的统计一次性落盘
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(flushPendingStats)
+                                                     name:UIApplicationDidEnterBackgroundNotification
+                                                   object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(flushPendingStats)
+                                                     name:UIApplicationWillTerminateNotification
+                                                   object:nil];
     }
     return self;
 }
@@ -65,6 +101,8 @@
 
 - (void)startReadingSession:(NSString *)bookUrl bookTitle:(NSString *)bookTitle {
     self.sessionStartTime = [NSDate date];
+    self.sessionWords = 0;
+    self.lastAddedWords = 0;
     self.currentBookUrl = bookUrl;
     self.currentBookTitle = bookTitle;
 }
@@ -86,49 +124,26 @@
     self.sessionStartTime = nil;
     self.currentBookUrl = nil;
     self.currentBookTitle = nil;
+
+    // 离开阅读页时顺带持久化（阅读过程中不产生 I/O）
+    [self persistRecordsIfNeeded];
+    [self.store flush];
 }
 
 - (void)saveDuration:(NSInteger)duration forDate:(NSDate *)date {
-    NSString *dateKey = [self dateKeyFromDate:date];
-    NSString *key = [NSString stringWithFormat:@"ReadingDuration_%@", dateKey];
-
-    NSInteger existingDuration = [[NSUserDefaults standardUserDefaults] integerForKey:key];
-    [[NSUserDefaults standardUserDefaults] setInteger:existingDuration + duration forKey:key];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    [self.store addDuration:duration words:0 chapters:0 atDate:date];
 }
 
 - (NSInteger)getTodayReadingDuration {
-    return [self getDurationForDate:[NSDate date]];
+    return [self.store durationForDayOfDate:[NSDate date]];
 }
 
 - (NSInteger)getThisWeekReadingDuration {
-    NSInteger total = 0;
-    NSCalendar *calendar = [NSCalendar currentCalendar];
-    NSDate *today = [NSDate date];
-
-    for (NSInteger i = 0; i < 7; i++) {
-        NSDate *date = [calendar dateByAddingUnit:NSCalendarUnitDay value:-i toDate:today options:0];
-        total += [self getDurationForDate:date];
-    }
-
-    return total;
+    return [self.store durationForWeekOfDate:[NSDate date]];
 }
 
 - (NSInteger)getTotalReadingDuration {
-    NSInteger total = [[NSUserDefaults standardUserDefaults] integerForKey:@"TotalReadingDuration"];
-    return total;
-}
-
-- (NSInteger)getDurationForDate:(NSDate *)date {
-    NSString *dateKey = [self dateKeyFromDate:date];
-    NSString *key = [NSString stringWithFormat:@"ReadingDuration_%@", dateKey];
-    return [[NSUserDefaults standardUserDefaults] integerForKey:key];
-}
-
-- (NSString *)dateKeyFromDate:(NSDate *)date {
-    NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
-    formatter.dateFormat = @"yyyy-MM-dd";
-    return [formatter stringFromDate:date];
+    return self.store.totalDuration;
 }
 
 #pragma mark - 阅读记录
@@ -146,126 +161,143 @@
     record.readTime = [NSDate date];
     record.duration = self.sessionStartTime ? (NSInteger)[[NSDate date] timeIntervalSinceDate:self.sessionStartTime] : 0;
 
-    // 获取现有记录
-    NSMutableArray<ReadingRecord *> *records = [[self getRecentReadingRecords] mutableCopy];
-    if (!records) {
-        records = [NSMutableArray array];
-    }
-
     // 添加到开头
-    [records insertObject:record atIndex:0];
+    [self.records insertObject:record atIndex:0];
 
     // 只保留最近100条
-    if (records.count > 100) {
-        [records removeObjectsInRange:NSMakeRange(100, records.count - 100)];
+    if (self.records.count > kMaxStoredRecords) {
+        [self.records removeObjectsInRange:NSMakeRange(kMaxStoredRecords, self.records.count - kMaxStoredRecords)];
     }
+    self.recordsDirty = YES;
 
-    // 保存
-    [self saveReadingRecords:records];
-
-    // 更新已读书籍集合
+    // 更新已读书籍集合和章节计数
     [self addToReadBooks:bookUrl];
+    [self.store addDuration:0 words:0 chapters:1 atDate:record.readTime];
 }
 
 - (NSArray<ReadingRecord *> *)getRecentReadingRecords {
-    NSData *data = [[NSUserDefaults standardUserDefaults] objectForKey:@"ReadingRecords"];
-    if (!data) {
-        return @[];
+    // 只返回最近20条
+    if (self.records.count > kMaxRecentRecords) {
+        return [self.records subarrayWithRange:NSMakeRange(0, kMaxRecentRecords)];
     }
 
-    NSArray *records = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+    return [self.records copy];
+}
 
-    // 只返回最近20条
-    if (records.count > 20) {
-        return [records subarrayWithRange:NSMakeRange(0, 20)];
+- (void)loadRecords {
+    NSData *data = [[NSUserDefaults standardUserDefaults] objectForKey:kReadingRecordsKey];
+    NSArray *records = data ? [NSKeyedUnarchiver unarchiveObjectWithData:data] : nil;
+    self.records = [NSMutableArray arrayWithArray:records ?: @[]];
+
+    NSArray *readBooks = [[NSUserDefaults standardUserDefaults] arrayForKey:kReadBooksKey];
+    self.readBooks = [NSMutableSet setWithArray:readBooks ?: @[]];
+}
+
+- (void)persistRecordsIfNeeded {
+    if (!self.recordsDirty) {
+        return;
     }
+    self.recordsDirty = NO;
 
-    return records ?: @[];
+    // 不调用 synchronize，交给系统择机写入
+    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:self.records];
+    [[NSUserDefaults standardUserDefaults] setObject:data forKey:kReadingRecordsKey];
+    [[NSUserDefaults standardUserDefaults] setObject:[self.readBooks allObjects] forKey:kReadBooksKey];
 }
 
-- (void)saveReadingRecords:(NSArray<ReadingRecord *> *)records {
-    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:records];
-    [[NSUserDefaults standardUserDefaults] setObject:data forKey:@"ReadingRecords"];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+- (void)flushPendingStats {
+    [self persistRecordsIfNeeded];
+    [self.store flushAndWait];
 }
 
 #pragma mark - 阅读统计
 
 - (void)addToReadBooks:(NSString *)bookUrl {
-    NSMutableSet *readBooks = [NSMutableSet setWithArray:[[NSUserDefaults standardUserDefaults] arrayForKey:@"ReadBooks"] ?: @[]];
-    [readBooks addObject:bookUrl];
-    [[NSUserDefaults standardUserDefaults] setObject:[readBooks allObjects] forKey:@"ReadBooks"];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    if (bookUrl.length == 0 || [self.readBooks containsObject:bookUrl]) {
+        return;
+    }
+    [self.readBooks addObject:bookUrl];
+    self.recordsDirty = YES;
 }
 
 - (NSInteger)getReadBooksCount {
-    NSArray *readBooks = [[NSUserDefaults standardUserDefaults] arrayForKey:@"ReadBooks"];
-    return readBooks.count;
+    return self.readBooks.count;
 }
 
 - (NSInteger)getReadChaptersCount {
-    NSInteger count = [[NSUserDefaults standardUserDefaults] integerForKey:@"ReadChaptersCount"];
-    return count;
+    return self.store.totalChapters;
 }
 
 - (NSInteger)getTodayReadingWords {
-    NSString *dateKey = [self dateKeyFromDate:[NSDate date]];
-    NSString *key = [NSString stringWithFormat:@"ReadingWords_%@", dateKey];
-    return [[NSUserDefaults standardUserDefaults] integerForKey:key];
+    return [self.store wordsForDayOfDate:[NSDate date]];
 }
 
 - (void)addReadingWords:(NSInteger)words {
-    NSString *dateKey = [self dateKeyFromDate:[NSDate date]];
-    NSString *key = [NSString stringWithFormat:@"ReadingWords_%@", dateKey];
+    [self.store addDuration:0 words:words chapters:0 atDate:[NSDate date]];
 
-    NSInteger existingWords = [[NSUserDefaults standardUserDefaults] integerForKey:key];
-    [[NSUserDefaults standardUserDefaults] setInteger:existingWords + words forKey:key];
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    if (self.sessionStartTime && words > 0) {
+        self.sessionWords += words;
+        self.lastAddedWords = words;
+    }
+}
+
+- (double)currentReadingSpeed {
+    if (!self.sessionStartTime) {
+        return 0;
+    }
+
+    NSTimeInterval elapsed = [[NSDate date] timeIntervalSinceDate:self.sessionStartTime];
+    NSInteger finishedWords = self.sessionWords - self.lastAddedWords;
+    if (elapsed < 60 || finishedWords <= 0) {
+        return 0;
+    }
+    return finishedWords / elapsed;
 }
 
 #pragma mark - 数据清理
 
 - (void)cleanupOldRecords {
-    // 清理超过30天的阅读时长记录
+    // 超过30天的按天数据折叠进月归档，周/月/总计保持不变
+    NSDate *cutoff = [NSDate dateWithTimeIntervalSinceNow:-30 * 24 * 60 * 60];
+    [self.store pruneDaysBeforeDate:cutoff];
+}
+
+- (void)migrateLegacyDailyStats {
+    // 旧版本按天存储在 NSUserDefaults，首次启动新存储时一次性迁移
+    NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
+    NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+    formatter.dateFormat = @"yyyy-MM-dd";
     NSCalendar *calendar = [NSCalendar currentCalendar];
     NSDate *today = [NSDate date];
 
-    for (NSInteger i = 31; i < 60; i++) {  // 清理31-60天前的数据
+    for (NSInteger i = 0; i < 60; i++) {
         NSDate *date = [calendar dateByAddingUnit:NSCalendarUnitDay value:-i toDate:today options:0];
-        NSString *dateKey = [self dateKeyFromDate:date];
+        NSString *dateKey = [formatter stringFromDate:date];
         NSString *durationKey = [NSString stringWithFormat:@"ReadingDuration_%@", dateKey];
         NSString *wordsKey = [NSString stringWithFormat:@"ReadingWords_%@", dateKey];
 
-        [[NSUserDefaults standardUserDefaults] removeObjectForKey:durationKey];
-        [[NSUserDefaults standardUserDefaults] removeObjectForKey:wordsKey];
+        [self.store addDuration:[defaults integerForKey:durationKey]
+                          words:[defaults integerForKey:wordsKey]
+                       chapters:0
+                         atDate:date];
+        [defaults removeObjectForKey:durationKey];
+        [defaults removeObjectForKey:wordsKey];
     }
 
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    [defaults removeObjectForKey:@"ReadChaptersCount"];
+    [defaults removeObjectForKey:@"TotalReadingDuration"];
+    [self.store flush];
 }
 
 - (void)clearAllStats {
     // 清空所有统计数据
-    [[NSUserDefaults standardUserDefaults] removeObjectForKey:@"ReadingRecords"];
-    [[NSUserDefaults standardUserDefaults] removeObjectForKey:@"ReadBooks"];
-    [[NSUserDefaults standardUserDefaults] removeObjectForKey:@"ReadChaptersCount"];
-    [[NSUserDefaults standardUserDefaults] removeObjectForKey:@"TotalReadingDuration"];
+    [self.records removeAllObjects];
+    [self.readBooks removeAllObjects];
+    self.recordsDirty = NO;
+    [self.store removeAllStats];
 
-    // 清空近30天的数据
-    NSCalendar *calendar = [NSCalendar currentCalendar];
-    NSDate *today = [NSDate date];
-
-    for (NSInteger i = 0; i < 30; i++) {
-        NSDate *date = [calendar dateByAddingUnit:NSCalendarUnitDay value:-i toDate:today options:0];
-        NSString *dateKey = [self dateKeyFromDate:date];
-        NSString *durationKey = [NSString stringWithFormat:@"ReadingDuration_%@", dateKey];
-        NSString *wordsKey = [NSString stringWithFormat:@"ReadingWords_%@", dateKey];
-
-        [[NSUserDefaults standardUserDefaults] removeObjectForKey:durationKey];
-        [[NSUserDefaults standardUserDefaults] removeObjectForKey:wordsKey];
-    }
-
-    [[NSUserDefaults standardUserDefaults] synchronize];
+    [[NSUserDefaults standardUserDefaults] removeObjectForKey:kReadingRecordsKey];
+    [[NSUserDefaults standardUserDefaults] removeObjectForKey:kReadBooksKey];
 }
 
 @end
-
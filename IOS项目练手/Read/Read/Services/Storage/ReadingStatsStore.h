@@ -0,0 +1,103 @@
+//
+//  ReadingStatsStore.h
+//  Read
+//
+//  阅读统计存储 - 按天分桶的内存计数器 + 追加写二进制文件
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 阅读统计存储
+ *
+ * 职责：
+ *   1. 在内存中累计阅读时长/字数/章节数（写入不产生任何 I/O）
+ *   2. 按固定间隔把增量追加到紧凑的二进制文件（每条记录24字节）
+ *   3. 维护日/周/总计汇总，查询均为 O(1)
+ *   4. 过期日数据折叠进月归档，文件过大时自动压缩
+ *
+ * 文件格式：
+ *   文件头 8 字节（魔数 + 版本），之后是定长记录序列；
+ *   每条记录自带校验和，崩溃导致的半条记录在加载时被截断丢弃。
+ *
+ * 使用示例：
+ *   ReadingStatsStore *store = [[ReadingStatsStore alloc] initWithFilePath:path flushInterval:30];
+ *   [store addDuration:60 words:0 chapters:0 atDate:[NSDate date]];
+ *   NSInteger week = [store durationForWeekOfDate:[NSDate date]];
+ */
+@interface ReadingStatsStore : NSObject
+
+/**
+ * 初始化（同步加载已有文件）
+ * @param filePath 数据文件路径
+ * @param flushInterval 定时刷盘间隔（秒）
+ */
+- (instancetype)initWithFilePath:(NSString *)filePath flushInterval:(NSTimeInterval)flushInterval;
+
+// 数据文件路径
+@property (copy, nonatomic, readonly) NSString *filePath;
+
+#pragma mark - 写入
+
+/**
+ * 累加统计（仅修改内存，等待下次刷盘）
+ * @param duration 阅读时长（秒）
+ * @param words 阅读字数
+ * @param chapters 阅读章节数
+ * @param date 归属日期
+ */
+- (void)addDuration:(NSInteger)duration
+              words:(NSInteger)words
+           chapters:(NSInteger)chapters
+             atDate:(NSDate *)date;
+
+#pragma mark - 查询（O(1)）
+
+/**
+ * 指定日期当天的阅读时长（秒）
+ */
+- (NSInteger)durationForDayOfDate:(NSDate *)date;
+
+/**
+ * 指定日期当天的阅读字数
+ */
+- (NSInteger)wordsForDayOfDate:(NSDate *)date;
+
+/**
+ * 指定日期所在自然周（周一开始）的阅读时长（秒）
+ */
+- (NSInteger)durationForWeekOfDate:(NSDate *)date;
+
+// 总阅读时长（秒）
+@property (assign, nonatomic, readonly) NSInteger totalDuration;
+
+// 总阅读章节数
+@property (assign, nonatomic, readonly) NSInteger totalChapters;
+
+#pragma mark - 维护
+
+/**
+ * 把指定日期之前的按天数据折叠进月归档（周/总计不受影响）
+ */
+- (void)pruneDaysBeforeDate:(NSDate *)date;
+
+/**
+ * 清空所有统计
+ */
+- (void)removeAllStats;
+
+/**
+ * 异步刷盘
+ */
+- (void)flush;
+
+/**
+ * 同步刷盘（进入后台时调用）
+ */
+- (void)flushAndWait;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,415 @@
+//
+//  ReadingStatsStore.m
+//  Read
+//
+//  阅读统计存储实现
+//
+
+#import "ReadingStatsStore.h"
+
+#pragma mark - 文件格式
+
+static const uint32_t kStatsFileMagic = 0x53545352;    // "RSTS"
+static const uint32_t kStatsFileVersion = 1;
+static const NSUInteger kStatsHeaderSize = 8;
+static const NSUInteger kStatsCompactThreshold = 2048; // 记录数超过此值时压缩文件
+
+typedef NS_ENUM(uint32_t, ReadingStatsRecordType) {
+    ReadingStatsRecordTypeDay = 1,      // 日增量，key 为日序号
+    ReadingStatsRecordTypeArchive = 2   // 月归档，key 为月序号
+};
+
+typedef struct {
+    uint32_t type;
+    int32_t key;
+    int32_t duration;
+    int32_t words;
+    int32_t chapters;
+    uint32_t checksum;
+} ReadingStatsRecord;
+
+static uint32_t ReadingStatsChecksum(const ReadingStatsRecord *record) {
+    // FNV-1a，覆盖除校验和以外的 20 字节
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(ReadingStatsRecord, checksum); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+#pragma mark - 日期换算（纯整数运算，不创建 NSDateFormatter / NSCalendar）
+
+static int32_t ReadingStatsDayNumber(NSDate *date) {
+    NSTimeInterval local = date.timeIntervalSince1970 + [[NSTimeZone localTimeZone] secondsFromGMTForDate:date];
+    return (int32_t)floor(local / 86400.0);
+}
+
+static int32_t ReadingStatsWeekKey(int32_t day) {
+    // 1970-01-01 是周四，+3 使每周从周一开始
+    int32_t shifted = day + 3;
+    return shifted >= 0 ? shifted / 7 : (shifted - 6) / 7;
+}
+
+static int32_t ReadingStatsMonthKey(int32_t day) {
+    // 日序号 -> 公历年月（civil_from_days 算法）
+    int32_t z = day + 719468;
+    int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    uint32_t doe = (uint32_t)(z - era * 146097);
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int32_t year = (int32_t)yoe + era * 400;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t month = mp < 10 ? mp + 3 : mp - 9;
+    if (month <= 2) {
+        year += 1;
+    }
+    return year * 12 + (int32_t)(month - 1);
+}
+
+#pragma mark - 汇总桶
+
+@interface ReadingStatsBucket : NSObject
+@property (assign, nonatomic) NSInteger duration;
+@property (assign, nonatomic) NSInteger words;
+@property (assign, nonatomic) NSInteger chapters;
+@end
+
+@implementation ReadingStatsBucket
+@end
+
+#pragma mark - ReadingStatsStore
+
+@interface ReadingStatsStore ()
+@property (copy, nonatomic, readwrite) NSString *filePath;
+@property (strong, nonatomic) NSMutableDictionary<NSNumber *, ReadingStatsBucket *> *dayBuckets;
+@property (strong, nonatomic) NSMutableDictionary<NSNumber *, ReadingStatsBucket *> *weekBuckets;
+@property (strong, nonatomic) NSMutableDictionary<NSNumber *, ReadingStatsBucket *> *monthArchives;  // 已折叠的日数据
+@property (strong, nonatomic) ReadingStatsBucket *totalBucket;
+@property (strong, nonatomic) NSMutableData *pendingRecords;   // 待刷盘的增量记录
+@property (assign, nonatomic) NSUInteger fileRecordCount;      // 文件中的记录数（仅在 ioQueue 访问）
+@property (strong, nonatomic) dispatch_queue_t ioQueue;
+@property (strong, nonatomic) dispatch_source_t flushTimer;
+@end
+
+@implementation ReadingStatsStore
+
+- (instancetype)initWithFilePath:(NSString *)filePath flushInterval:(NSTimeInterval)flushInterval {
+    self = [super init];
+    if (self) {
+        _filePath = [filePath copy];
+        _dayBuckets = [NSMutableDictionary dictionary];
+        _weekBuckets = [NSMutableDictionary dictionary];
+        _monthArchives = [NSMutableDictionary dictionary];
+        _totalBucket = [[ReadingStatsBucket alloc] init];
+        _pendingRecords = [NSMutableData data];
+        _ioQueue = dispatch_queue_create("com.read.stats.io", DISPATCH_QUEUE_SERIAL);
+
+        [self loadFromFile];
+        [self startFlushTimerWithInterval:flushInterval];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_flushTimer) {
+        dispatch_source_cancel(_flushTimer);
+    }
+}
+
+#pragma mark - 写入
+
+- (void)addDuration:(NSInteger)duration
+              words:(NSInteger)words
+           chapters:(NSInteger)chapters
+             atDate:(NSDate *)date {
+    if (duration == 0 && words == 0 && chapters == 0) {
+        return;
+    }
+
+    ReadingStatsRecord record = {0};
+    record.type = ReadingStatsRecordTypeDay;
+    record.key = ReadingStatsDayNumber(date);
+    record.duration = (int32_t)duration;
+    record.words = (int32_t)words;
+    record.chapters = (int32_t)chapters;
+
+    @synchronized (self) {
+        [self applyRecord:&record];
+
+        // ⭐ 同一天的连续增量合并为一条，刷盘时文件只增长一条记录
+        NSUInteger length = self.pendingRecords.length;
+        if (length >= sizeof(ReadingStatsRecord)) {
+            ReadingStatsRecord *last = (ReadingStatsRecord *)((uint8_t *)self.pendingRecords.mutableBytes + length - sizeof(ReadingStatsRecord));
+            if (last->type == record.type && last->key == record.key) {
+                last->duration += record.duration;
+                last->words += record.words;
+                last->chapters += record.chapters;
+                return;
+            }
+        }
+        [self.pendingRecords appendBytes:&record length:sizeof(record)];
+    }
+}
+
+- (void)applyRecord:(const ReadingStatsRecord *)record {
+    if (record->type == ReadingStatsRecordTypeDay) {
+        int32_t day = record->key;
+        [self addRecord:record toBucket:[self bucketForKey:@(day) in:self.dayBuckets]];
+        [self addRecord:record toBucket:[self bucketForKey:@(ReadingStatsWeekKey(day)) in:self.weekBuckets]];
+    } else if (record->type == ReadingStatsRecordTypeArchive) {
+        [self addRecord:record toBucket:[self bucketForKey:@(record->key) in:self.monthArchives]];
+    } else {
+        return;
+    }
+    [self addRecord:record toBucket:self.totalBucket];
+}
+
+- (ReadingStatsBucket *)bucketForKey:(NSNumber *)key in:(NSMutableDictionary<NSNumber *, ReadingStatsBucket *> *)buckets {
+    ReadingStatsBucket *bucket = buckets[key];
+    if (!bucket) {
+        bucket = [[ReadingStatsBucket alloc] init];
+        buckets[key] = bucket;
+    }
+    return bucket;
+}
+
+- (void)addRecord:(const ReadingStatsRecord *)record toBucket:(ReadingStatsBucket *)bucket {
+    bucket.duration += record->duration;
+    bucket.words += record->words;
+    bucket.chapters += record->chapters;
+}
+
+#pragma mark - 查询
+
+- (NSInteger)durationForDayOfDate:(NSDate *)date {
+    @synchronized (self) {
+        return self.dayBuckets[@(ReadingStatsDayNumber(date))].duration;
+    }
+}
+
+- (NSInteger)wordsForDayOfDate:(NSDate *)date {
+    @synchronized (self) {
+        return self.dayBuckets[@(ReadingStatsDayNumber(date))].words;
+    }
+}
+
+- (NSInteger)durationForWeekOfDate:(NSDate *)date {
+    @synchronized (self) {
+        return self.weekBuckets[@(ReadingStatsWeekKey(ReadingStatsDayNumber(date)))].duration;
+    }
+}
+
+- (NSInteger)totalDuration {
+    @synchronized (self) {
+        return self.totalBucket.duration;
+    }
+}
+
+- (NSInteger)totalChapters {
+    @synchronized (self) {
+        return self.totalBucket.chapters;
+    }
+}
+
+#pragma mark - 维护
+
+- (void)pruneDaysBeforeDate:(NSDate *)date {
+    int32_t cutoffDay = ReadingStatsDayNumber(date);
+    int32_t cutoffWeek = ReadingStatsWeekKey(cutoffDay);
+    BOOL pruned = NO;
+
+    @synchronized (self) {
+        for (NSNumber *dayKey in [self.dayBuckets allKeys]) {
+            int32_t day = dayKey.intValue;
+            if (day >= cutoffDay) {
+                continue;
+            }
+            ReadingStatsBucket *bucket = self.dayBuckets[dayKey];
+            ReadingStatsBucket *archive = [self bucketForKey:@(ReadingStatsMonthKey(day)) in:self.monthArchives];
+            archive.duration += bucket.duration;
+            archive.words += bucket.words;
+            archive.chapters += bucket.chapters;
+            [self.dayBuckets removeObjectForKey:dayKey];
+            pruned = YES;
+        }
+
+        for (NSNumber *weekKey in [self.weekBuckets allKeys]) {
+            if (weekKey.intValue < cutoffWeek) {
+                [self.weekBuckets removeObjectForKey:weekKey];
+            }
+        }
+    }
+
+    if (pruned) {
+        dispatch_async(self.ioQueue, ^{
+            [self compactFile];
+        });
+    }
+}
+
+- (void)removeAllStats {
+    @synchronized (self) {
+        [self.dayBuckets removeAllObjects];
+        [self.weekBuckets removeAllObjects];
+        [self.monthArchives removeAllObjects];
+        self.totalBucket = [[ReadingStatsBucket alloc] init];
+        self.pendingRecords.length = 0;
+    }
+
+    dispatch_async(self.ioQueue, ^{
+        [self writeFileWithRecords:[NSData data]];
+    });
+}
+
+#pragma mark - 刷盘
+
+- (void)startFlushTimerWithInterval:(NSTimeInterval)interval {
+    if (interval <= 0) {
+        return;
+    }
+
+    self.flushTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.ioQueue);
+    uint64_t intervalNs = (uint64_t)(interval * NSEC_PER_SEC);
+    // 允许较大的误差，让系统合并唤醒
+    dispatch_source_set_timer(self.flushTimer, dispatch_time(DISPATCH_TIME_NOW, intervalNs), intervalNs, intervalNs / 4);
+
+    __weak typeof(self) weakSelf = self;
+    dispatch_source_set_event_handler(self.flushTimer, ^{
+        [weakSelf flushOnIOQueue];
+    });
+    dispatch_resume(self.flushTimer);
+}
+
+- (void)flush {
+    dispatch_async(self.ioQueue, ^{
+        [self flushOnIOQueue];
+    });
+}
+
+- (void)flushAndWait {
+    dispatch_sync(self.ioQueue, ^{
+        [self flushOnIOQueue];
+    });
+}
+
+- (void)flushOnIOQueue {
+    NSData *records;
+    @synchronized (self) {
+        if (self.pendingRecords.length == 0) {
+            return;
+        }
+        records = [self.pendingRecords copy];
+        self.pendingRecords.length = 0;
+    }
+
+    NSMutableData *sealed = [records mutableCopy];
+    NSUInteger count = sealed.length / sizeof(ReadingStatsRecord);
+    ReadingStatsRecord *items = (ReadingStatsRecord *)sealed.mutableBytes;
+    for (NSUInteger i = 0; i < count; i++) {
+        items[i].checksum = ReadingStatsChecksum(&items[i]);
+    }
+
+    if (![[NSFileManager defaultManager] fileExistsAtPath:self.filePath]) {
+        [self writeFileWithRecords:sealed];
+        return;
+    }
+
+    NSFileHandle *handle = [NSFileHandle fileHandleForWritingAtPath:self.filePath];
+    if (!handle) {
+        NSLog(@"❌ 阅读统计写入失败: %@", self.filePath);
+        return;
+    }
+    [handle seekToEndOfFile];
+    [handle writeData:sealed];
+    [handle closeFile];
+    self.fileRecordCount += count;
+
+    if (self.fileRecordCount > kStatsCompactThreshold) {
+        [self compactFile];
+    }
+}
+
+- (void)compactFile {
+    // ⭐ 快照与清空待写增量必须在同一把锁内完成，否则增量会被重复计入
+    NSMutableData *records = [NSMutableData data];
+    @synchronized (self) {
+        [self.monthArchives enumerateKeysAndObjectsUsingBlock:^(NSNumber *key, ReadingStatsBucket *bucket, BOOL *stop) {
+            [self appendRecordOfType:ReadingStatsRecordTypeArchive key:key.intValue bucket:bucket to:records];
+        }];
+        [self.dayBuckets enumerateKeysAndObjectsUsingBlock:^(NSNumber *key, ReadingStatsBucket *bucket, BOOL *stop) {
+            [self appendRecordOfType:ReadingStatsRecordTypeDay key:key.intValue bucket:bucket to:records];
+        }];
+        self.pendingRecords.length = 0;
+    }
+
+    [self writeFileWithRecords:records];
+}
+
+- (void)appendRecordOfType:(ReadingStatsRecordType)type
+                       key:(int32_t)key
+                    bucket:(ReadingStatsBucket *)bucket
+                        to:(NSMutableData *)data {
+    ReadingStatsRecord record = {0};
+    record.type = type;
+    record.key = key;
+    record.duration = (int32_t)bucket.duration;
+    record.words = (int32_t)bucket.words;
+    record.chapters = (int32_t)bucket.chapters;
+    record.checksum = ReadingStatsChecksum(&record);
+    [data appendBytes:&record length:sizeof(record)];
+}
+
+- (void)writeFileWithRecords:(NSData *)records {
+    NSMutableData *data = [NSMutableData dataWithCapacity:kStatsHeaderSize + records.length];
+    uint32_t header[2] = {kStatsFileMagic, kStatsFileVersion};
+    [data appendBytes:header length:sizeof(header)];
+    [data appendData:records];
+
+    NSError *error = nil;
+    if (![data writeToFile:self.filePath options:NSDataWritingAtomic error:&error]) {
+        NSLog(@"❌ 阅读统计写入失败: %@", error.localizedDescription);
+        return;
+    }
+    self.fileRecordCount = records.length / sizeof(ReadingStatsRecord);
+}
+
+#pragma mark - 加载
+
+- (void)loadFromFile {
+    NSData *data = [NSData dataWithContentsOfFile:self.filePath options:NSDataReadingMappedIfSafe error:nil];
+    if (data.length < kStatsHeaderSize) {
+        return;
+    }
+
+    const uint32_t *header = (const uint32_t *)data.bytes;
+    if (header[0] != kStatsFileMagic || header[1] != kStatsFileVersion) {
+        NSLog(@"⚠️ 阅读统计文件格式不匹配，已忽略");
+        return;
+    }
+
+    NSUInteger offset = kStatsHeaderSize;
+    NSUInteger count = 0;
+    while (offset + sizeof(ReadingStatsRecord) <= data.length) {
+        ReadingStatsRecord record;
+        memcpy(&record, (const uint8_t *)data.bytes + offset, sizeof(record));
+        if (record.checksum != ReadingStatsChecksum(&record)) {
+            break;
+        }
+        [self applyRecord:&record];
+        offset += sizeof(record);
+        count++;
+    }
+    self.fileRecordCount = count;
+
+    // 崩溃留下的半条/损坏记录：截断到最后一条有效记录
+    if (offset < data.length) {
+        NSLog(@"⚠️ 阅读统计文件尾部损坏，截断 %lu 字节", (unsigned long)(data.length - offset));
+        NSFileHandle *handle = [NSFileHandle fileHandleForWritingAtPath:self.filePath];
+        [handle truncateFileAtOffset:offset];
+        [handle closeFile];
+    }
+}
+
+@end
@@ -159,6 +159,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (class, nonatomic, readonly) NSTimeInterval preloadDelay;
 
+/**
+ * 阅读统计刷盘间隔（默认30秒）
+ */
+@property (class, nonatomic, readonly) NSTimeInterval statsFlushInterval;
+
 #pragma mark - 动画配置
 
 /**
@@ -119,6 +119,10 @@
     return 2.0;
 }
 
++ (NSTimeInterval)statsFlushInterval {
+    return 30.0;
+}
+
 #pragma mark - 动画配置
 
 + (NSTimeInterval)toolbarAnimationDuration {
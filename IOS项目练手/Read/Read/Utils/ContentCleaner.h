@@ -0,0 +1,55 @@
+//
+//  ContentCleaner.h
+//  Read
+//
+//  正文清洗器 - 把书源的正文规则编译为一遍扫描完成的清洗流程
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 正文清洗器
+ *
+ * 职责：
+ *   1. 编译正文规则：末尾的 @text / @textNodes 改为 @html（标签由清洗器去除）；
+ *      规则##正则##替换内容 中的正则：纯文本且只删除的编入扫描，其余预先编译
+ *   2. 一遍扫描 UTF-16 缓冲区，写入同一个输出缓冲区，同时完成：
+ *      去标签（跳过 script / style / 注释）、解码 HTML 实体、去除广告文字和零宽水印字符、
+ *      合并空白、段首缩进和分段
+ *   3. 按规则缓存编译结果，同一书源的每一章直接复用
+ *
+ * 说明：
+ *   段落之间只保留一个换行，段间距由排版的段落样式提供。
+ *   含正则元字符或有替换内容的规则无法并入扫描：保留原来的文本提取，
+ *   先在提取出的文本上替换，再整理，结果与逐步执行规则相同。
+ *
+ * 使用示例：
+ *   ContentCleaner *cleaner = [ContentCleaner cleanerForContentRule:bookSource.ruleContent.content];
+ *   id result = [RuleParser extractFromContent:html withRule:cleaner.extractionRule];
+ *   NSString *text = [cleaner cleanContent:result];
+ */
+@interface ContentCleaner : NSObject
+
+/**
+ * 获取规则对应的清洗器（线程安全，编译结果按规则缓存）
+ * @param rule 书源的正文规则（可以为空，此时只做通用清洗）
+ */
++ (instancetype)cleanerForContentRule:(nullable NSString *)rule;
+
+/**
+ * 用于提取正文的规则（去掉 ## 过滤部分，文本提取改为保留 HTML）
+ */
+@property (copy, nonatomic, readonly) NSString *extractionRule;
+
+/**
+ * 清洗正文（线程安全）
+ * @param content 提取到的正文（HTML 片段或纯文本）
+ * @return 清洗后的文本，段落之间以 \n 分隔
+ */
+- (NSString *)cleanContent:(NSString *)content;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,507 @@
+//
+//  ContentCleaner.m
+//  Read
+//
+//  正文清洗器实现
+//
+
+#import "ContentCleaner.h"
+
+#pragma mark - 扫描程序
+
+typedef struct {
+    unichar *characters;
+    NSUInteger length;
+} ContentCleanerLiteral;
+
+typedef struct {
+    ContentCleanerLiteral *literals;    // 纯文本的广告规则
+    NSUInteger literalCount;
+    uint64_t lastCharacterBits[1024];   // 广告文字末字符位图（65536 位），绝大多数字符一次查表即可排除
+} ContentCleanerProgram;
+
+typedef struct {
+    unichar *buffer;
+    NSUInteger length;
+    NSUInteger paragraphBegin;          // 当前段落（含分隔符和缩进）的开始位置
+    NSUInteger contentBegin;            // 当前段落正文的开始位置
+    BOOL atParagraphStart;              // 下一个字符开始新段落
+    BOOL pendingSpace;                  // 已合并的空白，遇到下一个字符时按需输出一个空格
+} ContentCleanerOutput;
+
+static const unichar kContentCleanerIndent = 0x3000;   // 段首缩进：两个全角空格
+
+static inline BOOL ContentCleanerIsWide(unichar c) {
+    // 中日韩文字和全角标点之间的空白直接去掉
+    return c >= 0x2E80;
+}
+
+static inline BOOL ContentCleanerHasLastCharacter(const ContentCleanerProgram *program, unichar c) {
+    return (program->lastCharacterBits[c >> 6] >> (c & 63)) & 1;
+}
+
+// 输出末尾恰好是一条广告文字时删除（只在当前段落内匹配，删空的段落连同分隔符一起撤销）
+static void ContentCleanerRemoveLiteral(ContentCleanerOutput *output, const ContentCleanerProgram *program) {
+    NSUInteger available = output->length - output->contentBegin;
+    for (NSUInteger i = 0; i < program->literalCount; i++) {
+        const ContentCleanerLiteral *literal = &program->literals[i];
+        if (literal->length > available ||
+            memcmp(output->buffer + output->length - literal->length, literal->characters, literal->length * sizeof(unichar)) != 0) {
+            continue;
+        }
+
+        output->length -= literal->length;
+        if (output->length == output->contentBegin) {
+            output->length = output->paragraphBegin;
+            output->atParagraphStart = YES;
+            output->pendingSpace = NO;
+        } else if (output->buffer[output->length - 1] == ' ') {
+            output->length--;
+            output->pendingSpace = YES;
+        }
+        return;
+    }
+}
+
+static inline void ContentCleanerEmit(ContentCleanerOutput *output, const ContentCleanerProgram *program, unichar c) {
+    if (output->atParagraphStart) {
+        output->paragraphBegin = output->length;
+        if (output->length > 0) {
+            output->buffer[output->length++] = '\n';
+        }
+        output->buffer[output->length++] = kContentCleanerIndent;
+        output->buffer[output->length++] = kContentCleanerIndent;
+        output->contentBegin = output->length;
+        output->atParagraphStart = NO;
+        output->pendingSpace = NO;
+    } else if (output->pendingSpace) {
+        if (!(ContentCleanerIsWide(output->buffer[output->length - 1]) && ContentCleanerIsWide(c))) {
+            output->buffer[output->length++] = ' ';
+        }
+        output->pendingSpace = NO;
+    }
+
+    output->buffer[output->length++] = c;
+
+    if (program->literalCount > 0 && ContentCleanerHasLastCharacter(program, c)) {
+        ContentCleanerRemoveLiteral(output, program);
+    }
+}
+
+// 按字符类别处理：换行分段、空白合并、零宽水印和控制字符丢弃，其余输出
+static inline void ContentCleanerAccept(ContentCleanerOutput *output, const ContentCleanerProgram *program, unichar c) {
+    switch (c) {
+        case '\n':
+            output->atParagraphStart = YES;
+            return;
+        case ' ': case '\t': case '\r': case '\f': case 0x00A0: case 0x3000:
+            if (!output->atParagraphStart) {
+                output->pendingSpace = YES;
+            }
+            return;
+        case 0x200B: case 0x200C: case 0x200D: case 0x2060: case 0xFEFF:
+            return;
+        default:
+            break;
+    }
+    if (c < 0x20 || (c >= 0x2002 && c <= 0x200A)) {
+        if (c >= 0x2002 && !output->atParagraphStart) {
+            output->pendingSpace = YES;
+        }
+        return;
+    }
+    ContentCleanerEmit(output, program, c);
+}
+
+#pragma mark - 标签与实体
+
+static inline unichar ContentCleanerLower(unichar c) {
+    return (c >= 'A' && c <= 'Z') ? (unichar)(c + 32) : c;
+}
+
+static BOOL ContentCleanerNameEquals(const char *name, NSUInteger nameLength, const char *expected) {
+    return strlen(expected) == nameLength && strncmp(name, expected, nameLength) == 0;
+}
+
+static BOOL ContentCleanerIsBlockTag(const char *name, NSUInteger length) {
+    static const char *const kBlockTags[] = {
+        "br", "p", "div", "li", "tr", "dd", "dt", "hr", "ul", "ol", "pre", "table",
+        "section", "article", "blockquote", "h1", "h2", "h3", "h4", "h5", "h6"
+    };
+    for (NSUInteger i = 0; i < sizeof(kBlockTags) / sizeof(kBlockTags[0]); i++) {
+        if (ContentCleanerNameEquals(name, length, kBlockTags[i])) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+// 从 start 开始查找不区分大小写的 ASCII 串，返回其位置
+static NSUInteger ContentCleanerFind(const unichar *input, NSUInteger length, NSUInteger start, const char *needle) {
+    NSUInteger needleLength = strlen(needle);
+    for (NSUInteger i = start; i + needleLength <= length; i++) {
+        NSUInteger j = 0;
+        while (j < needleLength && ContentCleanerLower(input[i + j]) == (unichar)needle[j]) {
+            j++;
+        }
+        if (j == needleLength) {
+            return i;
+        }
+    }
+    return NSNotFound;
+}
+
+// input[start] 为 '<'，识别为标签时返回标签之后的位置，否则返回 NSNotFound（按普通字符处理）
+static NSUInteger ContentCleanerSkipTag(const unichar *input, NSUInteger length, NSUInteger start, BOOL *isBlock) {
+    *isBlock = NO;
+    NSUInteger i = start + 1;
+    if (i >= length) {
+        return NSNotFound;
+    }
+
+    // 注释
+    if (input[i] == '!') {
+        if (i + 2 < length && input[i + 1] == '-' && input[i + 2] == '-') {
+            NSUInteger end = ContentCleanerFind(input, length, i + 3, "-->");
+            return end == NSNotFound ? length : end + 3;
+        }
+        NSUInteger end = ContentCleanerFind(input, length, i, ">");
+        return end == NSNotFound ? NSNotFound : end + 1;
+    }
+
+    BOOL closing = input[i] == '/';
+    if (closing) {
+        i++;
+    }
+
+    char name[12];
+    NSUInteger nameLength = 0;
+    while (i < length && nameLength < sizeof(name)) {
+        unichar c = ContentCleanerLower(input[i]);
+        if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'))) {
+            break;
+        }
+        name[nameLength++] = (char)c;
+        i++;
+    }
+    if (nameLength == 0) {
+        return NSNotFound;   // "a < b" 之类的普通文字
+    }
+
+    NSUInteger end = ContentCleanerFind(input, length, i, ">");
+    if (end == NSNotFound) {
+        return NSNotFound;
+    }
+
+    // 脚本和样式的内容整段跳过
+    if (!closing && (ContentCleanerNameEquals(name, nameLength, "script") || ContentCleanerNameEquals(name, nameLength, "style"))) {
+        const char *terminator = name[1] == 'c' ? "</script" : "</style";
+        NSUInteger close = ContentCleanerFind(input, length, end + 1, terminator);
+        if (close == NSNotFound) {
+            return length;
+        }
+        NSUInteger closeEnd = ContentCleanerFind(input, length, close, ">");
+        return closeEnd == NSNotFound ? length : closeEnd + 1;
+    }
+
+    *isBlock = ContentCleanerIsBlockTag(name, nameLength);
+    return end + 1;
+}
+
+typedef struct {
+    const char *name;
+    unichar value;
+} ContentCleanerEntity;
+
+static const ContentCleanerEntity kContentCleanerEntities[] = {
+    {"nbsp", 0x00A0}, {"amp", '&'}, {"lt", '<'}, {"gt", '>'}, {"quot", '"'}, {"apos", '\''},
+    {"ldquo", 0x201C}, {"rdquo", 0x201D}, {"lsquo", 0x2018}, {"rsquo", 0x2019},
+    {"hellip", 0x2026}, {"mdash", 0x2014}, {"ndash", 0x2013}, {"middot", 0x00B7},
+    {"emsp", 0x3000}, {"ensp", ' '}, {"thinsp", ' '}, {"copy", 0x00A9}, {"times", 0x00D7}
+};
+
+// input[start] 为 '&'，解码成功时返回实体之后的位置，否则返回 NSNotFound
+static NSUInteger ContentCleanerDecodeEntity(const unichar *input, NSUInteger length, NSUInteger start, uint32_t *codepoint) {
+    NSUInteger limit = MIN(length, start + 12);
+    NSUInteger semicolon = start + 1;
+    while (semicolon < limit && input[semicolon] != ';') {
+        semicolon++;
+    }
+    if (semicolon >= limit || semicolon == start + 1) {
+        return NSNotFound;
+    }
+
+    NSUInteger i = start + 1;
+    if (input[i] == '#') {
+        i++;
+        BOOL hex = i < semicolon && (input[i] == 'x' || input[i] == 'X');
+        if (hex) {
+            i++;
+        }
+        if (i == semicolon) {
+            return NSNotFound;
+        }
+        uint32_t value = 0;
+        for (; i < semicolon; i++) {
+            unichar c = ContentCleanerLower(input[i]);
+            uint32_t digit;
+            if (c >= '0' && c <= '9') {
+                digit = c - '0';
+            } else if (hex && c >= 'a' && c <= 'f') {
+                digit = c - 'a' + 10;
+            } else {
+                return NSNotFound;
+            }
+            value = value * (hex ? 16 : 10) + digit;
+            if (value > 0x10FFFF) {
+                return NSNotFound;
+            }
+        }
+        *codepoint = value;
+        return semicolon + 1;
+    }
+
+    char name[10];
+    NSUInteger nameLength = semicolon - i;
+    if (nameLength >= sizeof(name)) {
+        return NSNotFound;
+    }
+    for (NSUInteger j = 0; j < nameLength; j++) {
+        name[j] = (char)ContentCleanerLower(input[i + j]);
+    }
+    for (NSUInteger j = 0; j < sizeof(kContentCleanerEntities) / sizeof(kContentCleanerEntities[0]); j++) {
+        if (ContentCleanerNameEquals(name, nameLength, kContentCleanerEntities[j].name)) {
+            *codepoint = kContentCleanerEntities[j].value;
+            return semicolon + 1;
+        }
+    }
+    return NSNotFound;
+}
+
+#pragma mark - 融合扫描
+
+// 输出缓冲区需要的容量：每个段落最多多出换行和两个缩进，段落数不超过输入长度的一半
+static inline NSUInteger ContentCleanerOutputCapacity(NSUInteger length) {
+    return length + 3 * ((length + 1) / 2) + 4;
+}
+
+static NSUInteger ContentCleanerRun(const unichar *input, NSUInteger length, unichar *buffer, const ContentCleanerProgram *program) {
+    ContentCleanerOutput output = {buffer, 0, 0, 0, YES, NO};
+
+    NSUInteger i = 0;
+    while (i < length) {
+        unichar c = input[i];
+
+        if (c == '<') {
+            BOOL isBlock;
+            NSUInteger next = ContentCleanerSkipTag(input, length, i, &isBlock);
+            if (next != NSNotFound) {
+                if (isBlock) {
+                    output.atParagraphStart = YES;
+                }
+                i = next;
+                continue;
+            }
+        } else if (c == '&') {
+            uint32_t codepoint;
+            NSUInteger next = ContentCleanerDecodeEntity(input, length, i, &codepoint);
+            if (next != NSNotFound) {
+                if (codepoint > 0xFFFF) {
+                    codepoint -= 0x10000;
+                    ContentCleanerEmit(&output, program, (unichar)(0xD800 + (codepoint >> 10)));
+                    ContentCleanerEmit(&output, program, (unichar)(0xDC00 + (codepoint & 0x3FF)));
+                } else if (codepoint > 0) {
+                    ContentCleanerAccept(&output, program, (unichar)codepoint);
+                }
+                i = next;
+                continue;
+            }
+        }
+
+        ContentCleanerAccept(&output, program, c);
+        i++;
+    }
+
+    return output.length;
+}
+
+#pragma mark - ContentCleaner
+
+@interface ContentCleaner ()
+@property (copy, nonatomic, readwrite) NSString *extractionRule;
+@property (copy, nonatomic) NSArray<NSString *> *literalPatterns;             // 编入扫描的纯文本规则（只删除）
+@property (strong, nonatomic, nullable) NSRegularExpression *regexPattern;    // 预编译的正则规则
+@property (copy, nonatomic) NSString *replacementTemplate;                    // ##pattern##replacement 的替换内容（默认删除）
+@end
+
+@implementation ContentCleaner {
+    ContentCleanerProgram _program;
+}
+
++ (instancetype)cleanerForContentRule:(nullable NSString *)rule {
+    static NSCache<NSString *, ContentCleaner *> *cache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [[NSCache alloc] init];
+        cache.countLimit = 32;
+    });
+
+    NSString *key = rule ?: @"";
+    ContentCleaner *cleaner = [cache objectForKey:key];
+    if (!cleaner) {
+        cleaner = [[ContentCleaner alloc] initWithRule:key];
+        [cache setObject:cleaner forKey:key];
+    }
+    return cleaner;
+}
+
+- (instancetype)initWithRule:(NSString *)rule {
+    self = [super init];
+    if (self) {
+        // 规则##正则##替换内容：只有第一个 ## 之后是正则，第二个 ## 之后是替换内容（没有时删除匹配）
+        NSArray<NSString *> *parts = [rule componentsSeparatedByString:@"##"];
+        NSString *pattern = parts.count > 1 ? parts[1] : nil;
+        NSString *replacement = parts.count > 2 ? parts[2] : @"";
+
+        NSMutableArray<NSString *> *literals = [NSMutableArray array];
+        NSString *literal = (pattern.length > 0 && replacement.length == 0) ? [self literalFromPattern:pattern] : nil;
+        if (literal.length > 0) {
+            [literals addObject:literal];
+        } else if (pattern.length > 0) {
+            NSError *error = nil;
+            _regexPattern = [NSRegularExpression regularExpressionWithPattern:pattern options:0 error:&error];
+            if (!_regexPattern) {
+                NSLog(@"⚠️ 正文过滤规则无效: %@ (%@)", pattern, error.localizedDescription);
+            }
+        }
+        _literalPatterns = literals;
+        _replacementTemplate = [replacement copy];
+
+        // 有正则时保留原来的文本提取，正则作用在提取出的文本上（整理之前），与书源作者调试时看到的一致
+        NSString *extraction = parts.firstObject ?: @"";
+        _extractionRule = _regexPattern ? extraction : [self htmlExtractionRuleFromRule:extraction];
+        [self compileLiterals];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    for (NSUInteger i = 0; i < _program.literalCount; i++) {
+        free(_program.literals[i].characters);
+    }
+    free(_program.literals);
+}
+
+#pragma mark - 清洗
+
+- (NSString *)cleanContent:(NSString *)content {
+    if (content.length == 0) {
+        return @"";
+    }
+
+    // ⭐ 正则无法并入扫描：先在提取出的文本上替换，再整理（缩进、分段、合并空白）
+    if (self.regexPattern) {
+        content = [self.regexPattern stringByReplacingMatchesInString:content
+                                                              options:0
+                                                                range:NSMakeRange(0, content.length)
+                                                         withTemplate:self.replacementTemplate];
+    }
+
+    return [self runProgram:&_program onString:content];
+}
+
+- (NSString *)runProgram:(const ContentCleanerProgram *)program onString:(NSString *)string {
+    NSUInteger length = string.length;
+
+    // 输入：能直接拿到内部 UTF-16 缓冲区时不复制
+    const unichar *input = CFStringGetCharactersPtr((__bridge CFStringRef)string);
+    unichar *inputCopy = NULL;
+    if (!input) {
+        inputCopy = malloc(length * sizeof(unichar));
+        [string getCharacters:inputCopy range:NSMakeRange(0, length)];
+        input = inputCopy;
+    }
+
+    unichar *buffer = malloc(ContentCleanerOutputCapacity(length) * sizeof(unichar));
+    NSUInteger outputLength = ContentCleanerRun(input, length, buffer, program);
+    free(inputCopy);
+
+    if (outputLength == 0) {
+        free(buffer);
+        return @"";
+    }
+
+    // 输出缓冲区直接交给字符串，不再复制
+    buffer = realloc(buffer, outputLength * sizeof(unichar));
+    return [[NSString alloc] initWithCharactersNoCopy:buffer length:outputLength freeWhenDone:YES];
+}
+
+#pragma mark - 规则编译
+
+// 文本提取交给清洗器：末尾的 @text / @textNodes 改为 @html（|| 的每个分支分别处理）
+- (NSString *)htmlExtractionRuleFromRule:(NSString *)rule {
+    NSArray<NSString *> *alternatives = [rule componentsSeparatedByString:@"||"];
+    NSMutableArray<NSString *> *rewritten = [NSMutableArray arrayWithCapacity:alternatives.count];
+    for (NSString *alternative in alternatives) {
+        NSString *trimmed = [alternative stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        for (NSString *suffix in @[@"@textNodes", @"@text"]) {
+            if ([trimmed hasSuffix:suffix]) {
+                trimmed = [[trimmed substringToIndex:trimmed.length - suffix.length] stringByAppendingString:@"@html"];
+                break;
+            }
+        }
+        [rewritten addObject:trimmed];
+    }
+    return [rewritten componentsJoinedByString:@"||"];
+}
+
+// 不含正则元字符（转义的标点视为字面字符）时返回对应的纯文本，否则返回 nil
+- (nullable NSString *)literalFromPattern:(NSString *)pattern {
+    NSCharacterSet *metaCharacters = [NSCharacterSet characterSetWithCharactersInString:@"^$.|?*+()[]{}"];
+    NSMutableString *literal = [NSMutableString stringWithCapacity:pattern.length];
+
+    for (NSUInteger i = 0; i < pattern.length; i++) {
+        unichar c = [pattern characterAtIndex:i];
+        if (c == '\\') {
+            if (i + 1 >= pattern.length) {
+                return nil;
+            }
+            unichar escaped = [pattern characterAtIndex:++i];
+            // \d \s \w 等是字符类，不是字面字符
+            if ([[NSCharacterSet alphanumericCharacterSet] characterIsMember:escaped]) {
+                return nil;
+            }
+            [literal appendFormat:@"%C", escaped];
+        } else if ([metaCharacters characterIsMember:c]) {
+            return nil;
+        } else {
+            [literal appendFormat:@"%C", c];
+        }
+    }
+
+    // 含空白的文字在扫描中会被合并，无法按原样匹配，交给正则处理
+    if ([literal rangeOfCharacterFromSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]].location != NSNotFound) {
+        return nil;
+    }
+    return literal;
+}
+
+- (void)compileLiterals {
+    memset(&_program, 0, sizeof(_program));
+    if (self.literalPatterns.count == 0) {
+        return;
+    }
+
+    _program.literals = calloc(self.literalPatterns.count, sizeof(ContentCleanerLiteral));
+    for (NSString *pattern in self.literalPatterns) {
+        ContentCleanerLiteral *literal = &_program.literals[_program.literalCount++];
+        literal->length = pattern.length;
+        literal->characters = malloc(pattern.length * sizeof(unichar));
+        [pattern getCharacters:literal->characters range:NSMakeRange(0, pattern.length)];
+
+        unichar last = literal->characters[literal->length - 1];
+        _program.lastCharacterBits[last >> 6] |= (uint64_t)1 << (last & 63);
+    }
+}
+
+@end
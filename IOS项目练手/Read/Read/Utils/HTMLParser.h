@@ -27,6 +27,19 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (NSDictionary *)extractFieldsFromHTML:(NSString *)html withRules:(NSDictionary<NSString *, NSString *> *)rules;
 
+#pragma mark - 正则预编译
+
+/**
+ * 选择器步骤（class. / id. / tag. / text.）对应的正则，其他步骤返回 nil
+ * 选择器匹配时使用 NSRegularExpressionDotMatchesLineSeparators
+ */
++ (nullable NSString *)patternForSelectorStep:(NSString *)step;
+
+/**
+ * 编译正则（全局缓存，线程安全）；无效的正则也会被记住，返回 nil
+ */
++ (nullable NSRegularExpression *)regexWithPattern:(NSString *)pattern options:(NSRegularExpressionOptions)options;
+
 @end
 
 #pragma mark - 规则语法说明
@@ -6,6 +6,10 @@
 //
 
 #import "HTMLParser.h"
+#import "TraceRecorder.h"
+#import "MetricsRegistry.h"
+
+static const NSUInteger kRegexCacheLimit = 512;
 
 @implementation HTMLParser
 
@@ -16,7 +20,7 @@
         return nil;
     }
 
-    // 处理 || 语法（或操作）
+    // 处理 || 语法（或操作）：每个备选规则单独计时
     if ([rule containsString:@"||"]) {
         NSArray<NSString *> *alternatives = [rule componentsSeparatedByString:@"||"];
         for (NSString *alternativeRule in alternatives) {
@@ -28,6 +32,10 @@
         return nil;
     }
 
+    TraceSpan span = TraceSpanBegin("parse", "HTMLParser");
+    METRICS_TIME_SCOPE(MetricTimerRuleHTML);
+    NSString *tracedRule = rule;
+
     // 处理 ## 语法（正则过滤）
     NSString *regexPattern = nil;
     if ([rule containsString:@"##"]) {
@@ -124,6 +132,7 @@
         }
     }
 
+    TRACE_END(span, tracedRule.UTF8String, (int64_t)html.length);
     return result;
 }
 
@@ -141,11 +150,53 @@
     return results;
 }
 
+#pragma mark - 正则预编译
+
++ (nullable NSString *)patternForSelectorStep:(NSString *)step {
+    if ([step hasPrefix:@"class."]) {
+        NSString *className = [step substringFromIndex:6];
+        return [NSString stringWithFormat:@"<[^>]*class=[\"'][^\"']*\\b%@\\b[^\"']*[\"'][^>]*>.*?</[^>]+>", className];
+    }
+    if ([step hasPrefix:@"id."]) {
+        NSString *idName = [step substringFromIndex:3];
+        return [NSString stringWithFormat:@"<[^>]*id=[\"']%@[\"'][^>]*>.*?</[^>]+>", idName];
+    }
+    if ([step hasPrefix:@"tag."]) {
+        NSString *tagName = [step substringFromIndex:4];
+        return [NSString stringWithFormat:@"<%@[^>]*>.*?</%@>", tagName, tagName];
+    }
+    if ([step hasPrefix:@"text."]) {
+        NSString *text = [step substringFromIndex:5];
+        return [NSString stringWithFormat:@"<a[^>]*>%@</a>", text];
+    }
+    return nil;
+}
+
++ (nullable NSRegularExpression *)regexWithPattern:(NSString *)pattern options:(NSRegularExpressionOptions)options {
+    static NSCache *cache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [[NSCache alloc] init];
+        cache.countLimit = kRegexCacheLimit;
+    });
+
+    // ⭐ 同一条规则对每个元素、每一页都会重复编译同样的正则
+    NSString *key = [NSString stringWithFormat:@"%lu:%@", (unsigned long)options, pattern];
+    id cached = [cache objectForKey:key];
+    if (cached) {
+        return cached == [NSNull null] ? nil : cached;
+    }
+
+    NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:pattern options:options error:nil];
+    [cache setObject:regex ?: [NSNull null] forKey:key];
+    return regex;
+}
+
 #pragma mark - 选择器实现
 
 + (id)selectByClass:(NSString *)className fromHTML:(id)html {
     if ([html isKindOfClass:[NSString class]]) {
-        NSString *pattern = [NSString stringWithFormat:@"<[^>]*class=[\"'][^\"']*\\b%@\\b[^\"']*[\"'][^>]*>.*?</[^>]+>", className];
+        NSString *pattern = [self patternForSelectorStep:[@"class." stringByAppendingString:className]];
         return [self findAllMatches:pattern inHTML:html];
     }
     return nil;
@@ -153,7 +204,7 @@
 
 + (id)selectByID:(NSString *)idName fromHTML:(id)html {
     if ([html isKindOfClass:[NSString class]]) {
-        NSString *pattern = [NSString stringWithFormat:@"<[^>]*id=[\"']%@[\"'][^>]*>.*?</[^>]+>", idName];
+        NSString *pattern = [self patternForSelectorStep:[@"id." stringByAppendingString:idName]];
         NSArray *matches = [self findAllMatches:pattern inHTML:html];
         return matches.count > 0 ? matches[0] : nil;
     }
@@ -162,7 +213,7 @@
 
 + (id)selectByTag:(NSString *)tagName fromHTML:(id)html {
     if ([html isKindOfClass:[NSString class]]) {
-        NSString *pattern = [NSString stringWithFormat:@"<%@[^>]*>.*?</%@>", tagName, tagName];
+        NSString *pattern = [self patternForSelectorStep:[@"tag." stringByAppendingString:tagName]];
         return [self findAllMatches:pattern inHTML:html];
     } else if ([html isKindOfClass:[NSArray class]]) {
         NSMutableArray *results = [NSMutableArray array];
@@ -179,7 +230,7 @@
 
 + (id)selectByText:(NSString *)text fromHTML:(id)html {
     if ([html isKindOfClass:[NSString class]]) {
-        NSString *pattern = [NSString stringWithFormat:@"<a[^>]*>%@</a>", text];
+        NSString *pattern = [self patternForSelectorStep:[@"text." stringByAppendingString:text]];
         NSArray *matches = [self findAllMatches:pattern inHTML:html];
         return matches.count > 0 ? matches[0] : nil;
     }
@@ -194,9 +245,7 @@
     }
 
     NSString *pattern = [NSString stringWithFormat:@"%@=[\"']([^\"']*)[\"']", attrName];
-    NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:pattern
-                                                                           options:NSRegularExpressionCaseInsensitive
-                                                                             error:nil];
+    NSRegularExpression *regex = [self regexWithPattern:pattern options:NSRegularExpressionCaseInsensitive];
     NSTextCheckingResult *match = [regex firstMatchInString:html options:0 range:NSMakeRange(0, html.length)];
 
     if (match && match.numberOfRanges > 1) {
@@ -212,10 +261,7 @@
     }
 
     // 移除 HTML 标签
-    NSString *pattern = @"<[^>]+>";
-    NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:pattern
-                                                                           options:0
-                                                                             error:nil];
+    NSRegularExpression *regex = [self regexWithPattern:@"<[^>]+>" options:0];
     NSString *text = [regex stringByReplacingMatchesInString:html
                                                       options:0
                                                         range:NSMakeRange(0, html.length)
@@ -234,9 +280,10 @@
 #pragma mark - 正则匹配
 
 + (NSArray<NSString *> *)findAllMatches:(NSString *)pattern inHTML:(NSString *)html {
-    NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:pattern
-                                                                           options:NSRegularExpressionDotMatchesLineSeparators
-                                                                             error:nil];
+    NSRegularExpression *regex = [self regexWithPattern:pattern options:NSRegularExpressionDotMatchesLineSeparators];
+    if (!regex) {
+        return @[];
+    }
     NSArray<NSTextCheckingResult *> *matches = [regex matchesInString:html options:0 range:NSMakeRange(0, html.length)];
 
     NSMutableArray<NSString *> *results = [NSMutableArray array];
@@ -253,9 +300,7 @@
         return string;
     }
 
-    NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:pattern
-                                                                           options:0
-                                                                             error:nil];
+    NSRegularExpression *regex = [self regexWithPattern:pattern options:0];
     return [regex stringByReplacingMatchesInString:string
                                            options:0
                                              range:NSMakeRange(0, string.length)
@@ -6,8 +6,17 @@
 //
 
 #import "JSScriptEngine.h"
+#import "TraceRecorder.h"
+#import "MetricsRegistry.h"
+
+// 命令行（GNUstep）构建没有 JavaScriptCore：规则字符串的拆分照常可用，脚本不执行
+#if __has_include(<JavaScriptCore/JavaScriptCore.h>)
 #import <JavaScriptCore/JavaScriptCore.h>
 #import <CommonCrypto/CommonCrypto.h>
+#define JS_SCRIPT_ENGINE_AVAILABLE 1
+#else
+#define JS_SCRIPT_ENGINE_AVAILABLE 0
+#endif
 
 @implementation JSScriptEngine
 
@@ -50,11 +59,16 @@
     return normalRule.length > 0 ? normalRule : nil;
 }
 
+#if JS_SCRIPT_ENGINE_AVAILABLE
+
 + (id)executeScript:(NSString *)script withContext:(NSDictionary *)context {
     if (!script || script.length == 0) {
         return nil;
     }
 
+    TRACE_SCOPE("script", "executeScript");
+    METRICS_TIME_SCOPE(MetricTimerScript);
+
     // 创建 JavaScript 上下文
     JSContext *jsContext = [[JSContext alloc] init];
 
@@ -160,5 +174,13 @@
     }
 }
 
+#else
+
++ (id)executeScript:(NSString *)script withContext:(NSDictionary *)context {
+    return nil;
+}
+
+#endif
+
 @end
 
@@ -0,0 +1,138 @@
+//
+//  MetricsRegistry.h
+//  Read
+//
+//  性能指标 - 按书源常驻统计请求、解码、解析、JS 耗时和各级缓存命中率
+//
+
+#import <Foundation/Foundation.h>
+#include <stdint.h>
+
+@class BookSource;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 书源槽位（0 表示未归属到具体书源）
+ */
+typedef uint32_t MetricsSource;
+
+typedef NS_ENUM(uint32_t, MetricCounter) {
+    MetricCounterRequestBytes = 0,    // 响应字节数
+    MetricCounterRequestErrors,       // 请求失败次数
+    MetricCounterParseFailures,       // 解析结果为空的次数
+    MetricCounterSearchCacheHit,
+    MetricCounterSearchCacheMiss,
+    MetricCounterTocCacheHit,
+    MetricCounterTocCacheMiss,
+    MetricCounterChapterCacheHit,
+    MetricCounterChapterCacheMiss,
+    MetricCounterPaginationCacheHit,
+    MetricCounterPaginationCacheMiss,
+    MetricCounterCount
+};
+
+typedef NS_ENUM(uint32_t, MetricTimer) {
+    MetricTimerRequest = 0,           // 请求（发出到收到响应，墙钟时间）
+    MetricTimerDecode,                // 响应解码为字符串
+    MetricTimerParseSearch,           // 搜索结果解析（含规则和 JS）
+    MetricTimerParseToc,              // 目录解析（含规则和 JS）
+    MetricTimerParseContent,          // 正文解析和清洗（含规则和 JS）
+    MetricTimerRuleHTML,              // HTML 规则求值
+    MetricTimerRuleJSON,              // JSON 路径规则求值
+    MetricTimerScript,                // JS 执行
+    MetricTimerCount
+};
+
+uint64_t MetricsNow(void);
+
+/**
+ * 计数（只写当前线程的分片，不加锁）
+ */
+void MetricsCount(MetricsSource source, MetricCounter counter, uint64_t delta);
+
+/**
+ * 记录一次耗时（纳秒，写入当前线程分片的直方图）
+ */
+void MetricsRecordTime(MetricsSource source, MetricTimer timer, uint64_t nanos);
+
+/**
+ * 当前线程正在处理的书源（规则解析器、JS 引擎不知道书源，按这里归属）
+ */
+MetricsSource MetricsCurrentSource(void);
+MetricsSource MetricsSourceEnter(MetricsSource source);
+void MetricsSourceRestore(MetricsSource *previous);
+
+typedef struct {
+    MetricsSource source;
+    MetricTimer timer;
+    uint64_t start;
+} MetricsTiming;
+
+void MetricsTimingEnd(MetricsTiming *timing);
+
+#define METRICS_CONCAT_(a, b) a##b
+#define METRICS_CONCAT(a, b) METRICS_CONCAT_(a, b)
+
+/**
+ * 作用域内的规则、JS 耗时归属到指定书源，离开作用域时恢复
+ */
+#define METRICS_SOURCE_SCOPE(source) \
+    __attribute__((cleanup(MetricsSourceRestore), unused)) MetricsSource METRICS_CONCAT(_metricsSource, __LINE__) = MetricsSourceEnter(source)
+
+/**
+ * 作用域计时：记录到当前线程的书源
+ */
+#define METRICS_TIME_SCOPE(timer) \
+    __attribute__((cleanup(MetricsTimingEnd), unused)) MetricsTiming METRICS_CONCAT(_metricsTiming, __LINE__) = \
+        (MetricsTiming){MetricsCurrentSource(), (timer), MetricsNow()}
+
+/**
+ * 性能指标注册表
+ *
+ * 职责：
+ *   1. 书源登记：按书源名称和站点域名分配槽位（网络层只知道域名，解析层知道书源）
+ *   2. 常驻统计：计数器和耗时直方图按线程分片，写入只改本线程的分片，不加锁、不分配内存
+ *      （每个线程第一次记录某个书源时分配一次该书源的分片，线程结束时并入汇总后释放）
+ *   3. 快照：汇总所有线程的分片，给出每个书源的请求数、字节数、各阶段耗时分位数、缓存命中率和错误数，
+ *      按本地耗时（解码 + 解析）从高到低排列；也可以导出 JSON 离线分析
+ *
+ * 说明：
+ *   耗时直方图采用 HDR 风格的对数-线性分桶（微秒，每个 2 的幂区间再分 8 个子桶），
+ *   分位数取桶中点，相对误差不超过 6.25%，最大值精确记录。
+ *   解析阶段（parseSearch / parseToc / parseContent）包含其中的规则和 JS 耗时，规则和 JS 计时是它们的细分，不要相加。
+ *   章节缓存、分页缓存不知道书源时记在「未归属」槽位；最多登记 4096 个书源，超出的也记在这里。
+ *   多个书源共用一个站点时，网络层指标记在先登记的书源上。
+ *
+ * 使用示例：
+ *   MetricsSource source = [MetricsRegistry sourceForBookSource:bookSource];
+ *   METRICS_SOURCE_SCOPE(source);
+ *   METRICS_TIME_SCOPE(MetricTimerParseToc);
+ *   MetricsCount(source, MetricCounterTocCacheMiss, 1);
+ *
+ *   NSDictionary *snapshot = [MetricsRegistry snapshot];
+ */
+@interface MetricsRegistry : NSObject
+
+/**
+ * 按书源名称或站点域名查找槽位，没有则分配（都为空或槽位用尽时返回 0）
+ */
++ (MetricsSource)sourceWithName:(nullable NSString *)name host:(nullable NSString *)host;
+
++ (MetricsSource)sourceForBookSource:(nullable BookSource *)bookSource;
+
+/**
+ * 汇总快照
+ * {uptimeSeconds, total: {...}, sources: [{name, host, requests, bytes, errors, parseFailures, costMs, timers, cache}]}
+ */
++ (NSDictionary *)snapshot;
+
+/**
+ * 导出到目录下的 metrics-<时间>.json
+ * @return 文件路径，失败返回 nil
+ */
++ (nullable NSString *)writeSnapshotToDirectory:(NSString *)directory error:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
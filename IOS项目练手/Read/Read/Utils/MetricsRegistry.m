@@ -0,0 +1,475 @@
+//
+//  MetricsRegistry.m
+//  Read
+//
+//  性能指标实现
+//
+
+#import "MetricsRegistry.h"
+#import "BookSource.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+
+enum {
+    kMetricsSourcePageSize = 64,    // 书源分片指针按页分配
+    kMetricsSourcePageCount = 64,
+    kMetricsMaxSources = kMetricsSourcePageSize * kMetricsSourcePageCount,   // 4096，含槽位 0（未归属）
+    kMetricsSubBucketBits = 3,      // 每个 2 的幂区间分 8 个子桶
+    kMetricsSubBuckets = 1 << kMetricsSubBucketBits,
+    kMetricsBucketCount = (32 - kMetricsSubBucketBits + 1) * kMetricsSubBuckets,   // 覆盖 0 ~ 2^32 微秒
+};
+
+#pragma mark - 分片
+
+/**
+ * 一个线程中一个书源的统计（约 8KB），只由所属线程写入
+ */
+typedef struct {
+    uint64_t counters[MetricCounterCount];
+    uint64_t timerCounts[MetricTimerCount];
+    uint64_t timerTotals[MetricTimerCount];      // 纳秒
+    uint64_t timerMax[MetricTimerCount];         // 纳秒
+    uint32_t buckets[MetricTimerCount][kMetricsBucketCount];
+} MetricsSourceShard;
+
+/**
+ * 每个线程一个分片，书源分片指针按页、书源分片按需分配
+ * 线程结束时分片并入 gRetired 后释放，GCD 回收、新建工作线程不会让内存一直增长
+ */
+typedef struct MetricsShard {
+    struct MetricsShard *next;
+    MetricsSourceShard **pages[kMetricsSourcePageCount];
+} MetricsShard;
+
+static MetricsShard *gShards = NULL;
+static MetricsShard gRetired;               // 已结束线程的汇总（只在 gShardsLock 内读写）
+static pthread_mutex_t gShardsLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t gShardKey;
+static pthread_once_t gShardKeyOnce = PTHREAD_ONCE_INIT;
+static __thread MetricsShard *tCurrentShard = NULL;
+static __thread MetricsSource tCurrentSource = 0;
+
+static const char *const kTimerNames[MetricTimerCount] = {
+    "request", "decode", "parseSearch", "parseToc", "parseContent", "ruleHTML", "ruleJSON", "script",
+};
+
+uint64_t MetricsNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * 单写者累加：不需要原子读改写，只要读者不会读到撕裂的值
+ */
+static inline void MetricsAdd(uint64_t *value, uint64_t delta) {
+    __atomic_store_n(value, __atomic_load_n(value, __ATOMIC_RELAXED) + delta, __ATOMIC_RELAXED);
+}
+
+/**
+ * 书源分片（其他线程读取时 create 传 NO）
+ */
+static MetricsSourceShard *MetricsShardSource(MetricsShard *shard, MetricsSource source, BOOL create) {
+    MetricsSourceShard **page = __atomic_load_n(&shard->pages[source / kMetricsSourcePageSize], __ATOMIC_ACQUIRE);
+    if (!page) {
+        if (!create || !(page = calloc(kMetricsSourcePageSize, sizeof(MetricsSourceShard *)))) {
+            return NULL;
+        }
+        __atomic_store_n(&shard->pages[source / kMetricsSourcePageSize], page, __ATOMIC_RELEASE);
+    }
+
+    MetricsSourceShard *sourceShard = __atomic_load_n(&page[source % kMetricsSourcePageSize], __ATOMIC_ACQUIRE);
+    if (!sourceShard && create) {
+        sourceShard = calloc(1, sizeof(MetricsSourceShard));
+        if (sourceShard) {
+            __atomic_store_n(&page[source % kMetricsSourcePageSize], sourceShard, __ATOMIC_RELEASE);
+        }
+    }
+    return sourceShard;
+}
+
+static void MetricsAccumulate(MetricsSourceShard *into, const MetricsSourceShard *from);
+
+/**
+ * 线程结束：从链表中摘下分片，统计并入 gRetired，然后释放
+ */
+static void MetricsShardRetire(void *value) {
+    MetricsShard *shard = value;
+    tCurrentShard = NULL;
+
+    pthread_mutex_lock(&gShardsLock);
+    for (MetricsShard **link = &gShards; *link; link = &(*link)->next) {
+        if (*link == shard) {
+            *link = shard->next;
+            break;
+        }
+    }
+    for (uint32_t p = 0; p < kMetricsSourcePageCount; p++) {
+        MetricsSourceShard **page = shard->pages[p];
+        if (!page) {
+            continue;
+        }
+        for (uint32_t i = 0; i < kMetricsSourcePageSize; i++) {
+            if (page[i]) {
+                MetricsSourceShard *retired = MetricsShardSource(&gRetired, p * kMetricsSourcePageSize + i, YES);
+                if (retired) {
+                    MetricsAccumulate(retired, page[i]);
+                }
+                free(page[i]);
+            }
+        }
+        free(page);
+    }
+    pthread_mutex_unlock(&gShardsLock);
+    free(shard);
+}
+
+static void MetricsShardKeyCreate(void) {
+    pthread_key_create(&gShardKey, MetricsShardRetire);
+}
+
+static MetricsSourceShard *MetricsCurrentSourceShard(MetricsSource source) {
+    if (source >= kMetricsMaxSources) {
+        source = 0;
+    }
+
+    MetricsShard *shard = tCurrentShard;
+    if (!shard) {
+        shard = calloc(1, sizeof(MetricsShard));
+        if (!shard) {
+            return NULL;
+        }
+        pthread_once(&gShardKeyOnce, MetricsShardKeyCreate);
+        pthread_setspecific(gShardKey, shard);
+        pthread_mutex_lock(&gShardsLock);
+        shard->next = gShards;
+        gShards = shard;
+        pthread_mutex_unlock(&gShardsLock);
+        tCurrentShard = shard;
+    }
+    return MetricsShardSource(shard, source, YES);
+}
+
+#pragma mark - 直方图
+
+static uint32_t MetricsBucketIndex(uint64_t micros) {
+    if (micros < kMetricsSubBuckets) {
+        return (uint32_t)micros;
+    }
+    if (micros >> 32) {
+        micros = UINT32_MAX;
+    }
+    uint32_t exponent = 63 - (uint32_t)__builtin_clzll(micros);
+    uint32_t subBucket = (uint32_t)(micros >> (exponent - kMetricsSubBucketBits)) & (kMetricsSubBuckets - 1);
+    return (exponent - kMetricsSubBucketBits + 1) * kMetricsSubBuckets + subBucket;
+}
+
+/**
+ * 桶的中点（微秒）
+ */
+static double MetricsBucketMidpoint(uint32_t index) {
+    if (index < kMetricsSubBuckets) {
+        return index;
+    }
+    uint32_t exponent = index / kMetricsSubBuckets + kMetricsSubBucketBits - 1;
+    uint32_t subBucket = index % kMetricsSubBuckets;
+    double width = (double)(1ull << (exponent - kMetricsSubBucketBits));
+    return (kMetricsSubBuckets + subBucket) * width + width / 2;
+}
+
+#pragma mark - 记录
+
+void MetricsCount(MetricsSource source, MetricCounter counter, uint64_t delta) {
+    MetricsSourceShard *shard = MetricsCurrentSourceShard(source);
+    if (shard && counter < MetricCounterCount) {
+        MetricsAdd(&shard->counters[counter], delta);
+    }
+}
+
+void MetricsRecordTime(MetricsSource source, MetricTimer timer, uint64_t nanos) {
+    MetricsSourceShard *shard = MetricsCurrentSourceShard(source);
+    if (!shard || timer >= MetricTimerCount) {
+        return;
+    }
+
+    MetricsAdd(&shard->timerCounts[timer], 1);
+    MetricsAdd(&shard->timerTotals[timer], nanos);
+    if (nanos > __atomic_load_n(&shard->timerMax[timer], __ATOMIC_RELAXED)) {
+        __atomic_store_n(&shard->timerMax[timer], nanos, __ATOMIC_RELAXED);
+    }
+    uint32_t *bucket = &shard->buckets[timer][MetricsBucketIndex(nanos / 1000)];
+    __atomic_store_n(bucket, __atomic_load_n(bucket, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+}
+
+MetricsSource MetricsCurrentSource(void) {
+    return tCurrentSource;
+}
+
+MetricsSource MetricsSourceEnter(MetricsSource source) {
+    MetricsSource previous = tCurrentSource;
+    tCurrentSource = source;
+    return previous;
+}
+
+void MetricsSourceRestore(MetricsSource *previous) {
+    tCurrentSource = *previous;
+}
+
+void MetricsTimingEnd(MetricsTiming *timing) {
+    MetricsRecordTime(timing->source, timing->timer, MetricsNow() - timing->start);
+}
+
+#pragma mark - 汇总
+
+static void MetricsAccumulate(MetricsSourceShard *into, const MetricsSourceShard *from) {
+    for (uint32_t i = 0; i < MetricCounterCount; i++) {
+        into->counters[i] += __atomic_load_n(&from->counters[i], __ATOMIC_RELAXED);
+    }
+    for (uint32_t t = 0; t < MetricTimerCount; t++) {
+        into->timerCounts[t] += __atomic_load_n(&from->timerCounts[t], __ATOMIC_RELAXED);
+        into->timerTotals[t] += __atomic_load_n(&from->timerTotals[t], __ATOMIC_RELAXED);
+        into->timerMax[t] = MAX(into->timerMax[t], __atomic_load_n(&from->timerMax[t], __ATOMIC_RELAXED));
+        for (uint32_t b = 0; b < kMetricsBucketCount; b++) {
+            into->buckets[t][b] += __atomic_load_n(&from->buckets[t][b], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * 把一个线程分片按书源累加到 sums，sums[sourceCount] 是合计
+ */
+static void MetricsAccumulateShard(MetricsSourceShard *sums, MetricsShard *shard, NSUInteger sourceCount) {
+    for (NSUInteger s = 0; s < sourceCount; s++) {
+        MetricsSourceShard *sourceShard = MetricsShardSource(shard, (MetricsSource)s, NO);
+        if (sourceShard) {
+            MetricsAccumulate(&sums[s], sourceShard);
+            MetricsAccumulate(&sums[sourceCount], sourceShard);
+        }
+    }
+}
+
+static double MetricsPercentileMs(const MetricsSourceShard *shard, MetricTimer timer, double quantile) {
+    uint64_t count = 0;
+    for (uint32_t b = 0; b < kMetricsBucketCount; b++) {
+        count += shard->buckets[timer][b];
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = MAX((uint64_t)ceil(quantile * count), 1ull);
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < kMetricsBucketCount; b++) {
+        seen += shard->buckets[timer][b];
+        if (seen >= rank) {
+            double maxMicros = shard->timerMax[timer] / 1000.0;
+            return MIN(MetricsBucketMidpoint(b), maxMicros) / 1000.0;
+        }
+    }
+    return shard->timerMax[timer] / 1000000.0;
+}
+
+static NSDictionary *MetricsShardDictionary(const MetricsSourceShard *shard) {
+    NSMutableDictionary *timers = [NSMutableDictionary dictionary];
+    for (uint32_t t = 0; t < MetricTimerCount; t++) {
+        uint64_t count = shard->timerCounts[t];
+        if (count == 0) {
+            continue;
+        }
+        double totalMs = shard->timerTotals[t] / 1000000.0;
+        timers[@(kTimerNames[t])] = @{
+            @"count": @(count),
+            @"totalMs": @(totalMs),
+            @"meanMs": @(totalMs / count),
+            @"p50Ms": @(MetricsPercentileMs(shard, t, 0.50)),
+            @"p90Ms": @(MetricsPercentileMs(shard, t, 0.90)),
+            @"p99Ms": @(MetricsPercentileMs(shard, t, 0.99)),
+            @"maxMs": @(shard->timerMax[t] / 1000000.0),
+        };
+    }
+
+    // 缓存命中率：计数器中命中、未命中成对排列
+    NSMutableDictionary *cache = [NSMutableDictionary dictionary];
+    NSArray<NSString *> *cacheNames = @[@"search", @"toc", @"chapter", @"pagination"];
+    for (NSUInteger i = 0; i < cacheNames.count; i++) {
+        uint64_t hits = shard->counters[MetricCounterSearchCacheHit + i * 2];
+        uint64_t misses = shard->counters[MetricCounterSearchCacheMiss + i * 2];
+        if (hits + misses == 0) {
+            continue;
+        }
+        cache[cacheNames[i]] = @{@"hits": @(hits), @"misses": @(misses), @"hitRatio": @((double)hits / (hits + misses))};
+    }
+
+    // 本地耗时：解码 + 解析（解析已包含规则和 JS）
+    uint64_t costNanos = shard->timerTotals[MetricTimerDecode] + shard->timerTotals[MetricTimerParseSearch] +
+                         shard->timerTotals[MetricTimerParseToc] + shard->timerTotals[MetricTimerParseContent];
+
+    return @{
+        @"requests": @(shard->timerCounts[MetricTimerRequest]),
+        @"bytes": @(shard->counters[MetricCounterRequestBytes]),
+        @"errors": @(shard->counters[MetricCounterRequestErrors]),
+        @"parseFailures": @(shard->counters[MetricCounterParseFailures]),
+        @"costMs": @(costNanos / 1000000.0),
+        @"timers": timers,
+        @"cache": cache,
+    };
+}
+
+static BOOL MetricsShardIsEmpty(const MetricsSourceShard *shard) {
+    for (uint32_t i = 0; i < MetricCounterCount; i++) {
+        if (shard->counters[i]) {
+            return NO;
+        }
+    }
+    for (uint32_t t = 0; t < MetricTimerCount; t++) {
+        if (shard->timerCounts[t]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+#pragma mark - MetricsRegistry
+
+static pthread_mutex_t gRegistryLock = PTHREAD_MUTEX_INITIALIZER;
+static NSMutableArray<NSMutableDictionary *> *gSourceInfos;              // 下标即槽位
+static NSMutableDictionary<NSString *, NSNumber *> *gSlotsByName;
+static NSMutableDictionary<NSString *, NSNumber *> *gSlotsByHost;
+static uint64_t gStartTime;
+
+@implementation MetricsRegistry
+
++ (void)initialize {
+    if (self == [MetricsRegistry class]) {
+        gSourceInfos = [NSMutableArray arrayWithObject:[@{@"name": @"未归属"} mutableCopy]];
+        gSlotsByName = [NSMutableDictionary dictionary];
+        gSlotsByHost = [NSMutableDictionary dictionary];
+        gStartTime = MetricsNow();
+    }
+}
+
++ (MetricsSource)sourceWithName:(nullable NSString *)name host:(nullable NSString *)host {
+    if (name.length == 0) {
+        name = nil;
+    }
+    host = host.length > 0 ? host.lowercaseString : nil;
+    if (!name && !host) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&gRegistryLock);
+
+    NSNumber *slot = name ? gSlotsByName[name] : gSlotsByHost[host];
+    if (!slot && name && host) {
+        // 网络层先用域名登记的匿名槽位，由第一个同域名的书源认领
+        NSNumber *hostSlot = gSlotsByHost[host];
+        if (hostSlot && !gSourceInfos[hostSlot.unsignedIntValue][@"name"]) {
+            slot = hostSlot;
+        }
+    }
+
+    if (!slot) {
+        if (gSourceInfos.count >= kMetricsMaxSources) {
+            pthread_mutex_unlock(&gRegistryLock);
+            return 0;
+        }
+        slot = @(gSourceInfos.count);
+        [gSourceInfos addObject:[NSMutableDictionary dictionary]];
+    }
+
+    NSMutableDictionary *info = gSourceInfos[slot.unsignedIntValue];
+    if (name && !info[@"name"]) {
+        info[@"name"] = name;
+        gSlotsByName[name] = slot;
+    }
+    if (host && !info[@"host"]) {
+        info[@"host"] = host;
+    }
+    if (host && !gSlotsByHost[host]) {
+        gSlotsByHost[host] = slot;
+    }
+
+    pthread_mutex_unlock(&gRegistryLock);
+    return slot.unsignedIntValue;
+}
+
++ (MetricsSource)sourceForBookSource:(nullable BookSource *)bookSource {
+    if (!bookSource) {
+        return 0;
+    }
+    return [self sourceWithName:bookSource.bookSourceName host:[NSURL URLWithString:bookSource.bookSourceUrl].host];
+}
+
++ (NSDictionary *)snapshot {
+    pthread_mutex_lock(&gRegistryLock);
+    NSArray<NSDictionary *> *infos = [[NSArray alloc] initWithArray:gSourceInfos copyItems:YES];
+    pthread_mutex_unlock(&gRegistryLock);
+
+    NSUInteger sourceCount = infos.count;
+    MetricsSourceShard *sums = calloc(sourceCount + 1, sizeof(MetricsSourceShard));   // 最后一个是合计
+    if (!sums) {
+        return @{};
+    }
+
+    // 存活线程的分片 + 已结束线程的汇总
+    pthread_mutex_lock(&gShardsLock);
+    for (MetricsShard *shard = gShards; shard; shard = shard->next) {
+        MetricsAccumulateShard(sums, shard, sourceCount);
+    }
+    MetricsAccumulateShard(sums, &gRetired, sourceCount);
+    pthread_mutex_unlock(&gShardsLock);
+
+    NSMutableArray<NSDictionary *> *sources = [NSMutableArray array];
+    for (NSUInteger s = 0; s < sourceCount; s++) {
+        if (MetricsShardIsEmpty(&sums[s])) {
+            continue;
+        }
+        NSMutableDictionary *entry = [MetricsShardDictionary(&sums[s]) mutableCopy];
+        entry[@"name"] = infos[s][@"name"] ?: infos[s][@"host"];
+        entry[@"host"] = infos[s][@"host"];
+        [sources addObject:entry];
+    }
+    [sources sortUsingComparator:^NSComparisonResult(NSDictionary *a, NSDictionary *b) {
+        return [b[@"costMs"] compare:a[@"costMs"]];
+    }];
+
+    NSDictionary *total = MetricsShardDictionary(&sums[sourceCount]);
+    free(sums);
+
+    return @{
+        @"uptimeSeconds": @((MetricsNow() - gStartTime) / 1e9),
+        @"total": total,
+        @"sources": sources,
+    };
+}
+
++ (nullable NSString *)writeSnapshotToDirectory:(NSString *)directory error:(NSError **)error {
+    if (![[NSFileManager defaultManager] createDirectoryAtPath:directory
+                                   withIntermediateDirectories:YES
+                                                    attributes:nil
+                                                         error:error]) {
+        return nil;
+    }
+
+    NSData *data = [NSJSONSerialization dataWithJSONObject:[self snapshot]
+                                                   options:NSJSONWritingPrettyPrinted | NSJSONWritingSortedKeys
+                                                     error:error];
+    if (!data) {
+        return nil;
+    }
+
+    NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+    formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    formatter.dateFormat = @"yyyyMMdd-HHmmss";
+    NSString *fileName = [NSString stringWithFormat:@"metrics-%@.json", [formatter stringFromDate:[NSDate date]]];
+    NSString *path = [directory stringByAppendingPathComponent:fileName];
+
+    if (![data writeToFile:path options:NSDataWritingAtomic error:error]) {
+        return nil;
+    }
+    return path;
+}
+
+@end
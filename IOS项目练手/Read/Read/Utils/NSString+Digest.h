@@ -0,0 +1,22 @@
+//
+//  NSString+Digest.h
+//  Read
+//
+//  字符串摘要分类 - 把书籍URL等任意字符串转换为安全的文件名
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface NSString (Digest)
+
+/**
+ * UTF-8 编码后的 SHA1 十六进制串（40 位小写）
+ * 书籍URL包含 / 等字符，不能直接作为文件名，统一用它生成文件名
+ */
+- (NSString *)sha1String;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,25 @@
+//
+//  NSString+Digest.m
+//  Read
+//
+//  字符串摘要分类实现
+//
+
+#import "NSString+Digest.h"
+#import <CommonCrypto/CommonDigest.h>
+
+@implementation NSString (Digest)
+
+- (NSString *)sha1String {
+    NSData *data = [self dataUsingEncoding:NSUTF8StringEncoding];
+    unsigned char digest[CC_SHA1_DIGEST_LENGTH];
+    CC_SHA1(data.bytes, (CC_LONG)data.length, digest);
+
+    NSMutableString *result = [NSMutableString stringWithCapacity:CC_SHA1_DIGEST_LENGTH * 2];
+    for (int i = 0; i < CC_SHA1_DIGEST_LENGTH; i++) {
+        [result appendFormat:@"%02x", digest[i]];
+    }
+    return result;
+}
+
+@end
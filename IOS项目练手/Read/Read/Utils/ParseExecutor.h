@@ -0,0 +1,89 @@
+//
+//  ParseExecutor.h
+//  Read
+//
+//  解析执行器 - 固定数量的解析线程 + 有上限的积压，满载时让网络层暂缓发出新请求
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 解析优先级（排队时高优先级先执行，已开始的任务不受影响）
+ */
+typedef NS_ENUM(NSInteger, ParseExecutorPriority) {
+    ParseExecutorPriorityLow = 0,       // 规则开销过大的书源
+    ParseExecutorPriorityNormal,        // 搜索结果
+    ParseExecutorPriorityHigh           // 目录、正文（用户正在等待）
+};
+
+/**
+ * 解析执行器
+ *
+ * 职责：
+ *   1. 执行：所有响应解析在同一个操作队列中执行，并发数按 CPU 核数固定（留一个核给主线程），
+ *      解析阻塞时 GCD 不会为补位不断创建新线程
+ *   2. 积压：排队 + 执行中的任务数，加上已放行、响应还没交给解析的请求数，不超过 capacity
+ *   3. 准入：网络层发请求前调用 performWithPriority:whenAccepting:，满载时请求排队，积压降到一半以下再依次放行；
+ *      高优先级（阅读页的目录和正文）不排队，直接放行；响应回调执行完后调用 endAdmission 归还名额
+ *
+ * 说明：
+ *   容量是软上限：已经放行的请求的响应总会被接收和解析，不会丢弃；
+ *   宽搜索（上百个书源）时同时在内存中的响应和解析中间结果因此不超过约 capacity 份，线程数和峰值内存保持平稳。
+ *   不走网络的解析（本地导入、测试）直接 submit，不需要准入。
+ *
+ * 使用示例：
+ *   [[ParseExecutor sharedExecutor] performWhenAccepting:^{
+ *       [task resume];      // 响应回调执行完后调用 endAdmission
+ *   }];
+ *
+ *   [[ParseExecutor sharedExecutor] submitWithPriority:ParseExecutorPriorityNormal block:^{
+ *       NSArray *books = [SourceResponseParser booksFromSearchContent:html bookSource:source];
+ *       dispatch_async(dispatch_get_main_queue(), ^{ ... });
+ *   }];
+ */
+@interface ParseExecutor : NSObject
+
+// 单例
++ (instancetype)sharedExecutor;
+
+/**
+ * 解析线程数（CPU 核数 - 1，至少 1）
+ */
+@property (assign, nonatomic, readonly) NSUInteger workerCount;
+
+/**
+ * 积压上限（解析线程数 × 8，至少 16）
+ */
+@property (assign, nonatomic, readonly) NSUInteger capacity;
+
+/**
+ * 当前积压：排队和执行中的解析任务 + 已放行未归还的请求
+ */
+@property (assign, nonatomic, readonly) NSUInteger backlog;
+
+/**
+ * 提交解析任务（总是接受；每个任务在独立的自动释放池中执行）
+ */
+- (void)submitWithPriority:(ParseExecutorPriority)priority block:(dispatch_block_t)block;
+
+/**
+ * 请求准入：未满载（或高优先级）时立即放行，否则排队，等积压下降后按到达顺序放行
+ * block 总在主线程执行（已在主线程且立即放行时同步执行）；执行即占用一个名额，必须调用一次 endAdmission 归还
+ */
+- (void)performWithPriority:(ParseExecutorPriority)priority whenAccepting:(dispatch_block_t)block;
+
+/**
+ * 普通优先级准入（搜索请求）
+ */
+- (void)performWhenAccepting:(dispatch_block_t)block;
+
+/**
+ * 归还一个准入名额（响应已交给解析任务或请求失败）
+ */
+- (void)endAdmission;
+
+@end
+
+NS_ASSUME_NONNULL_END
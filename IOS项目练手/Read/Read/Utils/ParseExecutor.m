@@ -0,0 +1,158 @@
+//
+//  ParseExecutor.m
+//  Read
+//
+//  解析执行器实现
+//
+
+#import "ParseExecutor.h"
+
+static const NSUInteger kBacklogPerWorker = 8;
+static const NSUInteger kMinimumCapacity = 16;
+
+@interface ParseExecutor ()
+@property (strong, nonatomic) NSOperationQueue *operationQueue;
+@property (strong, nonatomic) NSMutableArray<dispatch_block_t> *waiters;   // 等待准入的请求（先到先放行）
+@property (assign, nonatomic) BOOL throttling;                            // 满载后直到积压降到一半才放行，避免在上限附近反复切换
+@end
+
+@implementation ParseExecutor {
+    NSUInteger _pendingTasks;   // 排队和执行中的解析任务
+    NSUInteger _admitted;       // 已放行、未归还的请求
+}
+
++ (instancetype)sharedExecutor {
+    static ParseExecutor *executor = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        executor = [[ParseExecutor alloc] init];
+    });
+    return executor;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        NSUInteger cores = [NSProcessInfo processInfo].activeProcessorCount;
+        _workerCount = MAX(cores, 2) - 1;
+        _capacity = MAX(_workerCount * kBacklogPerWorker, kMinimumCapacity);
+
+        _operationQueue = [[NSOperationQueue alloc] init];
+        _operationQueue.name = @"com.read.parse";
+        _operationQueue.maxConcurrentOperationCount = _workerCount;
+        _operationQueue.qualityOfService = NSQualityOfServiceUserInitiated;
+
+        _waiters = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (NSUInteger)backlog {
+    @synchronized (self) {
+        return _pendingTasks + _admitted;
+    }
+}
+
+#pragma mark - 解析任务
+
+- (void)submitWithPriority:(ParseExecutorPriority)priority block:(dispatch_block_t)block {
+    @synchronized (self) {
+        _pendingTasks++;
+    }
+
+    __weak typeof(self) weakSelf = self;
+    NSBlockOperation *operation = [NSBlockOperation blockOperationWithBlock:^{
+        @autoreleasepool {
+            block();
+        }
+        [weakSelf finishTask];
+    }];
+    operation.queuePriority = [self queuePriorityForPriority:priority];
+    [self.operationQueue addOperation:operation];
+}
+
+- (NSOperationQueuePriority)queuePriorityForPriority:(ParseExecutorPriority)priority {
+    switch (priority) {
+        case ParseExecutorPriorityHigh:
+            return NSOperationQueuePriorityHigh;
+        case ParseExecutorPriorityLow:
+            return NSOperationQueuePriorityLow;
+        default:
+            return NSOperationQueuePriorityNormal;
+    }
+}
+
+- (void)finishTask {
+    @synchronized (self) {
+        _pendingTasks--;
+    }
+    [self releaseWaitersIfNeeded];
+}
+
+#pragma mark - 准入
+
+- (void)performWhenAccepting:(dispatch_block_t)block {
+    [self performWithPriority:ParseExecutorPriorityNormal whenAccepting:block];
+}
+
+- (void)performWithPriority:(ParseExecutorPriority)priority whenAccepting:(dispatch_block_t)block {
+    BOOL accepted = NO;
+    @synchronized (self) {
+        // ⭐ 阅读页的目录和正文请求不排在搜索积压后面：直接放行，只计入积压
+        if (priority == ParseExecutorPriorityHigh ||
+            (!self.throttling && _pendingTasks + _admitted < self.capacity)) {
+            _admitted++;
+            accepted = YES;
+        } else {
+            self.throttling = YES;
+            [self.waiters addObject:[block copy]];
+        }
+    }
+
+    if (accepted) {
+        [self performOnMainQueue:block];
+    }
+}
+
+// 放行的请求统一在主线程发出（立即放行和排队后放行一致，网络层的任务列表只在主线程修改）
+- (void)performOnMainQueue:(dispatch_block_t)block {
+    if ([NSThread isMainThread]) {
+        block();
+    } else {
+        dispatch_async(dispatch_get_main_queue(), block);
+    }
+}
+
+- (void)endAdmission {
+    @synchronized (self) {
+        if (_admitted > 0) {
+            _admitted--;
+        }
+    }
+    [self releaseWaitersIfNeeded];
+}
+
+/**
+ * 积压降到容量一半以下时，按空出的名额放行排队的请求
+ */
+- (void)releaseWaitersIfNeeded {
+    NSArray<dispatch_block_t> *released = nil;
+    @synchronized (self) {
+        NSUInteger backlog = _pendingTasks + _admitted;
+        if (!self.throttling || backlog > self.capacity / 2) {
+            return;
+        }
+
+        NSUInteger count = MIN(self.waiters.count, self.capacity - backlog);
+        released = [self.waiters subarrayWithRange:NSMakeRange(0, count)];
+        [self.waiters removeObjectsInRange:NSMakeRange(0, count)];
+        _admitted += count;
+        self.throttling = self.waiters.count > 0;
+    }
+
+    for (dispatch_block_t block in released) {
+        dispatch_async(dispatch_get_main_queue(), block);
+    }
+}
+
+@end
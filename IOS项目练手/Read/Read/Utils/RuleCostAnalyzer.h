@@ -0,0 +1,97 @@
+//
+//  RuleCostAnalyzer.h
+//  Read
+//
+//  规则开销分析器 - 导入书源时静态评估每条规则的开销，标记可能拖慢解析的书源
+//
+
+#import <Foundation/Foundation.h>
+#import "BookSource.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 规则复杂度（从低到高）
+ */
+typedef NS_ENUM(NSInteger, RuleComplexity) {
+    RuleComplexityNone = 0,         // 空规则
+    RuleComplexityPath,             // 属性 / 文本提取、JSON 路径（线性）
+    RuleComplexitySelector,         // 单层选择器（一次 .*? 正则扫描）
+    RuleComplexityNestedSelector,   // 多层选择器（每层对上一层的每个结果重新扫描）
+    RuleComplexityRegex,            // ## 正则过滤
+    RuleComplexityScript,           // JS
+    RuleComplexityPathological      // 可能灾难性回溯的正则
+};
+
+/**
+ * 单条规则的分析结果
+ */
+@interface RuleCostEntry : NSObject
+@property (copy, nonatomic) NSString *field;             // 规则字段（如 ruleToc.chapterUrl）
+@property (copy, nonatomic) NSString *rule;
+@property (assign, nonatomic) RuleComplexity complexity;
+@property (assign, nonatomic) NSInteger score;           // 已乘以每页元素数
+@end
+
+/**
+ * 一个书源的分析结果
+ */
+@interface RuleCostReport : NSObject
+@property (strong, nonatomic) NSArray<RuleCostEntry *> *entries;
+@property (assign, nonatomic) NSInteger costScore;
+@property (strong, nonatomic) NSArray<NSString *> *warnings;
+
+/**
+ * 样本页实测解析耗时（毫秒），键为 search / toc / content；没有样本时为空
+ */
+@property (strong, nonatomic) NSDictionary<NSString *, NSNumber *> *sampleMilliseconds;
+@end
+
+/**
+ * 规则开销分析器
+ *
+ * 职责：
+ *   1. 分类：把每条规则拆成 || 备选、@ 步骤、## 正则和 @js 脚本，给出复杂度和开销分
+ *   2. 校验：选择器和 ## 正则在导入时试编译，无效的给出警告（不写入 HTMLParser 的正则缓存，
+ *      批量导入不会挤掉运行中常用的正则）；单个添加的启用书源用 warmUpBookSource: 预编译
+ *   3. 估算：有样本页时用 SourceResponseParser 实测一次解析耗时（疑似灾难性回溯的书源跳过实测）
+ *   4. 标记：开销分和警告写回 BookSource（costScore / costWarnings），随快照保存
+ *
+ * 说明：
+ *   开销分是相对值：单层选择器约 10 分，每多一层选择器 ×4，## 正则 5 分，JS 30 分；
+ *   逐元素求值的规则（搜索结果字段、章节名和章节链接）按每页约 20 / 100 个元素放大。
+ *   搜索按开销分从低到高发起请求，isSlowBookSource: 为真的书源在低优先级队列解析；
+ *   含可能灾难性回溯的正则的书源开销分至少为慢书源阈值，不论规则多少都按慢书源处理。
+ *
+ * 使用示例：
+ *   [RuleCostAnalyzer analyzeBookSource:source];    // 导入时调用
+ *   if ([RuleCostAnalyzer isSlowBookSource:source]) { ... }
+ */
+@interface RuleCostAnalyzer : NSObject
+
+/**
+ * 分析书源并把结果写回 costScore / costWarnings
+ */
++ (RuleCostReport *)analyzeBookSource:(BookSource *)bookSource;
+
+/**
+ * 分析书源，并对样本页实测解析耗时
+ * @param samples 样本页内容，键为 search / toc / content
+ */
++ (RuleCostReport *)analyzeBookSource:(BookSource *)bookSource
+                              samples:(nullable NSDictionary<NSString *, NSString *> *)samples;
+
+/**
+ * 开销分是否超过阈值（含可能灾难性回溯的正则的书源总是为真）
+ */
++ (BOOL)isSlowBookSource:(BookSource *)bookSource;
+
+/**
+ * 预编译书源的选择器、## 正则和正文清洗器，写入运行时缓存
+ * 只用于单个书源（批量导入时调用会挤掉缓存中常用的正则）
+ */
++ (void)warmUpBookSource:(BookSource *)bookSource;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,313 @@
+//
+//  RuleCostAnalyzer.m
+//  Read
+//
+//  规则开销分析器实现
+//
+
+#import "RuleCostAnalyzer.h"
+#import "HTMLParser.h"
+#import "JSScriptEngine.h"
+#import "ContentCleaner.h"
+#import "SourceResponseParser.h"
+#import "MetricsRegistry.h"
+
+static const NSInteger kSelectorScore = 10;          // 一次 .*? 选择器扫描
+static const NSInteger kNestedSelectorFactor = 4;    // 每多一层选择器
+static const NSInteger kPathStepScore = 1;
+static const NSInteger kRegexScore = 5;
+static const NSInteger kLeadingWildcardScore = 20;
+static const NSInteger kPathologicalScore = 200;
+static const NSInteger kScriptScore = 30;
+static const NSInteger kSearchElementFactor = 20;    // 每页搜索结果数
+static const NSInteger kTocElementFactor = 100;      // 每页章节数
+static const NSUInteger kNestedSelectorWarningDepth = 3;
+static const NSInteger kRuleCostSlowThreshold = 10000;
+static const double kSampleSlowMilliseconds = 50;
+
+// 无上限的量词作用在本身含量词的分组上，如 (a+)+、(.*?)*、(\w+\s?){2,}；
+// 有上限的重复（(\d+){2}、(\s*\S+){1,3}）回溯次数有界，不算
+static NSString *const kNestedQuantifierPattern = @"\\((?:[^()\\\\]|\\\\.)*[+*](?:[^()\\\\]|\\\\.)*\\)(?:[+*]|\\{\\d+,\\})";
+
+typedef void (^RuleCostFieldBlock)(NSString *field, NSString *rule, NSInteger elementFactor);
+
+@implementation RuleCostEntry
+@end
+
+@implementation RuleCostReport
+@end
+
+@implementation RuleCostAnalyzer
+
+#pragma mark - 公共接口
+
++ (RuleCostReport *)analyzeBookSource:(BookSource *)bookSource {
+    return [self analyzeBookSource:bookSource samples:nil];
+}
+
++ (RuleCostReport *)analyzeBookSource:(BookSource *)bookSource
+                              samples:(nullable NSDictionary<NSString *, NSString *> *)samples {
+    NSMutableArray<RuleCostEntry *> *entries = [NSMutableArray array];
+    NSMutableArray<NSString *> *warnings = [NSMutableArray array];
+
+    [self enumerateRulesOfBookSource:bookSource usingBlock:^(NSString *field, NSString *rule, NSInteger elementFactor) {
+        [entries addObject:[self entryForField:field rule:rule elementFactor:elementFactor warnings:warnings]];
+    }];
+
+    NSInteger costScore = 0;
+    BOOL pathological = NO;
+    for (RuleCostEntry *entry in entries) {
+        costScore += entry.score;
+        pathological = pathological || entry.complexity == RuleComplexityPathological;
+    }
+
+    RuleCostReport *report = [[RuleCostReport alloc] init];
+    report.entries = entries;
+    // 灾难性回溯与规则条数无关，开销分再低也按慢书源处理
+    report.costScore = pathological ? MAX(costScore, kRuleCostSlowThreshold) : MAX(costScore, 1);
+    report.sampleMilliseconds = samples.count > 0 && !pathological
+        ? [self measureBookSource:bookSource samples:samples warnings:warnings]
+        : @{};
+    if (samples.count > 0 && pathological) {
+        [warnings addObject:@"含可能灾难性回溯的正则，跳过样本页实测"];
+    }
+    report.warnings = warnings;
+
+    bookSource.costScore = report.costScore;
+    bookSource.costWarnings = warnings.count > 0 ? [warnings copy] : nil;
+    return report;
+}
+
++ (BOOL)isSlowBookSource:(BookSource *)bookSource {
+    return bookSource.costScore >= kRuleCostSlowThreshold;
+}
+
++ (void)warmUpBookSource:(BookSource *)bookSource {
+    [self enumerateRulesOfBookSource:bookSource usingBlock:^(NSString *field, NSString *rule, NSInteger elementFactor) {
+        for (NSString *alternative in [rule componentsSeparatedByString:@"||"]) {
+            NSString *normal = [alternative stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+            if ([JSScriptEngine containsJavaScript:normal]) {
+                normal = [JSScriptEngine extractNormalRuleFromRule:normal] ?: @"";
+            }
+            if (normal.length == 0 || [normal containsString:@"{{"]) {
+                continue;
+            }
+
+            NSString *pattern = nil;
+            normal = [self selectorPartOfRule:normal regexPattern:&pattern];
+            if (pattern.length > 0) {
+                [HTMLParser regexWithPattern:pattern options:0];
+            }
+            for (NSString *step in [normal componentsSeparatedByString:@"@"]) {
+                NSString *selectorPattern = [HTMLParser patternForSelectorStep:step];
+                if (selectorPattern) {
+                    [HTMLParser regexWithPattern:selectorPattern options:NSRegularExpressionDotMatchesLineSeparators];
+                }
+            }
+        }
+    }];
+
+    // ⭐ 正文清洗器按规则缓存，第一次阅读时不再编译
+    [ContentCleaner cleanerForContentRule:bookSource.ruleContent.content];
+}
+
+#pragma mark - 规则字段
+
+/**
+ * 参与分析和预编译的规则字段（elementFactor 为每页求值次数）
+ */
++ (void)enumerateRulesOfBookSource:(BookSource *)bookSource usingBlock:(RuleCostFieldBlock)block {
+    void (^visit)(NSString *, id, NSInteger) = ^(NSString *field, id rule, NSInteger elementFactor) {
+        if ([rule isKindOfClass:[NSString class]] && [rule length] > 0) {
+            block(field, rule, elementFactor);
+        }
+    };
+
+    RuleSearch *search = bookSource.ruleSearch;
+    visit(@"ruleSearch.bookList", search.bookList, 1);
+    visit(@"ruleSearch.name", search.name, kSearchElementFactor);
+    visit(@"ruleSearch.author", search.author, kSearchElementFactor);
+    visit(@"ruleSearch.bookUrl", search.bookUrl, kSearchElementFactor);
+    visit(@"ruleSearch.intro", search.intro, kSearchElementFactor);
+    visit(@"ruleSearch.lastChapter", search.lastChapter, kSearchElementFactor);
+    visit(@"ruleSearch.coverUrl", search.coverUrl, kSearchElementFactor);
+
+    visit(@"ruleBookInfo.tocUrl", bookSource.ruleBookInfo.tocUrl, 1);
+
+    RuleToc *toc = bookSource.ruleToc;
+    visit(@"ruleToc.chapterList", toc.chapterList, 1);
+    visit(@"ruleToc.chapterName", toc.chapterName, kTocElementFactor);
+    visit(@"ruleToc.chapterUrl", toc.chapterUrl, kTocElementFactor);
+
+    RuleContent *content = bookSource.ruleContent;
+    visit(@"ruleContent.content", content.content, 1);
+    visit(@"ruleContent.nextContentUrl", content.nextContentUrl, 1);
+}
+
+/**
+ * 与 HTMLParser 一致地拆分 ## ：规则##正则##替换内容，只有 parts[1] 是运行时编译的正则
+ */
++ (NSString *)selectorPartOfRule:(NSString *)rule regexPattern:(NSString * _Nullable * _Nonnull)pattern {
+    *pattern = nil;
+    if (![rule containsString:@"##"]) {
+        return rule;
+    }
+    NSArray<NSString *> *parts = [rule componentsSeparatedByString:@"##"];
+    *pattern = parts.count > 1 ? parts[1] : nil;
+    return parts[0];
+}
+
+#pragma mark - 规则分类
+
++ (RuleCostEntry *)entryForField:(NSString *)field
+                            rule:(NSString *)rule
+                   elementFactor:(NSInteger)elementFactor
+                        warnings:(NSMutableArray<NSString *> *)warnings {
+    RuleComplexity complexity = RuleComplexityNone;
+    NSInteger score = 0;
+
+    // || 备选最坏情况下全部求值一遍
+    for (NSString *alternative in [rule componentsSeparatedByString:@"||"]) {
+        NSString *trimmed = [alternative stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+        RuleComplexity alternativeComplexity = RuleComplexityNone;
+        score += [self scoreForRule:trimmed field:field complexity:&alternativeComplexity warnings:warnings];
+        complexity = MAX(complexity, alternativeComplexity);
+    }
+
+    if (complexity == RuleComplexityScript && elementFactor > 1) {
+        [warnings addObject:[NSString stringWithFormat:@"%@：每个元素执行一次 JS", field]];
+    }
+
+    RuleCostEntry *entry = [[RuleCostEntry alloc] init];
+    entry.field = field;
+    entry.rule = rule;
+    entry.complexity = complexity;
+    entry.score = score * elementFactor;
+    return entry;
+}
+
++ (NSInteger)scoreForRule:(NSString *)rule
+                    field:(NSString *)field
+               complexity:(RuleComplexity *)complexity
+                 warnings:(NSMutableArray<NSString *> *)warnings {
+    NSInteger score = 0;
+    *complexity = RuleComplexityPath;
+
+    if ([JSScriptEngine containsJavaScript:rule]) {
+        score += kScriptScore;
+        *complexity = RuleComplexityScript;
+        rule = [JSScriptEngine extractNormalRuleFromRule:rule] ?: @"";
+    }
+
+    // 模板规则（{{$.id}}）只做字符串替换
+    if ([rule containsString:@"{{"]) {
+        return score + kPathStepScore;
+    }
+
+    NSString *regexPattern = nil;
+    rule = [self selectorPartOfRule:rule regexPattern:&regexPattern];
+    if (regexPattern) {
+        score += [self scoreForRegex:regexPattern field:field complexity:complexity warnings:warnings];
+    }
+
+    NSUInteger selectorDepth = 0;
+    for (NSString *step in [rule componentsSeparatedByString:@"@"]) {
+        NSString *pattern = [HTMLParser patternForSelectorStep:step];
+        if (!pattern) {
+            score += step.length > 0 ? kPathStepScore : 0;
+            continue;
+        }
+
+        selectorDepth++;
+        if (![self isValidPattern:pattern options:NSRegularExpressionDotMatchesLineSeparators]) {
+            [warnings addObject:[NSString stringWithFormat:@"%@：选择器 %@ 生成的正则无效", field, step]];
+        }
+    }
+
+    if (selectorDepth > 0) {
+        NSInteger selectorScore = kSelectorScore;
+        for (NSUInteger i = 1; i < selectorDepth; i++) {
+            selectorScore *= kNestedSelectorFactor;
+        }
+        score += selectorScore;
+        *complexity = MAX(*complexity, selectorDepth > 1 ? RuleComplexityNestedSelector : RuleComplexitySelector);
+    }
+    if (selectorDepth >= kNestedSelectorWarningDepth) {
+        [warnings addObject:[NSString stringWithFormat:@"%@：嵌套 %lu 层选择器，每层对上一层的每个结果重新做 .*? 匹配",
+                             field, (unsigned long)selectorDepth]];
+    }
+
+    return score;
+}
+
++ (NSInteger)scoreForRegex:(NSString *)pattern
+                     field:(NSString *)field
+                complexity:(RuleComplexity *)complexity
+                  warnings:(NSMutableArray<NSString *> *)warnings {
+    if (pattern.length == 0) {
+        return 0;
+    }
+
+    *complexity = MAX(*complexity, RuleComplexityRegex);
+    if (![self isValidPattern:pattern options:0]) {
+        [warnings addObject:[NSString stringWithFormat:@"%@：## 正则无效（%@）", field, pattern]];
+        return kRegexScore;
+    }
+
+    NSRegularExpression *nestedQuantifier = [HTMLParser regexWithPattern:kNestedQuantifierPattern options:0];
+    if ([nestedQuantifier firstMatchInString:pattern options:0 range:NSMakeRange(0, pattern.length)]) {
+        *complexity = RuleComplexityPathological;
+        [warnings addObject:[NSString stringWithFormat:@"%@：## 正则含嵌套量词，可能灾难性回溯（%@）", field, pattern]];
+        return kPathologicalScore;
+    }
+
+    if ([pattern hasPrefix:@".*"] || [pattern hasPrefix:@".+"]) {
+        // 无锚点时每个起点都扫到末尾
+        [warnings addObject:[NSString stringWithFormat:@"%@：## 正则以 %@ 开头且没有锚点", field, [pattern substringToIndex:2]]];
+        return kLeadingWildcardScore;
+    }
+
+    return kRegexScore;
+}
+
+/**
+ * 只检查能否编译，不写入 HTMLParser 的正则缓存
+ * （批量导入上千个书源时会把运行中常用的正则挤出缓存）
+ */
++ (BOOL)isValidPattern:(NSString *)pattern options:(NSRegularExpressionOptions)options {
+    return [NSRegularExpression regularExpressionWithPattern:pattern options:options error:nil] != nil;
+}
+
+#pragma mark - 样本实测
+
++ (NSDictionary<NSString *, NSNumber *> *)measureBookSource:(BookSource *)bookSource
+                                                   samples:(NSDictionary<NSString *, NSString *> *)samples
+                                                  warnings:(NSMutableArray<NSString *> *)warnings {
+    NSMutableDictionary<NSString *, NSNumber *> *milliseconds = [NSMutableDictionary dictionary];
+
+    [samples enumerateKeysAndObjectsUsingBlock:^(NSString *kind, NSString *sample, BOOL *stop) {
+        uint64_t start = MetricsNow();
+        @autoreleasepool {
+            if ([kind isEqualToString:@"search"]) {
+                [SourceResponseParser booksFromSearchContent:sample bookSource:bookSource];
+            } else if ([kind isEqualToString:@"toc"]) {
+                [SourceResponseParser chaptersFromTocContent:sample bookSource:bookSource baseURL:bookSource.bookSourceUrl ?: @""];
+            } else if ([kind isEqualToString:@"content"]) {
+                [SourceResponseParser chapterTextFromContent:sample bookSource:bookSource];
+            } else {
+                return;
+            }
+        }
+        double elapsed = (MetricsNow() - start) / 1e6;
+        milliseconds[kind] = @(elapsed);
+
+        if (elapsed > kSampleSlowMilliseconds) {
+            NSDictionary *titles = @{@"search": @"搜索", @"toc": @"目录", @"content": @"正文"};
+            [warnings addObject:[NSString stringWithFormat:@"%@样本页解析耗时 %.0f ms", titles[kind], elapsed]];
+        }
+    }];
+
+    return milliseconds;
+}
+
+@end
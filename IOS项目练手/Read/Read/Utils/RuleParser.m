@@ -7,6 +7,8 @@
 
 #import "RuleParser.h"
 #import "HTMLParser.h"
+#import "TraceRecorder.h"
+#import "MetricsRegistry.h"
 
 @implementation RuleParser
 
@@ -17,20 +19,24 @@
         return nil;
     }
 
+    TraceSpan span = TraceSpanBegin("parse", "RuleParser");
+
     // 尝试解析为 JSON
     NSData *jsonData = [content dataUsingEncoding:NSUTF8StringEncoding];
     NSError *error = nil;
     id jsonObject = [NSJSONSerialization JSONObjectWithData:jsonData options:0 error:&error];
 
+    id result = nil;
     if (!error && jsonObject) {
         // 是 JSON，使用 JSON 路径解析
-        id result = [self extractFromJSON:jsonObject withRule:rule];
-        return result;
+        result = [self extractFromJSON:jsonObject withRule:rule];
     } else {
         // 是 HTML，使用 HTML 解析
-        id result = [HTMLParser extractFromHTML:content withRule:rule];
-        return result;
+        result = [HTMLParser extractFromHTML:content withRule:rule];
     }
+
+    TRACE_END(span, rule.UTF8String, (int64_t)content.length);
+    return result;
 }
 
 + (NSDictionary *)extractFieldsFromContent:(NSString *)content withRules:(NSDictionary<NSString *, NSString *> *)rules {
@@ -73,6 +79,8 @@
         return jsonObject;
     }
 
+    METRICS_TIME_SCOPE(MetricTimerRuleJSON);
+
     // 按 . 分割路径
     NSArray<NSString *> *components = [rule componentsSeparatedByString:@"."];
     id currentObject = jsonObject;
@@ -0,0 +1,94 @@
+//
+//  SourceResponseParser.h
+//  Read
+//
+//  书源响应解析器 - 按书源规则把搜索、目录、正文响应解析为模型（同步，不依赖网络和 UIKit）
+//
+
+#import <Foundation/Foundation.h>
+#import "BookSource.h"
+#import "ChapterModel.h"
+#import "SearchResultBook.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 目录分批回调
+ * @param chapters 本批章节（按元素顺序，chapterIndex 为元素序号）
+ * @param elementCount 目录元素总数（章节数的上限）
+ */
+typedef void (^SourceResponseChapterBatchHandler)(NSArray<ChapterModel *> *chapters, NSUInteger elementCount);
+
+/**
+ * 书源响应解析器
+ *
+ * 职责：
+ *   1. 搜索结果：bookList 规则取出书籍元素，逐个提取书名、作者、链接等字段
+ *   2. 目录：chapterList 规则取出章节元素，逐个提取章节名和链接（支持 @js 链接规则）
+ *   3. 正文：正文规则提取 + ContentCleaner 清洗；下一页链接提取
+ *
+ * 说明：
+ *   BookSearchService / BookContentService 在后台线程调用这里的方法，
+ *   解析基准测试（Benchmarks）直接链接本文件，在命令行中对录制的响应计时。
+ *   所有方法线程安全。
+ *
+ * 使用示例：
+ *   NSArray<ChapterModel *> *chapters = [SourceResponseParser chaptersFromTocContent:html
+ *                                                                         bookSource:bookSource
+ *                                                                            baseURL:tocUrl];
+ */
+@interface SourceResponseParser : NSObject
+
+/**
+ * 解析搜索结果
+ * @return 书籍列表（书名为空的条目被跳过）；响应为空或书源缺少搜索规则时返回 nil
+ */
++ (nullable NSArray<SearchResultBook *> *)booksFromSearchContent:(NSString *)content
+                                                      bookSource:(BookSource *)bookSource;
+
+/**
+ * 解析目录
+ * @param baseURL 目录页URL（用于补全相对链接）
+ * @return 章节列表（章节名或链接缺失的条目被跳过，index 为元素序号）
+ */
++ (NSArray<ChapterModel *> *)chaptersFromTocContent:(NSString *)content
+                                         bookSource:(BookSource *)bookSource
+                                            baseURL:(NSString *)baseURL;
+
+/**
+ * 分批解析目录：阅读位置附近的一块最先提取并交出，其余按离阅读位置由近到远并行提取，每块完成即交出
+ * @param index 阅读位置（元素序号，超出范围时按最后一块）
+ * @param batchHandler 每批调用一次（在解析线程上，调用之间串行，第一批之后顺序不定）
+ * @return 完整章节列表，与 chaptersFromTocContent:bookSource:baseURL: 相同
+ */
++ (NSArray<ChapterModel *> *)chaptersFromTocContent:(NSString *)content
+                                         bookSource:(BookSource *)bookSource
+                                            baseURL:(NSString *)baseURL
+                                        aroundIndex:(NSUInteger)index
+                                       batchHandler:(SourceResponseChapterBatchHandler)batchHandler;
+
+/**
+ * 提取并清洗正文
+ */
++ (NSString *)chapterTextFromContent:(NSString *)content bookSource:(BookSource *)bookSource;
+
+/**
+ * 提取正文的下一页链接（书源没有下一页规则或未找到时返回 nil）
+ */
++ (nullable NSString *)nextPageURLFromContent:(NSString *)content
+                                   bookSource:(BookSource *)bookSource
+                                      baseURL:(NSString *)baseURL;
+
+/**
+ * 规则结果转字符串（数组取第一个元素，NSNull 视为空）
+ */
++ (nullable NSString *)stringFromResult:(nullable id)result;
+
+/**
+ * 补全链接（完整链接原样返回，/ 开头按站点根路径，其余相对于 baseURL）
+ */
++ (NSString *)fullURL:(nullable NSString *)url baseURL:(NSString *)baseURL;
+
+@end
+
+NS_ASSUME_NONNULL_END
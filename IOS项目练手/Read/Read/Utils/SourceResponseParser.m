@@ -0,0 +1,444 @@
+//
+//  SourceResponseParser.m
+//  Read
+//
+//  书源响应解析器实现
+//
+
+#import "SourceResponseParser.h"
+#import "RuleParser.h"
+#import "HTMLParser.h"
+#import "ContentCleaner.h"
+#import "JSScriptEngine.h"
+#import "TraceRecorder.h"
+#import "MetricsRegistry.h"
+
+static const NSUInteger kTocChunkSize = 256;            // 并行提取时每块的章节数
+static const NSUInteger kTocParallelThreshold = 512;    // 章节数少于此值时串行提取（分块调度不划算）
+
+typedef ChapterModel * _Nullable (^SourceResponseChapterExtractor)(NSUInteger index);
+
+@implementation SourceResponseParser
+
+#pragma mark - 搜索结果
+
++ (nullable NSArray<SearchResultBook *> *)booksFromSearchContent:(NSString *)content
+                                                      bookSource:(BookSource *)bookSource {
+    if (!content || content.length == 0) {
+        return nil;
+    }
+
+    RuleSearch *searchRule = bookSource.ruleSearch;
+    if (!searchRule) {
+        return nil;
+    }
+
+    TRACE_SCOPE("parse", "booksFromSearch");
+    MetricsSource source = [MetricsRegistry sourceForBookSource:bookSource];
+    METRICS_SOURCE_SCOPE(source);
+    METRICS_TIME_SCOPE(MetricTimerParseSearch);
+
+    // 使用 RuleParser 提取书籍列表（自动检测 JSON 或 HTML）
+    id bookListResult = [RuleParser extractFromContent:content withRule:searchRule.bookList];
+    NSArray *bookElements = nil;
+
+    if ([bookListResult isKindOfClass:[NSArray class]]) {
+        bookElements = bookListResult;
+    } else if ([bookListResult isKindOfClass:[NSDictionary class]]) {
+        bookElements = @[bookListResult];
+    } else if ([bookListResult isKindOfClass:[NSString class]]) {
+        bookElements = @[bookListResult];
+    } else {
+        MetricsCount(source, MetricCounterParseFailures, 1);
+        return @[];
+    }
+
+    // 解析每本书的信息
+    NSMutableArray<SearchResultBook *> *books = [NSMutableArray array];
+
+    for (id bookElement in bookElements) {
+        SearchResultBook *book = [[SearchResultBook alloc] init];
+        book.bookSource = bookSource;
+
+        // 根据元素类型选择解析方式
+        if ([bookElement isKindOfClass:[NSDictionary class]]) {
+            // JSON 对象，直接提取字段
+            NSDictionary *bookDict = (NSDictionary *)bookElement;
+            book.name = [RuleParser extractFromJSON:bookDict withRule:searchRule.name];
+            book.author = [RuleParser extractFromJSON:bookDict withRule:searchRule.author];
+
+            // 提取书籍URL（可能需要模板替换）
+            NSString *bookUrlRule = searchRule.bookUrl;
+            if ([bookUrlRule containsString:@"{{$."]) {
+                book.bookUrl = [RuleParser applyTemplate:bookUrlRule withData:bookDict];
+            } else {
+                book.bookUrl = [RuleParser extractFromJSON:bookDict withRule:bookUrlRule];
+            }
+
+            book.intro = [RuleParser extractFromJSON:bookDict withRule:searchRule.intro];
+            book.lastChapter = [RuleParser extractFromJSON:bookDict withRule:searchRule.lastChapter];
+
+            // 封面URL（如果有）
+            if (searchRule.coverUrl) {
+                book.coverUrl = [RuleParser extractFromJSON:bookDict withRule:searchRule.coverUrl];
+            }
+        } else if ([bookElement isKindOfClass:[NSString class]]) {
+            // HTML 字符串，使用 HTMLParser
+            NSString *html = (NSString *)bookElement;
+            book.name = [HTMLParser extractFromHTML:html withRule:searchRule.name];
+            book.author = [HTMLParser extractFromHTML:html withRule:searchRule.author];
+            book.bookUrl = [HTMLParser extractFromHTML:html withRule:searchRule.bookUrl];
+            book.intro = [HTMLParser extractFromHTML:html withRule:searchRule.intro];
+            book.lastChapter = [HTMLParser extractFromHTML:html withRule:searchRule.lastChapter];
+        }
+
+        // 处理相对URL
+        if (book.bookUrl && ![book.bookUrl hasPrefix:@"http"]) {
+            book.bookUrl = [self searchResultURL:book.bookUrl baseURL:bookSource.bookSourceUrl];
+        }
+
+        // 如果书名不为空，添加到结果
+        if (book.name && book.name.length > 0) {
+            [books addObject:book];
+        }
+    }
+
+    return books;
+}
+
+#pragma mark - 目录
+
++ (NSArray<ChapterModel *> *)chaptersFromTocContent:(NSString *)content
+                                         bookSource:(BookSource *)bookSource
+                                            baseURL:(NSString *)baseURL {
+    RuleToc *tocRule = bookSource.ruleToc;
+    if (!tocRule.chapterList || content.length == 0) {
+        return @[];
+    }
+
+    TRACE_SCOPE("parse", "chaptersFromToc");
+    MetricsSource source = [MetricsRegistry sourceForBookSource:bookSource];
+    METRICS_SOURCE_SCOPE(source);
+    METRICS_TIME_SCOPE(MetricTimerParseToc);
+
+    NSArray *chapterElements = [self chapterElementsFromTocContent:content tocRule:tocRule];
+    SourceResponseChapterExtractor chapterAtIndex = [self chapterExtractorForElements:chapterElements
+                                                                              tocRule:tocRule
+                                                                              baseURL:baseURL];
+
+    NSArray<NSValue *> *ranges = [self chunkRangesFrom:0 to:chapterElements.count];
+    NSArray<NSArray<ChapterModel *> *> *results = [self chaptersInRanges:ranges
+                                                               extractor:chapterAtIndex
+                                                                  source:source
+                                                            batchHandler:nil];
+
+    NSMutableArray<ChapterModel *> *chapters = [NSMutableArray arrayWithCapacity:chapterElements.count];
+    for (NSArray<ChapterModel *> *chunk in results) {
+        [chapters addObjectsFromArray:chunk];
+    }
+
+    if (chapters.count == 0) {
+        MetricsCount(source, MetricCounterParseFailures, 1);
+    }
+    return chapters;
+}
+
++ (NSArray<ChapterModel *> *)chaptersFromTocContent:(NSString *)content
+                                         bookSource:(BookSource *)bookSource
+                                            baseURL:(NSString *)baseURL
+                                        aroundIndex:(NSUInteger)index
+                                       batchHandler:(SourceResponseChapterBatchHandler)batchHandler {
+    RuleToc *tocRule = bookSource.ruleToc;
+    if (!tocRule.chapterList || content.length == 0) {
+        return @[];
+    }
+
+    TRACE_SCOPE("parse", "chaptersFromToc");
+    MetricsSource source = [MetricsRegistry sourceForBookSource:bookSource];
+    METRICS_SOURCE_SCOPE(source);
+    METRICS_TIME_SCOPE(MetricTimerParseToc);
+
+    NSArray *chapterElements = [self chapterElementsFromTocContent:content tocRule:tocRule];
+    SourceResponseChapterExtractor chapterAtIndex = [self chapterExtractorForElements:chapterElements
+                                                                              tocRule:tocRule
+                                                                              baseURL:baseURL];
+    NSUInteger count = chapterElements.count;
+
+    // 1. 阅读位置所在的一块先提取并立即交出（元素数不足一块时就是整个目录）
+    NSUInteger windowLength = MIN(kTocChunkSize, count);
+    NSUInteger windowStart = MIN(index > windowLength / 2 ? index - windowLength / 2 : 0, count - windowLength);
+    NSRange window = NSMakeRange(windowStart, windowLength);
+
+    NSArray<NSArray<ChapterModel *> *> *windowResult = [self chaptersInRanges:@[[NSValue valueWithRange:window]]
+                                                                    extractor:chapterAtIndex
+                                                                       source:source
+                                                                 batchHandler:nil];
+    if (count > 0) {
+        batchHandler(windowResult.firstObject, count);
+    }
+
+    // 2. 其余部分按离阅读位置由近到远交替排列（后一块、前一块……），并行提取，每块完成即交出
+    NSArray<NSValue *> *after = [self chunkRangesFrom:NSMaxRange(window) to:count];
+    NSArray<NSValue *> *before = [[self chunkRangesFrom:0 to:window.location] reverseObjectEnumerator].allObjects;
+    NSMutableArray<NSValue *> *ranges = [NSMutableArray arrayWithCapacity:after.count + before.count];
+    for (NSUInteger i = 0; i < MAX(after.count, before.count); i++) {
+        if (i < after.count) [ranges addObject:after[i]];
+        if (i < before.count) [ranges addObject:before[i]];
+    }
+
+    NSArray<NSArray<ChapterModel *> *> *results = [self chaptersInRanges:ranges
+                                                               extractor:chapterAtIndex
+                                                                  source:source
+                                                            batchHandler:^(NSArray<ChapterModel *> *chapters) {
+        batchHandler(chapters, count);
+    }];
+
+    // 3. 按元素顺序合并，结果与一次性解析相同
+    NSMutableArray<ChapterModel *> *chapters = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = before.count; i > 0; i--) {
+        [chapters addObjectsFromArray:results[[ranges indexOfObject:before[i - 1]]]];
+    }
+    [chapters addObjectsFromArray:windowResult.firstObject ?: @[]];
+    for (NSValue *range in after) {
+        [chapters addObjectsFromArray:results[[ranges indexOfObject:range]]];
+    }
+
+    if (chapters.count == 0) {
+        MetricsCount(source, MetricCounterParseFailures, 1);
+    }
+    return chapters;
+}
+
+/**
+ * chapterList 规则取出章节元素（结果不是数组时视为没有章节）
+ */
++ (NSArray *)chapterElementsFromTocContent:(NSString *)content tocRule:(RuleToc *)tocRule {
+    id chapterListResult = [RuleParser extractFromContent:content withRule:tocRule.chapterList];
+    return [chapterListResult isKindOfClass:[NSArray class]] ? chapterListResult : @[];
+}
+
+/**
+ * 单个章节的提取器：名称和链接都提取到才生成，index 为元素序号
+ */
++ (SourceResponseChapterExtractor)chapterExtractorForElements:(NSArray *)chapterElements
+                                                      tocRule:(RuleToc *)tocRule
+                                                      baseURL:(NSString *)baseURL {
+    // 链接规则对每个元素都一样，拆分一次
+    BOOL urlRuleHasScript = tocRule.chapterUrl && [JSScriptEngine containsJavaScript:tocRule.chapterUrl];
+    NSString *normalUrlRule = urlRuleHasScript ? [JSScriptEngine extractNormalRuleFromRule:tocRule.chapterUrl] : tocRule.chapterUrl;
+    NSString *urlScript = urlRuleHasScript ? [JSScriptEngine extractJavaScriptFromRule:tocRule.chapterUrl] : nil;
+
+    return ^ChapterModel *(NSUInteger i) {
+        id element = chapterElements[i];
+
+        // 解析章节名称
+        NSString *chapterName = nil;
+        if (tocRule.chapterName) {
+            chapterName = [self stringFromResult:[self extractFromElement:element withRule:tocRule.chapterName]];
+        }
+
+        // 解析章节URL
+        NSString *chapterUrl = nil;
+        if (urlRuleHasScript) {
+            // 先用普通规则提取数据，再执行 JavaScript 脚本
+            NSString *extractedValue = normalUrlRule ? [self stringFromResult:[self extractFromElement:element withRule:normalUrlRule]] : nil;
+            if (urlScript && extractedValue) {
+                NSDictionary *context = @{@"result": extractedValue};
+                chapterUrl = [self stringFromResult:[JSScriptEngine executeScript:urlScript withContext:context]];
+            }
+        } else if (normalUrlRule) {
+            chapterUrl = [self stringFromResult:[self extractFromElement:element withRule:normalUrlRule]];
+        }
+
+        if (!chapterName || !chapterUrl) {
+            return nil;
+        }
+
+        // 构建完整URL
+        return [ChapterModel chapterWithName:chapterName
+                                         url:[self fullURL:chapterUrl baseURL:baseURL]
+                                       index:i];
+    };
+}
+
+/**
+ * 把 [start, end) 按固定大小切块
+ */
++ (NSArray<NSValue *> *)chunkRangesFrom:(NSUInteger)start to:(NSUInteger)end {
+    NSMutableArray<NSValue *> *ranges = [NSMutableArray array];
+    for (NSUInteger location = start; location < end; location += kTocChunkSize) {
+        [ranges addObject:[NSValue valueWithRange:NSMakeRange(location, MIN(kTocChunkSize, end - location))]];
+    }
+    return ranges;
+}
+
+/**
+ * 逐块提取章节，返回与 ranges 一一对应的结果
+ * 元素总数不少于 kTocParallelThreshold 时各块在多个核上并行提取，每块只写自己的数组；
+ * batchHandler 在每块完成后调用（加锁串行，顺序不定）
+ */
++ (NSArray<NSArray<ChapterModel *> *> *)chaptersInRanges:(NSArray<NSValue *> *)ranges
+                                               extractor:(SourceResponseChapterExtractor)chapterAtIndex
+                                                  source:(MetricsSource)source
+                                            batchHandler:(void (^)(NSArray<ChapterModel *> *chapters))batchHandler {
+    NSUInteger total = 0;
+    NSMutableArray<NSMutableArray<ChapterModel *> *> *results = [NSMutableArray arrayWithCapacity:ranges.count];
+    for (NSValue *value in ranges) {
+        total += value.rangeValue.length;
+        [results addObject:[NSMutableArray arrayWithCapacity:value.rangeValue.length]];
+    }
+
+    NSObject *handlerLock = [[NSObject alloc] init];
+    void (^extractChunk)(size_t) = ^(size_t chunk) {
+        NSMutableArray<ChapterModel *> *output = results[chunk];
+        NSRange range = ranges[chunk].rangeValue;
+        @autoreleasepool {
+            for (NSUInteger i = range.location; i < NSMaxRange(range); i++) {
+                ChapterModel *chapter = chapterAtIndex(i);
+                if (chapter) {
+                    [output addObject:chapter];
+                }
+            }
+        }
+        if (batchHandler) {
+            @synchronized (handlerLock) {
+                batchHandler(output);
+            }
+        }
+    };
+
+    if (total < kTocParallelThreshold) {
+        for (size_t chunk = 0; chunk < ranges.count; chunk++) {
+            extractChunk(chunk);
+        }
+    } else {
+        // ⭐ 大目录按固定大小分块，在多个核上并行提取；dispatch_apply 大致按下标顺序领取，排在前面的块先完成
+        dispatch_apply(ranges.count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t chunk) {
+            // 书源归属是线程局部的，工作线程上重新设置，规则和 JS 耗时才能记到该书源
+            METRICS_SOURCE_SCOPE(source);
+            TRACE_SCOPE("parse", "tocChunk");
+            extractChunk(chunk);
+        });
+    }
+
+    return results;
+}
+
+/**
+ * 按元素类型提取：JSON 对象按 JSON 规则，HTML 片段按通用规则，其他类型转为字符串
+ */
++ (nullable id)extractFromElement:(id)element withRule:(NSString *)rule {
+    if ([element isKindOfClass:[NSDictionary class]]) {
+        return [RuleParser extractFromJSON:element withRule:rule];
+    }
+    if ([element isKindOfClass:[NSString class]]) {
+        return [RuleParser extractFromContent:element withRule:rule];
+    }
+    return [element description];
+}
+
+#pragma mark - 正文
+
++ (NSString *)chapterTextFromContent:(NSString *)content bookSource:(BookSource *)bookSource {
+    TRACE_SCOPE("parse", "chapterText");
+    MetricsSource source = [MetricsRegistry sourceForBookSource:bookSource];
+    METRICS_SOURCE_SCOPE(source);
+    METRICS_TIME_SCOPE(MetricTimerParseContent);
+
+    // ⭐ 去标签、解码实体、去广告、整理段落由清洗器一遍完成
+    ContentCleaner *cleaner = [ContentCleaner cleanerForContentRule:bookSource.ruleContent.content];
+    id contentResult = [RuleParser extractFromContent:content withRule:cleaner.extractionRule];
+    NSString *text = [cleaner cleanContent:[self stringFromResult:contentResult] ?: @""];
+    if (text.length == 0) {
+        MetricsCount(source, MetricCounterParseFailures, 1);
+    }
+    return text;
+}
+
++ (nullable NSString *)nextPageURLFromContent:(NSString *)content
+                                   bookSource:(BookSource *)bookSource
+                                      baseURL:(NSString *)baseURL {
+    NSString *rule = bookSource.ruleContent.nextContentUrl;
+    if (rule.length == 0) {
+        return nil;
+    }
+    NSString *url = [self stringFromResult:[RuleParser extractFromContent:content withRule:rule]];
+    return url.length > 0 ? [self fullURL:url baseURL:baseURL] : nil;
+}
+
+#pragma mark - 辅助方法
+
++ (nullable NSString *)stringFromResult:(nullable id)result {
+    if (!result || [result isKindOfClass:[NSNull class]]) {
+        return nil;
+    }
+
+    if ([result isKindOfClass:[NSString class]]) {
+        return result;
+    }
+
+    if ([result isKindOfClass:[NSArray class]]) {
+        NSArray *array = result;
+        if (array.count > 0) {
+            return [self stringFromResult:array[0]];
+        }
+        return nil;
+    }
+
+    return [NSString stringWithFormat:@"%@", result];
+}
+
++ (NSString *)fullURL:(nullable NSString *)url baseURL:(NSString *)baseURL {
+    if (!url || url.length == 0) {
+        return baseURL;
+    }
+
+    // 如果已经是完整URL
+    if ([url hasPrefix:@"http://"] || [url hasPrefix:@"https://"]) {
+        return url;
+    }
+
+    // 如果是相对路径
+    if ([url hasPrefix:@"/"]) {
+        // 提取baseURL的scheme和host
+        NSURL *base = [NSURL URLWithString:baseURL];
+        if (base) {
+            return [NSString stringWithFormat:@"%@://%@%@", base.scheme, base.host, url];
+        }
+    }
+
+    // 相对于当前页面的路径
+    NSURL *base = [NSURL URLWithString:baseURL];
+    if (base) {
+        NSURL *full = [NSURL URLWithString:url relativeToURL:base];
+        return full.absoluteString;
+    }
+
+    return url;
+}
+
+/**
+ * 搜索结果的相对链接按书源根地址拼接
+ */
++ (NSString *)searchResultURL:(NSString *)relativeURL baseURL:(NSString *)baseURL {
+    if ([relativeURL hasPrefix:@"http"]) {
+        return relativeURL;
+    }
+
+    // 移除 baseURL 末尾的斜杠和 # 符号
+    if ([baseURL hasSuffix:@"#"]) {
+        baseURL = [baseURL substringToIndex:baseURL.length - 1];
+    }
+    if ([baseURL hasSuffix:@"/"]) {
+        baseURL = [baseURL substringToIndex:baseURL.length - 1];
+    }
+
+    // 处理相对路径
+    if ([relativeURL hasPrefix:@"/"]) {
+        return [baseURL stringByAppendingString:relativeURL];
+    } else {
+        return [baseURL stringByAppendingFormat:@"/%@", relativeURL];
+    }
+}
+
+@end
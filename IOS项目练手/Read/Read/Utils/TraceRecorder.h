@@ -0,0 +1,134 @@
+//
+//  TraceRecorder.h
+//  Read
+//
+//  性能追踪 - 记录耗时区间（每线程环形缓冲区），导出 Chrome trace_event JSON
+//
+
+#import <Foundation/Foundation.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * 一个耗时区间（开始时创建，结束时写入当前线程的缓冲区）
+ * start 为 0 表示开始时追踪未开启，结束时不记录
+ */
+typedef struct {
+    const char *category;   // 分类（字符串常量）
+    const char *name;       // 名称（字符串常量）
+    uint64_t start;         // 开始时间（纳秒）
+} TraceSpan;
+
+/**
+ * 追踪是否开启（只读，用 +[TraceRecorder startRecording] / stopRecording 切换）
+ */
+extern bool TraceRecorderEnabled;
+
+uint64_t TraceRecorderNow(void);
+
+/**
+ * 开始一个区间：追踪关闭时只有一次全局变量读取
+ */
+static inline TraceSpan TraceSpanBegin(const char *category, const char *name) {
+    TraceSpan span = {category, name, 0};
+    if (__builtin_expect(TraceRecorderEnabled, 0)) {
+        span.start = TraceRecorderNow();
+    }
+    return span;
+}
+
+/**
+ * 结束区间（同一线程内开始和结束，导出为完整事件，可嵌套）
+ */
+void TraceSpanEnd(TraceSpan *span);
+
+/**
+ * 结束区间并附加详情（截断到 47 字节）和一个数值（如字节数）
+ */
+void TraceSpanEndWithDetail(const TraceSpan *span, const char * _Nullable detail, int64_t value);
+
+/**
+ * 结束异步区间（开始和结束可以在不同线程，例如网络请求；导出为异步事件，不参与线程内的嵌套）
+ */
+void TraceSpanEndAsync(const TraceSpan *span, const char * _Nullable detail, int64_t value);
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+/**
+ * 作用域区间：离开作用域时自动结束
+ */
+#define TRACE_SCOPE(category, name) \
+    __attribute__((cleanup(TraceSpanEnd), unused)) TraceSpan TRACE_CONCAT(_traceSpan, __LINE__) = TraceSpanBegin(category, name)
+
+/**
+ * 结束区间并附加详情；详情和数值表达式只在追踪开启时求值
+ */
+#define TRACE_END(span, detail, value) \
+    do { if ((span).start) TraceSpanEndWithDetail(&(span), (detail), (value)); } while (0)
+
+#define TRACE_END_ASYNC(span, detail, value) \
+    do { if ((span).start) TraceSpanEndAsync(&(span), (detail), (value)); } while (0)
+
+/**
+ * 性能追踪
+ *
+ * 职责：
+ *   1. 开关追踪：关闭时埋点只有一次全局变量读取，不分配内存、不取时间
+ *   2. 记录：每个线程第一次记录时分配自己的环形缓冲区（kTraceEventsPerThread 条），
+ *      写入不加锁；写满后覆盖最旧的事件
+ *   3. 导出：Chrome trace_event JSON，可以直接拖进 Perfetto（ui.perfetto.dev）或 chrome://tracing 查看火焰图
+ *
+ * 说明：
+ *   埋点的分类：network（请求、解码）、parse（规则求值）、script（JS）、paginate（分页）、storage（离线缓存读写）、
+ *   content（章节获取全程）、reader（点击章节到首屏显示）。
+ *   录制中也可以导出：逐条复制后检查该槽是否已被所属线程覆盖，覆盖过的事件丢弃，不会导出写到一半的事件。
+ *
+ * 使用示例：
+ *   - (void)work {
+ *       TRACE_SCOPE("parse", "work");                       // 作用域区间
+ *       ...
+ *   }
+ *
+ *   TraceSpan span = TraceSpanBegin("network", "request");   // 跨线程区间
+ *   [session dataTaskWithRequest:request completionHandler:^(...) {
+ *       TRACE_END_ASYNC(span, request.URL.absoluteString.UTF8String, data.length);
+ *   }];
+ *
+ *   [TraceRecorder startRecording];
+ *   ... 打开一章 ...
+ *   [TraceRecorder stopRecording];
+ *   NSString *path = [TraceRecorder writeChromeTraceToDirectory:directory error:&error];
+ */
+@interface TraceRecorder : NSObject
+
++ (BOOL)isRecording;
+
+/**
+ * 清空之前的事件并开始记录
+ */
++ (void)startRecording;
+
++ (void)stopRecording;
+
+/**
+ * 已记录的事件数（所有线程）
+ */
++ (NSUInteger)eventCount;
+
+/**
+ * 导出 Chrome trace_event JSON（录制中导出时，导出期间被覆盖的旧事件会被丢弃）
+ */
++ (NSData *)chromeTraceData;
+
+/**
+ * 导出到目录下的 trace-<时间>.json
+ * @return 文件路径，失败返回 nil
+ */
++ (nullable NSString *)writeChromeTraceToDirectory:(NSString *)directory error:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,327 @@
+//
+//  TraceRecorder.m
+//  Read
+//
+//  性能追踪实现
+//
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE     // pthread_getname_np（GNUstep 下编译基准测试时）
+#endif
+
+#import "TraceRecorder.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdio.h>
+#include <unistd.h>
+
+enum {
+    kTraceEventsPerThread = 4096,   // 每线程约 384KB
+    kTraceDetailLength = 48,
+};
+static const int64_t kTraceNoValue = INT64_MIN;
+
+bool TraceRecorderEnabled = false;
+
+#pragma mark - 缓冲区
+
+typedef struct {
+    const char *category;
+    const char *name;
+    uint64_t start;
+    uint64_t duration;
+    uint64_t asyncId;                  // 0 表示同步区间
+    int64_t value;
+    char detail[kTraceDetailLength];
+} TraceEvent;
+
+/**
+ * 每个线程一个环形缓冲区，只由所属线程写入
+ * 线程结束时缓冲区放回空闲链表（事件仍可导出），新线程优先复用，缓冲区总数不超过同时存在的线程数；
+ * startRecording 只递增代数，各线程写入时发现代数变化再自行清零，不改动别的线程正在写的缓冲区
+ */
+typedef struct TraceRing {
+    struct TraceRing *next;
+    struct TraceRing *nextFree;        // 空闲链表（所属线程已结束）
+    uint32_t tid;
+    char threadName[64];
+    _Atomic uint64_t generation;       // 事件所属的录制代数
+    _Atomic uint64_t written;          // 本代累计写入数，下标为 written % kTraceEventsPerThread
+    TraceEvent events[kTraceEventsPerThread];
+} TraceRing;
+
+static TraceRing *gRings = NULL;
+static TraceRing *gFreeRings = NULL;
+static pthread_mutex_t gRingsLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t gRingKey;
+static pthread_once_t gRingKeyOnce = PTHREAD_ONCE_INIT;
+static _Atomic uint32_t gNextTid = 1;
+static _Atomic uint64_t gNextAsyncId = 1;
+static _Atomic uint64_t gGeneration = 1;
+static uint64_t gRecordingStart = 0;
+static __thread TraceRing *tCurrentRing = NULL;
+
+uint64_t TraceRecorderNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * 线程结束：缓冲区放回空闲链表
+ */
+static void TraceRingRelease(void *value) {
+    TraceRing *ring = value;
+    tCurrentRing = NULL;
+
+    pthread_mutex_lock(&gRingsLock);
+    ring->nextFree = gFreeRings;
+    gFreeRings = ring;
+    pthread_mutex_unlock(&gRingsLock);
+}
+
+static void TraceRingKeyCreate(void) {
+    pthread_key_create(&gRingKey, TraceRingRelease);
+}
+
+/**
+ * 取一个空闲缓冲区：优先取不含本次录制事件的，都含有时取最早放回的（丢弃该已结束线程的事件）
+ * 调用方持有 gRingsLock
+ */
+static TraceRing *TraceTakeFreeRing(void) {
+    uint64_t generation = atomic_load(&gGeneration);
+    TraceRing **chosen = NULL;
+    for (TraceRing **link = &gFreeRings; *link; link = &(*link)->nextFree) {
+        chosen = link;
+        if (atomic_load(&(*link)->generation) != generation) {
+            break;
+        }
+    }
+    if (!chosen) {
+        return NULL;
+    }
+    TraceRing *ring = *chosen;
+    *chosen = ring->nextFree;
+    ring->nextFree = NULL;
+    return ring;
+}
+
+static TraceRing *TraceCurrentRing(void) {
+    if (tCurrentRing) {
+        return tCurrentRing;
+    }
+
+    char threadName[64] = {0};
+    pthread_getname_np(pthread_self(), threadName, sizeof(threadName));
+    uint32_t tid = atomic_fetch_add(&gNextTid, 1);
+    if (threadName[0] == '\0') {
+        snprintf(threadName, sizeof(threadName), "%s %u", [NSThread isMainThread] ? "main" : "worker", tid);
+    }
+
+    pthread_mutex_lock(&gRingsLock);
+    TraceRing *ring = TraceTakeFreeRing();
+    if (!ring) {
+        ring = calloc(1, sizeof(TraceRing));
+        if (!ring) {
+            pthread_mutex_unlock(&gRingsLock);
+            return NULL;
+        }
+        ring->next = gRings;
+        gRings = ring;
+    }
+    // 在锁内换主人，导出时不会读到一半
+    ring->tid = tid;
+    memcpy(ring->threadName, threadName, sizeof(threadName));
+    atomic_store(&ring->written, 0);
+    atomic_store(&ring->generation, atomic_load(&gGeneration));
+    pthread_mutex_unlock(&gRingsLock);
+
+    pthread_once(&gRingKeyOnce, TraceRingKeyCreate);
+    pthread_setspecific(gRingKey, ring);
+    tCurrentRing = ring;
+    return ring;
+}
+
+static void TraceRecord(const TraceSpan *span, uint64_t asyncId, const char *detail, int64_t value) {
+    uint64_t end = TraceRecorderNow();
+    TraceRing *ring = TraceCurrentRing();
+    if (!ring) {
+        return;
+    }
+
+    // 开始了新一次录制：先清零计数再更新代数，导出方看到新代数时计数一定已清零
+    uint64_t generation = atomic_load_explicit(&gGeneration, memory_order_relaxed);
+    if (atomic_load_explicit(&ring->generation, memory_order_relaxed) != generation) {
+        atomic_store_explicit(&ring->written, 0, memory_order_relaxed);
+        atomic_store_explicit(&ring->generation, generation, memory_order_release);
+    }
+
+    uint64_t index = atomic_load_explicit(&ring->written, memory_order_relaxed);
+    TraceEvent *event = &ring->events[index % kTraceEventsPerThread];
+    event->category = span->category;
+    event->name = span->name;
+    event->start = span->start;
+    event->duration = end - span->start;
+    event->asyncId = asyncId;
+    event->value = value;
+    size_t length = detail ? strnlen(detail, kTraceDetailLength - 1) : 0;
+    if (length > 0 && detail[length] != '\0') {
+        // 不截断在 UTF-8 多字节字符中间
+        while (length > 0 && ((unsigned char)detail[length] & 0xC0) == 0x80) {
+            length--;
+        }
+    }
+    if (length > 0) {
+        memcpy(event->detail, detail, length);
+    }
+    event->detail[length] = '\0';
+    atomic_store_explicit(&ring->written, index + 1, memory_order_release);
+}
+
+#pragma mark - 区间
+
+void TraceSpanEnd(TraceSpan *span) {
+    if (span->start && TraceRecorderEnabled) {
+        TraceRecord(span, 0, NULL, kTraceNoValue);
+    }
+}
+
+void TraceSpanEndWithDetail(const TraceSpan *span, const char *detail, int64_t value) {
+    if (span->start && TraceRecorderEnabled) {
+        TraceRecord(span, 0, detail, value);
+    }
+}
+
+void TraceSpanEndAsync(const TraceSpan *span, const char *detail, int64_t value) {
+    if (span->start && TraceRecorderEnabled) {
+        TraceRecord(span, atomic_fetch_add(&gNextAsyncId, 1), detail, value);
+    }
+}
+
+#pragma mark - TraceRecorder
+
+@implementation TraceRecorder
+
++ (BOOL)isRecording {
+    return TraceRecorderEnabled;
+}
+
++ (void)startRecording {
+    atomic_fetch_add(&gGeneration, 1);
+    gRecordingStart = TraceRecorderNow();
+    TraceRecorderEnabled = true;
+}
+
++ (void)stopRecording {
+    TraceRecorderEnabled = false;
+}
+
++ (NSUInteger)eventCount {
+    NSUInteger count = 0;
+    pthread_mutex_lock(&gRingsLock);
+    uint64_t generation = atomic_load(&gGeneration);
+    for (TraceRing *ring = gRings; ring; ring = ring->next) {
+        if (atomic_load_explicit(&ring->generation, memory_order_acquire) == generation) {
+            count += (NSUInteger)MIN(atomic_load(&ring->written), (uint64_t)kTraceEventsPerThread);
+        }
+    }
+    pthread_mutex_unlock(&gRingsLock);
+    return count;
+}
+
++ (NSData *)chromeTraceData {
+    NSMutableArray<NSDictionary *> *events = [NSMutableArray array];
+    NSNumber *pid = @(getpid());
+    uint64_t origin = gRecordingStart;
+
+    [events addObject:@{@"ph": @"M", @"name": @"process_name", @"pid": pid, @"tid": @0, @"args": @{@"name": @"Read"}}];
+
+    pthread_mutex_lock(&gRingsLock);
+    uint64_t generation = atomic_load(&gGeneration);
+    for (TraceRing *ring = gRings; ring; ring = ring->next) {
+        // 还是上一次录制的缓冲区（所属线程在本次录制中没有写入）
+        if (atomic_load_explicit(&ring->generation, memory_order_acquire) != generation) {
+            continue;
+        }
+        uint64_t written = atomic_load_explicit(&ring->written, memory_order_acquire);
+        if (written == 0) {
+            continue;
+        }
+
+        NSNumber *tid = @(ring->tid);
+        [events addObject:@{@"ph": @"M", @"name": @"thread_name", @"pid": pid, @"tid": tid,
+                            @"args": @{@"name": [NSString stringWithUTF8String:ring->threadName] ?: @""}}];
+
+        uint64_t first = written > kTraceEventsPerThread ? written - kTraceEventsPerThread : 0;
+        for (uint64_t i = first; i < written; i++) {
+            // ⭐ 所属线程可能还在写：先复制，再检查复制期间这个槽有没有被覆盖（计数追上一圈或开始了新一次录制），
+            //    被覆盖的事件可能读到一半，丢弃
+            TraceEvent copy = ring->events[i % kTraceEventsPerThread];
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&ring->generation, memory_order_relaxed) != generation ||
+                atomic_load_explicit(&ring->written, memory_order_relaxed) >= i + kTraceEventsPerThread) {
+                continue;
+            }
+            copy.detail[kTraceDetailLength - 1] = '\0';
+
+            TraceEvent *event = &copy;
+            if (event->start < origin) {
+                continue;
+            }
+
+            NSMutableDictionary *args = [NSMutableDictionary dictionary];
+            if (event->detail[0]) {
+                args[@"detail"] = [NSString stringWithUTF8String:event->detail] ?: @"";
+            }
+            if (event->value != kTraceNoValue) {
+                args[@"value"] = @(event->value);
+            }
+
+            // Chrome trace 的时间单位是微秒
+            double ts = (event->start - origin) / 1000.0;
+            double dur = event->duration / 1000.0;
+            NSString *category = @(event->category);
+            NSString *name = @(event->name);
+
+            if (event->asyncId == 0) {
+                [events addObject:@{@"ph": @"X", @"cat": category, @"name": name, @"pid": pid, @"tid": tid,
+                                    @"ts": @(ts), @"dur": @(dur), @"args": args}];
+            } else {
+                NSString *identifier = [NSString stringWithFormat:@"0x%llx", (unsigned long long)event->asyncId];
+                [events addObject:@{@"ph": @"b", @"cat": category, @"name": name, @"id": identifier,
+                                    @"pid": pid, @"tid": tid, @"ts": @(ts), @"args": args}];
+                [events addObject:@{@"ph": @"e", @"cat": category, @"name": name, @"id": identifier,
+                                    @"pid": pid, @"tid": tid, @"ts": @(ts + dur)}];
+            }
+        }
+    }
+    pthread_mutex_unlock(&gRingsLock);
+
+    NSDictionary *trace = @{@"traceEvents": events, @"displayTimeUnit": @"ms"};
+    return [NSJSONSerialization dataWithJSONObject:trace options:0 error:nil] ?: [NSData data];
+}
+
++ (nullable NSString *)writeChromeTraceToDirectory:(NSString *)directory error:(NSError **)error {
+    if (![[NSFileManager defaultManager] createDirectoryAtPath:directory
+                                   withIntermediateDirectories:YES
+                                                    attributes:nil
+                                                         error:error]) {
+        return nil;
+    }
+
+    NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+    formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    formatter.dateFormat = @"yyyyMMdd-HHmmss";
+    NSString *fileName = [NSString stringWithFormat:@"trace-%@.json", [formatter stringFromDate:[NSDate date]]];
+    NSString *path = [directory stringByAppendingPathComponent:fileName];
+
+    if (![[self chromeTraceData] writeToFile:path options:NSDataWritingAtomic error:error]) {
+        return nil;
+    }
+    return path;
+}
+
+@end
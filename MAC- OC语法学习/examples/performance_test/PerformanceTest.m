@@ -2,8 +2,12 @@
 //  PerformanceTest.m
 //  性能测试：字典映射 vs 嵌套循环
 //
+//  使用微基准框架（MicroBenchmark）：每种规模是一个用例，自动预热、校准迭代次数，
+//  输出中位数、MAD、批 p99，结果写成 JSON。运行：make benchmark
+//
 
 #import <Foundation/Foundation.h>
+#import "MicroBenchmark.h"
 
 // 模拟工具栏项
 @interface ToolBarItem : NSObject
@@ -27,7 +31,12 @@
 
 // 性能测试类
 @interface PerformanceTest : NSObject
-+ (void)runTest;
++ (NSArray<ToolBarData *> *)generateTestData:(NSInteger)typeCount itemsPerType:(NSInteger)itemCount;
++ (NSArray<ToolBarData *> *)method1_DictionaryMapping:(NSArray<ToolBarData *> *)beeNestArray
+                                            localData:(NSArray<ToolBarData *> *)localDataArray;
++ (NSArray<ToolBarData *> *)method2_NestedLoop:(NSArray<ToolBarData *> *)beeNestArray
+                                      localData:(NSArray<ToolBarData *> *)localDataArray;
++ (void)printComplexityAnalysis;
 @end
 
 @implementation PerformanceTest
@@ -116,52 +125,7 @@
     return beeNestArray;
 }
 
-+ (void)runTest {
-    NSLog(@"========================================");
-    NSLog(@"性能测试：字典映射 vs 嵌套循环");
-    NSLog(@"========================================\n");
-
-    // 测试不同规模的数据
-    NSArray *testCases = @[
-        @{@"types": @5, @"items": @10},      // 小规模：5种类型，每种10个项
-        @{@"types": @10, @"items": @20},     // 中等规模：10种类型，每种20个项
-        @{@"types": @20, @"items": @50},     // 大规模：20种类型，每种50个项
-        @{@"types": @50, @"items": @100},    // 超大规模：50种类型，每种100个项
-    ];
-
-    for (NSDictionary *testCase in testCases) {
-        NSInteger typeCount = [testCase[@"types"] integerValue];
-        NSInteger itemCount = [testCase[@"items"] integerValue];
-
-        NSLog(@"📊 测试规模：%ld 种类型，每种 %ld 个项（共 %ld 个项）",
-              (long)typeCount, (long)itemCount, (long)(typeCount * itemCount));
-
-        // 生成测试数据
-        NSArray *beeNestData = [self generateTestData:typeCount itemsPerType:itemCount];
-        NSArray *localData = [self generateTestData:typeCount itemsPerType:itemCount];
-
-        // 测试方法1：字典映射
-        NSArray *beeNestCopy1 = [self generateTestData:typeCount itemsPerType:itemCount];
-        CFAbsoluteTime start1 = CFAbsoluteTimeGetCurrent();
-        [self method1_DictionaryMapping:beeNestCopy1 localData:localData];
-        CFAbsoluteTime end1 = CFAbsoluteTimeGetCurrent();
-        double time1 = (end1 - start1) * 1000.0;
-
-        // 测试方法2：嵌套循环
-        NSArray *beeNestCopy2 = [self generateTestData:typeCount itemsPerType:itemCount];
-        CFAbsoluteTime start2 = CFAbsoluteTimeGetCurrent();
-        [self method2_NestedLoop:beeNestCopy2 localData:localData];
-        CFAbsoluteTime end2 = CFAbsoluteTimeGetCurrent();
-        double time2 = (end2 - start2) * 1000.0;
-
-        // 输出结果
-        NSLog(@"  ✅ 方法1（字典映射）: %.4f ms", time1);
-        NSLog(@"  ❌ 方法2（嵌套循环）: %.4f ms", time2);
-        NSLog(@"  📈 性能提升：%.2f 倍", time2 / time1);
-        NSLog(@"  ⚡ 时间节省：%.2f%%\n", ((time2 - time1) / time2) * 100);
-    }
-
-    // 复杂度分析
++ (void)printComplexityAnalysis {
     NSLog(@"========================================");
     NSLog(@"算法复杂度分析：");
     NSLog(@"========================================");
@@ -183,10 +147,43 @@
 
 @end
 
+// 测试不同规模的数据：类型数 × 每种类型的项数
+static const NSInteger kTestCases[][2] = {
+    {5, 10},      // 小规模：5种类型，每种10个项
+    {10, 20},     // 中等规模：10种类型，每种20个项
+    {20, 50},     // 大规模：20种类型，每种50个项
+    {50, 100},    // 超大规模：50种类型，每种100个项
+};
+
+// 两个方法都原地修改蜂巢数据，重复执行时工作量不变，所以数据只生成一次（不计时）
+MICRO_BENCHMARK(toolbar, dictionaryMapping) {
+    for (size_t i = 0; i < sizeof(kTestCases) / sizeof(kTestCases[0]); i++) {
+        NSArray *beeNestData = [PerformanceTest generateTestData:kTestCases[i][0] itemsPerType:kTestCases[i][1]];
+        NSArray *localData = [PerformanceTest generateTestData:kTestCases[i][0] itemsPerType:kTestCases[i][1]];
+        NSString *variant = [NSString stringWithFormat:@"%ldx%ld", (long)kTestCases[i][0], (long)kTestCases[i][1]];
+        [context measureVariant:variant block:^{
+            MICRO_DO_NOT_OPTIMIZE([PerformanceTest method1_DictionaryMapping:beeNestData localData:localData]);
+        }];
+    }
+}
+
+MICRO_BENCHMARK(toolbar, nestedLoop) {
+    for (size_t i = 0; i < sizeof(kTestCases) / sizeof(kTestCases[0]); i++) {
+        NSArray *beeNestData = [PerformanceTest generateTestData:kTestCases[i][0] itemsPerType:kTestCases[i][1]];
+        NSArray *localData = [PerformanceTest generateTestData:kTestCases[i][0] itemsPerType:kTestCases[i][1]];
+        NSString *variant = [NSString stringWithFormat:@"%ldx%ld", (long)kTestCases[i][0], (long)kTestCases[i][1]];
+        [context measureVariant:variant block:^{
+            MICRO_DO_NOT_OPTIMIZE([PerformanceTest method2_NestedLoop:beeNestData localData:localData]);
+        }];
+    }
+}
+
 int main(int argc, const char * argv[]) {
     @autoreleasepool {
-        [PerformanceTest runTest];
+        int status = MicroBenchmarkMain(argc, argv);
+        if (status == 0) {
+            [PerformanceTest printComplexityAnalysis];
+        }
+        return status;
     }
-    return 0;
 }
-